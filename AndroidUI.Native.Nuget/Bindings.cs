@@ -141,6 +141,276 @@ namespace AndroidUI
 
             [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
             public static extern nuint SkNinePatchGlue_serializedSize(void* mPatch);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool SkKernel_computeBounds(float* xy, int count, float* outLTRB);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_matrixGetType(float* matrix);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_mapPoints(float* matrix, float* dst, float* src, int count);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_mapXY(float* matrix, float* srcX, float* srcY, float* dstX, float* dstY, int count);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_mapRects(float* matrix, float* dst, float* src, int count);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_mapRectsPerMatrix(float* matrices, float* dst, float* src, int count);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_mapRadius(float* matrix, float* dst, float* src, int count);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_quadSegmentCounts(float* pts, int count, float tolerance, int* segments);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_cubicSegmentCounts(float* pts, int count, float tolerance, int* segments);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_conicSegmentCounts(float* pts, float* weights, int count, float tolerance, int* segments);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_tessellateQuads(float* pts, int count, int* segments, float* outXY, float* outTangents);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_tessellateCubics(float* pts, int count, int* segments, float* outXY, float* outTangents);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_tessellateConics(float* pts, float* weights, int count, int* segments, float* outXY, float* outTangents);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_parsePathDataUtf16(char* chars, int length, char* verbs, int* verbSizes, int verbCapacity, float* points, int pointCapacity, int* info);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_parsePathDataUtf8(byte* chars, int length, char* verbs, int* verbSizes, int verbCapacity, float* points, int pointCapacity, int* info);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_interpolatePathPoints(float* from, float* to, float* dst, int count, float fraction);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_regionFromRects(int* rects, int count, int op, int* runs, int capacity);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_regionOp(int* a, int aLength, int* b, int bLength, int op, int* runs, int capacity);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool SkKernel_regionContains(int* runs, int length, int x, int y);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool SkKernel_regionContainsRect(int* runs, int length, int left, int top, int right, int bottom);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool SkKernel_regionIntersectsRect(int* runs, int length, int left, int top, int right, int bottom);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_regionGetRects(int* runs, int length, int* rects, int capacity);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_regionGetBounds(int* runs, int length, int* bounds);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool SkKernel_ninePatchLattice(void* chunk, int width, int height, int* xDivs, int* yDivs, byte* rectTypes, uint* colors, int* counts);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_ninePatchCells(void* chunk, int width, int height, float* dst, float* cells, byte* rectTypes, uint* colors, int capacity);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void* SkKernel_pngMapFile(byte* path);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_pngUnmap(void* png);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern byte* SkKernel_pngData(void* png, long* length);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool SkKernel_pngIsPng(void* png);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern byte* SkKernel_pngChunk(void* png, byte* tag, uint* length);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void* SkKernel_pngNinePatch(void* png, uint* size);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool SkKernel_pngInsets(void* png, int* opticalInsets, int* outlineInsets, float* outlineRadius, byte* outlineAlpha);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern sbyte* SkKernel_ninePatchCacheAcquire(sbyte* chunk, int length, float scaleX, float scaleY, int scaledWidth, int scaledHeight);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_ninePatchCacheRelease(void* patch);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_ninePatchCacheSetBudget(long unusedBytes);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_ninePatchCacheSize(void* patch);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_ninePatchCacheStats(long* stats);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void* SkKernel_resamplerCreate(int srcLeft, int srcWidth, int srcHeight, int dstWidth, int dstHeight);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_resamplerPushRows(void* resampler, void* rows, nuint rowBytes, int count, void* dst, nuint dstRowBytes);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_resamplerDestroy(void* resampler);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void* SkKernel_pixelPoolAcquire(long bytes, [MarshalAs(UnmanagedType.I1)] bool zero);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_pixelPoolRelease(void* block);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern long SkKernel_pixelPoolSizeClass(long bytes);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_pixelPoolSetBudget(long bytes);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_pixelPoolTrim(long keepBytes);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_pixelPoolSetHugePages([MarshalAs(UnmanagedType.I1)] bool enabled);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_pixelPoolStats(long* stats);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void* SkKernel_looperCreate();
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_looperDestroy(void* looper);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_looperPollOnce(void* looper, int timeoutMillis, int* fds, int* events, int capacity);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_looperWake(void* looper);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool SkKernel_looperIsPolling(void* looper);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            public static extern bool SkKernel_looperSetFileDescriptorEvents(void* looper, int fd, int events);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void* SkKernel_frameClockCreate(long periodNanos);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_frameClockDestroy(void* clock);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern long SkKernel_frameClockNow();
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_frameClockSetPeriod(void* clock, long periodNanos);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern long SkKernel_frameClockGetPeriod(void* clock);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern long SkKernel_frameClockLatest(void* clock);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern long SkKernel_frameClockWait(void* clock);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_frameClockWake(void* clock);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_animatorInterpolate(int* kind, float* param, float* input, float* output, int count);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_animatorLerp(float* fraction, int* lane, float* from, float* to, float* value, int count);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_animatorArgb(float* fraction, int* lane, int* from, int* to, int* value, int count);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_interpolatorLookup(float* table, int size, float* input, float* output, int count);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void* SkKernel_pathSamplerAcquire(float* approximation, int numPoints);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_pathSamplerRelease(void* sampler);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_pathSamplerSample(void* sampler, float* fraction, float* position, float* tangent, int count);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_pathSamplerStats(long* stats);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void* SkKernel_commandArenaCreate();
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_commandArenaDestroy(void* arena);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_commandArenaReset(void* arena);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_commandArenaAppend(void* arena, int command, int* payload, int words);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void* SkKernel_commandArenaCopy(void* arena);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int* SkKernel_commandArenaData(void* arena);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_commandArenaSize(void* arena);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_commandArenaCount(void* arena);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void* SkKernel_rtreeCreate(float* bounds, int count);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_rtreeDestroy(void* tree);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_rtreeSearch(void* tree, float* query, int* results);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_rtreeBytes(void* tree);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_drawBatchOrder(float* bounds, int* keys, int count, int* order);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void* SkKernel_velocityCreate();
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_velocityDestroy(void* tracker);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_velocityClear(void* tracker, int slotBits);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern void SkKernel_velocityAddMovement(void* tracker, long eventTime, int slotBits, float* positions);
+
+            [DllImport("AndroidUI.Native.dll", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+            public static extern int SkKernel_velocityEstimate(void* tracker, int strategy, int degree, int weighting, long* time, int* degrees, float* confidence, float* xCoeff, float* yCoeff);
         }
 
         /// <summary>
@@ -6,6 +6,26 @@
 
 #include "SkNx.h"
 
+#include "SkBoundsKernel.h"
+#include "SkMatrixKernel.h"
+#include "SkTessellateKernel.h"
+#include "SkPathDataKernel.h"
+#include "SkMorphKernel.h"
+#include "SkRegionKernel.h"
+#include "SkNinePatchKernel.h"
+#include "SkPngChunkKernel.h"
+#include "SkNinePatchCacheKernel.h"
+#include "SkResampleKernel.h"
+#include "SkPixelPoolKernel.h"
+#include "SkLooperKernel.h"
+#include "SkFrameClockKernel.h"
+#include "SkAnimatorKernel.h"
+#include "SkPathSamplerKernel.h"
+#include "SkCommandArenaKernel.h"
+#include "SkRTreeKernel.h"
+#include "SkDrawBatchKernel.h"
+#include "SkVelocityKernel.h"
+
 /*
 
 -Xclang -ast-print
@@ -0,0 +1,238 @@
+#include "SkAnimatorKernel.h"
+#include "SkNxKernel.h"
+
+using kernel::Sk8f;
+
+namespace {
+
+    constexpr float kPi = 3.14159265358979323846f;
+
+    // sin(pi * x), x is reduced to [-0.5, 0.5] where the taylor series to x^11 is
+    // accurate to a few ulp of a float
+    Sk8f sinpi(const Sk8f& x) {
+        Sk8f r = x - Sk8f(2) * ((x + Sk8f(1)) * Sk8f(0.5f)).floor();
+        r = (r > Sk8f(0.5f)).thenElse(Sk8f(1) - r, r);
+        r = (r < Sk8f(-0.5f)).thenElse(Sk8f(-1) - r, r);
+        Sk8f y = r * Sk8f(kPi);
+        Sk8f y2 = y * y;
+        Sk8f p = Sk8f(-1.0f / 39916800);
+        p = p * y2 + Sk8f(1.0f / 362880);
+        p = p * y2 + Sk8f(-1.0f / 5040);
+        p = p * y2 + Sk8f(1.0f / 120);
+        p = p * y2 + Sk8f(-1.0f / 6);
+        p = p * y2 + Sk8f(1);
+        return y * p;
+    }
+
+    Sk8f bounce(const Sk8f& t) {
+        return t * t * Sk8f(8);
+    }
+
+    // the factor of AccelerateInterpolator and DecelerateInterpolator is almost always 1,
+    // their exponent is 2 and the curve is a product, any other exponent needs a pow which
+    // is taken one lane at a time, in double like the managed interpolators
+    float powLane(int kind, float t, float p) {
+        if (kind == SkKernel_AnimatorInterpolator_Accelerate) {
+            return (float)std::pow((double)t, (double)p);
+        }
+        return (float)(1.0 - std::pow((double)(1.0f - t), (double)p));
+    }
+
+    Sk8f interpolate(int kind, const Sk8f& t, const Sk8f& p) {
+        switch (kind) {
+            case SkKernel_AnimatorInterpolator_AccelerateDecelerate:
+                // cos((t + 1) * pi) / 2 + 0.5
+                return Sk8f(0.5f) - sinpi(t + Sk8f(0.5f)) * Sk8f(0.5f);
+            case SkKernel_AnimatorInterpolator_Accelerate:
+                return t * t;
+            case SkKernel_AnimatorInterpolator_Decelerate:
+                return Sk8f(1) - (Sk8f(1) - t) * (Sk8f(1) - t);
+            case SkKernel_AnimatorInterpolator_Anticipate:
+                return t * t * ((p + Sk8f(1)) * t - p);
+            case SkKernel_AnimatorInterpolator_Overshoot: {
+                Sk8f s = t - Sk8f(1);
+                return s * s * ((p + Sk8f(1)) * s + p) + Sk8f(1);
+            }
+            case SkKernel_AnimatorInterpolator_AnticipateOvershoot: {
+                Sk8f a = t * Sk8f(2);
+                Sk8f o = t * Sk8f(2) - Sk8f(2);
+                Sk8f first = Sk8f(0.5f) * (a * a * ((p + Sk8f(1)) * a - p));
+                Sk8f second = Sk8f(0.5f) * (o * o * ((p + Sk8f(1)) * o + p) + Sk8f(2));
+                return (t < Sk8f(0.5f)).thenElse(first, second);
+            }
+            case SkKernel_AnimatorInterpolator_Bounce: {
+                Sk8f s = t * Sk8f(1.1226f);
+                Sk8f r = bounce(s - Sk8f(1.0435f)) + Sk8f(0.95f);
+                r = (s < Sk8f(0.9644f)).thenElse(bounce(s - Sk8f(0.8526f)) + Sk8f(0.9f), r);
+                r = (s < Sk8f(0.7408f)).thenElse(bounce(s - Sk8f(0.54719f)) + Sk8f(0.7f), r);
+                return (s < Sk8f(0.3535f)).thenElse(bounce(s), r);
+            }
+            case SkKernel_AnimatorInterpolator_Cycle:
+                return sinpi(Sk8f(2) * p * t);
+            default:
+                return t;
+        }
+    }
+
+    // lanes of one interpolator kind waiting to fill a vector
+    struct Pending {
+        float input[8];
+        float param[8];
+        int index[8];
+        int count;
+    };
+
+    void flush(int kind, Pending& pending, float* output) {
+        const int n = pending.count;
+        // pad with copies of the first lane so the unused lanes stay finite
+        for (int k = n; k < 8; k++) {
+            pending.input[k] = pending.input[0];
+            pending.param[k] = pending.param[0];
+        }
+        float result[8];
+        Sk8f p = Sk8f::Load(pending.param);
+        bool product = true;
+        if (kind == SkKernel_AnimatorInterpolator_Accelerate || kind == SkKernel_AnimatorInterpolator_Decelerate) {
+            product = (p == Sk8f(2)).allTrue();
+        }
+        if (product) {
+            interpolate(kind, Sk8f::Load(pending.input), p).store(result);
+        } else {
+            for (int k = 0; k < n; k++) {
+                result[k] = pending.param[k] == 2
+                    ? interpolate(kind, Sk8f(pending.input[k]), Sk8f(2))[0]
+                    : powLane(kind, pending.input[k], pending.param[k]);
+            }
+        }
+        for (int k = 0; k < n; k++) {
+            output[pending.index[k]] = result[k];
+        }
+        pending.count = 0;
+    }
+}
+
+extern "C" SK_API void SkKernel_animatorInterpolate(const int* kind, const float* param, const float* input, float* output, int count) {
+    Pending pending[SkKernel_AnimatorInterpolator_Count];
+    for (int k = 0; k < SkKernel_AnimatorInterpolator_Count; k++) {
+        pending[k].count = 0;
+    }
+    for (int i = 0; i < count; i++) {
+        const int k = kind[i];
+        if (k <= SkKernel_AnimatorInterpolator_Linear || k >= SkKernel_AnimatorInterpolator_Count) {
+            output[i] = input[i];
+            continue;
+        }
+        Pending& lanes = pending[k];
+        lanes.input[lanes.count] = input[i];
+        lanes.param[lanes.count] = param[i];
+        lanes.index[lanes.count] = i;
+        if (++lanes.count == 8) {
+            flush(k, lanes, output);
+        }
+    }
+    for (int k = 0; k < SkKernel_AnimatorInterpolator_Count; k++) {
+        if (pending[k].count > 0) {
+            flush(k, pending[k], output);
+        }
+    }
+}
+
+extern "C" SK_API void SkKernel_animatorLerp(const float* fraction, const int* lane, const float* from, const float* to, float* value, int count) {
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        Sk8f f(fraction[lane[i]], fraction[lane[i + 1]], fraction[lane[i + 2]], fraction[lane[i + 3]],
+               fraction[lane[i + 4]], fraction[lane[i + 5]], fraction[lane[i + 6]], fraction[lane[i + 7]]);
+        Sk8f a = Sk8f::Load(from + i);
+        (a + f * (Sk8f::Load(to + i) - a)).store(value + i);
+    }
+    for (; i < count; i++) {
+        value[i] = from[i] + fraction[lane[i]] * (to[i] - from[i]);
+    }
+}
+
+namespace {
+
+    // the component steps of ArgbEvaluator, kept in the same precision so both round alike
+    float channel(int color, int shift) {
+        return ((color >> shift) & 0xff) / 255.0f;
+    }
+
+    float toLinear(float c) {
+        return (float)std::pow((double)c, 2.2);
+    }
+
+    // Math.Round then an int cast, a value with no int, as a blend overshooting into
+    // negative light gives, converts to INT32_MIN like cvttsd2si
+    uint32_t roundToInt(float c) {
+        const double r = std::nearbyint((double)c);
+        if (!(r >= -2147483648.0 && r < 2147483648.0)) {
+            return 0x80000000u;
+        }
+        return (uint32_t)(int32_t)r;
+    }
+
+    uint32_t toSrgb(float c) {
+        return roundToInt((float)std::pow((double)c, 1.0 / 2.2) * 255.0f);
+    }
+}
+
+extern "C" SK_API void SkKernel_animatorArgb(const float* fraction, const int* lane, const int* from, const int* to, int* value, int count) {
+    for (int i = 0; i < count; i++) {
+        const float f = fraction[lane[i]];
+        const int s = from[i], e = to[i];
+        float a = channel(s, 24), ea = channel(e, 24);
+        float r = toLinear(channel(s, 16)), er = toLinear(channel(e, 16));
+        float g = toLinear(channel(s, 8)), eg = toLinear(channel(e, 8));
+        float b = toLinear(channel(s, 0)), eb = toLinear(channel(e, 0));
+        a = a + f * (ea - a);
+        r = r + f * (er - r);
+        g = g + f * (eg - g);
+        b = b + f * (eb - b);
+        value[i] = (int)(roundToInt(a * 255.0f) << 24 | toSrgb(r) << 16 | toSrgb(g) << 8 | toSrgb(b));
+    }
+}
+
+namespace {
+
+    float lookup(const float* table, int last, float t) {
+        if (t <= 0) {
+            return 0;
+        }
+        if (t >= 1) {
+            return 1;
+        }
+        if (t != t) {
+            return t;
+        }
+        const float position = t * last;
+        const int index = std::min((int)position, last - 1);
+        const float fraction = position - index;
+        return table[index] + fraction * (table[index + 1] - table[index]);
+    }
+}
+
+extern "C" SK_API void SkKernel_interpolatorLookup(const float* table, int size, const float* input, float* output, int count) {
+    const int last = size - 1;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        Sk8f t = Sk8f::Load(input + i);
+        // clamping first keeps NaN and the ends inside the table, they are selected back below
+        Sk8f position = Sk8f::Min(Sk8f::Max(t, Sk8f(0)), Sk8f(1)) * Sk8f((float)last);
+        float p[8], lo[8], hi[8];
+        position.store(p);
+        for (int k = 0; k < 8; k++) {
+            const int index = std::min((int)p[k], last - 1);
+            p[k] = (float)index;
+            lo[k] = table[index];
+            hi[k] = table[index + 1];
+        }
+        Sk8f a = Sk8f::Load(lo);
+        Sk8f r = a + (position - Sk8f::Load(p)) * (Sk8f::Load(hi) - a);
+        r = (t >= Sk8f(1)).thenElse(Sk8f(1), r);
+        r = (t <= Sk8f(0)).thenElse(Sk8f(0), r);
+        (t == t).thenElse(r, t).store(output + i);
+    }
+    for (; i < count; i++) {
+        output[i] = lookup(table, last, input[i]);
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+batched evaluation of running value animators
+
+each animator is one lane, a lane holds the elapsed fraction of the current iteration, the
+kind of built in interpolator the animator uses and that interpolator's parameter
+
+lanes may mix interpolator kinds freely, the lanes of each kind are packed into vectors of
+8 as they are met so every interpolator is evaluated 8 lanes at a time in one pass over
+the lanes
+
+the values animated by a lane are channels, a channel names its lane and holds the start
+and end value of a two keyframe animation, float channels are blended with the lane's
+interpolated fraction, argb channels are blended in linear space like ArgbEvaluator
+
+*/
+
+/**
+ * interpolator kinds, the parameter of each kind is noted beside it
+ */
+enum SkKernel_AnimatorInterpolator {
+    SkKernel_AnimatorInterpolator_Linear = 0,
+    SkKernel_AnimatorInterpolator_AccelerateDecelerate = 1,
+    SkKernel_AnimatorInterpolator_Accelerate = 2,           // 2 * factor
+    SkKernel_AnimatorInterpolator_Decelerate = 3,           // 2 * factor
+    SkKernel_AnimatorInterpolator_Anticipate = 4,           // tension
+    SkKernel_AnimatorInterpolator_Overshoot = 5,            // tension
+    SkKernel_AnimatorInterpolator_AnticipateOvershoot = 6,  // tension * extra tension
+    SkKernel_AnimatorInterpolator_Bounce = 7,
+    SkKernel_AnimatorInterpolator_Cycle = 8,                // cycles
+    SkKernel_AnimatorInterpolator_Count = 9,
+};
+
+/**
+ * output[i] = the interpolation of input[i] by the interpolator kind[i] with param[i]
+ *
+ * a lane with an unknown kind is passed through unchanged, output may alias input
+ */
+extern "C" SK_API void SkKernel_animatorInterpolate(const int* kind, const float* param, const float* input, float* output, int count);
+
+/**
+ * value[i] = from[i] + fraction[lane[i]] * (to[i] - from[i]) for count channels
+ */
+extern "C" SK_API void SkKernel_animatorLerp(const float* fraction, const int* lane, const float* from, const float* to, float* value, int count);
+
+/**
+ * value[i] = the argb color fraction[lane[i]] of the way from from[i] to to[i] for count
+ * channels, blended in linear space and rounded exactly as ArgbEvaluator does
+ */
+extern "C" SK_API void SkKernel_animatorArgb(const float* fraction, const int* lane, const int* from, const int* to, int* value, int count);
+
+/**
+ * output[i] = table sampled at input[i], table holds size values of y at evenly spaced x
+ * from 0 to 1 inclusive and is blended linearly between samples
+ *
+ * input at or below 0 gives 0, at or above 1 gives 1 and NaN gives NaN, like
+ * PathInterpolator, size must be at least 2, output may alias input
+ */
+extern "C" SK_API void SkKernel_interpolatorLookup(const float* table, int size, const float* input, float* output, int count);
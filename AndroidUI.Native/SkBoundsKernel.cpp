@@ -0,0 +1,87 @@
+#include "SkBoundsKernel.h"
+#include "SkNxKernel.h"
+
+using kernel::Sk4f;
+using kernel::Sk8f;
+
+extern "C" SK_API bool SkKernel_computeBounds(const float* xy, int count, float* out) {
+    if (count <= 0 || xy == nullptr) {
+        out[0] = out[1] = out[2] = out[3] = 0;
+        return true;
+    }
+
+    // same approach as SkRect::setBoundsCheck, each vector holds (x, y) pairs,
+    // min/max are folded across the pairs at the end
+    //
+    // accum starts at zero and is multiplied by every coordinate,
+    // it stays zero unless a coordinate is infinite or NaN in which case it becomes NaN
+
+    Sk4f min, max;
+    if (count & 1) {
+        min = max = Sk4f(xy[0], xy[1], xy[0], xy[1]);
+        xy += 2;
+        count -= 1;
+    }
+    else {
+        min = max = Sk4f::Load(xy);
+        xy += 4;
+        count -= 2;
+    }
+    Sk4f accum = min * Sk4f(0);
+
+#if defined(KERNEL_AVX)
+    // 4 points per step
+    Sk8f min8(min, min), max8(max, max), accum8(accum, accum);
+    while (count >= 4) {
+        Sk8f v = Sk8f::Load(xy);
+        accum8 = accum8 * v;
+        min8 = Sk8f::Min(min8, v);
+        max8 = Sk8f::Max(max8, v);
+        xy += 8;
+        count -= 4;
+    }
+    min = Sk4f::Min(min8.lo(), min8.hi());
+    max = Sk4f::Max(max8.lo(), max8.hi());
+    accum = accum8.lo() * accum8.hi();
+#else
+    // unroll by two to keep two independent dependency chains in flight
+    Sk4f min1 = min, max1 = max, accum1 = accum;
+    while (count >= 4) {
+        Sk4f a = Sk4f::Load(xy);
+        Sk4f b = Sk4f::Load(xy + 4);
+        accum = accum * a;
+        accum1 = accum1 * b;
+        min = Sk4f::Min(min, a);
+        min1 = Sk4f::Min(min1, b);
+        max = Sk4f::Max(max, a);
+        max1 = Sk4f::Max(max1, b);
+        xy += 8;
+        count -= 4;
+    }
+    min = Sk4f::Min(min, min1);
+    max = Sk4f::Max(max, max1);
+    accum = accum * accum1;
+#endif
+
+    // count is even here, at most one pair remains
+    while (count != 0) {
+        Sk4f v = Sk4f::Load(xy);
+        accum = accum * v;
+        min = Sk4f::Min(min, v);
+        max = Sk4f::Max(max, v);
+        xy += 4;
+        count -= 2;
+    }
+
+    bool all_finite = (accum * Sk4f(0) == Sk4f(0)).allTrue();
+    if (all_finite) {
+        out[0] = std::min(min[0], min[2]);
+        out[1] = std::min(min[1], min[3]);
+        out[2] = std::max(max[0], max[2]);
+        out[3] = std::max(max[1], max[3]);
+    }
+    else {
+        out[0] = out[1] = out[2] = out[3] = 0;
+    }
+    return all_finite;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+bulk point kernels, these operate on whole arrays per call so the managed side pays
+for a single P/Invoke instead of one per Sk4f operation
+
+*/
+
+/**
+ * computes the bounds of count points stored as interleaved x, y pairs
+ *
+ * out receives left, top, right, bottom
+ *
+ * returns true if every coordinate is finite, otherwise out is set to (0, 0, 0, 0)
+ * and false is returned
+ *
+ * a count of zero or less sets out to (0, 0, 0, 0) and returns true
+ */
+extern "C" SK_API bool SkKernel_computeBounds(const float* xy, int count, float* out);
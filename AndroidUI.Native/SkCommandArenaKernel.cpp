@@ -0,0 +1,61 @@
+#include "SkCommandArenaKernel.h"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+    struct Arena {
+        std::vector<int32_t> words;
+        int count = 0;
+    };
+}
+
+extern "C" SK_API void* SkKernel_commandArenaCreate() {
+    return new Arena();
+}
+
+extern "C" SK_API void SkKernel_commandArenaDestroy(void* arena) {
+    delete (Arena*)arena;
+}
+
+extern "C" SK_API void SkKernel_commandArenaReset(void* arena) {
+    Arena* a = (Arena*)arena;
+    a->words.clear();
+    a->count = 0;
+}
+
+extern "C" SK_API void SkKernel_commandArenaAppend(void* arena, int command, const int32_t* payload, int words) {
+    Arena* a = (Arena*)arena;
+    const size_t at = a->words.size();
+    a->words.resize(at + SK_KERNEL_COMMAND_ARENA_HEADER_WORDS + (size_t)words);
+    int32_t* record = a->words.data() + at;
+    record[0] = command;
+    record[1] = words;
+    if (words > 0) {
+        memcpy(record + SK_KERNEL_COMMAND_ARENA_HEADER_WORDS, payload, (size_t)words * sizeof(int32_t));
+    }
+    a->count++;
+}
+
+extern "C" SK_API void* SkKernel_commandArenaCopy(const void* arena) {
+    const Arena* a = (const Arena*)arena;
+    Arena* copy = new Arena();
+    // a vector copy allocates only what the source uses
+    copy->words = a->words;
+    copy->count = a->count;
+    return copy;
+}
+
+extern "C" SK_API const int32_t* SkKernel_commandArenaData(const void* arena) {
+    const Arena* a = (const Arena*)arena;
+    return a->words.empty() ? nullptr : a->words.data();
+}
+
+extern "C" SK_API int SkKernel_commandArenaSize(const void* arena) {
+    return (int)(((const Arena*)arena)->words.size() * sizeof(int32_t));
+}
+
+extern "C" SK_API int SkKernel_commandArenaCount(const void* arena) {
+    return ((const Arena*)arena)->count;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+flat storage for recorded canvas commands
+
+an arena holds records back to back in one block of 4 byte words, a record is a header of
+two words, the command and the number of payload words, followed by its payload, a fixed
+layout struct the recorder defines per command
+
+the arena never interprets a payload, the recorder writes it and playback reads it in place
+through the data pointer, which stays valid until the next append, reset or destroy
+
+an arena is not thread safe
+
+*/
+
+#define SK_KERNEL_COMMAND_ARENA_HEADER_WORDS 2
+
+extern "C" SK_API void* SkKernel_commandArenaCreate();
+
+extern "C" SK_API void SkKernel_commandArenaDestroy(void* arena);
+
+/**
+ * removes every record, keeping the memory for the next recording
+ */
+extern "C" SK_API void SkKernel_commandArenaReset(void* arena);
+
+/**
+ * appends a record of command followed by words payload words
+ */
+extern "C" SK_API void SkKernel_commandArenaAppend(void* arena, int command, const int32_t* payload, int words);
+
+/**
+ * returns a new arena holding a copy of every record, sized to fit them exactly
+ */
+extern "C" SK_API void* SkKernel_commandArenaCopy(const void* arena);
+
+/**
+ * the first record, null when the arena is empty
+ */
+extern "C" SK_API const int32_t* SkKernel_commandArenaData(const void* arena);
+
+/**
+ * the size of every record in bytes
+ */
+extern "C" SK_API int SkKernel_commandArenaSize(const void* arena);
+
+/**
+ * the number of records
+ */
+extern "C" SK_API int SkKernel_commandArenaCount(const void* arena);
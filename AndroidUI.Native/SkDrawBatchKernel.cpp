@@ -0,0 +1,64 @@
+#include "SkDrawBatchKernel.h"
+
+#include <vector>
+
+namespace {
+
+    struct Batch {
+        int key;
+        float l, t, r, b;
+        int head;
+        int tail;
+    };
+
+    // SkRect::Intersects
+    bool intersects(const Batch& batch, const float* rect) {
+        const float L = batch.l > rect[0] ? batch.l : rect[0];
+        const float T = batch.t > rect[1] ? batch.t : rect[1];
+        const float R = batch.r < rect[2] ? batch.r : rect[2];
+        const float B = batch.b < rect[3] ? batch.b : rect[3];
+        return L < R && T < B;
+    }
+}
+
+extern "C" SK_API int SkKernel_drawBatchOrder(const float* bounds, const int* keys, int count, int* order) {
+    if (count <= 0) {
+        return 0;
+    }
+    std::vector<Batch> batches;
+    // the draw after each draw in its batch, -1 for the last
+    std::vector<int> next((size_t)count, -1);
+    for (int i = 0; i < count; i++) {
+        const float* rect = bounds + i * 4;
+        int target = -1;
+        const int last = (int)batches.size() - 1;
+        const int first = last - SK_KERNEL_DRAW_BATCH_LOOKBACK + 1 > 0 ? last - SK_KERNEL_DRAW_BATCH_LOOKBACK + 1 : 0;
+        for (int k = last; k >= first; k--) {
+            if (batches[k].key == keys[i]) {
+                target = k;
+                break;
+            }
+            if (intersects(batches[k], rect)) {
+                break;
+            }
+        }
+        if (target < 0) {
+            batches.push_back({ keys[i], rect[0], rect[1], rect[2], rect[3], i, i });
+            continue;
+        }
+        Batch& batch = batches[target];
+        next[batch.tail] = i;
+        batch.tail = i;
+        batch.l = rect[0] < batch.l ? rect[0] : batch.l;
+        batch.t = rect[1] < batch.t ? rect[1] : batch.t;
+        batch.r = rect[2] > batch.r ? rect[2] : batch.r;
+        batch.b = rect[3] > batch.b ? rect[3] : batch.b;
+    }
+    int n = 0;
+    for (const Batch& batch : batches) {
+        for (int i = batch.head; i >= 0; i = next[i]) {
+            order[n++] = i;
+        }
+    }
+    return (int)batches.size();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+reorders a run of draws so draws sharing a key sit next to each other, without changing
+what the run draws
+
+the draws of a run share their canvas state and carry device bounds covering every pixel
+they may touch, a draw may only move ahead of draws whose bounds it does not intersect, so
+the order of any two draws that could touch the same pixel is kept
+
+each draw is added to the latest batch of its key, unless a later batch intersects it, else
+it starts a new batch, the run is then drawn batch by batch, like the op reordering of hwui
+
+a draw looks back at most SK_KERNEL_DRAW_BATCH_LOOKBACK batches, keeping the pass linear
+
+*/
+
+#define SK_KERNEL_DRAW_BATCH_LOOKBACK 64
+
+/**
+ * writes the new order of count draws to order, as indices into bounds and keys, bounds
+ * holds 4 floats per draw, left, top, right, bottom
+ *
+ * returns the number of batches
+ */
+extern "C" SK_API int SkKernel_drawBatchOrder(const float* bounds, const int* keys, int count, int* order);
@@ -0,0 +1,221 @@
+#include "SkFrameClockKernel.h"
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#if defined(SK_BUILD_FOR_WIN)
+// windows.h comes from SkTypes.h
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#elif defined(__linux__)
+#define FRAME_CLOCK_TIMERFD 1
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    constexpr int64_t NANOS_PER_SECOND = 1000000000;
+
+    struct FrameClock {
+        std::mutex mutex;
+        int64_t origin = 0;
+        int64_t period = 0;
+        // the last frame taken, 0 before the first one
+        int64_t last = 0;
+        bool woken = false;
+#if defined(SK_BUILD_FOR_WIN)
+        HANDLE timer = nullptr;
+        HANDLE wake = nullptr;
+#elif defined(FRAME_CLOCK_TIMERFD)
+        int timer = -1;
+        int wake = -1;
+#else
+        std::condition_variable condition;
+#endif
+
+        ~FrameClock() {
+#if defined(SK_BUILD_FOR_WIN)
+            if (timer != nullptr) {
+                CloseHandle(timer);
+            }
+            if (wake != nullptr) {
+                CloseHandle(wake);
+            }
+#elif defined(FRAME_CLOCK_TIMERFD)
+            if (timer >= 0) {
+                close(timer);
+            }
+            if (wake >= 0) {
+                close(wake);
+            }
+#endif
+        }
+
+        // the latest deadline at or before now, never earlier than the last frame taken
+        int64_t latest_locked(int64_t now) {
+            int64_t frame = origin + (now - origin) / period * period;
+            if (frame > last) {
+                last = frame;
+            }
+            return last;
+        }
+    };
+
+    int64_t clamp_period(int64_t periodNanos) {
+        // at most 1000 frames a second, a period of 0 would never advance
+        return periodNanos < NANOS_PER_SECOND / 1000 ? NANOS_PER_SECOND / 1000 : periodNanos;
+    }
+}
+
+extern "C" SK_API int64_t SkKernel_frameClockNow() {
+#if defined(SK_BUILD_FOR_WIN)
+    static const int64_t frequency = [] {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        return (int64_t)f.QuadPart;
+    }();
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    int64_t ticks = counter.QuadPart;
+    // split to avoid overflowing ticks * NANOS_PER_SECOND
+    return ticks / frequency * NANOS_PER_SECOND + ticks % frequency * NANOS_PER_SECOND / frequency;
+#elif defined(FRAME_CLOCK_TIMERFD)
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec * NANOS_PER_SECOND + t.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+extern "C" SK_API void* SkKernel_frameClockCreate(int64_t periodNanos) {
+    FrameClock* clock = new FrameClock();
+    clock->origin = SkKernel_frameClockNow();
+    clock->period = clamp_period(periodNanos);
+#if defined(SK_BUILD_FOR_WIN)
+    clock->timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (clock->timer == nullptr) {
+        // before windows 10 1803, waits are rounded to the system timer resolution
+        clock->timer = CreateWaitableTimerW(nullptr, FALSE, nullptr);
+    }
+    clock->wake = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (clock->timer == nullptr || clock->wake == nullptr) {
+        delete clock;
+        return nullptr;
+    }
+#elif defined(FRAME_CLOCK_TIMERFD)
+    clock->timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    clock->wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (clock->timer < 0 || clock->wake < 0) {
+        delete clock;
+        return nullptr;
+    }
+#endif
+    return clock;
+}
+
+extern "C" SK_API void SkKernel_frameClockDestroy(void* clock) {
+    delete static_cast<FrameClock*>(clock);
+}
+
+extern "C" SK_API void SkKernel_frameClockSetPeriod(void* clock, int64_t periodNanos) {
+    FrameClock* c = static_cast<FrameClock*>(clock);
+    std::lock_guard<std::mutex> lock(c->mutex);
+    if (c->last != 0) {
+        c->origin = c->last;
+    }
+    c->period = clamp_period(periodNanos);
+}
+
+extern "C" SK_API int64_t SkKernel_frameClockGetPeriod(void* clock) {
+    FrameClock* c = static_cast<FrameClock*>(clock);
+    std::lock_guard<std::mutex> lock(c->mutex);
+    return c->period;
+}
+
+extern "C" SK_API int64_t SkKernel_frameClockLatest(void* clock) {
+    FrameClock* c = static_cast<FrameClock*>(clock);
+    std::lock_guard<std::mutex> lock(c->mutex);
+    return c->latest_locked(SkKernel_frameClockNow());
+}
+
+extern "C" SK_API int64_t SkKernel_frameClockWait(void* clock) {
+    FrameClock* c = static_cast<FrameClock*>(clock);
+    int64_t deadline = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(c->mutex);
+            if (c->woken) {
+                c->woken = false;
+                return 0;
+            }
+            int64_t now = SkKernel_frameClockNow();
+            if (deadline == 0) {
+                int64_t passed = c->origin + (now - c->origin) / c->period * c->period;
+                deadline = c->last == 0 ? passed + c->period : c->last + c->period;
+            }
+            if (deadline <= now) {
+                return c->latest_locked(now);
+            }
+#if !defined(SK_BUILD_FOR_WIN) && !defined(FRAME_CLOCK_TIMERFD)
+            auto until = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deadline));
+            c->condition.wait_until(lock, until, [c] { return c->woken; });
+            continue;
+#endif
+        }
+
+        // a stale wake or a timer that fires early goes around again
+#if defined(SK_BUILD_FOR_WIN)
+        // relative, in 100 nanosecond units
+        LARGE_INTEGER due;
+        due.QuadPart = -((deadline - SkKernel_frameClockNow()) / 100);
+        if (due.QuadPart < 0) {
+            SetWaitableTimer(c->timer, &due, 0, nullptr, nullptr, FALSE);
+            HANDLE handles[2] = { c->wake, c->timer };
+            WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+        }
+#elif defined(FRAME_CLOCK_TIMERFD)
+        itimerspec spec = {};
+        spec.it_value.tv_sec = deadline / NANOS_PER_SECOND;
+        spec.it_value.tv_nsec = deadline % NANOS_PER_SECOND;
+        timerfd_settime(c->timer, TFD_TIMER_ABSTIME, &spec, nullptr);
+        pollfd fds[2] = { { c->wake, POLLIN, 0 }, { c->timer, POLLIN, 0 } };
+        if (poll(fds, 2, -1) > 0) {
+            uint64_t count;
+            if (fds[0].revents & POLLIN) {
+                while (read(c->wake, &count, sizeof(count)) < 0 && errno == EINTR) {
+                }
+            }
+            if (fds[1].revents & POLLIN) {
+                while (read(c->timer, &count, sizeof(count)) < 0 && errno == EINTR) {
+                }
+            }
+        }
+#endif
+    }
+}
+
+extern "C" SK_API void SkKernel_frameClockWake(void* clock) {
+    FrameClock* c = static_cast<FrameClock*>(clock);
+    {
+        std::lock_guard<std::mutex> lock(c->mutex);
+        c->woken = true;
+    }
+#if defined(SK_BUILD_FOR_WIN)
+    SetEvent(c->wake);
+#elif defined(FRAME_CLOCK_TIMERFD)
+    uint64_t one = 1;
+    while (write(c->wake, &one, sizeof(one)) < 0 && errno == EINTR) {
+    }
+#else
+    c->condition.notify_all();
+#endif
+}
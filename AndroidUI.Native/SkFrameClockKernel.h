@@ -0,0 +1,59 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+a vsync source for hosts that do not have one
+
+frames are phase locked to deadlines origin + k * period on the monotonic clock, a frame
+time is always one of these deadlines, never the moment a thread happened to wake, so
+frame times are evenly spaced however late the waiting thread is scheduled, a frame taken
+late skips the deadlines it missed
+
+on linux a wait sleeps on a timerfd armed with an absolute deadline and is woken through
+an eventfd, on windows it sleeps on a high resolution waitable timer when the system has
+them and is woken through an event, other systems wait on a condition variable
+
+all times are in nanoseconds of the monotonic clock, see SkKernel_frameClockNow
+
+*/
+
+/**
+ * returns a clock ticking every periodNanos starting now, or null if its timer cannot
+ * be created
+ */
+extern "C" SK_API void* SkKernel_frameClockCreate(int64_t periodNanos);
+
+extern "C" SK_API void SkKernel_frameClockDestroy(void* clock);
+
+/**
+ * the monotonic clock frame times are measured on
+ */
+extern "C" SK_API int64_t SkKernel_frameClockNow();
+
+/**
+ * changes the period, deadlines stay phase locked to the last frame taken
+ */
+extern "C" SK_API void SkKernel_frameClockSetPeriod(void* clock, int64_t periodNanos);
+
+extern "C" SK_API int64_t SkKernel_frameClockGetPeriod(void* clock);
+
+/**
+ * takes the latest deadline that has passed without waiting, taking it again within the
+ * same period returns the same frame time
+ */
+extern "C" SK_API int64_t SkKernel_frameClockLatest(void* clock);
+
+/**
+ * sleeps until the deadline after the previous frame and takes it, if that deadline
+ * has already passed this does not sleep and behaves like latest
+ *
+ * returns 0 without taking a frame when woken
+ */
+extern "C" SK_API int64_t SkKernel_frameClockWait(void* clock);
+
+/**
+ * wakes a wait in progress, or the next one if none is, may be called from any thread
+ */
+extern "C" SK_API void SkKernel_frameClockWake(void* clock);
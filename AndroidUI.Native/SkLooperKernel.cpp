@@ -0,0 +1,338 @@
+#include "SkLooperKernel.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#if defined(SK_BUILD_FOR_WIN)
+// windows.h comes from SkTypes.h
+#elif defined(__linux__)
+#define LOOPER_EPOLL 1
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    constexpr int MAX_EVENTS = 16;
+
+    struct Looper {
+        std::atomic<bool> polling{ false };
+        std::mutex mutex;
+        // the events watched on each descriptor
+        std::unordered_map<int, int> watched;
+#if defined(SK_BUILD_FOR_WIN)
+        HANDLE wake = nullptr;
+#elif defined(LOOPER_EPOLL)
+        int epoll = -1;
+        int wake = -1;
+#else
+        int wakeRead = -1;
+        int wakeWrite = -1;
+#endif
+
+        ~Looper() {
+#if defined(SK_BUILD_FOR_WIN)
+            if (wake != nullptr) {
+                CloseHandle(wake);
+            }
+#elif defined(LOOPER_EPOLL)
+            if (epoll >= 0) {
+                close(epoll);
+            }
+            if (wake >= 0) {
+                close(wake);
+            }
+#else
+            if (wakeRead >= 0) {
+                close(wakeRead);
+            }
+            if (wakeWrite >= 0) {
+                close(wakeWrite);
+            }
+#endif
+        }
+    };
+
+#if defined(LOOPER_EPOLL)
+    uint32_t to_epoll(int events) {
+        uint32_t e = 0;
+        if (events & SK_KERNEL_LOOPER_EVENT_INPUT) {
+            e |= EPOLLIN;
+        }
+        if (events & SK_KERNEL_LOOPER_EVENT_OUTPUT) {
+            e |= EPOLLOUT;
+        }
+        return e;
+    }
+
+    int from_epoll(uint32_t e) {
+        int events = 0;
+        if (e & EPOLLIN) {
+            events |= SK_KERNEL_LOOPER_EVENT_INPUT;
+        }
+        if (e & EPOLLOUT) {
+            events |= SK_KERNEL_LOOPER_EVENT_OUTPUT;
+        }
+        // a hang up is reported as an error, like android's MessageQueue does
+        if (e & (EPOLLERR | EPOLLHUP)) {
+            events |= SK_KERNEL_LOOPER_EVENT_ERROR;
+        }
+        return events;
+    }
+#elif !defined(SK_BUILD_FOR_WIN)
+    bool set_flags(int fd) {
+        return fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) == 0
+            && fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+    }
+#endif
+}
+
+extern "C" SK_API void* SkKernel_looperCreate() {
+    Looper* looper = new Looper();
+#if defined(SK_BUILD_FOR_WIN)
+    // auto reset, a wait consumes the wake
+    looper->wake = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (looper->wake == nullptr) {
+        delete looper;
+        return nullptr;
+    }
+#elif defined(LOOPER_EPOLL)
+    looper->wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    looper->epoll = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = looper->wake;
+    if (looper->wake < 0 || looper->epoll < 0
+        || epoll_ctl(looper->epoll, EPOLL_CTL_ADD, looper->wake, &ev) != 0) {
+        delete looper;
+        return nullptr;
+    }
+#else
+    int fds[2];
+    if (pipe(fds) != 0) {
+        delete looper;
+        return nullptr;
+    }
+    looper->wakeRead = fds[0];
+    looper->wakeWrite = fds[1];
+    if (!set_flags(fds[0]) || !set_flags(fds[1])) {
+        delete looper;
+        return nullptr;
+    }
+#endif
+    return looper;
+}
+
+extern "C" SK_API void SkKernel_looperDestroy(void* looper) {
+    delete static_cast<Looper*>(looper);
+}
+
+extern "C" SK_API void SkKernel_looperWake(void* looper) {
+    Looper* l = static_cast<Looper*>(looper);
+#if defined(SK_BUILD_FOR_WIN)
+    SetEvent(l->wake);
+#elif defined(LOOPER_EPOLL)
+    uint64_t one = 1;
+    // EAGAIN means the counter is already non zero, the looper will wake either way
+    while (write(l->wake, &one, sizeof(one)) < 0 && errno == EINTR) {
+    }
+#else
+    char one = 1;
+    // EAGAIN means the pipe is full, the looper will wake either way
+    while (write(l->wakeWrite, &one, 1) < 0 && errno == EINTR) {
+    }
+#endif
+}
+
+extern "C" SK_API bool SkKernel_looperIsPolling(void* looper) {
+    return static_cast<Looper*>(looper)->polling.load(std::memory_order_relaxed);
+}
+
+extern "C" SK_API bool SkKernel_looperSetFileDescriptorEvents(void* looper, int fd, int events) {
+    Looper* l = static_cast<Looper*>(looper);
+    events &= SK_KERNEL_LOOPER_EVENT_INPUT | SK_KERNEL_LOOPER_EVENT_OUTPUT | SK_KERNEL_LOOPER_EVENT_ERROR;
+    {
+        std::lock_guard<std::mutex> lock(l->mutex);
+        auto it = l->watched.find(fd);
+        if (it != l->watched.end() && it->second == events) {
+            return true;
+        }
+#if defined(LOOPER_EPOLL)
+        // epoll_wait picks up changes made while it waits, nothing needs waking
+        if (events == 0) {
+            if (it != l->watched.end()) {
+                l->watched.erase(it);
+                // the descriptor may already be closed, which removed it
+                epoll_ctl(l->epoll, EPOLL_CTL_DEL, fd, nullptr);
+            }
+            return true;
+        }
+        epoll_event ev = {};
+        ev.events = to_epoll(events);
+        ev.data.fd = fd;
+        int op = it == l->watched.end() ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+        if (epoll_ctl(l->epoll, op, fd, &ev) != 0) {
+            // the descriptor was closed and reused since it was added
+            if (op != EPOLL_CTL_MOD || errno != ENOENT
+                || epoll_ctl(l->epoll, EPOLL_CTL_ADD, fd, &ev) != 0) {
+                return false;
+            }
+        }
+        l->watched[fd] = events;
+        return true;
+#else
+        if (events == 0) {
+            if (it == l->watched.end()) {
+                return true;
+            }
+            l->watched.erase(it);
+        } else {
+            l->watched[fd] = events;
+        }
+#endif
+    }
+#if !defined(LOOPER_EPOLL)
+    // a wait in progress waits on the old set, it starts over with the new one
+    SkKernel_looperWake(looper);
+    return true;
+#endif
+}
+
+extern "C" SK_API int SkKernel_looperPollOnce(void* looper, int timeoutMillis, int* fds, int* events, int capacity) {
+    Looper* l = static_cast<Looper*>(looper);
+    int count = 0;
+#if defined(SK_BUILD_FOR_WIN)
+    HANDLE handles[MAXIMUM_WAIT_OBJECTS];
+    int handleFds[MAXIMUM_WAIT_OBJECTS];
+    DWORD handleCount = 1;
+    handles[0] = l->wake;
+    {
+        std::lock_guard<std::mutex> lock(l->mutex);
+        for (auto& w : l->watched) {
+            // handles are always writable
+            if ((w.second & SK_KERNEL_LOOPER_EVENT_OUTPUT) && count < capacity) {
+                fds[count] = w.first;
+                events[count] = SK_KERNEL_LOOPER_EVENT_OUTPUT;
+                count++;
+            }
+            if ((w.second & SK_KERNEL_LOOPER_EVENT_INPUT) && handleCount < MAXIMUM_WAIT_OBJECTS) {
+                handles[handleCount] = (HANDLE)(intptr_t)w.first;
+                handleFds[handleCount] = w.first;
+                handleCount++;
+            }
+        }
+    }
+    DWORD timeout = count != 0 ? 0 : timeoutMillis < 0 ? INFINITE : (DWORD)timeoutMillis;
+    l->polling.store(true, std::memory_order_relaxed);
+    DWORD result = WaitForMultipleObjects(handleCount, handles, FALSE, timeout);
+    l->polling.store(false, std::memory_order_relaxed);
+    if (result == WAIT_TIMEOUT || result == WAIT_OBJECT_0) {
+        return count;
+    }
+    // the signaled handle was consumed by the wait, check the ones after it as well
+    DWORD first = result >= WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + handleCount ? result - WAIT_OBJECT_0 : 1;
+    for (DWORD i = first; i < handleCount; i++) {
+        int e = 0;
+        if (i == first && result != WAIT_FAILED) {
+            e = SK_KERNEL_LOOPER_EVENT_INPUT;
+        } else {
+            DWORD r = WaitForSingleObject(handles[i], 0);
+            e = r == WAIT_OBJECT_0 ? SK_KERNEL_LOOPER_EVENT_INPUT
+                : r == WAIT_FAILED ? SK_KERNEL_LOOPER_EVENT_ERROR : 0;
+        }
+        if (e == 0) {
+            continue;
+        }
+        int k = 0;
+        while (k < count && fds[k] != handleFds[i]) {
+            k++;
+        }
+        if (k == count) {
+            if (count == capacity) {
+                break;
+            }
+            fds[count] = handleFds[i];
+            events[count] = 0;
+            count++;
+        }
+        events[k] |= e;
+    }
+    return count;
+#elif defined(LOOPER_EPOLL)
+    epoll_event ready[MAX_EVENTS];
+    l->polling.store(true, std::memory_order_relaxed);
+    int n = epoll_wait(l->epoll, ready, MAX_EVENTS, timeoutMillis);
+    l->polling.store(false, std::memory_order_relaxed);
+    if (n < 0) {
+        return errno == EINTR ? 0 : -1;
+    }
+    for (int i = 0; i < n; i++) {
+        int fd = ready[i].data.fd;
+        if (fd == l->wake) {
+            uint64_t counter;
+            while (read(l->wake, &counter, sizeof(counter)) < 0 && errno == EINTR) {
+            }
+        } else if (count < capacity) {
+            fds[count] = fd;
+            events[count] = from_epoll(ready[i].events);
+            count++;
+        }
+    }
+    return count;
+#else
+    std::vector<pollfd> polled;
+    polled.push_back({ l->wakeRead, POLLIN, 0 });
+    {
+        std::lock_guard<std::mutex> lock(l->mutex);
+        for (auto& w : l->watched) {
+            short e = 0;
+            if (w.second & SK_KERNEL_LOOPER_EVENT_INPUT) {
+                e |= POLLIN;
+            }
+            if (w.second & SK_KERNEL_LOOPER_EVENT_OUTPUT) {
+                e |= POLLOUT;
+            }
+            polled.push_back({ w.first, e, 0 });
+        }
+    }
+    l->polling.store(true, std::memory_order_relaxed);
+    int n = poll(polled.data(), (nfds_t)polled.size(), timeoutMillis);
+    l->polling.store(false, std::memory_order_relaxed);
+    if (n < 0) {
+        return errno == EINTR ? 0 : -1;
+    }
+    if (polled[0].revents & POLLIN) {
+        char drain[64];
+        while (read(l->wakeRead, drain, sizeof(drain)) > 0) {
+        }
+    }
+    for (size_t i = 1; i < polled.size() && count < capacity; i++) {
+        short r = polled[i].revents;
+        int e = 0;
+        if (r & POLLIN) {
+            e |= SK_KERNEL_LOOPER_EVENT_INPUT;
+        }
+        if (r & POLLOUT) {
+            e |= SK_KERNEL_LOOPER_EVENT_OUTPUT;
+        }
+        if (r & (POLLERR | POLLHUP | POLLNVAL)) {
+            e |= SK_KERNEL_LOOPER_EVENT_ERROR;
+        }
+        if (e != 0) {
+            fds[count] = polled[i].fd;
+            events[count] = e;
+            count++;
+        }
+    }
+    return count;
+#endif
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+the native half of a MessageQueue, modeled on android's Looper.cpp
+
+poll blocks until the looper is woken, a watched file descriptor becomes ready or the
+timeout expires, a timeout of -1 waits forever and 0 never blocks
+
+on linux the looper waits in epoll_wait and is woken through an eventfd, other posix
+systems use poll and a pipe, on windows the looper waits in WaitForMultipleObjects and is
+woken through an event
+
+file descriptor events use the OnFileDescriptorEventListener bits, watching is level
+triggered, a descriptor stays reported for as long as it is ready
+
+on windows a descriptor is a waitable HANDLE, it reports input while it is signaled and
+is always ready for output, at most MAXIMUM_WAIT_OBJECTS - 1 handles are waited on
+
+*/
+
+#define SK_KERNEL_LOOPER_EVENT_INPUT (1 << 0)
+#define SK_KERNEL_LOOPER_EVENT_OUTPUT (1 << 1)
+#define SK_KERNEL_LOOPER_EVENT_ERROR (1 << 2)
+
+/**
+ * returns null if the wake or poll descriptors cannot be created
+ */
+extern "C" SK_API void* SkKernel_looperCreate();
+
+extern "C" SK_API void SkKernel_looperDestroy(void* looper);
+
+/**
+ * waits for at most timeoutMillis, then writes up to capacity ready descriptors and their
+ * events to fds and events
+ *
+ * returns how many descriptors were written, 0 when the looper was woken or timed out,
+ * -1 if waiting failed
+ */
+extern "C" SK_API int SkKernel_looperPollOnce(void* looper, int timeoutMillis, int* fds, int* events, int capacity);
+
+/**
+ * wakes a poll in progress, or the next one if none is, may be called from any thread
+ */
+extern "C" SK_API void SkKernel_looperWake(void* looper);
+
+/**
+ * returns true while a thread is blocked in poll
+ */
+extern "C" SK_API bool SkKernel_looperIsPolling(void* looper);
+
+/**
+ * sets the events watched on fd, 0 stops watching it, may be called from any thread
+ *
+ * returns false if the descriptor cannot be watched
+ */
+extern "C" SK_API bool SkKernel_looperSetFileDescriptorEvents(void* looper, int fd, int events);
@@ -0,0 +1,286 @@
+#include "SkMatrixKernel.h"
+#include "SkNxKernel.h"
+
+using kernel::Sk4f;
+using kernel::Sk8f;
+
+enum {
+    kMScaleX, kMSkewX, kMTransX,
+    kMSkewY, kMScaleY, kMTransY,
+    kMPersp0, kMPersp1, kMPersp2
+};
+
+static int compute_type(const float* m) {
+    if (m[kMPersp0] != 0 || m[kMPersp1] != 0 || m[kMPersp2] != 1) {
+        // perspective implies everything else, same as SkMatrix
+        return SkKernel_MatrixType_Perspective | SkKernel_MatrixType_Affine
+            | SkKernel_MatrixType_Scale | SkKernel_MatrixType_Translate;
+    }
+
+    int mask = 0;
+    if (m[kMTransX] != 0 || m[kMTransY] != 0) {
+        mask |= SkKernel_MatrixType_Translate;
+    }
+    if (m[kMSkewX] != 0 || m[kMSkewY] != 0) {
+        // an affine matrix is always treated as scaling too
+        mask |= SkKernel_MatrixType_Affine | SkKernel_MatrixType_Scale;
+    }
+    else if (m[kMScaleX] != 1 || m[kMScaleY] != 1) {
+        mask |= SkKernel_MatrixType_Scale;
+    }
+    return mask;
+}
+
+extern "C" SK_API int SkKernel_matrixGetType(const float* matrix) {
+    return compute_type(matrix);
+}
+
+static inline void map_perspective_xy(const float* m, float sx, float sy, float* ox, float* oy) {
+    float x = m[kMScaleX] * sx + m[kMSkewX] * sy + m[kMTransX];
+    float y = m[kMSkewY] * sx + m[kMScaleY] * sy + m[kMTransY];
+    float z = m[kMPersp0] * sx + m[kMPersp1] * sy + m[kMPersp2];
+    if (z != 0) {
+        z = 1 / z;
+    }
+    *ox = x * z;
+    *oy = y * z;
+}
+
+// dst = src * scale + swapPairs(src) * skew + trans
+//
+// this covers identity, translate, scale+translate and affine,
+// the simpler types pass zero for skew and one for scale and the compiler
+// cannot fold those away, so each type gets its own instantiation below
+template <bool kHasScale, bool kHasSkew>
+static void map_pairs(const float* m, float* dst, const float* src, int count) {
+    Sk4f scale4(m[kMScaleX], m[kMScaleY], m[kMScaleX], m[kMScaleY]);
+    Sk4f skew4(m[kMSkewX], m[kMSkewY], m[kMSkewX], m[kMSkewY]);
+    Sk4f trans4(m[kMTransX], m[kMTransY], m[kMTransX], m[kMTransY]);
+
+#if defined(KERNEL_AVX)
+    Sk8f scale8(scale4, scale4), skew8(skew4, skew4), trans8(trans4, trans4);
+    while (count >= 4) {
+        Sk8f v = Sk8f::Load(src);
+        Sk8f r = trans8;
+        if (kHasScale) r = r + v * scale8; else r = r + v;
+        if (kHasSkew) r = r + v.swapPairs() * skew8;
+        r.store(dst);
+        src += 8;
+        dst += 8;
+        count -= 4;
+    }
+#endif
+    while (count >= 2) {
+        Sk4f v = Sk4f::Load(src);
+        Sk4f r = trans4;
+        if (kHasScale) r = r + v * scale4; else r = r + v;
+        if (kHasSkew) r = r + v.swapPairs() * skew4;
+        r.store(dst);
+        src += 4;
+        dst += 4;
+        count -= 2;
+    }
+    if (count) {
+        float x = src[0], y = src[1];
+        float sx = kHasScale ? m[kMScaleX] : 1, sy = kHasScale ? m[kMScaleY] : 1;
+        float kx = kHasSkew ? m[kMSkewX] : 0, ky = kHasSkew ? m[kMSkewY] : 0;
+        dst[0] = x * sx + y * kx + m[kMTransX];
+        dst[1] = x * ky + y * sy + m[kMTransY];
+    }
+}
+
+static void map_points(const float* m, int type, float* dst, const float* src, int count) {
+    if (count <= 0) {
+        return;
+    }
+    if (type & SkKernel_MatrixType_Perspective) {
+        for (int i = 0; i < count; i++) {
+            map_perspective_xy(m, src[0], src[1], &dst[0], &dst[1]);
+            src += 2;
+            dst += 2;
+        }
+    }
+    else if (type & SkKernel_MatrixType_Affine) {
+        map_pairs<true, true>(m, dst, src, count);
+    }
+    else if (type & SkKernel_MatrixType_Scale) {
+        map_pairs<true, false>(m, dst, src, count);
+    }
+    else if (type & SkKernel_MatrixType_Translate) {
+        map_pairs<false, false>(m, dst, src, count);
+    }
+    else if (dst != src) {
+        memmove(dst, src, sizeof(float) * 2 * count);
+    }
+}
+
+extern "C" SK_API void SkKernel_mapPoints(const float* matrix, float* dst, const float* src, int count) {
+    map_points(matrix, compute_type(matrix), dst, src, count);
+}
+
+extern "C" SK_API void SkKernel_mapXY(const float* matrix, const float* srcX, const float* srcY, float* dstX, float* dstY, int count) {
+    if (count <= 0) {
+        return;
+    }
+
+    const float* m = matrix;
+    int type = compute_type(m);
+
+    if (type == SkKernel_MatrixType_Identity) {
+        if (dstX != srcX) memmove(dstX, srcX, sizeof(float) * count);
+        if (dstY != srcY) memmove(dstY, srcY, sizeof(float) * count);
+        return;
+    }
+
+    bool persp = (type & SkKernel_MatrixType_Perspective) != 0;
+    int i = 0;
+
+    // structure of arrays, every lane is an independent point so any matrix type vectorizes
+#if defined(KERNEL_AVX)
+    {
+        Sk8f sx(m[kMScaleX]), kx(m[kMSkewX]), tx(m[kMTransX]),
+            ky(m[kMSkewY]), sy(m[kMScaleY]), ty(m[kMTransY]),
+            p0(m[kMPersp0]), p1(m[kMPersp1]), p2(m[kMPersp2]), zero(0), one(1);
+        for (; i + 8 <= count; i += 8) {
+            Sk8f x = Sk8f::Load(srcX + i), y = Sk8f::Load(srcY + i);
+            Sk8f X = x * sx + y * kx + tx;
+            Sk8f Y = x * ky + y * sy + ty;
+            if (persp) {
+                Sk8f z = x * p0 + y * p1 + p2;
+                z = (z != zero).thenElse(one / z, zero);
+                X = X * z;
+                Y = Y * z;
+            }
+            X.store(dstX + i);
+            Y.store(dstY + i);
+        }
+    }
+#endif
+    {
+        Sk4f sx(m[kMScaleX]), kx(m[kMSkewX]), tx(m[kMTransX]),
+            ky(m[kMSkewY]), sy(m[kMScaleY]), ty(m[kMTransY]),
+            p0(m[kMPersp0]), p1(m[kMPersp1]), p2(m[kMPersp2]), zero(0), one(1);
+        for (; i + 4 <= count; i += 4) {
+            Sk4f x = Sk4f::Load(srcX + i), y = Sk4f::Load(srcY + i);
+            Sk4f X = x * sx + y * kx + tx;
+            Sk4f Y = x * ky + y * sy + ty;
+            if (persp) {
+                Sk4f z = x * p0 + y * p1 + p2;
+                z = (z != zero).thenElse(one / z, zero);
+                X = X * z;
+                Y = Y * z;
+            }
+            X.store(dstX + i);
+            Y.store(dstY + i);
+        }
+    }
+    for (; i < count; i++) {
+        float x = srcX[i], y = srcY[i];
+        if (persp) {
+            map_perspective_xy(m, x, y, &dstX[i], &dstY[i]);
+        }
+        else {
+            dstX[i] = x * m[kMScaleX] + y * m[kMSkewX] + m[kMTransX];
+            dstY[i] = x * m[kMSkewY] + y * m[kMScaleY] + m[kMTransY];
+        }
+    }
+}
+
+static inline void store_sorted(float* dst, const Sk4f& v) {
+    // v holds two corners, (x0, y0, x1, y1)
+    Sk4f s = v.swapHalves();
+    Sk4f lo = Sk4f::Min(v, s), hi = Sk4f::Max(v, s);
+    dst[0] = lo[0];
+    dst[1] = lo[1];
+    dst[2] = hi[0];
+    dst[3] = hi[1];
+}
+
+static inline void map_rect(const float* m, int type, float* dst, const float* src) {
+    if (!(type & SkKernel_MatrixType_Affine)) {
+        // identity, translate, scale + translate, map both corners and sort
+        Sk4f scale4(m[kMScaleX], m[kMScaleY], m[kMScaleX], m[kMScaleY]);
+        Sk4f trans4(m[kMTransX], m[kMTransY], m[kMTransX], m[kMTransY]);
+        store_sorted(dst, Sk4f::Load(src) * scale4 + trans4);
+        return;
+    }
+
+    // affine or perspective, map all four corners and take their bounds
+    float l = src[0], t = src[1], r = src[2], b = src[3];
+    float quad[8] = { l, t, r, t, r, b, l, b };
+    map_points(m, type, quad, quad, 4);
+    Sk4f a = Sk4f::Load(quad), c = Sk4f::Load(quad + 4);
+    Sk4f lo = Sk4f::Min(a, c), hi = Sk4f::Max(a, c);
+    lo = Sk4f::Min(lo, lo.swapHalves());
+    hi = Sk4f::Max(hi, hi.swapHalves());
+    dst[0] = lo[0];
+    dst[1] = lo[1];
+    dst[2] = hi[0];
+    dst[3] = hi[1];
+}
+
+extern "C" SK_API void SkKernel_mapRects(const float* matrix, float* dst, const float* src, int count) {
+    if (count <= 0) {
+        return;
+    }
+    int type = compute_type(matrix);
+    if (!(type & SkKernel_MatrixType_Affine)) {
+        // map every corner as a plain point pair first, SkMatrix::mapRect always returns sorted bounds
+        map_points(matrix, type, dst, src, count * 2);
+        for (int i = 0; i < count; i++) {
+            store_sorted(dst, Sk4f::Load(dst));
+            dst += 4;
+        }
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        map_rect(matrix, type, dst, src);
+        src += 4;
+        dst += 4;
+    }
+}
+
+extern "C" SK_API void SkKernel_mapRectsPerMatrix(const float* matrices, float* dst, const float* src, int count) {
+    for (int i = 0; i < count; i++) {
+        map_rect(matrices, compute_type(matrices), dst, src);
+        matrices += 9;
+        src += 4;
+        dst += 4;
+    }
+}
+
+extern "C" SK_API void SkKernel_mapRadius(const float* matrix, float* dst, const float* src, int count) {
+    const float* m = matrix;
+    int type = compute_type(m);
+
+    if (type & SkKernel_MatrixType_Perspective) {
+        // vectors under perspective depend on where they are, map them relative to the origin
+        float ox, oy;
+        map_perspective_xy(m, 0, 0, &ox, &oy);
+        for (int i = 0; i < count; i++) {
+            float r = src[i];
+            float x0, y0, x1, y1;
+            map_perspective_xy(m, r, 0, &x0, &y0);
+            map_perspective_xy(m, 0, r, &x1, &y1);
+            float d0 = std::sqrt((x0 - ox) * (x0 - ox) + (y0 - oy) * (y0 - oy));
+            float d1 = std::sqrt((x1 - ox) * (x1 - ox) + (y1 - oy) * (y1 - oy));
+            dst[i] = std::sqrt(d0 * d1);
+        }
+        return;
+    }
+
+    // without perspective the vectors (r, 0) and (0, r) map to r * column0 and r * column1,
+    // so sqrt(|r * c0| * |r * c1|) == |r| * sqrt(|c0| * |c1|) which is one multiply per radius
+    float c0 = std::sqrt(m[kMScaleX] * m[kMScaleX] + m[kMSkewY] * m[kMSkewY]);
+    float c1 = std::sqrt(m[kMSkewX] * m[kMSkewX] + m[kMScaleY] * m[kMScaleY]);
+    float factor = std::sqrt(c0 * c1);
+
+    int i = 0;
+    Sk4f f4(factor);
+    for (; i + 4 <= count; i += 4) {
+        (Sk4f::Load(src + i).abs() * f4).store(dst + i);
+    }
+    for (; i < count; i++) {
+        dst[i] = std::fabs(src[i]) * factor;
+    }
+}
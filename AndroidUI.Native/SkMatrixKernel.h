@@ -0,0 +1,58 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+batched SkMatrix mapping
+
+every matrix argument points to 9 floats laid out like SkMatrix / SKMatrix:
+
+    scaleX, skewX,  transX,
+    skewY,  scaleY, transY,
+    persp0, persp1, persp2
+
+the matrix type is classified once per call and a specialized loop is run over the
+whole array, dst may alias src
+
+*/
+
+enum SkKernel_MatrixTypeMask {
+    SkKernel_MatrixType_Identity = 0,
+    SkKernel_MatrixType_Translate = 0x01,
+    SkKernel_MatrixType_Scale = 0x02,
+    SkKernel_MatrixType_Affine = 0x04,
+    SkKernel_MatrixType_Perspective = 0x08,
+};
+
+/**
+ * returns a combination of SkKernel_MatrixTypeMask, same rules as SkMatrix::getType
+ */
+extern "C" SK_API int SkKernel_matrixGetType(const float* matrix);
+
+/**
+ * maps count points stored as interleaved x, y pairs
+ */
+extern "C" SK_API void SkKernel_mapPoints(const float* matrix, float* dst, const float* src, int count);
+
+/**
+ * maps count points stored as separate x and y arrays
+ */
+extern "C" SK_API void SkKernel_mapXY(const float* matrix, const float* srcX, const float* srcY, float* dstX, float* dstY, int count);
+
+/**
+ * maps count rects stored as left, top, right, bottom and stores the sorted bounds of each result
+ */
+extern "C" SK_API void SkKernel_mapRects(const float* matrix, float* dst, const float* src, int count);
+
+/**
+ * same as SkKernel_mapRects but every rect has its own matrix, matrices holds count * 9 floats
+ *
+ * used to map the bounds of every child of a view in one call
+ */
+extern "C" SK_API void SkKernel_mapRectsPerMatrix(const float* matrices, float* dst, const float* src, int count);
+
+/**
+ * maps count radii, same rules as SkMatrix::mapRadius
+ */
+extern "C" SK_API void SkKernel_mapRadius(const float* matrix, float* dst, const float* src, int count);
@@ -0,0 +1,16 @@
+#include "SkMorphKernel.h"
+#include "SkNxKernel.h"
+
+using kernel::Sk8f;
+
+extern "C" SK_API void SkKernel_interpolatePathPoints(const float* from, const float* to, float* dst, int count, float fraction) {
+    const float inverse = 1 - fraction;
+    const Sk8f f8(fraction), inv8(inverse);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        (Sk8f::Load(from + i) * inv8 + Sk8f::Load(to + i) * f8).store(dst + i);
+    }
+    for (; i < count; i++) {
+        dst[i] = from[i] * inverse + to[i] * fraction;
+    }
+}
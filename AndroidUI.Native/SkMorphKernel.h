@@ -0,0 +1,17 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+path morphing, the morphable points of two path data buffers with the same verbs are
+blended in one pass
+
+*/
+
+/**
+ * dst[i] = from[i] * (1 - fraction) + to[i] * fraction for count floats
+ *
+ * fraction 0 and 1 reproduce from and to exactly, dst may alias from or to
+ */
+extern "C" SK_API void SkKernel_interpolatePathPoints(const float* from, const float* to, float* dst, int count, float fraction);
@@ -0,0 +1,159 @@
+#include "SkNinePatchCacheKernel.h"
+
+#include "android_9_patch/JenkinsHash.h"
+#include "android_9_patch/NinePatchBindings.h"
+
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    struct Entry {
+        uint32_t hash;
+        float scaleX, scaleY;
+        int scaledWidth, scaledHeight;
+        // the chunk the patch was made from, compared on a hash match
+        std::vector<int8_t> source;
+        int8_t* patch;
+        int refs;
+        // position in the unused list while refs is 0
+        std::list<Entry*>::iterator unused;
+    };
+
+    struct Cache {
+        std::mutex mutex;
+        // keyed by the chunk hash, a bucket holds every scale of every chunk with that hash
+        std::unordered_multimap<uint32_t, Entry*> entries;
+        std::unordered_map<void*, Entry*> patches;
+        // released entries, most recently released first, kept for the next decode of the
+        // same resource until they exceed the budget
+        std::list<Entry*> unused;
+        int64_t unusedBytes = 0;
+        int64_t unusedBudget = SK_KERNEL_NINE_PATCH_CACHE_DEFAULT_BUDGET;
+        int64_t hits = 0;
+        int64_t misses = 0;
+        int64_t bytes = 0;
+
+        void remove(Entry* e) {
+            patches.erase(e->patch);
+            auto range = entries.equal_range(e->hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second == e) {
+                    entries.erase(it);
+                    break;
+                }
+            }
+            bytes -= (int64_t)e->source.size();
+            SkNinePatchGlue_finalize(e->patch);
+            delete e;
+        }
+
+        void trim() {
+            while (unusedBytes > unusedBudget) {
+                Entry* e = unused.back();
+                unused.pop_back();
+                unusedBytes -= (int64_t)e->source.size();
+                remove(e);
+            }
+        }
+    };
+
+    Cache& cache() {
+        static Cache* cache = new Cache();
+        return *cache;
+    }
+
+    uint32_t hash_chunk(const int8_t* chunk, int length) {
+        return android::JenkinsHashWhiten(android::JenkinsHashMixBytes(0, (const uint8_t*)chunk, (size_t)length));
+    }
+}
+
+extern "C" SK_API void* SkKernel_ninePatchCacheAcquire(const int8_t* chunk, int length, float scaleX, float scaleY, int scaledWidth, int scaledHeight) {
+    if (!chunk || length <= 0) {
+        return nullptr;
+    }
+    bool scaled = scaleX != 1.0f || scaleY != 1.0f;
+    if (!scaled) {
+        scaledWidth = scaledHeight = 0;
+    }
+    uint32_t hash = hash_chunk(chunk, length);
+
+    Cache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    auto range = c.entries.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        Entry* e = it->second;
+        if (e->scaleX == scaleX && e->scaleY == scaleY
+            && e->scaledWidth == scaledWidth && e->scaledHeight == scaledHeight
+            && e->source.size() == (size_t)length && memcmp(e->source.data(), chunk, (size_t)length) == 0) {
+            if (e->refs++ == 0) {
+                c.unused.erase(e->unused);
+                c.unusedBytes -= length;
+            }
+            c.hits++;
+            return e->patch;
+        }
+    }
+
+    // validating copies the chunk, the copy is then scaled in place
+    int8_t* patch = SkNinePatchGlue_validateNinePatchChunk((int8_t*)chunk, length);
+    if (!patch) {
+        return nullptr;
+    }
+    if (scaled) {
+        SkNinePatchGlue_scale(patch, scaleX, scaleY, scaledWidth, scaledHeight);
+    }
+    c.misses++;
+    Entry* e = new Entry{ hash, scaleX, scaleY, scaledWidth, scaledHeight,
+                          std::vector<int8_t>(chunk, chunk + length), patch, 1, {} };
+    c.entries.emplace(hash, e);
+    c.patches.emplace(patch, e);
+    c.bytes += length;
+    return patch;
+}
+
+extern "C" SK_API void SkKernel_ninePatchCacheRelease(void* patch) {
+    if (!patch) {
+        return;
+    }
+    Cache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    auto found = c.patches.find(patch);
+    if (found == c.patches.end()) {
+        return;
+    }
+    Entry* e = found->second;
+    if (--e->refs > 0) {
+        return;
+    }
+    c.unused.push_front(e);
+    e->unused = c.unused.begin();
+    c.unusedBytes += (int64_t)e->source.size();
+    c.trim();
+}
+
+extern "C" SK_API void SkKernel_ninePatchCacheSetBudget(int64_t unusedBytes) {
+    Cache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    c.unusedBudget = unusedBytes < 0 ? 0 : unusedBytes;
+    c.trim();
+}
+
+extern "C" SK_API int SkKernel_ninePatchCacheSize(void* patch) {
+    Cache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    auto found = c.patches.find(patch);
+    return found == c.patches.end() ? 0 : (int)found->second->source.size();
+}
+
+extern "C" SK_API void SkKernel_ninePatchCacheStats(int64_t* stats) {
+    Cache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    stats[SK_KERNEL_NINE_PATCH_CACHE_HITS] = c.hits;
+    stats[SK_KERNEL_NINE_PATCH_CACHE_MISSES] = c.misses;
+    stats[SK_KERNEL_NINE_PATCH_CACHE_BYTES] = c.bytes;
+    stats[SK_KERNEL_NINE_PATCH_CACHE_ENTRIES] = (int64_t)c.patches.size();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+content addressed nine patch chunk cache
+
+identical chunks share one validated, immutable Res_png_9patch, chunks are keyed by their
+JenkinsHash and compared byte for byte on a hash match, pre scaled variants are keyed by
+(hash, scaleX, scaleY, scaledWidth, scaledHeight) so a chunk is scaled once per density
+
+patches are reference counted, every acquire must be paired with a release, released
+patches are kept until the released ones exceed a byte budget so decoding the same
+resource again still hits
+
+the cache is thread safe
+
+*/
+
+#define SK_KERNEL_NINE_PATCH_CACHE_HITS 0
+#define SK_KERNEL_NINE_PATCH_CACHE_MISSES 1
+#define SK_KERNEL_NINE_PATCH_CACHE_BYTES 2
+#define SK_KERNEL_NINE_PATCH_CACHE_ENTRIES 3
+
+#define SK_KERNEL_NINE_PATCH_CACHE_DEFAULT_BUDGET (64 * 1024)
+
+/**
+ * returns the shared patch for a serialized chunk of length bytes, scaled when scaleX or
+ * scaleY is not 1, or null if the chunk is not a valid nine patch chunk
+ */
+extern "C" SK_API void* SkKernel_ninePatchCacheAcquire(const int8_t* chunk, int length, float scaleX, float scaleY, int scaledWidth, int scaledHeight);
+
+extern "C" SK_API void SkKernel_ninePatchCacheRelease(void* patch);
+
+/**
+ * sets how many bytes of released patches are kept, 0 drops every released patch
+ */
+extern "C" SK_API void SkKernel_ninePatchCacheSetBudget(int64_t unusedBytes);
+
+/**
+ * the serialized size of a patch returned by acquire
+ */
+extern "C" SK_API int SkKernel_ninePatchCacheSize(void* patch);
+
+/**
+ * stats receives hits, misses, bytes and entries, released patches still kept included
+ */
+extern "C" SK_API void SkKernel_ninePatchCacheStats(int64_t* stats);
@@ -0,0 +1,228 @@
+#include "SkNinePatchKernel.h"
+#include "SkNxKernel.h"
+
+#include "android_9_patch/NinePatchBindings.h"
+
+using kernel::Sk4f;
+
+namespace {
+
+    // Res_png_9patch::TRANSPARENT_COLOR and Res_png_9patch::NO_COLOR
+    constexpr uint32_t TRANSPARENT_COLOR = 0;
+    constexpr uint32_t NO_COLOR = 1;
+
+    struct Chunk {
+        int xCount, yCount, numColors;
+        const int32_t* xDivs;
+        const int32_t* yDivs;
+        const uint32_t* colors;
+
+        Chunk(void* chunk, int width, int height) {
+            uint8_t x, y, c;
+            SkNinePatchGlue_getNumXDivs(chunk, &x);
+            SkNinePatchGlue_getNumYDivs(chunk, &y);
+            SkNinePatchGlue_getNumColors(chunk, &c);
+            int32_t* xd;
+            int32_t* yd;
+            uint32_t* cs;
+            SkNinePatchGlue_getXDivs(chunk, &xd);
+            SkNinePatchGlue_getYDivs(chunk, &yd);
+            SkNinePatchGlue_getColors(chunk, &cs);
+            xCount = x;
+            yCount = y;
+            numColors = c;
+            xDivs = xd;
+            yDivs = yd;
+            colors = cs;
+
+            // a last div equal to the size adds nothing and is not supported by skia
+            if (xCount > 0 && xDivs[xCount - 1] == width) {
+                xCount--;
+            }
+            if (yCount > 0 && yDivs[yCount - 1] == height) {
+                yCount--;
+            }
+        }
+
+        // the framework gives a color for every distinct rect when it gives any
+        bool hasRectColors() const {
+            int xRects = xCount > 0 ? (0 == xDivs[0] ? xCount : xCount + 1) : 1;
+            int yRects = yCount > 0 ? (0 == yDivs[0] ? yCount : yCount + 1) : 1;
+            return numColors > 0 && numColors == xRects * yRects;
+        }
+    };
+
+    bool valid_divs(const int32_t* divs, int count, int start, int end) {
+        int prev = start - 1;
+        for (int i = 0; i < count; i++) {
+            if (prev >= divs[i] || divs[i] >= end) {
+                return false;
+            }
+            prev = divs[i];
+        }
+        return true;
+    }
+
+    // SkLatticeIter::Valid for a lattice covering the whole image
+    bool valid(const Chunk& c, int width, int height) {
+        if (width <= 0 || height <= 0) {
+            return false;
+        }
+        bool zeroXDivs = c.xCount <= 0 || (1 == c.xCount && 0 == c.xDivs[0]);
+        bool zeroYDivs = c.yCount <= 0 || (1 == c.yCount && 0 == c.yDivs[0]);
+        if (zeroXDivs && zeroYDivs) {
+            return false;
+        }
+        return valid_divs(c.xDivs, c.xCount, 0, width) && valid_divs(c.yDivs, c.yCount, 0, height);
+    }
+
+    int count_scalable_pixels(const int32_t* divs, int count, bool firstIsScalable, int start, int end) {
+        if (0 == count) {
+            return firstIsScalable ? end - start : 0;
+        }
+        int i, pixels;
+        if (firstIsScalable) {
+            pixels = divs[0] - start;
+            i = 1;
+        }
+        else {
+            pixels = 0;
+            i = 0;
+        }
+        for (; i < count; i += 2) {
+            int right = i + 1 < count ? divs[i + 1] : end;
+            pixels += right - divs[i];
+        }
+        return pixels;
+    }
+
+    // one axis of SkLatticeIter, src and dst receive count + 2 edges
+    void set_points(float* dst, int* src, const int32_t* divs, int count, bool isScalable,
+                    int srcEnd, float dstStart, float dstEnd) {
+        int srcScalable = count_scalable_pixels(divs, count, isScalable, 0, srcEnd);
+        int srcFixed = srcEnd - srcScalable;
+        float dstLen = dstEnd - dstStart;
+        // normally the scalable patches stretch and the fixed patches keep their size, when
+        // the fixed patches do not fit they shrink and the scalable patches vanish
+        bool shrink = (float)srcFixed > dstLen;
+        float scale = shrink ? dstLen / srcFixed : (dstLen - srcFixed) / srcScalable;
+
+        src[0] = 0;
+        dst[0] = dstStart;
+        for (int i = 0; i < count; i++) {
+            src[i + 1] = divs[i];
+            int srcDelta = src[i + 1] - src[i];
+            float dstDelta = shrink
+                ? (isScalable ? 0.0f : scale * srcDelta)
+                : (isScalable ? scale * srcDelta : (float)srcDelta);
+            dst[i + 1] = dst[i] + dstDelta;
+            isScalable = !isScalable;
+        }
+        src[count + 1] = srcEnd;
+        dst[count + 1] = dstEnd;
+    }
+
+    uint8_t rect_type(uint32_t color) {
+        if (TRANSPARENT_COLOR == color) {
+            return SK_KERNEL_LATTICE_TRANSPARENT;
+        }
+        return NO_COLOR == color ? SK_KERNEL_LATTICE_DEFAULT : SK_KERNEL_LATTICE_FIXED_COLOR;
+    }
+}
+
+extern "C" SK_API bool SkKernel_ninePatchLattice(void* chunk, int width, int height, int* xDivs, int* yDivs, uint8_t* rectTypes, uint32_t* colors, int* counts) {
+    Chunk c(chunk, width, height);
+    for (int i = 0; i < c.xCount; i++) {
+        xDivs[i] = c.xDivs[i];
+    }
+    for (int i = 0; i < c.yCount; i++) {
+        yDivs[i] = c.yDivs[i];
+    }
+    counts[0] = c.xCount;
+    counts[1] = c.yCount;
+    counts[2] = 0;
+
+    if (c.hasRectColors()) {
+        // skia wants a type for every rect, the degenerate first row and column keep the
+        // default type and the chunk colors fill the rest in order
+        int flagCount = (c.xCount + 1) * (c.yCount + 1);
+        for (int i = 0; i < flagCount; i++) {
+            rectTypes[i] = SK_KERNEL_LATTICE_DEFAULT;
+            colors[i] = 0;
+        }
+        bool padRow = c.yCount > 0 && 0 == c.yDivs[0];
+        bool padCol = c.xCount > 0 && 0 == c.xDivs[0];
+        bool any = false;
+        int color = 0;
+        for (int y = padRow ? 1 : 0; y < c.yCount + 1; y++) {
+            for (int x = padCol ? 1 : 0; x < c.xCount + 1; x++) {
+                uint32_t current = c.colors[color++];
+                uint8_t type = rect_type(current);
+                int flag = y * (c.xCount + 1) + x;
+                rectTypes[flag] = type;
+                colors[flag] = SK_KERNEL_LATTICE_FIXED_COLOR == type ? current : 0;
+                any |= SK_KERNEL_LATTICE_DEFAULT != type;
+            }
+        }
+        if (any) {
+            counts[2] = flagCount;
+        }
+    }
+    return valid(c, width, height);
+}
+
+extern "C" SK_API int SkKernel_ninePatchCells(void* chunk, int width, int height, const float* dst, float* cells, uint8_t* rectTypes, uint32_t* colors, int capacity) {
+    Chunk c(chunk, width, height);
+    if (!valid(c, width, height)) {
+        if (capacity >= 1) {
+            Sk4f(0, 0, (float)width, (float)height).store(cells);
+            Sk4f::Load(dst).store(cells + 4);
+            rectTypes[0] = SK_KERNEL_LATTICE_DEFAULT;
+            colors[0] = 0;
+        }
+        return 1;
+    }
+
+    // the first patch is scalable when the first div is at the edge, the div itself is
+    // then implied
+    const int32_t* xDivs = c.xDivs;
+    const int32_t* yDivs = c.yDivs;
+    int xCount = c.xCount;
+    int yCount = c.yCount;
+    bool xIsScalable = xCount > 0 && 0 == xDivs[0];
+    if (xIsScalable) {
+        xDivs++;
+        xCount--;
+    }
+    bool yIsScalable = yCount > 0 && 0 == yDivs[0];
+    if (yIsScalable) {
+        yDivs++;
+        yCount--;
+    }
+
+    int count = (xCount + 1) * (yCount + 1);
+    if (count > capacity) {
+        return count;
+    }
+
+    // at most 255 divs per axis
+    int srcX[257], srcY[257];
+    float dstX[257], dstY[257];
+    set_points(dstX, srcX, xDivs, xCount, xIsScalable, width, dst[0], dst[2]);
+    set_points(dstY, srcY, yDivs, yCount, yIsScalable, height, dst[1], dst[3]);
+
+    bool hasColors = c.hasRectColors();
+    int cell = 0;
+    for (int y = 0; y < yCount + 1; y++) {
+        for (int x = 0; x < xCount + 1; x++, cell++) {
+            float* out = cells + cell * 8;
+            Sk4f((float)srcX[x], (float)srcY[y], (float)srcX[x + 1], (float)srcY[y + 1]).store(out);
+            Sk4f(dstX[x], dstY[y], dstX[x + 1], dstY[y + 1]).store(out + 4);
+            uint32_t color = hasColors ? c.colors[cell] : NO_COLOR;
+            uint8_t type = rect_type(color);
+            rectTypes[cell] = type;
+            colors[cell] = SK_KERNEL_LATTICE_FIXED_COLOR == type ? color : 0;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+nine patch lattices, computed straight from a Res_png_9patch chunk through the
+SkNinePatchGlue accessors
+
+the lattice is the SkCanvas::Lattice android hands to drawImageLattice, a trailing div
+equal to the image size is dropped and a rect type is emitted for every rect when the
+chunk has one color per distinct rect
+
+cells are the src / dst rect pairs SkLatticeIter would produce for a destination, in
+row major order with the degenerate first row / column removed, each cell is 8 floats
+
+    srcLeft, srcTop, srcRight, srcBottom, dstLeft, dstTop, dstRight, dstBottom
+
+transparent cells are emitted too, flagged by their rect type
+
+*/
+
+#define SK_KERNEL_LATTICE_DEFAULT 0
+#define SK_KERNEL_LATTICE_TRANSPARENT 1
+#define SK_KERNEL_LATTICE_FIXED_COLOR 2
+
+/**
+ * fills the lattice divs of the chunk for an image of width x height
+ *
+ * xDivs and yDivs must hold the chunk's div counts, rectTypes and colors must hold
+ * (numXDivs + 1) * (numYDivs + 1) entries
+ *
+ * counts receives xCount, yCount and the number of rect types written (0 if the chunk
+ * has no per rect colors)
+ *
+ * returns false if skia would reject the lattice, the image is then drawn stretched
+ */
+extern "C" SK_API bool SkKernel_ninePatchLattice(void* chunk, int width, int height, int* xDivs, int* yDivs, uint8_t* rectTypes, uint32_t* colors, int* counts);
+
+/**
+ * emits every cell of the chunk's lattice stretched over dst (left, top, right, bottom)
+ *
+ * returns the number of cells, nothing is written if it exceeds capacity
+ *
+ * an invalid lattice emits a single cell covering the whole image
+ */
+extern "C" SK_API int SkKernel_ninePatchCells(void* chunk, int width, int height, const float* dst, float* cells, uint8_t* rectTypes, uint32_t* colors, int capacity);
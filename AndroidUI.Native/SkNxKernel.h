@@ -0,0 +1,377 @@
+#pragma once
+
+#ifndef SkNxKernel_DEFINED
+#define SkNxKernel_DEFINED
+
+#include "SkTypes.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX
+#include <immintrin.h>
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE41
+#include <smmintrin.h>
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+#include <emmintrin.h>
+#elif !defined(SKNX_NO_SIMD) && defined(SK_ARM_HAS_NEON)
+#include <arm_neon.h>
+#endif
+
+/*
+
+the SkNx in SkNx.h hands every result back as a heap allocated TmpPtr so that it can
+be passed across P/Invoke, that is fine for the managed Sk4f/Sk8f wrappers but far too
+slow for bulk work
+
+the types below are the by-value equivalents, they are only ever used inside native
+kernels that process whole arrays per call, they never cross the C API
+
+lane masks follow SkNx conventions: comparisons produce all-ones / all-zeros per lane
+
+*/
+
+#define KAI SK_ALWAYS_INLINE
+
+namespace kernel {
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+#define KERNEL_SSE 1
+#elif !defined(SKNX_NO_SIMD) && defined(SK_ARM_HAS_NEON)
+#define KERNEL_NEON 1
+#endif
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX
+#define KERNEL_AVX 1
+#endif
+
+    struct Sk4f {
+#if defined(KERNEL_SSE)
+        __m128 fVec;
+        KAI Sk4f(const __m128& v) : fVec(v) {}
+        KAI Sk4f() : fVec(_mm_setzero_ps()) {}
+        KAI Sk4f(float v) : fVec(_mm_set1_ps(v)) {}
+        KAI Sk4f(float a, float b, float c, float d) : fVec(_mm_setr_ps(a, b, c, d)) {}
+
+        KAI static Sk4f Load(const void* ptr) { return _mm_loadu_ps((const float*)ptr); }
+        KAI void store(void* ptr) const { _mm_storeu_ps((float*)ptr, fVec); }
+
+        KAI Sk4f operator+(const Sk4f& o) const { return _mm_add_ps(fVec, o.fVec); }
+        KAI Sk4f operator-(const Sk4f& o) const { return _mm_sub_ps(fVec, o.fVec); }
+        KAI Sk4f operator*(const Sk4f& o) const { return _mm_mul_ps(fVec, o.fVec); }
+        KAI Sk4f operator/(const Sk4f& o) const { return _mm_div_ps(fVec, o.fVec); }
+        KAI Sk4f operator-() const { return _mm_xor_ps(_mm_set1_ps(-0.0f), fVec); }
+
+        KAI Sk4f operator==(const Sk4f& o) const { return _mm_cmpeq_ps(fVec, o.fVec); }
+        KAI Sk4f operator!=(const Sk4f& o) const { return _mm_cmpneq_ps(fVec, o.fVec); }
+        KAI Sk4f operator< (const Sk4f& o) const { return _mm_cmplt_ps(fVec, o.fVec); }
+        KAI Sk4f operator> (const Sk4f& o) const { return _mm_cmpgt_ps(fVec, o.fVec); }
+        KAI Sk4f operator<=(const Sk4f& o) const { return _mm_cmple_ps(fVec, o.fVec); }
+        KAI Sk4f operator>=(const Sk4f& o) const { return _mm_cmpge_ps(fVec, o.fVec); }
+
+        KAI Sk4f operator&(const Sk4f& o) const { return _mm_and_ps(fVec, o.fVec); }
+        KAI Sk4f operator|(const Sk4f& o) const { return _mm_or_ps(fVec, o.fVec); }
+
+        KAI static Sk4f Min(const Sk4f& l, const Sk4f& r) { return _mm_min_ps(l.fVec, r.fVec); }
+        KAI static Sk4f Max(const Sk4f& l, const Sk4f& r) { return _mm_max_ps(l.fVec, r.fVec); }
+
+        KAI Sk4f abs() const { return _mm_andnot_ps(_mm_set1_ps(-0.0f), fVec); }
+        KAI Sk4f sqrt() const { return _mm_sqrt_ps(fVec); }
+        KAI Sk4f floor() const {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE41
+            return _mm_floor_ps(fVec);
+#else
+            __m128 roundtrip = _mm_cvtepi32_ps(_mm_cvttps_epi32(fVec));
+            __m128 too_big = _mm_cmpgt_ps(roundtrip, fVec);
+            return _mm_sub_ps(roundtrip, _mm_and_ps(too_big, _mm_set1_ps(1.0f)));
+#endif
+        }
+
+        KAI Sk4f thenElse(const Sk4f& t, const Sk4f& e) const {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE41
+            return _mm_blendv_ps(e.fVec, t.fVec, fVec);
+#else
+            return _mm_or_ps(_mm_and_ps(fVec, t.fVec), _mm_andnot_ps(fVec, e.fVec));
+#endif
+        }
+
+        // (a, b, c, d) -> (b, a, d, c), swaps x and y of two interleaved points
+        KAI Sk4f swapPairs() const { return _mm_shuffle_ps(fVec, fVec, _MM_SHUFFLE(2, 3, 0, 1)); }
+        // (a, b, c, d) -> (c, d, a, b), swaps the two points
+        KAI Sk4f swapHalves() const { return _mm_shuffle_ps(fVec, fVec, _MM_SHUFFLE(1, 0, 3, 2)); }
+
+        KAI bool allTrue() const { return 0xF == _mm_movemask_ps(fVec); }
+        KAI bool anyTrue() const { return 0x0 != _mm_movemask_ps(fVec); }
+
+        KAI float operator[](int k) const {
+            SkASSERT(0 <= k && k < 4);
+            union { __m128 v; float fs[4]; } pun = { fVec };
+            return pun.fs[k & 3];
+        }
+#elif defined(KERNEL_NEON)
+        float32x4_t fVec;
+        KAI Sk4f(const float32x4_t& v) : fVec(v) {}
+        KAI Sk4f() : fVec(vdupq_n_f32(0)) {}
+        KAI Sk4f(float v) : fVec(vdupq_n_f32(v)) {}
+        KAI Sk4f(float a, float b, float c, float d) {
+            float t[4] = { a, b, c, d };
+            fVec = vld1q_f32(t);
+        }
+
+        KAI static Sk4f Load(const void* ptr) { return vld1q_f32((const float*)ptr); }
+        KAI void store(void* ptr) const { vst1q_f32((float*)ptr, fVec); }
+
+        KAI Sk4f operator+(const Sk4f& o) const { return vaddq_f32(fVec, o.fVec); }
+        KAI Sk4f operator-(const Sk4f& o) const { return vsubq_f32(fVec, o.fVec); }
+        KAI Sk4f operator*(const Sk4f& o) const { return vmulq_f32(fVec, o.fVec); }
+        KAI Sk4f operator/(const Sk4f& o) const {
+#if defined(SK_CPU_ARM64)
+            return vdivq_f32(fVec, o.fVec);
+#else
+            float32x4_t est0 = vrecpeq_f32(o.fVec),
+                est1 = vmulq_f32(vrecpsq_f32(est0, o.fVec), est0),
+                est2 = vmulq_f32(vrecpsq_f32(est1, o.fVec), est1);
+            return vmulq_f32(fVec, est2);
+#endif
+        }
+        KAI Sk4f operator-() const { return vnegq_f32(fVec); }
+
+        KAI Sk4f operator==(const Sk4f& o) const { return vreinterpretq_f32_u32(vceqq_f32(fVec, o.fVec)); }
+        KAI Sk4f operator!=(const Sk4f& o) const { return vreinterpretq_f32_u32(vmvnq_u32(vceqq_f32(fVec, o.fVec))); }
+        KAI Sk4f operator< (const Sk4f& o) const { return vreinterpretq_f32_u32(vcltq_f32(fVec, o.fVec)); }
+        KAI Sk4f operator> (const Sk4f& o) const { return vreinterpretq_f32_u32(vcgtq_f32(fVec, o.fVec)); }
+        KAI Sk4f operator<=(const Sk4f& o) const { return vreinterpretq_f32_u32(vcleq_f32(fVec, o.fVec)); }
+        KAI Sk4f operator>=(const Sk4f& o) const { return vreinterpretq_f32_u32(vcgeq_f32(fVec, o.fVec)); }
+
+        KAI Sk4f operator&(const Sk4f& o) const {
+            return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(fVec), vreinterpretq_u32_f32(o.fVec)));
+        }
+        KAI Sk4f operator|(const Sk4f& o) const {
+            return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(fVec), vreinterpretq_u32_f32(o.fVec)));
+        }
+
+        KAI static Sk4f Min(const Sk4f& l, const Sk4f& r) { return vminq_f32(l.fVec, r.fVec); }
+        KAI static Sk4f Max(const Sk4f& l, const Sk4f& r) { return vmaxq_f32(l.fVec, r.fVec); }
+
+        KAI Sk4f abs() const { return vabsq_f32(fVec); }
+        KAI Sk4f sqrt() const {
+#if defined(SK_CPU_ARM64)
+            return vsqrtq_f32(fVec);
+#else
+            float t[4];
+            vst1q_f32(t, fVec);
+            return Sk4f(std::sqrt(t[0]), std::sqrt(t[1]), std::sqrt(t[2]), std::sqrt(t[3]));
+#endif
+        }
+        KAI Sk4f floor() const {
+#if defined(SK_CPU_ARM64)
+            return vrndmq_f32(fVec);
+#else
+            float32x4_t roundtrip = vcvtq_f32_s32(vcvtq_s32_f32(fVec));
+            uint32x4_t too_big = vcgtq_f32(roundtrip, fVec);
+            return vsubq_f32(roundtrip, vreinterpretq_f32_u32(vandq_u32(too_big, vreinterpretq_u32_f32(vdupq_n_f32(1)))));
+#endif
+        }
+
+        KAI Sk4f thenElse(const Sk4f& t, const Sk4f& e) const {
+            return vbslq_f32(vreinterpretq_u32_f32(fVec), t.fVec, e.fVec);
+        }
+
+        KAI Sk4f swapPairs() const { return vrev64q_f32(fVec); }
+        KAI Sk4f swapHalves() const { return vcombine_f32(vget_high_f32(fVec), vget_low_f32(fVec)); }
+
+        KAI bool allTrue() const {
+            uint32x4_t v = vreinterpretq_u32_f32(fVec);
+            return vgetq_lane_u32(v, 0) && vgetq_lane_u32(v, 1) && vgetq_lane_u32(v, 2) && vgetq_lane_u32(v, 3);
+        }
+        KAI bool anyTrue() const {
+            uint32x4_t v = vreinterpretq_u32_f32(fVec);
+            return vgetq_lane_u32(v, 0) || vgetq_lane_u32(v, 1) || vgetq_lane_u32(v, 2) || vgetq_lane_u32(v, 3);
+        }
+
+        KAI float operator[](int k) const {
+            SkASSERT(0 <= k && k < 4);
+            float t[4];
+            vst1q_f32(t, fVec);
+            return t[k & 3];
+        }
+#else
+        float fVal[4];
+        KAI Sk4f() : fVal{ 0, 0, 0, 0 } {}
+        KAI Sk4f(float v) : fVal{ v, v, v, v } {}
+        KAI Sk4f(float a, float b, float c, float d) : fVal{ a, b, c, d } {}
+
+        KAI static Sk4f Load(const void* ptr) { Sk4f r; memcpy(r.fVal, ptr, sizeof(r.fVal)); return r; }
+        KAI void store(void* ptr) const { memcpy(ptr, fVal, sizeof(fVal)); }
+
+#define KERNEL_MAP(EXPR) Sk4f r; for (int i = 0; i < 4; i++) { r.fVal[i] = (EXPR); } return r
+#define KERNEL_MASK(COND) Sk4f r; for (int i = 0; i < 4; i++) { uint32_t m = (COND) ? ~0u : 0u; memcpy(&r.fVal[i], &m, 4); } return r
+        KAI static uint32_t bits(float f) { uint32_t u; memcpy(&u, &f, 4); return u; }
+        KAI static float from_bits(uint32_t u) { float f; memcpy(&f, &u, 4); return f; }
+
+        KAI Sk4f operator+(const Sk4f& o) const { KERNEL_MAP(fVal[i] + o.fVal[i]); }
+        KAI Sk4f operator-(const Sk4f& o) const { KERNEL_MAP(fVal[i] - o.fVal[i]); }
+        KAI Sk4f operator*(const Sk4f& o) const { KERNEL_MAP(fVal[i] * o.fVal[i]); }
+        KAI Sk4f operator/(const Sk4f& o) const { KERNEL_MAP(fVal[i] / o.fVal[i]); }
+        KAI Sk4f operator-() const { KERNEL_MAP(-fVal[i]); }
+
+        KAI Sk4f operator==(const Sk4f& o) const { KERNEL_MASK(fVal[i] == o.fVal[i]); }
+        KAI Sk4f operator!=(const Sk4f& o) const { KERNEL_MASK(fVal[i] != o.fVal[i]); }
+        KAI Sk4f operator< (const Sk4f& o) const { KERNEL_MASK(fVal[i] < o.fVal[i]); }
+        KAI Sk4f operator> (const Sk4f& o) const { KERNEL_MASK(fVal[i] > o.fVal[i]); }
+        KAI Sk4f operator<=(const Sk4f& o) const { KERNEL_MASK(fVal[i] <= o.fVal[i]); }
+        KAI Sk4f operator>=(const Sk4f& o) const { KERNEL_MASK(fVal[i] >= o.fVal[i]); }
+
+        KAI Sk4f operator&(const Sk4f& o) const { KERNEL_MAP(from_bits(bits(fVal[i]) & bits(o.fVal[i]))); }
+        KAI Sk4f operator|(const Sk4f& o) const { KERNEL_MAP(from_bits(bits(fVal[i]) | bits(o.fVal[i]))); }
+
+        // matches minps/maxps: if either side is NaN the right hand side is returned
+        KAI static Sk4f Min(const Sk4f& l, const Sk4f& t) { Sk4f r; for (int i = 0; i < 4; i++) { r.fVal[i] = l.fVal[i] < t.fVal[i] ? l.fVal[i] : t.fVal[i]; } return r; }
+        KAI static Sk4f Max(const Sk4f& l, const Sk4f& t) { Sk4f r; for (int i = 0; i < 4; i++) { r.fVal[i] = l.fVal[i] > t.fVal[i] ? l.fVal[i] : t.fVal[i]; } return r; }
+
+        KAI Sk4f abs() const { KERNEL_MAP(std::fabs(fVal[i])); }
+        KAI Sk4f sqrt() const { KERNEL_MAP(std::sqrt(fVal[i])); }
+        KAI Sk4f floor() const { KERNEL_MAP(std::floor(fVal[i])); }
+
+        KAI Sk4f thenElse(const Sk4f& t, const Sk4f& e) const { KERNEL_MAP(bits(fVal[i]) ? t.fVal[i] : e.fVal[i]); }
+
+        KAI Sk4f swapPairs() const { return Sk4f(fVal[1], fVal[0], fVal[3], fVal[2]); }
+        KAI Sk4f swapHalves() const { return Sk4f(fVal[2], fVal[3], fVal[0], fVal[1]); }
+
+        KAI bool allTrue() const { return bits(fVal[0]) && bits(fVal[1]) && bits(fVal[2]) && bits(fVal[3]); }
+        KAI bool anyTrue() const { return bits(fVal[0]) || bits(fVal[1]) || bits(fVal[2]) || bits(fVal[3]); }
+
+        KAI float operator[](int k) const {
+            SkASSERT(0 <= k && k < 4);
+            return fVal[k & 3];
+        }
+#undef KERNEL_MASK
+#undef KERNEL_MAP
+#endif
+        KAI float min() const { return std::min(std::min((*this)[0], (*this)[1]), std::min((*this)[2], (*this)[3])); }
+        KAI float max() const { return std::max(std::max((*this)[0], (*this)[1]), std::max((*this)[2], (*this)[3])); }
+
+        // a * b + c, not fused
+        KAI static Sk4f Mad(const Sk4f& a, const Sk4f& b, const Sk4f& c) { return a * b + c; }
+    };
+
+    struct Sk8f {
+#if defined(KERNEL_AVX)
+        __m256 fVec;
+        KAI Sk8f(const __m256& v) : fVec(v) {}
+        KAI Sk8f() : fVec(_mm256_setzero_ps()) {}
+        KAI Sk8f(float v) : fVec(_mm256_set1_ps(v)) {}
+        KAI Sk8f(float a, float b, float c, float d, float e, float f, float g, float h)
+            : fVec(_mm256_setr_ps(a, b, c, d, e, f, g, h)) {}
+        KAI Sk8f(const Sk4f& lo, const Sk4f& hi)
+            : fVec(_mm256_insertf128_ps(_mm256_castps128_ps256(lo.fVec), hi.fVec, 1)) {}
+
+        KAI static Sk8f Load(const void* ptr) { return _mm256_loadu_ps((const float*)ptr); }
+        KAI void store(void* ptr) const { _mm256_storeu_ps((float*)ptr, fVec); }
+
+        KAI Sk4f lo() const { return _mm256_castps256_ps128(fVec); }
+        KAI Sk4f hi() const { return _mm256_extractf128_ps(fVec, 1); }
+
+        KAI Sk8f operator+(const Sk8f& o) const { return _mm256_add_ps(fVec, o.fVec); }
+        KAI Sk8f operator-(const Sk8f& o) const { return _mm256_sub_ps(fVec, o.fVec); }
+        KAI Sk8f operator*(const Sk8f& o) const { return _mm256_mul_ps(fVec, o.fVec); }
+        KAI Sk8f operator/(const Sk8f& o) const { return _mm256_div_ps(fVec, o.fVec); }
+        KAI Sk8f operator-() const { return _mm256_xor_ps(_mm256_set1_ps(-0.0f), fVec); }
+
+        KAI Sk8f operator==(const Sk8f& o) const { return _mm256_cmp_ps(fVec, o.fVec, _CMP_EQ_OQ); }
+        KAI Sk8f operator!=(const Sk8f& o) const { return _mm256_cmp_ps(fVec, o.fVec, _CMP_NEQ_UQ); }
+        KAI Sk8f operator< (const Sk8f& o) const { return _mm256_cmp_ps(fVec, o.fVec, _CMP_LT_OQ); }
+        KAI Sk8f operator> (const Sk8f& o) const { return _mm256_cmp_ps(fVec, o.fVec, _CMP_GT_OQ); }
+        KAI Sk8f operator<=(const Sk8f& o) const { return _mm256_cmp_ps(fVec, o.fVec, _CMP_LE_OQ); }
+        KAI Sk8f operator>=(const Sk8f& o) const { return _mm256_cmp_ps(fVec, o.fVec, _CMP_GE_OQ); }
+
+        KAI Sk8f operator&(const Sk8f& o) const { return _mm256_and_ps(fVec, o.fVec); }
+        KAI Sk8f operator|(const Sk8f& o) const { return _mm256_or_ps(fVec, o.fVec); }
+
+        KAI static Sk8f Min(const Sk8f& l, const Sk8f& r) { return _mm256_min_ps(l.fVec, r.fVec); }
+        KAI static Sk8f Max(const Sk8f& l, const Sk8f& r) { return _mm256_max_ps(l.fVec, r.fVec); }
+
+        KAI Sk8f abs() const { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), fVec); }
+        KAI Sk8f sqrt() const { return _mm256_sqrt_ps(fVec); }
+        KAI Sk8f floor() const { return _mm256_floor_ps(fVec); }
+
+        KAI Sk8f thenElse(const Sk8f& t, const Sk8f& e) const { return _mm256_blendv_ps(e.fVec, t.fVec, fVec); }
+
+        KAI Sk8f swapPairs() const { return _mm256_permute_ps(fVec, 0xB1); }
+
+        KAI bool allTrue() const { return 0xFF == _mm256_movemask_ps(fVec); }
+        KAI bool anyTrue() const { return 0x00 != _mm256_movemask_ps(fVec); }
+
+        KAI float operator[](int k) const {
+            SkASSERT(0 <= k && k < 8);
+            union { __m256 v; float fs[8]; } pun = { fVec };
+            return pun.fs[k & 7];
+        }
+#else
+        // no AVX, proxy down to a pair of Sk4f like SkNx does
+        Sk4f fLo, fHi;
+        KAI Sk8f() = default;
+        KAI Sk8f(float v) : fLo(v), fHi(v) {}
+        KAI Sk8f(float a, float b, float c, float d, float e, float f, float g, float h)
+            : fLo(a, b, c, d), fHi(e, f, g, h) {}
+        KAI Sk8f(const Sk4f& lo, const Sk4f& hi) : fLo(lo), fHi(hi) {}
+
+        KAI static Sk8f Load(const void* ptr) {
+            return { Sk4f::Load(ptr), Sk4f::Load((const float*)ptr + 4) };
+        }
+        KAI void store(void* ptr) const { fLo.store(ptr); fHi.store((float*)ptr + 4); }
+
+        KAI Sk4f lo() const { return fLo; }
+        KAI Sk4f hi() const { return fHi; }
+
+        KAI Sk8f operator+(const Sk8f& o) const { return { fLo + o.fLo, fHi + o.fHi }; }
+        KAI Sk8f operator-(const Sk8f& o) const { return { fLo - o.fLo, fHi - o.fHi }; }
+        KAI Sk8f operator*(const Sk8f& o) const { return { fLo * o.fLo, fHi * o.fHi }; }
+        KAI Sk8f operator/(const Sk8f& o) const { return { fLo / o.fLo, fHi / o.fHi }; }
+        KAI Sk8f operator-() const { return { -fLo, -fHi }; }
+
+        KAI Sk8f operator==(const Sk8f& o) const { return { fLo == o.fLo, fHi == o.fHi }; }
+        KAI Sk8f operator!=(const Sk8f& o) const { return { fLo != o.fLo, fHi != o.fHi }; }
+        KAI Sk8f operator< (const Sk8f& o) const { return { fLo < o.fLo, fHi < o.fHi }; }
+        KAI Sk8f operator> (const Sk8f& o) const { return { fLo > o.fLo, fHi > o.fHi }; }
+        KAI Sk8f operator<=(const Sk8f& o) const { return { fLo <= o.fLo, fHi <= o.fHi }; }
+        KAI Sk8f operator>=(const Sk8f& o) const { return { fLo >= o.fLo, fHi >= o.fHi }; }
+
+        KAI Sk8f operator&(const Sk8f& o) const { return { fLo & o.fLo, fHi & o.fHi }; }
+        KAI Sk8f operator|(const Sk8f& o) const { return { fLo | o.fLo, fHi | o.fHi }; }
+
+        KAI static Sk8f Min(const Sk8f& l, const Sk8f& r) { return { Sk4f::Min(l.fLo, r.fLo), Sk4f::Min(l.fHi, r.fHi) }; }
+        KAI static Sk8f Max(const Sk8f& l, const Sk8f& r) { return { Sk4f::Max(l.fLo, r.fLo), Sk4f::Max(l.fHi, r.fHi) }; }
+
+        KAI Sk8f abs() const { return { fLo.abs(), fHi.abs() }; }
+        KAI Sk8f sqrt() const { return { fLo.sqrt(), fHi.sqrt() }; }
+        KAI Sk8f floor() const { return { fLo.floor(), fHi.floor() }; }
+
+        KAI Sk8f thenElse(const Sk8f& t, const Sk8f& e) const {
+            return { fLo.thenElse(t.fLo, e.fLo), fHi.thenElse(t.fHi, e.fHi) };
+        }
+
+        KAI Sk8f swapPairs() const { return { fLo.swapPairs(), fHi.swapPairs() }; }
+
+        KAI bool allTrue() const { return fLo.allTrue() && fHi.allTrue(); }
+        KAI bool anyTrue() const { return fLo.anyTrue() || fHi.anyTrue(); }
+
+        KAI float operator[](int k) const {
+            SkASSERT(0 <= k && k < 8);
+            return k < 4 ? fLo[k] : fHi[k - 4];
+        }
+#endif
+        KAI float min() const { return std::min(lo().min(), hi().min()); }
+        KAI float max() const { return std::max(lo().max(), hi().max()); }
+
+        // a * b + c, not fused
+        KAI static Sk8f Mad(const Sk8f& a, const Sk8f& b, const Sk8f& c) { return a * b + c; }
+    };
+
+}  // namespace kernel
+
+#undef KAI
+
+#endif//SkNxKernel_DEFINED
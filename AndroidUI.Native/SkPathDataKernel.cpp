@@ -0,0 +1,341 @@
+#include "SkPathDataKernel.h"
+#include "SkNxKernel.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+    inline int count_trailing_zeros(uint32_t v) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, v);
+        return (int)index;
+#else
+        return __builtin_ctz(v);
+#endif
+    }
+
+    inline bool is_separator(uint32_t c) {
+        return c == ' ' || c == ',' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+    }
+
+    inline bool is_space(uint32_t c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    // 'e' and 'E' are exponents, never verbs
+    inline bool is_verb_start(uint32_t c) {
+        uint32_t lower = c | 0x20;
+        return lower >= 'a' && lower <= 'z' && lower != 'e';
+    }
+
+    inline bool is_digit(uint32_t c) {
+        return c - '0' < 10;
+    }
+
+    // number of floats each occurrence of a verb consumes, -1 for an invalid verb
+    inline int floats_per_verb(uint32_t verb) {
+        switch (verb) {
+        case 'z': case 'Z':
+            return 0;
+        case 'm': case 'l': case 't': case 'M': case 'L': case 'T':
+            return 2;
+        case 'h': case 'v': case 'H': case 'V':
+            return 1;
+        case 'c': case 'C':
+            return 6;
+        case 's': case 'q': case 'S': case 'Q':
+            return 4;
+        case 'a': case 'A':
+            return 7;
+        default:
+            return -1;
+        }
+    }
+
+    // length of the run of ascii digits starting at pos, 16 (or 8) characters per step
+    inline int digit_run(const uint8_t* s, int pos, int end) {
+        int i = pos;
+#if defined(KERNEL_SSE)
+        const __m128i zero = _mm_set1_epi8('0');
+        const __m128i nine = _mm_set1_epi8(9);
+        while (end - i >= 16) {
+            __m128i t = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)(s + i)), zero);
+            // unsigned t <= 9
+            int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(t, nine), t));
+            if (mask != 0xFFFF) {
+                return i + count_trailing_zeros(~mask) - pos;
+            }
+            i += 16;
+        }
+#elif defined(KERNEL_NEON) && defined(__aarch64__)
+        while (end - i >= 16) {
+            uint8x16_t t = vsubq_u8(vld1q_u8(s + i), vdupq_n_u8('0'));
+            if (vminvq_u8(vcltq_u8(t, vdupq_n_u8(10))) != 0xFF) {
+                break;
+            }
+            i += 16;
+        }
+#endif
+        while (i < end && is_digit(s[i])) {
+            i++;
+        }
+        return i - pos;
+    }
+
+    inline int digit_run(const uint16_t* s, int pos, int end) {
+        int i = pos;
+#if defined(KERNEL_SSE)
+        const __m128i zero = _mm_set1_epi16('0');
+        const __m128i minusOne = _mm_set1_epi16(-1);
+        const __m128i ten = _mm_set1_epi16(10);
+        while (end - i >= 8) {
+            __m128i t = _mm_sub_epi16(_mm_loadu_si128((const __m128i*)(s + i)), zero);
+            // signed 0 <= t < 10, code units at or above 0x8000 wrap negative
+            __m128i digits = _mm_and_si128(_mm_cmpgt_epi16(t, minusOne), _mm_cmplt_epi16(t, ten));
+            int mask = _mm_movemask_epi8(digits);
+            if (mask != 0xFFFF) {
+                return i + count_trailing_zeros(~mask) / 2 - pos;
+            }
+            i += 8;
+        }
+#elif defined(KERNEL_NEON) && defined(__aarch64__)
+        while (end - i >= 8) {
+            uint16x8_t t = vsubq_u16(vld1q_u16(s + i), vdupq_n_u16('0'));
+            if (vminvq_u16(vcltq_u16(t, vdupq_n_u16(10))) != 0xFFFF) {
+                break;
+            }
+            i += 8;
+        }
+#endif
+        while (i < end && is_digit(s[i])) {
+            i++;
+        }
+        return i - pos;
+    }
+
+    // powers of ten that are exact in a float
+    const float kPow10f[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+    template <typename C>
+    float strtod_fallback(const C* s, int start, int end) {
+        char stack[64];
+        std::string heap;
+        char* buffer = stack;
+        int length = end - start;
+        if (length >= (int)sizeof(stack)) {
+            heap.resize(length + 1);
+            buffer = &heap[0];
+        }
+        for (int i = 0; i < length; i++) {
+            buffer[i] = (char)s[start + i];
+        }
+        buffer[length] = '\0';
+        return (float)strtod(buffer, nullptr);
+    }
+
+    /*
+     * parses [sign] digits [. digits] [e [sign] digits] at pos
+     *
+     * up to 19 significant digits are accumulated as an integer, values that fit a float
+     * mantissa with a small exponent are produced with one correctly rounded float
+     * operation, anything else is handed to strtod
+     */
+    template <typename C>
+    int parse_number(const C* s, int* ioPos, int end, float* out) {
+        int start = *ioPos;
+        int pos = start;
+        bool negative = false;
+        if (s[pos] == '-' || s[pos] == '+') {
+            negative = s[pos] == '-';
+            pos++;
+        }
+
+        uint64_t mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+        bool truncated = false;
+
+        int run = digit_run(s, pos, end);
+        bool anyDigits = run > 0;
+        for (int i = 0; i < run; i++) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (uint32_t)(s[pos + i] - '0');
+                if (mantissa != 0) {
+                    digits++;
+                }
+            }
+            else {
+                exponent++;
+                truncated = true;
+            }
+        }
+        pos += run;
+
+        if (pos < end && s[pos] == '.') {
+            pos++;
+            run = digit_run(s, pos, end);
+            anyDigits |= run > 0;
+            for (int i = 0; i < run; i++) {
+                if (digits < 19) {
+                    mantissa = mantissa * 10 + (uint32_t)(s[pos + i] - '0');
+                    if (mantissa != 0) {
+                        digits++;
+                    }
+                    exponent--;
+                }
+                else {
+                    truncated = true;
+                }
+            }
+            pos += run;
+        }
+
+        if (!anyDigits) {
+            return SK_KERNEL_PATH_DATA_BAD_FLOAT;
+        }
+
+        // an 'e' without digits after it is not part of the number
+        if (pos < end && (s[pos] | 0x20) == 'e') {
+            int e = pos + 1;
+            bool negativeExponent = false;
+            if (e < end && (s[e] == '-' || s[e] == '+')) {
+                negativeExponent = s[e] == '-';
+                e++;
+            }
+            run = digit_run(s, e, end);
+            if (run > 0) {
+                int value = 0;
+                for (int i = 0; i < run; i++) {
+                    if (value < 100000) {
+                        value = value * 10 + (int)(s[e + i] - '0');
+                    }
+                }
+                exponent += negativeExponent ? -value : value;
+                pos = e + run;
+            }
+        }
+
+        float result;
+        if (!truncated && mantissa <= (1u << 24) && exponent >= -10 && exponent <= 10) {
+            result = (float)mantissa;
+            result = exponent < 0 ? result / kPow10f[-exponent] : result * kPow10f[exponent];
+        }
+        else {
+            result = strtod_fallback(s, negative ? start + 1 : start, pos);
+        }
+
+        if (std::isinf(result)) {
+            return SK_KERNEL_PATH_DATA_FLOAT_OUT_OF_RANGE;
+        }
+        *out = negative ? -result : result;
+        *ioPos = pos;
+        return SK_KERNEL_PATH_DATA_OK;
+    }
+
+    template <typename C>
+    int parse_path_data(const C* s, int length, uint16_t* verbs, int* verbSizes, int verbCapacity,
+        float* points, int pointCapacity, int* info) {
+        info[0] = 0;
+        info[1] = 0;
+        info[2] = 0;
+        info[3] = 0;
+
+        int pos = 0;
+        while (pos < length && is_space(s[pos])) {
+            pos++;
+        }
+        if (pos == length) {
+            return SK_KERNEL_PATH_DATA_EMPTY;
+        }
+
+        int verbCount = 0;
+        int pointCount = 0;
+        while (pos < length) {
+            uint32_t verb = s[pos];
+            int perVerb = floats_per_verb(verb);
+            if (perVerb < 0) {
+                info[2] = pos;
+                return SK_KERNEL_PATH_DATA_BAD_VERB;
+            }
+            int verbPosition = pos++;
+            int firstPoint = pointCount;
+
+            if (perVerb == 0) {
+                // anything between a close and the next verb is ignored
+                while (pos < length && !is_verb_start(s[pos])) {
+                    pos++;
+                }
+            }
+            else {
+                for (;;) {
+                    while (pos < length && is_separator(s[pos])) {
+                        pos++;
+                    }
+                    if (pos >= length || is_verb_start(s[pos])) {
+                        break;
+                    }
+                    int numberStart = pos;
+                    float value;
+                    int status = parse_number(s, &pos, length, &value);
+                    if (status != SK_KERNEL_PATH_DATA_OK) {
+                        info[0] = verbCount;
+                        info[1] = pointCount;
+                        info[2] = numberStart;
+                        return status;
+                    }
+                    if (pointCount == pointCapacity) {
+                        return SK_KERNEL_PATH_DATA_NO_CAPACITY;
+                    }
+                    points[pointCount++] = value;
+
+                    // skip whatever trails the number up to the next separator, same as strtod
+                    while (pos < length) {
+                        uint32_t c = s[pos];
+                        if (is_separator(c) || c == '-' || c == '+' || c == '.' || is_verb_start(c)) {
+                            break;
+                        }
+                        pos++;
+                    }
+                }
+            }
+
+            int floats = pointCount - firstPoint;
+            if (perVerb > 0 && floats % perVerb != 0) {
+                info[0] = verbCount;
+                info[1] = pointCount;
+                info[2] = verbPosition;
+                info[3] = floats;
+                return SK_KERNEL_PATH_DATA_BAD_POINT_COUNT;
+            }
+            if (verbCount == verbCapacity) {
+                return SK_KERNEL_PATH_DATA_NO_CAPACITY;
+            }
+            verbs[verbCount] = (uint16_t)verb;
+            verbSizes[verbCount] = floats;
+            verbCount++;
+        }
+
+        info[0] = verbCount;
+        info[1] = pointCount;
+        return SK_KERNEL_PATH_DATA_OK;
+    }
+}
+
+extern "C" SK_API int SkKernel_parsePathDataUtf16(const uint16_t* chars, int length,
+    uint16_t* verbs, int* verbSizes, int verbCapacity,
+    float* points, int pointCapacity, int* info) {
+    return parse_path_data(chars, length, verbs, verbSizes, verbCapacity, points, pointCapacity, info);
+}
+
+extern "C" SK_API int SkKernel_parsePathDataUtf8(const uint8_t* chars, int length,
+    uint16_t* verbs, int* verbSizes, int verbCapacity,
+    float* points, int pointCapacity, int* info) {
+    return parse_path_data(chars, length, verbs, verbSizes, verbCapacity, points, pointCapacity, info);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "SkTypes.h"
+
+#include <cstdint>
+
+/*
+
+streaming SVG path data parser, the "d" attribute of a vector drawable path
+
+the parser follows the rules of the android PathParser, each verb is followed by zero or
+more floats separated by spaces, commas, a minus sign that does not follow an exponent,
+or a second decimal point
+
+verbs are written as they appear in the string (one UTF-16 code unit each), verbSizes
+holds the number of floats that follow each verb and points holds every float in order
+
+a string of length N never produces more than N verbs or N points, so capacities of
+length always suffice
+
+info receives { verbCount, pointCount, errorPosition, errorFloatCount }
+
+errorPosition is the index of the verb (or of the first character of the number) that
+caused the failure, errorFloatCount is the number of floats found after the failing verb
+when the result is SK_KERNEL_PATH_DATA_BAD_POINT_COUNT
+
+*/
+
+#define SK_KERNEL_PATH_DATA_OK 0
+#define SK_KERNEL_PATH_DATA_EMPTY 1
+#define SK_KERNEL_PATH_DATA_BAD_VERB 2
+#define SK_KERNEL_PATH_DATA_BAD_POINT_COUNT 3
+#define SK_KERNEL_PATH_DATA_BAD_FLOAT 4
+#define SK_KERNEL_PATH_DATA_FLOAT_OUT_OF_RANGE 5
+#define SK_KERNEL_PATH_DATA_NO_CAPACITY 6
+
+extern "C" SK_API int SkKernel_parsePathDataUtf16(const uint16_t* chars, int length,
+    uint16_t* verbs, int* verbSizes, int verbCapacity,
+    float* points, int pointCapacity, int* info);
+
+extern "C" SK_API int SkKernel_parsePathDataUtf8(const uint8_t* chars, int length,
+    uint16_t* verbs, int* verbSizes, int verbCapacity,
+    float* points, int pointCapacity, int* info);
@@ -0,0 +1,214 @@
+#include "SkPathSamplerKernel.h"
+#include "SkNxKernel.h"
+
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using kernel::Sk4f;
+
+namespace {
+
+    struct Sampler {
+        uint32_t hash;
+        int count;
+        int refs;
+        // the arc length fraction of each point, searched for the segment of a fraction
+        std::vector<float> fractions;
+        // (x, y, tangent x, tangent y) of each point, the tangent is that of the segment
+        // starting at the point, the last point takes the tangent of the last segment
+        std::vector<float> points;
+        // (x, y, 0, 0) from each point to the next, the last point repeats the last segment
+        std::vector<float> deltas;
+
+        size_t bytes() const {
+            return (fractions.size() + points.size() + deltas.size()) * sizeof(float);
+        }
+
+        bool matches(const float* approximation, int numPoints) const {
+            if (numPoints != count) {
+                return false;
+            }
+            for (int i = 0; i < numPoints; i++) {
+                const float* p = approximation + i * 3;
+                if (memcmp(&fractions[i], p, sizeof(float)) != 0
+                    || memcmp(&points[i * 4], p + 1, sizeof(float) * 2) != 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    struct Cache {
+        std::mutex mutex;
+        std::unordered_multimap<uint32_t, Sampler*> entries;
+        std::unordered_set<const Sampler*> samplers;
+        int64_t hits = 0;
+        int64_t misses = 0;
+        int64_t bytes = 0;
+    };
+
+    Cache& cache() {
+        static Cache* cache = new Cache();
+        return *cache;
+    }
+
+    // FNV-1a over the bits of the approximation
+    uint32_t hash_approximation(const float* approximation, int numPoints) {
+        const uint8_t* bytes = (const uint8_t*)approximation;
+        const size_t length = (size_t)numPoints * 3 * sizeof(float);
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < length; i++) {
+            hash = (hash ^ bytes[i]) * 16777619u;
+        }
+        return hash;
+    }
+
+    Sampler* build(uint32_t hash, const float* approximation, int numPoints) {
+        Sampler* s = new Sampler{ hash, numPoints, 1, {}, {}, {} };
+        s->fractions.resize((size_t)numPoints);
+        s->points.resize((size_t)numPoints * 4);
+        s->deltas.resize((size_t)numPoints * 4);
+        for (int i = 0; i < numPoints; i++) {
+            s->fractions[i] = approximation[i * 3];
+        }
+        for (int i = 0; i < numPoints; i++) {
+            // the segment from this point, or the last segment for the last point
+            const int start = i < numPoints - 1 ? i : numPoints - 2;
+            const float* a = approximation + start * 3;
+            const float* b = a + 3;
+            const float dx = b[1] - a[1];
+            const float dy = b[2] - a[2];
+            const float length = std::sqrt(dx * dx + dy * dy);
+            float* point = &s->points[i * 4];
+            point[0] = approximation[i * 3 + 1];
+            point[1] = approximation[i * 3 + 2];
+            // a move or a repeated point has no direction
+            point[2] = length > 0 ? dx / length : 0;
+            point[3] = length > 0 ? dy / length : 0;
+            float* delta = &s->deltas[i * 4];
+            delta[0] = dx;
+            delta[1] = dy;
+            delta[2] = 0;
+            delta[3] = 0;
+        }
+        return s;
+    }
+
+    // the index of the point a fraction lands on exactly, or the start of the segment it
+    // lies within as a negative -(start + 1)
+    int search(const float* fractions, int count, float fraction) {
+        if (fraction < 0) {
+            return -1;
+        }
+        if (fraction > 1) {
+            return -(count - 2) - 1;
+        }
+        if (fraction == 0) {
+            return 0;
+        }
+        if (fraction == 1) {
+            return count - 1;
+        }
+        int low = 0;
+        int high = count - 1;
+        while (low <= high) {
+            const int mid = (low + high) / 2;
+            const float midFraction = fractions[mid];
+            if (fraction < midFraction) {
+                high = mid - 1;
+            } else if (fraction > midFraction) {
+                low = mid + 1;
+            } else {
+                return mid;
+            }
+        }
+        // now high is below the fraction and low is above the fraction
+        return -high - 1;
+    }
+}
+
+extern "C" SK_API void* SkKernel_pathSamplerAcquire(const float* approximation, int numPoints) {
+    if (!approximation || numPoints < 2) {
+        return nullptr;
+    }
+    const uint32_t hash = hash_approximation(approximation, numPoints);
+
+    Cache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    auto range = c.entries.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        Sampler* s = it->second;
+        if (s->matches(approximation, numPoints)) {
+            s->refs++;
+            c.hits++;
+            return s;
+        }
+    }
+    Sampler* s = build(hash, approximation, numPoints);
+    c.misses++;
+    c.entries.emplace(hash, s);
+    c.samplers.insert(s);
+    c.bytes += (int64_t)s->bytes();
+    return s;
+}
+
+extern "C" SK_API void SkKernel_pathSamplerRelease(void* sampler) {
+    if (!sampler) {
+        return;
+    }
+    Cache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    Sampler* s = (Sampler*)sampler;
+    if (c.samplers.find(s) == c.samplers.end() || --s->refs > 0) {
+        return;
+    }
+    auto range = c.entries.equal_range(s->hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == s) {
+            c.entries.erase(it);
+            break;
+        }
+    }
+    c.samplers.erase(s);
+    c.bytes -= (int64_t)s->bytes();
+    delete s;
+}
+
+extern "C" SK_API void SkKernel_pathSamplerSample(const void* sampler, const float* fraction, float* position, float* tangent, int count) {
+    const Sampler* s = (const Sampler*)sampler;
+    const float* fractions = s->fractions.data();
+    const float* points = s->points.data();
+    const float* deltas = s->deltas.data();
+    for (int i = 0; i < count; i++) {
+        const int found = search(fractions, s->count, fraction[i]);
+        Sk4f r;
+        if (found >= 0) {
+            r = Sk4f::Load(points + found * 4);
+        } else {
+            const int start = -found - 1;
+            const float startFraction = fractions[start];
+            const float endFraction = fractions[start + 1];
+            const float t = (fraction[i] - startFraction) / (endFraction - startFraction);
+            r = Sk4f::Load(points + start * 4) + Sk4f::Load(deltas + start * 4) * Sk4f(t);
+        }
+        position[i * 2] = r[0];
+        position[i * 2 + 1] = r[1];
+        if (tangent) {
+            tangent[i * 2] = r[2];
+            tangent[i * 2 + 1] = r[3];
+        }
+    }
+}
+
+extern "C" SK_API void SkKernel_pathSamplerStats(int64_t* stats) {
+    Cache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    stats[SK_KERNEL_PATH_SAMPLER_HITS] = c.hits;
+    stats[SK_KERNEL_PATH_SAMPLER_MISSES] = c.misses;
+    stats[SK_KERNEL_PATH_SAMPLER_BYTES] = c.bytes;
+    stats[SK_KERNEL_PATH_SAMPLER_ENTRIES] = (int64_t)c.samplers.size();
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+shared samplers for motion along a path
+
+a sampler is built from the approximation of a path, the (fraction, x, y) triples of
+SKPathExtensions.Approximate where fraction is the cumulative arc length of the point
+divided by the length of the path, and answers the position and unit tangent of the path
+at any fraction with a binary search of the arc length table and one Sk4f blend
+
+samplers are content addressed, every approximation with the same values shares one
+immutable sampler, so animators moving along the same path hold a single table between
+them, samplers are reference counted and freed with their last release
+
+the cache is thread safe, a sampler may be sampled from any thread
+
+*/
+
+#define SK_KERNEL_PATH_SAMPLER_HITS 0
+#define SK_KERNEL_PATH_SAMPLER_MISSES 1
+#define SK_KERNEL_PATH_SAMPLER_BYTES 2
+#define SK_KERNEL_PATH_SAMPLER_ENTRIES 3
+
+/**
+ * returns the shared sampler for numPoints (fraction, x, y) triples, or null if there are
+ * fewer than 2 points, every sampler returned must be given to release
+ */
+extern "C" SK_API void* SkKernel_pathSamplerAcquire(const float* approximation, int numPoints);
+
+extern "C" SK_API void SkKernel_pathSamplerRelease(void* sampler);
+
+/**
+ * position receives the x and y of the path at each of count fractions and tangent, which
+ * may be null, the unit direction of the segment the position lies on
+ *
+ * a fraction landing on a point gives that point, any other fraction is blended between
+ * the points either side of it, fractions outside 0 to 1 extend the first or last segment
+ */
+extern "C" SK_API void SkKernel_pathSamplerSample(const void* sampler, const float* fraction, float* position, float* tangent, int count);
+
+/**
+ * stats receives hits, misses, bytes and entries
+ */
+extern "C" SK_API void SkKernel_pathSamplerStats(int64_t* stats);
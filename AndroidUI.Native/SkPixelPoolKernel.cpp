@@ -0,0 +1,272 @@
+#include "SkPixelPoolKernel.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#ifndef SK_BUILD_FOR_WIN
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+    constexpr int64_t ALIGNMENT = 64;
+    constexpr int MIN_CLASS_SHIFT = 12;
+    constexpr int64_t MIN_CLASS = int64_t(1) << MIN_CLASS_SHIFT;
+    constexpr int64_t MAP_THRESHOLD = 256 * 1024;
+    constexpr int64_t HUGE_PAGE = 2 * 1024 * 1024;
+
+    int highest_bit(uint64_t v) {
+        int n = -1;
+        while (v) {
+            v >>= 1;
+            n++;
+        }
+        return n;
+    }
+
+    // 0 is MIN_CLASS, then 4 classes per power of two
+    int class_index(int64_t bytes) {
+        if (bytes <= MIN_CLASS) {
+            return 0;
+        }
+        int k = highest_bit((uint64_t)(bytes - 1));
+        int64_t base = int64_t(1) << k;
+        int64_t step = base / 4;
+        int64_t quarter = (bytes - base + step - 1) / step;
+        return 1 + (k - MIN_CLASS_SHIFT) * 4 + (int)(quarter - 1);
+    }
+
+    int64_t class_size(int index) {
+        if (index == 0) {
+            return MIN_CLASS;
+        }
+        int k = MIN_CLASS_SHIFT + (index - 1) / 4;
+        int64_t base = int64_t(1) << k;
+        return base + ((index - 1) % 4 + 1) * (base / 4);
+    }
+
+    enum class Kind { Heap, Mapped, LargePages };
+
+    struct Block {
+        void* memory;
+        int64_t size;
+        int index;
+        Kind kind;
+        // positions in the released lists while pooled
+        std::list<Block*>::iterator lru;
+        std::list<Block*>::iterator sameClass;
+    };
+
+    Block* allocate(int64_t size, int index, bool hugePages) {
+        Block* b = new Block{ nullptr, size, index, Kind::Heap, {}, {} };
+#ifdef SK_BUILD_FOR_WIN
+        if (size >= MAP_THRESHOLD) {
+            SIZE_T large = hugePages && size >= HUGE_PAGE ? GetLargePageMinimum() : 0;
+            if (large != 0 && size % (int64_t)large == 0) {
+                // fails without SeLockMemoryPrivilege, normal pages are used then
+                b->memory = VirtualAlloc(nullptr, (SIZE_T)size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+                b->kind = Kind::LargePages;
+            }
+            if (b->memory == nullptr) {
+                b->memory = VirtualAlloc(nullptr, (SIZE_T)size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+                b->kind = Kind::Mapped;
+            }
+        } else {
+            b->memory = _aligned_malloc((size_t)size, ALIGNMENT);
+        }
+#else
+        if (size >= MAP_THRESHOLD) {
+            void* p = mmap(nullptr, (size_t)size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p != MAP_FAILED) {
+#ifdef MADV_HUGEPAGE
+                if (hugePages && size >= HUGE_PAGE) {
+                    madvise(p, (size_t)size, MADV_HUGEPAGE);
+                }
+#endif
+                b->memory = p;
+                b->kind = Kind::Mapped;
+            }
+        } else if (posix_memalign(&b->memory, ALIGNMENT, (size_t)size) != 0) {
+            b->memory = nullptr;
+        }
+#endif
+        if (b->memory == nullptr) {
+            delete b;
+            return nullptr;
+        }
+        return b;
+    }
+
+    void free_block(Block* b) {
+#ifdef SK_BUILD_FOR_WIN
+        if (b->kind == Kind::Heap) {
+            _aligned_free(b->memory);
+        } else {
+            VirtualFree(b->memory, 0, MEM_RELEASE);
+        }
+#else
+        if (b->kind == Kind::Heap) {
+            free(b->memory);
+        } else {
+            munmap(b->memory, (size_t)b->size);
+        }
+#endif
+        delete b;
+    }
+
+    struct Pool {
+        std::mutex mutex;
+        std::unordered_map<void*, Block*> live;
+        // released blocks, most recently released first, overall and per class
+        std::list<Block*> released;
+        std::vector<std::list<Block*>> classes;
+        int64_t pooledBytes = 0;
+        int64_t liveBytes = 0;
+        int64_t budget = SK_KERNEL_PIXEL_POOL_DEFAULT_BUDGET;
+        int64_t hits = 0;
+        int64_t misses = 0;
+        bool hugePages = true;
+
+        // drops released blocks until at most keep bytes remain, the blocks are
+        // returned so they can be freed outside of the lock
+        void trim(int64_t keep, std::vector<Block*>& dropped) {
+            while (pooledBytes > keep) {
+                Block* b = released.back();
+                released.pop_back();
+                classes[b->index].erase(b->sameClass);
+                pooledBytes -= b->size;
+                dropped.push_back(b);
+            }
+        }
+    };
+
+    Pool& pool() {
+        static Pool* p = new Pool();
+        return *p;
+    }
+
+    void free_all(const std::vector<Block*>& blocks) {
+        for (Block* b : blocks) {
+            free_block(b);
+        }
+    }
+}
+
+extern "C" SK_API void* SkKernel_pixelPoolAcquire(int64_t bytes, bool zero) {
+    if (bytes <= 0) {
+        return nullptr;
+    }
+    int index = class_index(bytes);
+    int64_t size = class_size(index);
+    Pool& p = pool();
+    Block* b = nullptr;
+    bool hugePages;
+    {
+        std::lock_guard<std::mutex> lock(p.mutex);
+        if ((size_t)index < p.classes.size() && !p.classes[index].empty()) {
+            b = p.classes[index].front();
+            p.classes[index].pop_front();
+            p.released.erase(b->lru);
+            p.pooledBytes -= b->size;
+            p.live.emplace(b->memory, b);
+            p.liveBytes += b->size;
+            p.hits++;
+        } else {
+            p.misses++;
+        }
+        hugePages = p.hugePages;
+    }
+    if (b != nullptr) {
+        if (zero) {
+            memset(b->memory, 0, (size_t)bytes);
+        }
+        return b->memory;
+    }
+
+    b = allocate(size, index, hugePages);
+    if (b == nullptr) {
+        return nullptr;
+    }
+    // mapped memory is already zero
+    if (zero && b->kind == Kind::Heap) {
+        memset(b->memory, 0, (size_t)bytes);
+    }
+    std::lock_guard<std::mutex> lock(p.mutex);
+    p.live.emplace(b->memory, b);
+    p.liveBytes += b->size;
+    return b->memory;
+}
+
+extern "C" SK_API void SkKernel_pixelPoolRelease(void* block) {
+    if (block == nullptr) {
+        return;
+    }
+    Pool& p = pool();
+    std::vector<Block*> dropped;
+    {
+        std::lock_guard<std::mutex> lock(p.mutex);
+        auto it = p.live.find(block);
+        SkASSERT(it != p.live.end());
+        if (it == p.live.end()) {
+            return;
+        }
+        Block* b = it->second;
+        p.live.erase(it);
+        p.liveBytes -= b->size;
+        if ((size_t)b->index >= p.classes.size()) {
+            p.classes.resize((size_t)b->index + 1);
+        }
+        p.released.push_front(b);
+        b->lru = p.released.begin();
+        p.classes[b->index].push_front(b);
+        b->sameClass = p.classes[b->index].begin();
+        p.pooledBytes += b->size;
+        p.trim(p.budget, dropped);
+    }
+    free_all(dropped);
+}
+
+extern "C" SK_API int64_t SkKernel_pixelPoolSizeClass(int64_t bytes) {
+    return bytes <= 0 ? 0 : class_size(class_index(bytes));
+}
+
+extern "C" SK_API void SkKernel_pixelPoolSetBudget(int64_t bytes) {
+    Pool& p = pool();
+    std::vector<Block*> dropped;
+    {
+        std::lock_guard<std::mutex> lock(p.mutex);
+        p.budget = bytes < 0 ? 0 : bytes;
+        p.trim(p.budget, dropped);
+    }
+    free_all(dropped);
+}
+
+extern "C" SK_API void SkKernel_pixelPoolTrim(int64_t keepBytes) {
+    Pool& p = pool();
+    std::vector<Block*> dropped;
+    {
+        std::lock_guard<std::mutex> lock(p.mutex);
+        p.trim(keepBytes < 0 ? 0 : keepBytes, dropped);
+    }
+    free_all(dropped);
+}
+
+extern "C" SK_API void SkKernel_pixelPoolSetHugePages(bool enabled) {
+    Pool& p = pool();
+    std::lock_guard<std::mutex> lock(p.mutex);
+    p.hugePages = enabled;
+}
+
+extern "C" SK_API void SkKernel_pixelPoolStats(int64_t* stats) {
+    Pool& p = pool();
+    std::lock_guard<std::mutex> lock(p.mutex);
+    stats[SK_KERNEL_PIXEL_POOL_HITS] = p.hits;
+    stats[SK_KERNEL_PIXEL_POOL_MISSES] = p.misses;
+    stats[SK_KERNEL_PIXEL_POOL_POOLED_BYTES] = p.pooledBytes;
+    stats[SK_KERNEL_PIXEL_POOL_POOLED_BLOCKS] = (int64_t)p.released.size();
+    stats[SK_KERNEL_PIXEL_POOL_LIVE_BYTES] = p.liveBytes;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+size class pool for bitmap pixel memory
+
+requests are rounded up to a size class, classes are 4 KiB and then 4 per power of two
+(5, 6, 7 and 8 KiB, 10, 12, 14 and 16 KiB, ...) so at most a quarter of a block is unused,
+a block released to the pool is handed out again to the next request of the same class
+instead of going back to the system
+
+every block is 64 byte aligned, blocks of 256 KiB and up are mapped straight from the
+system and, when huge pages are enabled, blocks of 2 MiB and up ask for huge pages
+(transparent huge pages on linux, large pages on windows when the process may lock memory)
+
+released blocks are kept, most recently released first, until they exceed a byte budget,
+trimming drops the least recently released ones
+
+the pool is thread safe
+
+*/
+
+#define SK_KERNEL_PIXEL_POOL_HITS 0
+#define SK_KERNEL_PIXEL_POOL_MISSES 1
+#define SK_KERNEL_PIXEL_POOL_POOLED_BYTES 2
+#define SK_KERNEL_PIXEL_POOL_POOLED_BLOCKS 3
+#define SK_KERNEL_PIXEL_POOL_LIVE_BYTES 4
+
+#define SK_KERNEL_PIXEL_POOL_DEFAULT_BUDGET (16 * 1024 * 1024)
+
+/**
+ * returns a 64 byte aligned block of at least bytes bytes, zeroed when zero is true,
+ * or null if bytes is not positive or the system is out of memory
+ */
+extern "C" SK_API void* SkKernel_pixelPoolAcquire(int64_t bytes, bool zero);
+
+/**
+ * gives a block returned by acquire back to the pool
+ */
+extern "C" SK_API void SkKernel_pixelPoolRelease(void* block);
+
+/**
+ * the size of the class bytes is rounded up to
+ */
+extern "C" SK_API int64_t SkKernel_pixelPoolSizeClass(int64_t bytes);
+
+/**
+ * sets how many bytes of released blocks are kept, 0 frees every released block
+ */
+extern "C" SK_API void SkKernel_pixelPoolSetBudget(int64_t bytes);
+
+/**
+ * frees the least recently released blocks until at most keepBytes are kept
+ */
+extern "C" SK_API void SkKernel_pixelPoolTrim(int64_t keepBytes);
+
+extern "C" SK_API void SkKernel_pixelPoolSetHugePages(bool enabled);
+
+/**
+ * stats receives hits, misses, pooled bytes, pooled blocks and the bytes of blocks in use
+ */
+extern "C" SK_API void SkKernel_pixelPoolStats(int64_t* stats);
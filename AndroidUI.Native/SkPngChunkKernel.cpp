@@ -0,0 +1,275 @@
+#include "SkPngChunkKernel.h"
+
+#include <cstring>
+#include <new>
+
+#ifdef SK_BUILD_FOR_WIN
+#include <string>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    constexpr uint8_t PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+    // Res_png_9patch, the chunk is followed by the x divs, y divs and colors
+    struct Res_png_9patch {
+        int8_t wasDeserialized;
+        uint8_t numXDivs;
+        uint8_t numYDivs;
+        uint8_t numColors;
+        uint32_t xDivsOffset;
+        uint32_t yDivsOffset;
+        int32_t paddingLeft, paddingRight, paddingTop, paddingBottom;
+        uint32_t colorsOffset;
+    };
+    static_assert(sizeof(Res_png_9patch) == 32, "Res_png_9patch must match the serialized layout");
+
+    // Res_png_9patch::serializedSize, the counts are single bytes and read unaligned
+    inline uint32_t serialized_size(const uint8_t* patch) {
+        return sizeof(Res_png_9patch) + (patch[1] + patch[2] + patch[3]) * sizeof(uint32_t);
+    }
+
+    inline uint32_t load_be32(const uint8_t* p) {
+        return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | (uint32_t)p[3];
+    }
+
+    inline void swap_be32(void* p) {
+        uint8_t* b = (uint8_t*)p;
+        uint32_t v = load_be32(b);
+        memcpy(b, &v, sizeof(v));
+    }
+
+    struct Chunk {
+        const uint8_t* data = nullptr;
+        uint32_t length = 0;
+    };
+
+    struct MappedPng {
+        uint8_t* data = nullptr;
+        size_t length = 0;
+        bool png = false;
+        // the end of the last complete chunk
+        size_t chunksEnd = 0;
+        Res_png_9patch* patch = nullptr;
+        // used when the chunk is not 4 byte aligned in the file
+        uint8_t* patchCopy = nullptr;
+        Chunk npTc, npLb, npOl;
+#ifdef SK_BUILD_FOR_WIN
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+#endif
+
+        // walks the chunk headers, only the 8 byte header of every chunk is read
+        void scan() {
+            if (length < sizeof(PNG_SIGNATURE) || memcmp(data, PNG_SIGNATURE, sizeof(PNG_SIGNATURE)) != 0) {
+                return;
+            }
+            png = true;
+            size_t offset = sizeof(PNG_SIGNATURE);
+            chunksEnd = offset;
+            while (offset + 12 <= length) {
+                uint32_t chunkLength = load_be32(data + offset);
+                const uint8_t* tag = data + offset + 4;
+                // length, tag, data, crc
+                if (chunkLength > length - offset - 12) {
+                    return;
+                }
+                Chunk chunk = { data + offset + 8, chunkLength };
+                if (memcmp(tag, "npTc", 4) == 0 && !npTc.data) {
+                    npTc = chunk;
+                }
+                else if (memcmp(tag, "npLb", 4) == 0 && !npLb.data) {
+                    npLb = chunk;
+                }
+                else if (memcmp(tag, "npOl", 4) == 0 && !npOl.data) {
+                    npOl = chunk;
+                }
+                offset += 12 + (size_t)chunkLength;
+                chunksEnd = offset;
+                if (memcmp(tag, "IEND", 4) == 0) {
+                    return;
+                }
+            }
+        }
+
+        void unmap() {
+            delete[] patchCopy;
+#ifdef SK_BUILD_FOR_WIN
+            if (data) {
+                UnmapViewOfFile(data);
+            }
+            if (mapping) {
+                CloseHandle(mapping);
+            }
+            if (file != INVALID_HANDLE_VALUE) {
+                CloseHandle(file);
+            }
+#else
+            if (data) {
+                munmap(data, length);
+            }
+#endif
+        }
+    };
+
+    // Res_png_9patch::deserialize followed by Res_png_9patch::fileToDevice
+    Res_png_9patch* deserialize(uint8_t* data) {
+        Res_png_9patch* patch = (Res_png_9patch*)data;
+        patch->wasDeserialized = true;
+        patch->xDivsOffset = sizeof(Res_png_9patch);
+        patch->yDivsOffset = patch->xDivsOffset + patch->numXDivs * sizeof(int32_t);
+        patch->colorsOffset = patch->yDivsOffset + patch->numYDivs * sizeof(int32_t);
+
+        uint8_t* values = data + sizeof(Res_png_9patch);
+        for (int i = 0; i < patch->numXDivs + patch->numYDivs + patch->numColors; i++) {
+            swap_be32(values + i * sizeof(int32_t));
+        }
+        swap_be32(&patch->paddingLeft);
+        swap_be32(&patch->paddingRight);
+        swap_be32(&patch->paddingTop);
+        swap_be32(&patch->paddingBottom);
+        return patch;
+    }
+}
+
+extern "C" SK_API void* SkKernel_pngMapFile(const char* path) {
+    MappedPng* png = new (std::nothrow) MappedPng();
+    if (!png) {
+        return nullptr;
+    }
+#ifdef SK_BUILD_FOR_WIN
+    int wideLength = MultiByteToWideChar(CP_UTF8, 0, path, -1, nullptr, 0);
+    std::wstring widePath(wideLength > 0 ? wideLength : 0, L'\0');
+    if (wideLength > 0) {
+        MultiByteToWideChar(CP_UTF8, 0, path, -1, &widePath[0], wideLength);
+    }
+    png->file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER size;
+    if (png->file == INVALID_HANDLE_VALUE || !GetFileSizeEx(png->file, &size) || size.QuadPart <= 0
+        || (uint64_t)size.QuadPart > SIZE_MAX) {
+        png->unmap();
+        delete png;
+        return nullptr;
+    }
+    png->length = (size_t)size.QuadPart;
+    // a copy on write view, the nine patch fix up must not reach the file
+    png->mapping = CreateFileMappingW(png->file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (png->mapping) {
+        png->data = (uint8_t*)MapViewOfFile(png->mapping, FILE_MAP_COPY, 0, 0, 0);
+    }
+    if (!png->data) {
+        png->unmap();
+        delete png;
+        return nullptr;
+    }
+#else
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size <= 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        delete png;
+        return nullptr;
+    }
+    png->length = (size_t)st.st_size;
+    // a private writable mapping is copy on write, the nine patch fix up must not reach the file
+    void* data = mmap(nullptr, png->length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        delete png;
+        return nullptr;
+    }
+    png->data = (uint8_t*)data;
+#endif
+    png->scan();
+    return png;
+}
+
+extern "C" SK_API void SkKernel_pngUnmap(void* png) {
+    MappedPng* p = (MappedPng*)png;
+    if (p) {
+        p->unmap();
+        delete p;
+    }
+}
+
+extern "C" SK_API const uint8_t* SkKernel_pngData(void* png, int64_t* length) {
+    MappedPng* p = (MappedPng*)png;
+    *length = (int64_t)p->length;
+    return p->data;
+}
+
+extern "C" SK_API bool SkKernel_pngIsPng(void* png) {
+    return ((MappedPng*)png)->png;
+}
+
+extern "C" SK_API const uint8_t* SkKernel_pngChunk(void* png, const char* tag, uint32_t* length) {
+    MappedPng* p = (MappedPng*)png;
+    *length = 0;
+    if (!p->png) {
+        return nullptr;
+    }
+    // scan() validated the chunks up to chunksEnd
+    size_t offset = sizeof(PNG_SIGNATURE);
+    while (offset < p->chunksEnd) {
+        uint32_t chunkLength = load_be32(p->data + offset);
+        if (memcmp(p->data + offset + 4, tag, 4) == 0) {
+            *length = chunkLength;
+            return p->data + offset + 8;
+        }
+        offset += 12 + (size_t)chunkLength;
+    }
+    return nullptr;
+}
+
+extern "C" SK_API void* SkKernel_pngNinePatch(void* png, uint32_t* size) {
+    MappedPng* p = (MappedPng*)png;
+    *size = 0;
+    const Chunk& chunk = p->npTc;
+    if (!p->patch) {
+        if (!chunk.data || chunk.length < sizeof(Res_png_9patch)
+            || chunk.length != serialized_size(chunk.data)) {
+            return nullptr;
+        }
+        uint8_t* data = (uint8_t*)chunk.data;
+        // chunks follow odd length chunks unaligned, the fields are only read in place
+        // when they are aligned
+        if (((uintptr_t)data & 3) != 0) {
+            p->patchCopy = new (std::nothrow) uint8_t[chunk.length];
+            if (!p->patchCopy) {
+                return nullptr;
+            }
+            memcpy(p->patchCopy, data, chunk.length);
+            data = p->patchCopy;
+        }
+        p->patch = deserialize(data);
+    }
+    *size = chunk.length;
+    return p->patch;
+}
+
+extern "C" SK_API bool SkKernel_pngInsets(void* png, int32_t* opticalInsets, int32_t* outlineInsets, float* outlineRadius, uint8_t* outlineAlpha) {
+    MappedPng* p = (MappedPng*)png;
+    bool hasInsets = false;
+    // like NinePatchPeeker::readChunk the insets are stored in device order
+    if (p->npLb.data && p->npLb.length == sizeof(int32_t) * 4) {
+        memcpy(opticalInsets, p->npLb.data, sizeof(int32_t) * 4);
+        hasInsets = true;
+    }
+    // 4 int32_t, 1 float, 1 int32_t sized byte
+    if (p->npOl.data && p->npOl.length == 24) {
+        memcpy(outlineInsets, p->npOl.data, sizeof(int32_t) * 4);
+        memcpy(outlineRadius, p->npOl.data + 16, sizeof(float));
+        int32_t alpha;
+        memcpy(&alpha, p->npOl.data + 20, sizeof(int32_t));
+        *outlineAlpha = (uint8_t)(alpha & 0xff);
+        hasInsets = true;
+    }
+    return hasInsets;
+}
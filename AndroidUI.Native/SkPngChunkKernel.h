@@ -0,0 +1,58 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+memory mapped png chunk access
+
+a file is mapped copy on write and, when it is a png, its chunk list is walked once
+without touching the pixel data, the npTc (nine patch), npLb (layout bounds) and npOl
+(outline) chunks are then handed out as views into the mapping
+
+the nine patch chunk is stored in network byte order, it is deserialized and converted
+to device order in place the first time it is asked for, the copy on write mapping keeps
+the file itself untouched
+
+a mapping is not thread safe
+
+*/
+
+/**
+ * maps the file at the utf8 path, returns null if it cannot be opened or is empty
+ */
+extern "C" SK_API void* SkKernel_pngMapFile(const char* path);
+
+extern "C" SK_API void SkKernel_pngUnmap(void* png);
+
+/**
+ * the whole mapped file
+ */
+extern "C" SK_API const uint8_t* SkKernel_pngData(void* png, int64_t* length);
+
+/**
+ * true if the file starts with the png signature, the chunks of a truncated file are
+ * available up to the last complete one like a decoder would see them
+ */
+extern "C" SK_API bool SkKernel_pngIsPng(void* png);
+
+/**
+ * the data of the first chunk with the given 4 character tag, as stored in the file,
+ * or null if there is none
+ */
+extern "C" SK_API const uint8_t* SkKernel_pngChunk(void* png, const char* tag, uint32_t* length);
+
+/**
+ * the Res_png_9patch of the npTc chunk in device order, usable with the SkNinePatchGlue
+ * accessors, or null if there is none or it is malformed
+ *
+ * the patch lives as long as the mapping and must not be freed
+ */
+extern "C" SK_API void* SkKernel_pngNinePatch(void* png, uint32_t* size);
+
+/**
+ * reads the npLb and npOl chunks, returns false if neither is present
+ *
+ * insets not present are left untouched
+ */
+extern "C" SK_API bool SkKernel_pngInsets(void* png, int32_t* opticalInsets, int32_t* outlineInsets, float* outlineRadius, uint8_t* outlineAlpha);
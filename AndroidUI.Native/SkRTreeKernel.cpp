@@ -0,0 +1,131 @@
+#include "SkRTreeKernel.h"
+
+#include <vector>
+
+namespace {
+
+    struct Rect {
+        float l, t, r, b;
+
+        // SkRect::Intersects, empty rectangles never intersect
+        bool intersects(const Rect& o) const {
+            const float L = l > o.l ? l : o.l;
+            const float T = t > o.t ? t : o.t;
+            const float R = r < o.r ? r : o.r;
+            const float B = b < o.b ? b : o.b;
+            return L < R && T < B;
+        }
+
+        void join(const Rect& o) {
+            l = o.l < l ? o.l : l;
+            t = o.t < t ? o.t : t;
+            r = o.r > r ? o.r : r;
+            b = o.b > b ? o.b : b;
+        }
+    };
+
+    struct Branch {
+        Rect bounds;
+        // the item of a leaf branch, the child node otherwise
+        int index;
+    };
+
+    struct Node {
+        int level;
+        int count;
+        Branch children[SK_KERNEL_RTREE_MAX_CHILDREN];
+    };
+
+    struct Tree {
+        std::vector<Node> nodes;
+        Branch root;
+        int count;
+    };
+
+    // packs every run of up to MAX_CHILDREN branches into a node and returns the branches
+    // of the new nodes, until one branch remains
+    Branch bulkLoad(Tree& tree, std::vector<Branch> branches) {
+        int level = 0;
+        while (branches.size() > 1) {
+            std::vector<Branch> parents;
+            parents.reserve(branches.size() / SK_KERNEL_RTREE_MAX_CHILDREN + 1);
+            for (size_t i = 0; i < branches.size(); i += SK_KERNEL_RTREE_MAX_CHILDREN) {
+                Node node;
+                node.level = level;
+                node.count = 0;
+                Branch parent;
+                parent.bounds = branches[i].bounds;
+                for (size_t k = i; k < branches.size() && node.count < SK_KERNEL_RTREE_MAX_CHILDREN; k++) {
+                    node.children[node.count++] = branches[k];
+                    parent.bounds.join(branches[k].bounds);
+                }
+                parent.index = (int)tree.nodes.size();
+                tree.nodes.push_back(node);
+                parents.push_back(parent);
+            }
+            branches.swap(parents);
+            level++;
+        }
+        return branches[0];
+    }
+
+    void search(const Tree& tree, const Node& node, const Rect& query, int* results, int& found) {
+        for (int i = 0; i < node.count; i++) {
+            const Branch& child = node.children[i];
+            if (!child.bounds.intersects(query)) {
+                continue;
+            }
+            if (node.level == 0) {
+                results[found++] = child.index;
+            } else {
+                search(tree, tree.nodes[child.index], query, results, found);
+            }
+        }
+    }
+}
+
+extern "C" SK_API void* SkKernel_rtreeCreate(const float* bounds, int count) {
+    Tree* tree = new Tree();
+    tree->count = count < 0 ? 0 : count;
+    tree->root.bounds = { 0, 0, 0, 0 };
+    tree->root.index = -1;
+    if (tree->count == 0) {
+        return tree;
+    }
+    std::vector<Branch> leaves((size_t)tree->count);
+    for (int i = 0; i < tree->count; i++) {
+        leaves[i].bounds = { bounds[i * 4], bounds[i * 4 + 1], bounds[i * 4 + 2], bounds[i * 4 + 3] };
+        leaves[i].index = i;
+    }
+    if (tree->count == 1) {
+        // a single item still gets a leaf node so search has one shape
+        Node node;
+        node.level = 0;
+        node.count = 1;
+        node.children[0] = leaves[0];
+        tree->nodes.push_back(node);
+        tree->root = { leaves[0].bounds, 0 };
+        return tree;
+    }
+    tree->root = bulkLoad(*tree, std::move(leaves));
+    return tree;
+}
+
+extern "C" SK_API void SkKernel_rtreeDestroy(void* tree) {
+    delete (Tree*)tree;
+}
+
+extern "C" SK_API int SkKernel_rtreeSearch(const void* tree, const float* query, int* results) {
+    const Tree* t = (const Tree*)tree;
+    const Rect q = { query[0], query[1], query[2], query[3] };
+    int found = 0;
+    if (t->root.index >= 0 && t->root.bounds.intersects(q)) {
+        search(*t, t->nodes[t->root.index], q, results, found);
+    }
+    return found;
+}
+
+extern "C" SK_API int SkKernel_rtreeBytes(const void* tree) {
+    const Tree* t = (const Tree*)tree;
+    return (int)(sizeof(Tree) + t->nodes.capacity() * sizeof(Node));
+}
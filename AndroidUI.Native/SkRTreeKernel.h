@@ -0,0 +1,36 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+a static r-tree over rectangles, bulk loaded once like SkRTree
+
+items are numbered by their position in the bounds given to create, consecutive items are
+packed into the same leaves, which suits recorded draws since nearby draws tend to be
+recorded together, so no sorting is done
+
+rectangles are left, top, right, bottom, a rectangle is found when it shares some area with
+the query, so an empty rectangle is never found and an empty query finds nothing
+
+*/
+
+#define SK_KERNEL_RTREE_MAX_CHILDREN 11
+
+/**
+ * builds a tree of count rectangles, bounds holds 4 floats per rectangle
+ */
+extern "C" SK_API void* SkKernel_rtreeCreate(const float* bounds, int count);
+
+extern "C" SK_API void SkKernel_rtreeDestroy(void* tree);
+
+/**
+ * writes the number of every rectangle intersecting query, in ascending order, to results,
+ * which must hold as many ints as the tree has rectangles, returns the number written
+ */
+extern "C" SK_API int SkKernel_rtreeSearch(const void* tree, const float* query, int* results);
+
+/**
+ * the memory held by the tree in bytes
+ */
+extern "C" SK_API int SkKernel_rtreeBytes(const void* tree);
@@ -0,0 +1,392 @@
+#include "SkRegionKernel.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+    // appends bands, merging a band into the previous one when it continues it with the
+    // same intervals
+    class RunWriter {
+    public:
+        RunWriter(int* runs, int capacity) : fRuns(runs), fCapacity(capacity) {}
+
+        void addBand(int top, int bottom, const std::vector<int>& intervals) {
+            if (intervals.empty() || top >= bottom) {
+                return;
+            }
+            int n = (int)intervals.size() / 2;
+            if (fLastBand >= 0 && fLastBottom == top && fLastCount == n
+                && std::equal(intervals.begin(), intervals.end(), fLast.begin())) {
+                fLastBottom = bottom;
+                if (fLastBand + 1 < fCapacity) {
+                    fRuns[fLastBand + 1] = bottom;
+                }
+                return;
+            }
+            fLastBand = fLength;
+            fLastBottom = bottom;
+            fLastCount = n;
+            fLast = intervals;
+            put(top);
+            put(bottom);
+            put(n);
+            for (int v : intervals) {
+                put(v);
+            }
+        }
+
+        int length() const { return fLength; }
+
+    private:
+        void put(int v) {
+            if (fLength < fCapacity) {
+                fRuns[fLength] = v;
+            }
+            fLength++;
+        }
+
+        int* fRuns;
+        int fCapacity;
+        int fLength = 0;
+        int fLastBand = -1;
+        int fLastBottom = 0;
+        int fLastCount = 0;
+        std::vector<int> fLast;
+    };
+
+    inline bool apply(int op, bool a, bool b) {
+        switch (op) {
+        case SK_KERNEL_REGION_DIFFERENCE: return a && !b;
+        case SK_KERNEL_REGION_INTERSECT: return a && b;
+        case SK_KERNEL_REGION_UNION: return a || b;
+        case SK_KERNEL_REGION_XOR: return a != b;
+        case SK_KERNEL_REGION_REVERSE_DIFFERENCE: return b && !a;
+        case SK_KERNEL_REGION_REPLACE: return b;
+        default: return false;
+        }
+    }
+
+    struct Edge {
+        int x;
+        int delta;
+        bool first;
+        bool operator<(const Edge& o) const { return x < o.x; }
+    };
+
+    // every rect is assumed non empty
+    int sweep_rects(const int* rects, const std::vector<int>& order, int op, int* runs, int capacity) {
+        std::vector<int> ys;
+        ys.reserve(order.size() * 2);
+        for (int i : order) {
+            ys.push_back(rects[i * 4 + 1]);
+            ys.push_back(rects[i * 4 + 3]);
+        }
+        std::sort(ys.begin(), ys.end());
+        ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+        // rects sorted by top enter the active list as the sweep reaches them
+        std::vector<int> byTop(order);
+        std::stable_sort(byTop.begin(), byTop.end(), [rects](int a, int b) {
+            return rects[a * 4 + 1] < rects[b * 4 + 1];
+        });
+
+        const int first = order.empty() ? -1 : order[0];
+        const int others = (int)order.size() - 1;
+
+        RunWriter writer(runs, capacity);
+        std::vector<int> active;
+        std::vector<Edge> edges;
+        std::vector<int> intervals;
+        size_t next = 0;
+        for (size_t s = 0; s + 1 < ys.size(); s++) {
+            int y0 = ys[s];
+            int y1 = ys[s + 1];
+            while (next < byTop.size() && rects[byTop[next] * 4 + 1] <= y0) {
+                active.push_back(byTop[next++]);
+            }
+            active.erase(std::remove_if(active.begin(), active.end(), [rects, y0](int i) {
+                return rects[i * 4 + 3] <= y0;
+            }), active.end());
+            if (active.empty()) {
+                continue;
+            }
+
+            edges.clear();
+            for (int i : active) {
+                edges.push_back({ rects[i * 4], 1, i == first });
+                edges.push_back({ rects[i * 4 + 2], -1, i == first });
+            }
+            std::sort(edges.begin(), edges.end());
+
+            intervals.clear();
+            int coverage = 0;
+            int firstCoverage = 0;
+            bool inside = false;
+            int start = 0;
+            for (size_t e = 0; e < edges.size();) {
+                int x = edges[e].x;
+                // apply every edge at this x before testing coverage
+                for (; e < edges.size() && edges[e].x == x; e++) {
+                    coverage += edges[e].delta;
+                    if (edges[e].first) {
+                        firstCoverage += edges[e].delta;
+                    }
+                }
+                bool now;
+                switch (op) {
+                case SK_KERNEL_REGION_DIFFERENCE: now = firstCoverage > 0 && coverage == firstCoverage; break;
+                case SK_KERNEL_REGION_INTERSECT: now = coverage == others + 1; break;
+                case SK_KERNEL_REGION_XOR: now = (coverage & 1) != 0; break;
+                default: now = coverage > 0; break;
+                }
+                if (now != inside) {
+                    if (now) {
+                        start = x;
+                    }
+                    else {
+                        intervals.push_back(start);
+                        intervals.push_back(x);
+                    }
+                    inside = now;
+                }
+            }
+            writer.addBand(y0, y1, intervals);
+        }
+        return writer.length();
+    }
+
+    // returns the intervals of the band covering y, advancing band past bands above y
+    inline const int* band_at(const int* runs, int length, int* band, int y, int* count) {
+        while (*band < length && runs[*band + 1] <= y) {
+            *band += 3 + runs[*band + 2] * 2;
+        }
+        if (*band < length && runs[*band] <= y) {
+            *count = runs[*band + 2];
+            return runs + *band + 3;
+        }
+        *count = 0;
+        return nullptr;
+    }
+
+    void merge_intervals(const int* a, int na, const int* b, int nb, int op, std::vector<int>* out) {
+        out->clear();
+        int ia = 0, ib = 0;
+        na *= 2;
+        nb *= 2;
+        bool inside = false;
+        int start = 0;
+        while (ia < na || ib < nb) {
+            int xa = ia < na ? a[ia] : INT32_MAX;
+            int xb = ib < nb ? b[ib] : INT32_MAX;
+            int x = std::min(xa, xb);
+            if (xa == x) ia++;
+            if (xb == x) ib++;
+            // an odd index means we are inside an interval
+            bool now = apply(op, (ia & 1) != 0, (ib & 1) != 0);
+            if (now != inside) {
+                if (now) {
+                    start = x;
+                }
+                else {
+                    out->push_back(start);
+                    out->push_back(x);
+                }
+                inside = now;
+            }
+        }
+    }
+
+    int region_op(const int* a, int aLength, const int* b, int bLength, int op, int* runs, int capacity) {
+        std::vector<int> ys;
+        for (int i = 0; i < aLength; i += 3 + a[i + 2] * 2) {
+            ys.push_back(a[i]);
+            ys.push_back(a[i + 1]);
+        }
+        for (int i = 0; i < bLength; i += 3 + b[i + 2] * 2) {
+            ys.push_back(b[i]);
+            ys.push_back(b[i + 1]);
+        }
+        std::sort(ys.begin(), ys.end());
+        ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+        RunWriter writer(runs, capacity);
+        std::vector<int> intervals;
+        int bandA = 0, bandB = 0;
+        for (size_t s = 0; s + 1 < ys.size(); s++) {
+            int na, nb;
+            const int* ia = band_at(a, aLength, &bandA, ys[s], &na);
+            const int* ib = band_at(b, bLength, &bandB, ys[s], &nb);
+            merge_intervals(ia, na, ib, nb, op, &intervals);
+            writer.addBand(ys[s], ys[s + 1], intervals);
+        }
+        return writer.length();
+    }
+
+    inline bool interval_hit(const int* iv, int n, int left, int right, bool contain) {
+        // first interval whose right edge is past left
+        int lo = 0, hi = n;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (iv[mid * 2 + 1] <= left) {
+                lo = mid + 1;
+            }
+            else {
+                hi = mid;
+            }
+        }
+        if (lo == n) {
+            return false;
+        }
+        if (contain) {
+            return iv[lo * 2] <= left && right <= iv[lo * 2 + 1];
+        }
+        return iv[lo * 2] < right;
+    }
+}
+
+extern "C" SK_API int SkKernel_regionFromRects(const int* rects, int count, int op, int* runs, int capacity) {
+    std::vector<int> order;
+    order.reserve(count);
+    for (int i = 0; i < count; i++) {
+        const int* r = rects + i * 4;
+        if (r[0] < r[2] && r[1] < r[3]) {
+            order.push_back(i);
+        }
+        else if (op == SK_KERNEL_REGION_INTERSECT || (op == SK_KERNEL_REGION_DIFFERENCE && i == 0)) {
+            // anything intersected with, or subtracted from, nothing is nothing
+            return 0;
+        }
+    }
+
+    switch (op) {
+    case SK_KERNEL_REGION_DIFFERENCE:
+    case SK_KERNEL_REGION_INTERSECT:
+    case SK_KERNEL_REGION_UNION:
+    case SK_KERNEL_REGION_XOR:
+        return sweep_rects(rects, order, op, runs, capacity);
+    case SK_KERNEL_REGION_REPLACE: {
+        // only the last rect survives
+        std::vector<int> last;
+        if (count > 0 && rects[(count - 1) * 4] < rects[(count - 1) * 4 + 2]
+            && rects[(count - 1) * 4 + 1] < rects[(count - 1) * 4 + 3]) {
+            last.push_back(count - 1);
+        }
+        return sweep_rects(rects, last, SK_KERNEL_REGION_UNION, runs, capacity);
+    }
+    case SK_KERNEL_REGION_REVERSE_DIFFERENCE: {
+        // not associative, fold pairwise
+        std::vector<int> acc, tmp(16);
+        for (int i = 0; i < count; i++) {
+            int rect[7];
+            int rectLength = 0;
+            const int* r = rects + i * 4;
+            if (r[0] < r[2] && r[1] < r[3]) {
+                rect[0] = r[1]; rect[1] = r[3]; rect[2] = 1; rect[3] = r[0]; rect[4] = r[2];
+                rectLength = 5;
+            }
+            if (i == 0) {
+                acc.assign(rect, rect + rectLength);
+                continue;
+            }
+            int length = region_op(acc.data(), (int)acc.size(), rect, rectLength, op, tmp.data(), (int)tmp.size());
+            if (length > (int)tmp.size()) {
+                tmp.resize(length);
+                region_op(acc.data(), (int)acc.size(), rect, rectLength, op, tmp.data(), (int)tmp.size());
+            }
+            acc.assign(tmp.begin(), tmp.begin() + length);
+        }
+        if ((int)acc.size() <= capacity) {
+            std::copy(acc.begin(), acc.end(), runs);
+        }
+        return (int)acc.size();
+    }
+    default:
+        return 0;
+    }
+}
+
+extern "C" SK_API int SkKernel_regionOp(const int* a, int aLength, const int* b, int bLength, int op, int* runs, int capacity) {
+    return region_op(a, aLength, b, bLength, op, runs, capacity);
+}
+
+extern "C" SK_API bool SkKernel_regionContains(const int* runs, int length, int x, int y) {
+    for (int i = 0; i < length; i += 3 + runs[i + 2] * 2) {
+        if (y < runs[i]) {
+            return false;
+        }
+        if (y < runs[i + 1]) {
+            return interval_hit(runs + i + 3, runs[i + 2], x, x + 1, true);
+        }
+    }
+    return false;
+}
+
+extern "C" SK_API bool SkKernel_regionContainsRect(const int* runs, int length, int left, int top, int right, int bottom) {
+    if (left >= right || top >= bottom) {
+        return false;
+    }
+    int y = top;
+    for (int i = 0; i < length && y < bottom; i += 3 + runs[i + 2] * 2) {
+        if (runs[i + 1] <= y) {
+            continue;
+        }
+        // a gap between bands, or a band that does not cover the rect
+        if (runs[i] > y || !interval_hit(runs + i + 3, runs[i + 2], left, right, true)) {
+            return false;
+        }
+        y = runs[i + 1];
+    }
+    return y >= bottom;
+}
+
+extern "C" SK_API bool SkKernel_regionIntersectsRect(const int* runs, int length, int left, int top, int right, int bottom) {
+    if (left >= right || top >= bottom) {
+        return false;
+    }
+    for (int i = 0; i < length; i += 3 + runs[i + 2] * 2) {
+        if (runs[i] >= bottom) {
+            return false;
+        }
+        if (runs[i + 1] > top && interval_hit(runs + i + 3, runs[i + 2], left, right, false)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+extern "C" SK_API int SkKernel_regionGetRects(const int* runs, int length, int* rects, int capacity) {
+    int count = 0;
+    for (int i = 0; i < length; i += 3 + runs[i + 2] * 2) {
+        int n = runs[i + 2];
+        for (int k = 0; k < n; k++, count++) {
+            if (count < capacity) {
+                int* r = rects + count * 4;
+                r[0] = runs[i + 3 + k * 2];
+                r[1] = runs[i];
+                r[2] = runs[i + 4 + k * 2];
+                r[3] = runs[i + 1];
+            }
+        }
+    }
+    return count;
+}
+
+extern "C" SK_API void SkKernel_regionGetBounds(const int* runs, int length, int* bounds) {
+    if (length == 0) {
+        bounds[0] = bounds[1] = bounds[2] = bounds[3] = 0;
+        return;
+    }
+    int left = INT32_MAX, right = INT32_MIN, bottom = 0;
+    for (int i = 0; i < length; i += 3 + runs[i + 2] * 2) {
+        int n = runs[i + 2];
+        left = std::min(left, runs[i + 3]);
+        right = std::max(right, runs[i + 3 + n * 2 - 1]);
+        bottom = runs[i + 1];
+    }
+    bounds[0] = left;
+    bounds[1] = runs[0];
+    bounds[2] = right;
+    bounds[3] = bottom;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+run length scanline regions
+
+a region is a flat array of ints made of bands sorted top to bottom:
+
+    top, bottom, intervalCount, left0, right0, left1, right1, ...
+
+bands never overlap and never hold empty spans, intervals inside a band are sorted, never
+touch and never overlap, vertically adjacent bands with identical intervals are merged,
+so every region has exactly one representation and two regions are equal when their
+arrays are equal, the empty region is the empty array
+
+rects are passed as left, top, right, bottom quadruples, empty rects are ignored
+
+functions that produce a region return its length in ints, the output is only written
+when that length fits in capacity, so callers can retry with a larger buffer
+
+ops use the SkRegion::Op values
+
+*/
+
+#define SK_KERNEL_REGION_DIFFERENCE 0
+#define SK_KERNEL_REGION_INTERSECT 1
+#define SK_KERNEL_REGION_UNION 2
+#define SK_KERNEL_REGION_XOR 3
+#define SK_KERNEL_REGION_REVERSE_DIFFERENCE 4
+#define SK_KERNEL_REGION_REPLACE 5
+
+/**
+ * combines count rects left to right with op, ((r0 op r1) op r2) ...
+ *
+ * difference, intersect, union and xor are resolved in a single sweep over all rects
+ */
+extern "C" SK_API int SkKernel_regionFromRects(const int* rects, int count, int op, int* runs, int capacity);
+
+/**
+ * a op b
+ */
+extern "C" SK_API int SkKernel_regionOp(const int* a, int aLength, const int* b, int bLength, int op, int* runs, int capacity);
+
+extern "C" SK_API bool SkKernel_regionContains(const int* runs, int length, int x, int y);
+
+/**
+ * returns true if every pixel of the rect is inside the region, false for an empty rect
+ */
+extern "C" SK_API bool SkKernel_regionContainsRect(const int* runs, int length, int left, int top, int right, int bottom);
+
+/**
+ * returns true if the rect and the region share at least one pixel
+ */
+extern "C" SK_API bool SkKernel_regionIntersectsRect(const int* runs, int length, int left, int top, int right, int bottom);
+
+/**
+ * writes one rect per interval into rects when they fit in capacity rects, returns the rect count
+ */
+extern "C" SK_API int SkKernel_regionGetRects(const int* runs, int length, int* rects, int capacity);
+
+/**
+ * writes left, top, right, bottom of the region bounds, (0, 0, 0, 0) when empty
+ */
+extern "C" SK_API void SkKernel_regionGetBounds(const int* runs, int length, int* bounds);
@@ -0,0 +1,179 @@
+#include "SkResampleKernel.h"
+#include "SkNxKernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using kernel::Sk4f;
+
+namespace {
+
+    // the source pixels each destination pixel along one axis is made of, window d
+    // covers count[d] source pixels starting at start[d], their weights start at
+    // offset[d], windows never go backwards as d grows
+    struct Axis {
+        std::vector<int> start;
+        std::vector<int> count;
+        std::vector<int> offset;
+        std::vector<float> weights;
+
+        Axis(int src, int dst) : start(dst), count(dst), offset(dst) {
+            double scale = (double)src / dst;
+            for (int d = 0; d < dst; d++) {
+                offset[d] = (int)weights.size();
+                if (scale >= 1) {
+                    // area average
+                    double lo = d * scale;
+                    double hi = std::min((d + 1) * scale, (double)src);
+                    int i = (int)std::floor(lo);
+                    int end = std::min(src, (int)std::ceil(hi));
+                    // drop slivers left over from rounding so windows never overlap by nothing
+                    while (i < end - 1 && (i + 1) - lo < 1e-6) {
+                        i++;
+                    }
+                    while (end - 1 > i && hi - (end - 1) < 1e-6) {
+                        end--;
+                    }
+                    start[d] = i;
+                    for (; i < end; i++) {
+                        double w = std::min((double)i + 1, hi) - std::max((double)i, lo);
+                        weights.push_back((float)w);
+                    }
+                } else {
+                    // linear between the two nearest pixel centers
+                    double c = (d + 0.5) * scale - 0.5;
+                    c = std::min(std::max(c, 0.0), (double)(src - 1));
+                    int i = (int)std::floor(c);
+                    double f = c - i;
+                    start[d] = i;
+                    if (f > 1e-6 && i + 1 < src) {
+                        weights.push_back((float)(1 - f));
+                        weights.push_back((float)f);
+                    } else {
+                        weights.push_back(1);
+                    }
+                }
+                count[d] = (int)weights.size() - offset[d];
+                float sum = 0;
+                for (int k = 0; k < count[d]; k++) {
+                    sum += weights[offset[d] + k];
+                }
+                for (int k = 0; k < count[d]; k++) {
+                    weights[offset[d] + k] /= sum;
+                }
+            }
+        }
+
+        int last(int d) const { return start[d] + count[d] - 1; }
+    };
+
+    struct Resampler {
+        int srcLeft, srcWidth, srcHeight, dstWidth, dstHeight;
+        Axis x, y;
+        // the destination rows each source row is accumulated into
+        std::vector<int> firstRow, lastRow;
+        // one horizontally filtered source row
+        std::vector<Sk4f> filtered;
+        // destination rows still being accumulated, row d lives in slot d % slots
+        std::vector<Sk4f> accumulators;
+        int slots = 0;
+        int nextSrcRow = 0;
+        int rowsWritten = 0;
+
+        Resampler(int srcLeft, int srcWidth, int srcHeight, int dstWidth, int dstHeight)
+            : srcLeft(srcLeft), srcWidth(srcWidth), srcHeight(srcHeight),
+              dstWidth(dstWidth), dstHeight(dstHeight),
+              x(srcWidth, dstWidth), y(srcHeight, dstHeight),
+              firstRow(srcHeight, dstHeight), lastRow(srcHeight, -1),
+              filtered(dstWidth) {
+            for (int d = 0; d < dstHeight; d++) {
+                for (int s = y.start[d]; s <= y.last(d); s++) {
+                    firstRow[s] = std::min(firstRow[s], d);
+                    lastRow[s] = std::max(lastRow[s], d);
+                }
+            }
+            for (int s = 0; s < srcHeight; s++) {
+                slots = std::max(slots, lastRow[s] - firstRow[s] + 1);
+            }
+            accumulators.resize((size_t)slots * dstWidth);
+        }
+
+        static Sk4f load(const uint8_t* p) {
+            return Sk4f(p[0], p[1], p[2], p[3]);
+        }
+
+        void filterRow(const uint8_t* row) {
+            const uint8_t* base = row + (size_t)srcLeft * 4;
+            for (int d = 0; d < dstWidth; d++) {
+                const uint8_t* p = base + (size_t)x.start[d] * 4;
+                const float* w = x.weights.data() + x.offset[d];
+                Sk4f sum = load(p) * Sk4f(w[0]);
+                for (int k = 1; k < x.count[d]; k++) {
+                    sum = Sk4f::Mad(load(p + k * 4), Sk4f(w[k]), sum);
+                }
+                filtered[d] = sum;
+            }
+        }
+
+        void writeRow(int d, uint8_t* dst, size_t dstRowBytes) {
+            const Sk4f* acc = accumulators.data() + (size_t)(d % slots) * dstWidth;
+            uint8_t* out = dst + (size_t)d * dstRowBytes;
+            for (int i = 0; i < dstWidth; i++) {
+                Sk4f v = Sk4f::Min(Sk4f::Max(acc[i] + Sk4f(0.5f), Sk4f(0)), Sk4f(255));
+                float f[4];
+                v.store(f);
+                out[i * 4 + 0] = (uint8_t)f[0];
+                out[i * 4 + 1] = (uint8_t)f[1];
+                out[i * 4 + 2] = (uint8_t)f[2];
+                out[i * 4 + 3] = (uint8_t)f[3];
+            }
+        }
+
+        void push(const uint8_t* row, uint8_t* dst, size_t dstRowBytes) {
+            int s = nextSrcRow++;
+            if (s >= srcHeight || firstRow[s] > lastRow[s]) {
+                return;
+            }
+            filterRow(row);
+            for (int d = firstRow[s]; d <= lastRow[s]; d++) {
+                Sk4f w(y.weights[y.offset[d] + s - y.start[d]]);
+                Sk4f* acc = accumulators.data() + (size_t)(d % slots) * dstWidth;
+                if (s == y.start[d]) {
+                    for (int i = 0; i < dstWidth; i++) {
+                        acc[i] = filtered[i] * w;
+                    }
+                } else {
+                    for (int i = 0; i < dstWidth; i++) {
+                        acc[i] = Sk4f::Mad(filtered[i], w, acc[i]);
+                    }
+                }
+                if (s == y.last(d)) {
+                    writeRow(d, dst, dstRowBytes);
+                    rowsWritten++;
+                }
+            }
+        }
+    };
+}
+
+extern "C" SK_API void* SkKernel_resamplerCreate(int srcLeft, int srcWidth, int srcHeight, int dstWidth, int dstHeight) {
+    if (srcLeft < 0 || srcWidth <= 0 || srcHeight <= 0 || dstWidth <= 0 || dstHeight <= 0) {
+        return nullptr;
+    }
+    return new Resampler(srcLeft, srcWidth, srcHeight, dstWidth, dstHeight);
+}
+
+extern "C" SK_API int SkKernel_resamplerPushRows(void* resampler, const void* rows, size_t rowBytes, int count, void* dst, size_t dstRowBytes) {
+    Resampler* r = static_cast<Resampler*>(resampler);
+    const uint8_t* row = static_cast<const uint8_t*>(rows);
+    for (int i = 0; i < count; i++) {
+        r->push(row + (size_t)i * rowBytes, static_cast<uint8_t*>(dst), dstRowBytes);
+    }
+    return r->rowsWritten;
+}
+
+extern "C" SK_API void SkKernel_resamplerDestroy(void* resampler) {
+    delete static_cast<Resampler*>(resampler);
+}
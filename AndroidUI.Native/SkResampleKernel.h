@@ -0,0 +1,36 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+streaming resampler for 4 channel, 8 bit per channel pixels
+
+source rows are pushed top to bottom as a decoder produces them, each row is filtered
+horizontally once and accumulated into the destination rows it covers, a destination row
+is written out as soon as the last source row it covers has been pushed, so only the
+destination rows still being accumulated are ever held, never the whole source image
+
+downscaling averages the area each destination pixel covers, upscaling interpolates
+linearly between the two nearest source pixels, the weights of each destination pixel
+sum to 1 so premultiplied pixels stay premultiplied
+
+the channel order does not matter, all 4 channels are filtered the same way
+
+*/
+
+/**
+ * creates a resampler that maps the srcWidth columns starting at srcLeft of srcHeight
+ * rows onto dstWidth x dstHeight pixels, returns null if any size is not positive
+ */
+extern "C" SK_API void* SkKernel_resamplerCreate(int srcLeft, int srcWidth, int srcHeight, int dstWidth, int dstHeight);
+
+/**
+ * pushes the next count source rows, rows outside of the srcHeight rows are ignored
+ *
+ * finished rows are written to dst, which always points at the first destination row,
+ * returns how many destination rows have been written so far
+ */
+extern "C" SK_API int SkKernel_resamplerPushRows(void* resampler, const void* rows, size_t rowBytes, int count, void* dst, size_t dstRowBytes);
+
+extern "C" SK_API void SkKernel_resamplerDestroy(void* resampler);
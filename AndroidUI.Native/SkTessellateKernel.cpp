@@ -0,0 +1,261 @@
+#include "SkTessellateKernel.h"
+#include "SkNxKernel.h"
+
+#include <cmath>
+
+using kernel::Sk8f;
+
+static inline int clamp_segments(float n2) {
+    // n2 is the squared segment count, NaN and tiny values fall through to one segment
+    if (!(n2 > 1)) {
+        return 1;
+    }
+    if (n2 >= (float)SK_KERNEL_MAX_CURVE_SEGMENTS * SK_KERNEL_MAX_CURVE_SEGMENTS) {
+        return SK_KERNEL_MAX_CURVE_SEGMENTS;
+    }
+    return (int)std::ceil(std::sqrt(n2));
+}
+
+static inline float length(float x, float y) {
+    return std::sqrt(x * x + y * y);
+}
+
+// Wang's formula, a degree d curve needs sqrt(d * (d - 1) / 8 * M / tolerance) segments
+// where M is the largest second difference of its control points
+
+static inline float quad_segments_p2(const float* p, float precision) {
+    float ddx = p[0] - 2 * p[2] + p[4];
+    float ddy = p[1] - 2 * p[3] + p[5];
+    return 0.25f * precision * length(ddx, ddy);
+}
+
+static inline float cubic_segments_p2(const float* p, float precision) {
+    float m0 = length(p[0] - 2 * p[2] + p[4], p[1] - 2 * p[3] + p[5]);
+    float m1 = length(p[2] - 2 * p[4] + p[6], p[3] - 2 * p[5] + p[7]);
+    return 0.75f * precision * (m0 > m1 ? m0 : m1);
+}
+
+// conics use the rational form of Wang's formula, same as skgpu::wangs_formula::conic_p2
+static inline float conic_segments_p2(const float* p, float w, float precision) {
+    // center the points so the result is translation invariant
+    float minX = std::fmin(std::fmin(p[0], p[2]), p[4]);
+    float maxX = std::fmax(std::fmax(p[0], p[2]), p[4]);
+    float minY = std::fmin(std::fmin(p[1], p[3]), p[5]);
+    float maxY = std::fmax(std::fmax(p[1], p[3]), p[5]);
+    float cx = (minX + maxX) * 0.5f;
+    float cy = (minY + maxY) * 0.5f;
+    float x0 = p[0] - cx, y0 = p[1] - cy;
+    float x1 = p[2] - cx, y1 = p[3] - cy;
+    float x2 = p[4] - cx, y2 = p[5] - cy;
+
+    float maxLen2 = std::fmax(std::fmax(x0 * x0 + y0 * y0, x1 * x1 + y1 * y1), x2 * x2 + y2 * y2);
+    float maxLen = std::sqrt(maxLen2);
+
+    float dpx = x0 - 2 * w * x1 + x2;
+    float dpy = y0 - 2 * w * y1 + y2;
+    float dw = std::fabs(2 - 2 * w);
+
+    float rpMinus1 = std::fmax(0.0f, maxLen * precision - 1);
+    float numer = length(dpx, dpy) * precision + rpMinus1 * dw;
+    float denom = 4 * std::fmin(w, 1.0f);
+    return numer / denom;
+}
+
+extern "C" SK_API int SkKernel_quadSegmentCounts(const float* pts, int count, float tolerance, int* segments) {
+    float precision = 1 / tolerance;
+    int total = 0;
+    for (int i = 0; i < count; i++) {
+        int n = clamp_segments(quad_segments_p2(pts + i * 6, precision));
+        segments[i] = n;
+        total += n + 1;
+    }
+    return total;
+}
+
+extern "C" SK_API int SkKernel_cubicSegmentCounts(const float* pts, int count, float tolerance, int* segments) {
+    float precision = 1 / tolerance;
+    int total = 0;
+    for (int i = 0; i < count; i++) {
+        int n = clamp_segments(cubic_segments_p2(pts + i * 8, precision));
+        segments[i] = n;
+        total += n + 1;
+    }
+    return total;
+}
+
+extern "C" SK_API int SkKernel_conicSegmentCounts(const float* pts, const float* weights, int count, float tolerance, int* segments) {
+    float precision = 1 / tolerance;
+    int total = 0;
+    for (int i = 0; i < count; i++) {
+        int n = clamp_segments(conic_segments_p2(pts + i * 6, weights[i], precision));
+        segments[i] = n;
+        total += n + 1;
+    }
+    return total;
+}
+
+// power basis form of a single curve
+//
+//   position = ((A * t + B) * t + C) * t + D, divided by the denominator for conics
+//   tangent  = (TA * t + TB) * t + TC
+//
+// quads and conics leave A at zero
+struct CurveCoeffs {
+    float ax, ay, bx, by, cx, cy, dx, dy;
+    float tax, tay, tbx, tby, tcx, tcy;
+    // conic denominator, (DA * t + DB) * t + 1
+    float da, db;
+    bool rational;
+    // curve end points, emitted exactly instead of evaluated
+    float x0, y0, x1, y1;
+    // tangent used at the end points when the evaluated one is zero
+    float fx0, fy0, fx1, fy1;
+};
+
+static void quad_coeffs(const float* p, CurveCoeffs* c) {
+    float ax = p[4] - 2 * p[2] + p[0], ay = p[5] - 2 * p[3] + p[1];
+    float bx = 2 * (p[2] - p[0]), by = 2 * (p[3] - p[1]);
+    *c = {};
+    c->bx = ax; c->by = ay;
+    c->cx = bx; c->cy = by;
+    c->dx = p[0]; c->dy = p[1];
+    c->tbx = 2 * ax; c->tby = 2 * ay;
+    c->tcx = bx; c->tcy = by;
+    c->x0 = p[0]; c->y0 = p[1];
+    c->x1 = p[4]; c->y1 = p[5];
+    c->fx0 = c->fx1 = p[4] - p[0];
+    c->fy0 = c->fy1 = p[5] - p[1];
+}
+
+static void cubic_coeffs(const float* p, CurveCoeffs* c) {
+    *c = {};
+    c->ax = p[6] + 3 * (p[2] - p[4]) - p[0];
+    c->ay = p[7] + 3 * (p[3] - p[5]) - p[1];
+    c->bx = 3 * (p[4] - 2 * p[2] + p[0]);
+    c->by = 3 * (p[5] - 2 * p[3] + p[1]);
+    c->cx = 3 * (p[2] - p[0]);
+    c->cy = 3 * (p[3] - p[1]);
+    c->dx = p[0]; c->dy = p[1];
+    c->tax = 3 * c->ax; c->tay = 3 * c->ay;
+    c->tbx = 2 * c->bx; c->tby = 2 * c->by;
+    c->tcx = c->cx; c->tcy = c->cy;
+    c->x0 = p[0]; c->y0 = p[1];
+    c->x1 = p[6]; c->y1 = p[7];
+    // same fallbacks as SkEvalCubicTangentAt
+    c->fx0 = p[4] - p[0]; c->fy0 = p[5] - p[1];
+    c->fx1 = p[6] - p[2]; c->fy1 = p[7] - p[3];
+}
+
+static void conic_coeffs(const float* p, float w, CurveCoeffs* c) {
+    *c = {};
+    // numerator, same as SkConicCoeff
+    float p1wx = p[2] * w, p1wy = p[3] * w;
+    c->bx = p[4] - 2 * p1wx + p[0]; c->by = p[5] - 2 * p1wy + p[1];
+    c->cx = 2 * (p1wx - p[0]); c->cy = 2 * (p1wy - p[1]);
+    c->dx = p[0]; c->dy = p[1];
+    c->db = 2 * (w - 1);
+    c->da = -c->db;
+    c->rational = true;
+
+    // tangent, same as SkConic::evalTangentAt
+    float p20x = p[4] - p[0], p20y = p[5] - p[1];
+    float p10x = p[2] - p[0], p10y = p[3] - p[1];
+    c->tcx = w * p10x; c->tcy = w * p10y;
+    c->tax = w * p20x - p20x; c->tay = w * p20y - p20y;
+    c->tbx = p20x - 2 * c->tcx; c->tby = p20y - 2 * c->tcy;
+    c->x0 = p[0]; c->y0 = p[1];
+    c->x1 = p[4]; c->y1 = p[5];
+    c->fx0 = c->fx1 = p20x;
+    c->fy0 = c->fy1 = p20y;
+}
+
+// evaluates one curve 8 values of t at a time
+static int emit_curve(const CurveCoeffs& c, int n, float* outXY, float* outTangents) {
+    const Sk8f iota(0, 1, 2, 3, 4, 5, 6, 7);
+    const Sk8f ax(c.ax), ay(c.ay), bx(c.bx), by(c.by), cx(c.cx), cy(c.cy), dx(c.dx), dy(c.dy);
+    const Sk8f tax(c.tax), tay(c.tay), tbx(c.tbx), tby(c.tby), tcx(c.tcx), tcy(c.tcy);
+    const Sk8f da(c.da), db(c.db), one(1);
+    const float dt = 1.0f / n;
+
+    float xs[8], ys[8];
+    for (int i = 0; i <= n; i += 8) {
+        Sk8f t = (Sk8f((float)i) + iota) * Sk8f(dt);
+        int lanes = n + 1 - i < 8 ? n + 1 - i : 8;
+
+        Sk8f x = Sk8f::Mad(Sk8f::Mad(Sk8f::Mad(ax, t, bx), t, cx), t, dx);
+        Sk8f y = Sk8f::Mad(Sk8f::Mad(Sk8f::Mad(ay, t, by), t, cy), t, dy);
+        if (c.rational) {
+            Sk8f invDenom = one / Sk8f::Mad(Sk8f::Mad(da, t, db), t, one);
+            x = x * invDenom;
+            y = y * invDenom;
+        }
+        x.store(xs);
+        y.store(ys);
+        float* dst = outXY + i * 2;
+        for (int k = 0; k < lanes; k++) {
+            dst[k * 2] = xs[k];
+            dst[k * 2 + 1] = ys[k];
+        }
+
+        if (outTangents) {
+            Sk8f tx = Sk8f::Mad(Sk8f::Mad(tax, t, tbx), t, tcx);
+            Sk8f ty = Sk8f::Mad(Sk8f::Mad(tay, t, tby), t, tcy);
+            tx.store(xs);
+            ty.store(ys);
+            float* tdst = outTangents + i * 2;
+            for (int k = 0; k < lanes; k++) {
+                tdst[k * 2] = xs[k];
+                tdst[k * 2 + 1] = ys[k];
+            }
+        }
+    }
+
+    // pin the end points so consecutive curves join exactly
+    outXY[0] = c.x0;
+    outXY[1] = c.y0;
+    outXY[n * 2] = c.x1;
+    outXY[n * 2 + 1] = c.y1;
+
+    if (outTangents) {
+        if (outTangents[0] == 0 && outTangents[1] == 0) {
+            outTangents[0] = c.fx0;
+            outTangents[1] = c.fy0;
+        }
+        float* last = outTangents + n * 2;
+        if (last[0] == 0 && last[1] == 0) {
+            last[0] = c.fx1;
+            last[1] = c.fy1;
+        }
+    }
+    return n + 1;
+}
+
+extern "C" SK_API int SkKernel_tessellateQuads(const float* pts, int count, const int* segments, float* outXY, float* outTangents) {
+    int written = 0;
+    CurveCoeffs c;
+    for (int i = 0; i < count; i++) {
+        quad_coeffs(pts + i * 6, &c);
+        written += emit_curve(c, segments[i], outXY + written * 2, outTangents ? outTangents + written * 2 : nullptr);
+    }
+    return written;
+}
+
+extern "C" SK_API int SkKernel_tessellateCubics(const float* pts, int count, const int* segments, float* outXY, float* outTangents) {
+    int written = 0;
+    CurveCoeffs c;
+    for (int i = 0; i < count; i++) {
+        cubic_coeffs(pts + i * 8, &c);
+        written += emit_curve(c, segments[i], outXY + written * 2, outTangents ? outTangents + written * 2 : nullptr);
+    }
+    return written;
+}
+
+extern "C" SK_API int SkKernel_tessellateConics(const float* pts, const float* weights, int count, const int* segments, float* outXY, float* outTangents) {
+    int written = 0;
+    CurveCoeffs c;
+    for (int i = 0; i < count; i++) {
+        conic_coeffs(pts + i * 6, weights[i], &c);
+        written += emit_curve(c, segments[i], outXY + written * 2, outTangents ? outTangents + written * 2 : nullptr);
+    }
+    return written;
+}
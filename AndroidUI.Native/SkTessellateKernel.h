@@ -0,0 +1,46 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+batched quad, cubic and conic tessellation
+
+curves are independent, quads and conics take 3 points (6 floats) per curve, cubics take
+4 points (8 floats) per curve, conic weights are passed in a separate array
+
+tessellation is two passes, the segment count pass picks a segment count per curve from
+the tolerance (Wang's formula) and returns the total number of points required, the
+tessellate pass then evaluates every curve at t = i / segments for i in [0, segments]
+
+each curve emits segments + 1 points, the first and last points are the curve end points,
+points and tangents are written as interleaved x, y pairs, tangents are not normalized
+
+*/
+
+/**
+ * the largest segment count a single curve will be split into
+ */
+#define SK_KERNEL_MAX_CURVE_SEGMENTS 1024
+
+/**
+ * stores the segment count of each curve in segments and returns the total number of
+ * points that tessellating every curve will emit
+ *
+ * tolerance is the maximum distance in pixels between the curve and its polyline
+ */
+extern "C" SK_API int SkKernel_quadSegmentCounts(const float* pts, int count, float tolerance, int* segments);
+extern "C" SK_API int SkKernel_cubicSegmentCounts(const float* pts, int count, float tolerance, int* segments);
+extern "C" SK_API int SkKernel_conicSegmentCounts(const float* pts, const float* weights, int count, float tolerance, int* segments);
+
+/**
+ * evaluates every curve at segments[i] + 1 evenly spaced values of t
+ *
+ * outXY must hold the total returned by the matching segment count function,
+ * outTangents may be null, otherwise it must be the same size as outXY
+ *
+ * returns the number of points written
+ */
+extern "C" SK_API int SkKernel_tessellateQuads(const float* pts, int count, const int* segments, float* outXY, float* outTangents);
+extern "C" SK_API int SkKernel_tessellateCubics(const float* pts, int count, const int* segments, float* outXY, float* outTangents);
+extern "C" SK_API int SkKernel_tessellateConics(const float* pts, const float* weights, int count, const int* segments, float* outXY, float* outTangents);
@@ -0,0 +1,539 @@
+#include "SkVelocityKernel.h"
+#include "SkNxKernel.h"
+
+using kernel::Sk8f;
+
+namespace {
+
+    constexpr int kMaxPointers = SK_KERNEL_VELOCITY_MAX_POINTERS;
+    constexpr int kHistory = SK_KERNEL_VELOCITY_HISTORY_SIZE;
+    constexpr int kCoeffs = SK_KERNEL_VELOCITY_MAX_DEGREE + 1;
+    constexpr int kAllSlots = (1 << kMaxPointers) - 1;
+
+    // samples older than this are not used, we want to react to quick changes in direction
+    constexpr int64_t kHorizon = 100 * 1000000;
+
+    // the samples of a slot from consecutive movements, the newest from movement last
+    struct Ring {
+        int64_t time[kHistory];
+        float x[kHistory];
+        float y[kHistory];
+        int newest;
+        int count;
+        int64_t last;
+    };
+
+    // the kinds of solve a slot can need, slots of one kind share vectors
+    enum Solve {
+        kImpulse,
+        kClosedForm,
+        kQr2,
+        kQr3,
+        kQr4,
+        kSolveCount,
+    };
+
+    // up to 8 slots waiting for one kind of solve, each row holds one sample of every lane,
+    // rows past the samples of a lane are zero
+    struct Lanes {
+        int slot[8];
+        int count;
+        int rows;
+        float samples[8];
+        // least squares: time in seconds before the newest sample, x, y and weight
+        // impulse: the x and y travelled and the seconds taken by each step oldest first,
+        // and 1 for a step between samples at the same time
+        float a[kHistory][8];
+        float b[kHistory][8];
+        float c[kHistory][8];
+        float d[kHistory][8];
+        // x and y of the newest sample
+        float x[8];
+        float y[8];
+    };
+
+    struct Tracker {
+        Ring slots[kMaxPointers];
+        int bits;
+        int64_t time;
+        int64_t movement;
+        Lanes pending[kSolveCount];
+    };
+
+    struct Output {
+        int* degrees;
+        float* confidence;
+        float* xCoeff;
+        float* yCoeff;
+
+        void write(int slot, int degree, float conf, const float* x, const float* y) {
+            degrees[slot] = degree;
+            confidence[slot] = conf;
+            for (int i = 0; i < kCoeffs; i++) {
+                xCoeff[slot * kCoeffs + i] = i <= degree ? x[i] : 0;
+                yCoeff[slot * kCoeffs + i] = i <= degree ? y[i] : 0;
+            }
+        }
+
+        void position(int slot, float x, float y) {
+            write(slot, 0, 1, &x, &y);
+        }
+    };
+
+    // the weights of LeastSquaresVelocityTrackerStrategy, ages and deltas are in
+    // milliseconds and blended in double where the managed weights are
+    float chooseWeight(int weighting, float ageMillis, float deltaMillis, bool newest) {
+        switch (weighting) {
+            case SkKernel_VelocityWeighting_Delta:
+                // points that cover a shorter time span are weighed less
+                if (newest) {
+                    return 1.0f;
+                }
+                if (deltaMillis < 0) {
+                    return 0.5f;
+                }
+                if (deltaMillis < 10) {
+                    return (float)(0.5f + deltaMillis * 0.05);
+                }
+                return 1.0f;
+            case SkKernel_VelocityWeighting_Central:
+                // very recent and very old points are weighed less
+                if (ageMillis < 0) {
+                    return 0.5f;
+                }
+                if (ageMillis < 10) {
+                    return (float)(0.5f + ageMillis * 0.05);
+                }
+                if (ageMillis < 50) {
+                    return 1.0f;
+                }
+                if (ageMillis < 60) {
+                    return (float)(0.5f + (60 - ageMillis) * 0.05);
+                }
+                return 0.5f;
+            case SkKernel_VelocityWeighting_Recent:
+                // older points are weighed less
+                if (ageMillis < 50) {
+                    return 1.0f;
+                }
+                if (ageMillis < 100) {
+                    return 0.5f + (100 - ageMillis) * 0.01f;
+                }
+                return 0.5f;
+            default:
+                return 1.0f;
+        }
+    }
+
+    Sk8f dot(const Sk8f* a, const Sk8f* b, int rows) {
+        Sk8f r(0);
+        for (int h = 0; h < rows; h++) {
+            r = r + a[h] * b[h];
+        }
+        return r;
+    }
+
+    /*
+     * the weighted least squares fit of LeastSquaresVelocityTrackerStrategy
+     *
+     * the time of each sample is expanded to the columns of a, a[i][h] = w[h] * t[h]^i, which
+     * Gram-Schmidt factors into an orthonormal q and an upper triangular r, b then follows
+     * from r b = qt w y working up from the last coefficient, q and r depend only on the
+     * times and weights so x and y share them
+     *
+     * the coefficient of determination 1 - sserr / sstot is weighted like the fit
+     */
+    void solveQr(const Lanes& lanes, int n, Output& out) {
+        const int m = lanes.rows;
+        Sk8f a[kCoeffs][kHistory], q[kCoeffs][kHistory], r[kCoeffs][kCoeffs];
+        for (int h = 0; h < m; h++) {
+            const Sk8f t = Sk8f::Load(lanes.a[h]);
+            a[0][h] = Sk8f::Load(lanes.d[h]);
+            for (int i = 1; i < n; i++) {
+                a[i][h] = a[i - 1][h] * t;
+            }
+        }
+
+        Sk8f failed = Sk8f(0) != Sk8f(0);
+        for (int j = 0; j < n; j++) {
+            for (int h = 0; h < m; h++) {
+                q[j][h] = a[j][h];
+            }
+            for (int i = 0; i < j; i++) {
+                const Sk8f d = dot(q[j], q[i], m);
+                for (int h = 0; h < m; h++) {
+                    q[j][h] = q[j][h] - d * q[i][h];
+                }
+            }
+            Sk8f norm = dot(q[j], q[j], m).sqrt();
+            // vectors are linearly dependent or zero so the lane has no solution
+            failed = failed | (norm < Sk8f(0.000001f));
+            norm = failed.thenElse(Sk8f(1), norm);
+            const Sk8f invNorm = Sk8f(1) / norm;
+            for (int h = 0; h < m; h++) {
+                q[j][h] = q[j][h] * invNorm;
+            }
+            for (int i = 0; i < n; i++) {
+                r[j][i] = i < j ? Sk8f(0) : dot(q[j], a[i], m);
+            }
+        }
+
+        const Sk8f count = Sk8f::Load(lanes.samples);
+        float b[2][kCoeffs][8];
+        float det[2][8];
+        for (int axis = 0; axis < 2; axis++) {
+            const float (*values)[8] = axis == 0 ? lanes.b : lanes.c;
+            Sk8f wy[kHistory];
+            Sk8f ymean(0);
+            for (int h = 0; h < m; h++) {
+                const Sk8f y = Sk8f::Load(values[h]);
+                wy[h] = y * Sk8f::Load(lanes.d[h]);
+                ymean = ymean + y;
+            }
+            ymean = ymean / count;
+
+            Sk8f coeff[kCoeffs];
+            for (int i = n - 1; i >= 0; i--) {
+                Sk8f c = dot(q[i], wy, m);
+                for (int j = n - 1; j > i; j--) {
+                    c = c - r[i][j] * coeff[j];
+                }
+                coeff[i] = c / r[i][i];
+                coeff[i].store(b[axis][i]);
+            }
+
+            // padding rows have no weight so add nothing to either sum
+            Sk8f sserr(0), sstot(0);
+            for (int h = 0; h < m; h++) {
+                const Sk8f t = Sk8f::Load(lanes.a[h]);
+                const Sk8f y = Sk8f::Load(values[h]);
+                const Sk8f w = Sk8f::Load(lanes.d[h]);
+                Sk8f err = y - coeff[0];
+                Sk8f term(1);
+                for (int i = 1; i < n; i++) {
+                    term = term * t;
+                    err = err - term * coeff[i];
+                }
+                sserr = sserr + w * w * err * err;
+                const Sk8f var = y - ymean;
+                sstot = sstot + w * w * var * var;
+            }
+            const Sk8f fit = (sstot > Sk8f(0.000001f)).thenElse(Sk8f(1) - sserr / sstot, Sk8f(1));
+            fit.store(det[axis]);
+        }
+
+        float fail[8];
+        failed.store(fail);
+        for (int k = 0; k < lanes.count; k++) {
+            if (fail[k] != 0) {
+                out.position(lanes.slot[k], lanes.x[k], lanes.y[k]);
+                continue;
+            }
+            float x[kCoeffs], y[kCoeffs];
+            for (int i = 0; i < n; i++) {
+                x[i] = b[0][i][k];
+                y[i] = b[1][i][k];
+            }
+            out.write(lanes.slot[k], n - 1, det[0][k] * det[1][k], x, y);
+        }
+    }
+
+    /*
+     * the unweighted degree 2 fit of LeastSquaresVelocityTrackerStrategy, y = a t^2 + b t + c
+     * solved from the sums of the normal equations, padding rows have a time and position
+     * of zero so add nothing to any sum
+     */
+    void solveClosedForm(const Lanes& lanes, Output& out) {
+        const int m = lanes.rows;
+        const Sk8f count = Sk8f::Load(lanes.samples);
+        float coeff[2][3][8];
+        Sk8f failed = Sk8f(0) != Sk8f(0);
+        for (int axis = 0; axis < 2; axis++) {
+            const float (*values)[8] = axis == 0 ? lanes.b : lanes.c;
+            Sk8f sxi(0), sxiyi(0), syi(0), sxi2(0), sxi3(0), sxi2yi(0), sxi4(0);
+            for (int h = 0; h < m; h++) {
+                const Sk8f xi = Sk8f::Load(lanes.a[h]);
+                const Sk8f yi = Sk8f::Load(values[h]);
+                const Sk8f xi2 = xi * xi;
+                const Sk8f xi3 = xi2 * xi;
+                const Sk8f xi4 = xi3 * xi;
+                sxi = sxi + xi;
+                sxi2 = sxi2 + xi2;
+                sxiyi = sxiyi + xi * yi;
+                sxi2yi = sxi2yi + xi2 * yi;
+                syi = syi + yi;
+                sxi3 = sxi3 + xi3;
+                sxi4 = sxi4 + xi4;
+            }
+
+            const Sk8f Sxx = sxi2 - sxi * sxi / count;
+            const Sk8f Sxy = sxiyi - sxi * syi / count;
+            const Sk8f Sxx2 = sxi3 - sxi * sxi2 / count;
+            const Sk8f Sx2y = sxi2yi - sxi2 * syi / count;
+            const Sk8f Sx2x2 = sxi4 - sxi2 * sxi2 / count;
+
+            Sk8f denominator = Sxx * Sx2x2 - Sxx2 * Sxx2;
+            failed = failed | (denominator == Sk8f(0));
+            denominator = failed.thenElse(Sk8f(1), denominator);
+            const Sk8f a = (Sx2y * Sxx - Sxy * Sxx2) / denominator;
+            const Sk8f b = (Sxy * Sx2x2 - Sx2y * Sxx2) / denominator;
+            const Sk8f c = syi / count - b * sxi / count - a * sxi2 / count;
+            c.store(coeff[axis][0]);
+            b.store(coeff[axis][1]);
+            a.store(coeff[axis][2]);
+        }
+
+        float fail[8];
+        failed.store(fail);
+        for (int k = 0; k < lanes.count; k++) {
+            if (fail[k] != 0) {
+                out.position(lanes.slot[k], lanes.x[k], lanes.y[k]);
+                continue;
+            }
+            const float x[3] = { coeff[0][0][k], coeff[0][1][k], coeff[0][2][k] };
+            const float y[3] = { coeff[1][0][k], coeff[1][1][k], coeff[1][2][k] };
+            out.write(lanes.slot[k], 2, 1, x, y);
+        }
+    }
+
+    // the velocity of a body of unit mass given work, sign(work) * sqrt(2 * |work|)
+    Sk8f kineticEnergyToVelocity(const Sk8f& work) {
+        const Sk8f sign = (work < Sk8f(0)).thenElse(Sk8f(-1), Sk8f(1));
+        return sign * work.abs().sqrt() * Sk8f(1.41421356237f);
+    }
+
+    /*
+     * the impulse velocity of ImpulseVelocityTrackerStrategy
+     *
+     * the screen is a body the finger does work on, the work of a step from one sample to
+     * the next is (v[i] - v[i-1]) * |v[i]| where v[i] is the velocity over the step and
+     * v[i-1] the velocity the work so far gives, the first step counts half so a screen
+     * moving evenly is taken to have been moving already, the final velocity is that of
+     * the total work
+     *
+     * steps between samples at the same time are skipped, a lane of 2 samples takes the
+     * velocity of its one step and a lane of 1 has no velocity
+     */
+    void solveImpulse(const Lanes& lanes, Output& out) {
+        const Sk8f samples = Sk8f::Load(lanes.samples);
+        float v[2][8];
+        for (int axis = 0; axis < 2; axis++) {
+            const float (*travel)[8] = axis == 0 ? lanes.a : lanes.b;
+            Sk8f work(0), first(0);
+            for (int s = 1; s < lanes.rows; s++) {
+                const Sk8f vcurr = Sk8f::Load(travel[s]) / Sk8f::Load(lanes.c[s]);
+                const Sk8f active = (Sk8f((float)s) < samples) & (Sk8f::Load(lanes.d[s]) == Sk8f(0));
+                const Sk8f vprev = kineticEnergyToVelocity(work);
+                Sk8f next = work + (vcurr - vprev) * vcurr.abs();
+                if (s == 1) {
+                    next = next * Sk8f(0.5f);
+                    first = active.thenElse(vcurr, Sk8f(0));
+                }
+                work = active.thenElse(next, work);
+            }
+            Sk8f velocity = kineticEnergyToVelocity(work);
+            velocity = (samples == Sk8f(2)).thenElse(first, velocity);
+            velocity = (samples < Sk8f(2)).thenElse(Sk8f(0), velocity);
+            velocity.store(v[axis]);
+        }
+        for (int k = 0; k < lanes.count; k++) {
+            const float x[3] = { 0, v[0][k], 0 };
+            const float y[3] = { 0, v[1][k], 0 };
+            out.write(lanes.slot[k], 2, 1, x, y);
+        }
+    }
+
+    void flush(int solve, Lanes& lanes, Output& out) {
+        switch (solve) {
+            case kImpulse:
+                solveImpulse(lanes, out);
+                break;
+            case kClosedForm:
+                solveClosedForm(lanes, out);
+                break;
+            default:
+                solveQr(lanes, solve - kQr2 + 2, out);
+                break;
+        }
+        lanes.count = 0;
+        lanes.rows = 0;
+    }
+
+    // samples of a slot newest first
+    struct History {
+        int count;
+        int64_t time[kHistory];
+        float x[kHistory];
+        float y[kHistory];
+    };
+
+    void gather(const Tracker& tracker, const Ring& ring, History& history) {
+        int m = 0;
+        int index = ring.newest;
+        while (m < ring.count) {
+            if (tracker.time - ring.time[index] > kHorizon) {
+                break;
+            }
+            history.time[m] = ring.time[index];
+            history.x[m] = ring.x[index];
+            history.y[m] = ring.y[index];
+            m++;
+            index = (index == 0 ? kHistory : index) - 1;
+        }
+        history.count = m;
+    }
+
+    void add(Lanes& lanes, int slot, const History& history, int rows) {
+        const int k = lanes.count++;
+        lanes.slot[k] = slot;
+        lanes.samples[k] = (float)history.count;
+        lanes.x[k] = history.x[0];
+        lanes.y[k] = history.y[0];
+        lanes.rows = std::max(lanes.rows, rows);
+        for (int h = 0; h < kHistory; h++) {
+            lanes.a[h][k] = 0;
+            lanes.b[h][k] = 0;
+            lanes.c[h][k] = 0;
+            lanes.d[h][k] = 0;
+        }
+    }
+
+    void addLeastSquares(Lanes& lanes, int slot, const History& history, int weighting) {
+        add(lanes, slot, history, history.count);
+        const int k = lanes.count - 1;
+        const int64_t newest = history.time[0];
+        for (int h = 0; h < history.count; h++) {
+            const int64_t age = newest - history.time[h];
+            const float deltaMillis = h == 0 ? 0 : (history.time[h - 1] - history.time[h]) * 0.000001f;
+            lanes.a[h][k] = -age * 0.000000001f;
+            lanes.b[h][k] = history.x[h];
+            lanes.c[h][k] = history.y[h];
+            lanes.d[h][k] = chooseWeight(weighting, age * 0.000001f, deltaMillis, h == 0);
+        }
+    }
+
+    void addImpulse(Lanes& lanes, int slot, const History& history) {
+        add(lanes, slot, history, history.count);
+        const int k = lanes.count - 1;
+        // step s runs from sample i = count - s to the newer sample i - 1
+        for (int s = 1; s < history.count; s++) {
+            const int i = history.count - s;
+            lanes.a[s][k] = history.x[i] - history.x[i - 1];
+            lanes.b[s][k] = history.y[i] - history.y[i - 1];
+            lanes.c[s][k] = 1E-9f * (history.time[i] - history.time[i - 1]);
+            lanes.d[s][k] = history.time[i] == history.time[i - 1] ? 1.0f : 0.0f;
+        }
+    }
+}
+
+extern "C" SK_API void* SkKernel_velocityCreate() {
+    Tracker* tracker = new Tracker();
+    tracker->bits = 0;
+    tracker->time = 0;
+    tracker->movement = 0;
+    for (int s = 0; s < kMaxPointers; s++) {
+        tracker->slots[s].newest = 0;
+        tracker->slots[s].count = 0;
+        tracker->slots[s].last = 0;
+    }
+    for (int k = 0; k < kSolveCount; k++) {
+        tracker->pending[k].count = 0;
+        tracker->pending[k].rows = 0;
+    }
+    return tracker;
+}
+
+extern "C" SK_API void SkKernel_velocityDestroy(void* tracker) {
+    delete (Tracker*)tracker;
+}
+
+extern "C" SK_API void SkKernel_velocityClear(void* tracker, int slotBits) {
+    Tracker& t = *(Tracker*)tracker;
+    for (int s = 0; s < kMaxPointers; s++) {
+        if (slotBits & (1 << s)) {
+            t.slots[s].count = 0;
+        }
+    }
+    t.bits &= ~slotBits;
+}
+
+extern "C" SK_API void SkKernel_velocityAddMovement(void* tracker, int64_t eventTime, int slotBits, const float* positions) {
+    Tracker& t = *(Tracker*)tracker;
+    slotBits &= kAllSlots;
+    // a movement at the time of the last one replaces it
+    if (eventTime != t.time) {
+        t.movement++;
+    }
+    for (int s = 0; s < kMaxPointers; s++) {
+        Ring& ring = t.slots[s];
+        if (!(slotBits & (1 << s))) {
+            if (ring.count > 0 && ring.last == t.movement) {
+                // replaced by a movement without this slot
+                ring.newest = (ring.newest == 0 ? kHistory : ring.newest) - 1;
+                ring.count--;
+                ring.last--;
+            }
+            continue;
+        }
+        if (ring.count == 0 || ring.last < t.movement - 1) {
+            // the slot was missing from the movement before, its samples are no longer
+            // part of the current trace
+            ring.count = 0;
+        }
+        if (ring.count == 0 || ring.last != t.movement) {
+            ring.newest = ring.count == 0 ? 0 : (ring.newest + 1) % kHistory;
+            ring.count = std::min(ring.count + 1, kHistory);
+            ring.last = t.movement;
+        }
+        ring.time[ring.newest] = eventTime;
+        ring.x[ring.newest] = positions[0];
+        ring.y[ring.newest] = positions[1];
+        positions += 2;
+    }
+    t.bits = slotBits;
+    t.time = eventTime;
+}
+
+extern "C" SK_API int SkKernel_velocityEstimate(void* tracker, int strategy, int degree, int weighting,
+                                                int64_t* time, int* degrees, float* confidence,
+                                                float* xCoeff, float* yCoeff) {
+    Tracker& t = *(Tracker*)tracker;
+    Output out = { degrees, confidence, xCoeff, yCoeff };
+    *time = t.time;
+    for (int s = 0; s < kMaxPointers; s++) {
+        if (!(t.bits & (1 << s))) {
+            continue;
+        }
+        History history;
+        gather(t, t.slots[s], history);
+
+        int solve;
+        if (strategy == SkKernel_VelocityStrategy_Impulse) {
+            solve = kImpulse;
+        } else {
+            const int d = std::min(std::min(degree, SK_KERNEL_VELOCITY_MAX_DEGREE), history.count - 1);
+            if (d < 1) {
+                // no velocity for this pointer, but we do have its current position
+                out.position(s, history.x[0], history.y[0]);
+                continue;
+            }
+            solve = d == 2 && weighting == SkKernel_VelocityWeighting_None ? kClosedForm : kQr2 + d - 1;
+        }
+
+        Lanes& lanes = t.pending[solve];
+        if (solve == kImpulse) {
+            addImpulse(lanes, s, history);
+        } else {
+            addLeastSquares(lanes, s, history, weighting);
+        }
+        if (lanes.count == 8) {
+            flush(solve, lanes, out);
+        }
+    }
+    for (int k = 0; k < kSolveCount; k++) {
+        if (t.pending[k].count > 0) {
+            flush(k, t.pending[k], out);
+        }
+    }
+    return t.bits;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "SkTypes.h"
+
+/*
+
+movement history and velocity estimation for a velocity tracker
+
+a tracker holds a fixed size ring of (time, x, y) samples for each of its pointer slots,
+the caller maps its pointer ids to slots, a movement appends one sample to every slot it
+names, a slot missing from a movement starts over when it next appears, so a slot's ring
+is always the unbroken run of samples its pointer has in the most recent movements
+
+an estimate is made for every slot of the most recent movement in one call, the samples
+of each slot no older than the horizon are gathered newest first and the slots are packed
+by the solve they need into vectors of 8 so each solve runs 8 pointers at a time, padding
+samples carry no weight so slots with fewer samples share a vector with longer ones
+
+least squares fits a polynomial of degree 1 to 3 in time to x and to y by the weighted
+qr decomposition of Android's strategy, an unweighted fit of degree 2 is solved in
+closed form, impulse models the screen as a body the finger does work on
+
+times are in nanoseconds, coefficients are in position units per second to the power of
+their index, a polynomial is relative to the time of the most recent movement
+
+*/
+
+#define SK_KERNEL_VELOCITY_MAX_POINTERS 10
+#define SK_KERNEL_VELOCITY_HISTORY_SIZE 20
+#define SK_KERNEL_VELOCITY_MAX_DEGREE 3
+
+enum SkKernel_VelocityStrategy {
+    SkKernel_VelocityStrategy_Impulse = 0,
+    SkKernel_VelocityStrategy_LeastSquares = 1,
+};
+
+/**
+ * weightings of the least squares strategy, in the order of
+ * LeastSquaresVelocityTrackerStrategy.Weighting
+ */
+enum SkKernel_VelocityWeighting {
+    SkKernel_VelocityWeighting_None = 0,
+    SkKernel_VelocityWeighting_Delta = 1,
+    SkKernel_VelocityWeighting_Central = 2,
+    SkKernel_VelocityWeighting_Recent = 3,
+};
+
+/**
+ * returns a tracker with every slot empty
+ */
+extern "C" SK_API void* SkKernel_velocityCreate();
+
+extern "C" SK_API void SkKernel_velocityDestroy(void* tracker);
+
+/**
+ * empties the slots set in slotBits
+ */
+extern "C" SK_API void SkKernel_velocityClear(void* tracker, int slotBits);
+
+/**
+ * adds a movement at eventTime of the slots set in slotBits, positions holds an (x, y)
+ * pair for each of them in order of increasing slot
+ *
+ * a movement at the time of the last one replaces it, as a pointer going down reports the
+ * pointers already down again at the same time
+ */
+extern "C" SK_API void SkKernel_velocityAddMovement(void* tracker, int64_t eventTime, int slotBits, const float* positions);
+
+/**
+ * estimates every slot of the most recent movement with strategy, degree and weighting
+ * apply to least squares only, returns the bits of the slots estimated
+ *
+ * for each slot estimated degrees[slot] receives the degree of its polynomial,
+ * confidence[slot] the coefficient of determination of the fit and xCoeff and yCoeff the
+ * SK_KERNEL_VELOCITY_MAX_DEGREE + 1 coefficients from slot * (SK_KERNEL_VELOCITY_MAX_DEGREE + 1),
+ * a slot that cannot be fitted gets degree 0 and its position, time receives the time of
+ * the most recent movement
+ */
+extern "C" SK_API int SkKernel_velocityEstimate(void* tracker, int strategy, int degree, int weighting,
+                                                int64_t* time, int* degrees, float* confidence,
+                                                float* xCoeff, float* yCoeff);
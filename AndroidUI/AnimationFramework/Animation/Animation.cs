@@ -18,6 +18,7 @@ using AndroidUI.AnimationFramework.Interpolators;
 using AndroidUI.Applications;
 using AndroidUI.Exceptions;
 using AndroidUI.Execution;
+using AndroidUI.Extensions;
 using AndroidUI.Utils;
 
 namespace AndroidUI.AnimationFramework.Animation
@@ -1144,7 +1145,7 @@ namespace AndroidUI.AnimationFramework.Animation
             RectF previousRegion = mPreviousRegion;
 
             invalidate.set(left, top, right, bottom);
-            transformation.getMatrix().Value.MapRect(invalidate);
+            transformation.getMatrix().Value.mapRect(invalidate);
             // Enlarge the invalidate region to account for rounding errors
             invalidate.inset(-1.0f, -1.0f);
             tempRegion.set(invalidate);
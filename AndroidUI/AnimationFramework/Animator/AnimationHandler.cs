@@ -15,7 +15,6 @@
  */
 
 using AndroidUI.Applications;
-using AndroidUI.OS;
 using AndroidUI.Utils;
 
 namespace AndroidUI.AnimationFramework.Animator
@@ -62,6 +61,12 @@ namespace AndroidUI.AnimationFramework.Animator
 
         private Application.FrameCallback mFrameCallback;
 
+        /**
+         * Calculates the values of the animators opted in to batched evaluation once every
+         * animator has been pulsed for the frame.
+         */
+        private readonly AnimatorBatch mBatch = new();
+
         // should this be per-thread?
 
         static Context.ContextVariable<AnimationHandler> sAnimationHandlerLocal = new(StorageKeys.AnimationHandler, context => () => new(context));
@@ -120,7 +125,7 @@ namespace AndroidUI.AnimationFramework.Animator
             if (delay > 0)
             {
                 // .put(
-                mDelayedCallbackStartTime[callback] = NanoTime.currentTimeMillis() + delay;
+                mDelayedCallbackStartTime[callback] = getProvider().getFrameTime() + delay;
             }
         }
 
@@ -159,10 +164,17 @@ namespace AndroidUI.AnimationFramework.Animator
             }
         }
 
+        internal AnimatorBatch getBatch()
+        {
+            return mBatch;
+        }
+
         private void doAnimationFrame(long frameTime)
         {
-            long currentTime = NanoTime.currentTimeMillis();
+            // Start delays are measured in frame time so they end on a frame.
+            long currentTime = frameTime;
             int size = mAnimationCallbacks.Count;
+            mBatch.begin();
             for (int i = 0; i < size; i++)
             {
                 AnimationFrameCallback callback = mAnimationCallbacks.ElementAt(i);
@@ -182,6 +194,7 @@ namespace AndroidUI.AnimationFramework.Animator
                     }
                 }
             }
+            mBatch.end();
             cleanUpList();
         }
 
@@ -305,6 +318,8 @@ namespace AndroidUI.AnimationFramework.Animator
                     context.mAttachInfo.mViewRootImpl.mNextRtFrameCallbacks = new();
                 }
                 context.mAttachInfo.mViewRootImpl.mNextRtFrameCallbacks.Add(callback);
+                // frame callbacks run when the next frame is drawn, make sure there is one
+                context.application?.invalidate();
                 //mChoreographer.postFrameCallback(callback);
             }
 
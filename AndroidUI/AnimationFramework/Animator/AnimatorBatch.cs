@@ -0,0 +1,342 @@
+﻿using AndroidUI.AnimationFramework.Interpolators;
+using static AndroidUI.AnimationFramework.Animator.Keyframe;
+
+namespace AndroidUI.AnimationFramework.Animator
+{
+    /**
+     * Calculates the values of the batched animators of an animation frame together, see
+     * {@link ValueAnimator#setBatchedEvaluation(bool)}.
+     *
+     * While the AnimationHandler pulses its animators each batched animator adds a lane, holding
+     * its elapsed fraction and the built in interpolator it uses, and a channel for each value it
+     * animates, holding the start and end keyframe values. The lanes and channels are kept as
+     * parallel arrays so when the frame ends every fraction is interpolated and every value
+     * calculated by the native animator kernel in one pass, without a virtual call or a boxed
+     * value per animator. The values are then handed back to the animators in the order they
+     * were added, leaving only the property setters and update listeners to run per animator.
+     */
+    internal sealed class AnimatorBatch
+    {
+        // the channel kinds of PropertyValuesHolder.getBatchedChannel()
+        internal const int CHANNEL_NONE = 0;
+        internal const int CHANNEL_FLOAT = 1;
+        internal const int CHANNEL_INT = 2;
+        internal const int CHANNEL_ARGB = 3;
+
+        // SkKernel_AnimatorInterpolator
+        internal const int INTERPOLATOR_NONE = -1;
+        internal const int INTERPOLATOR_LINEAR = 0;
+        internal const int INTERPOLATOR_ACCELERATE_DECELERATE = 1;
+        internal const int INTERPOLATOR_ACCELERATE = 2;
+        internal const int INTERPOLATOR_DECELERATE = 3;
+        internal const int INTERPOLATOR_ANTICIPATE = 4;
+        internal const int INTERPOLATOR_OVERSHOOT = 5;
+        internal const int INTERPOLATOR_ANTICIPATE_OVERSHOOT = 6;
+        internal const int INTERPOLATOR_BOUNCE = 7;
+        internal const int INTERPOLATOR_CYCLE = 8;
+
+        private sealed class Channels<T> where T : unmanaged
+        {
+            internal int[] mLane = new int[16];
+            internal T[] mFrom = new T[16];
+            internal T[] mTo = new T[16];
+            internal T[] mValue = new T[16];
+            internal PropertyValuesHolder[] mHolder = new PropertyValuesHolder[16];
+            internal int mCount;
+
+            internal void add(int lane, T from, T to, PropertyValuesHolder holder)
+            {
+                if (mCount == mLane.Length)
+                {
+                    int capacity = mCount * 2;
+                    Array.Resize(ref mLane, capacity);
+                    Array.Resize(ref mFrom, capacity);
+                    Array.Resize(ref mTo, capacity);
+                    Array.Resize(ref mValue, capacity);
+                    Array.Resize(ref mHolder, capacity);
+                }
+                mLane[mCount] = lane;
+                mFrom[mCount] = from;
+                mTo[mCount] = to;
+                mHolder[mCount] = holder;
+                mCount++;
+            }
+
+            internal void clear()
+            {
+                Array.Clear(mHolder, 0, mCount);
+                mCount = 0;
+            }
+        }
+
+        private bool mCollecting;
+
+        private ValueAnimator[] mAnimators = new ValueAnimator[16];
+        private int[] mKinds = new int[16];
+        private float[] mParams = new float[16];
+        private float[] mInputs = new float[16];
+        private float[] mFractions = new float[16];
+        private int mCount;
+
+        private readonly Channels<float> mFloats = new();
+        private readonly Channels<int> mInts = new();
+        private readonly Channels<int> mArgbs = new();
+
+        /**
+         * Returns the number of animators batched in the current frame.
+         */
+        internal int getCount()
+        {
+            return mCount;
+        }
+
+        /**
+         * Starts collecting the batched animators of a frame, dropping any left by a frame that
+         * threw before it could end.
+         */
+        internal void begin()
+        {
+            clear();
+            mCollecting = true;
+        }
+
+        /**
+         * Adds the lane of an animator whose elapsed fraction for this frame is the given
+         * fraction, returning false if the animator cannot be batched, in which case it must
+         * calculate its values itself.
+         */
+        internal bool add(ValueAnimator animator, float fraction)
+        {
+            if (!mCollecting)
+            {
+                return false;
+            }
+            // a subclass may override animateValue()
+            Type type = animator.GetType();
+            if (type != typeof(ValueAnimator) && type != typeof(ObjectAnimator))
+            {
+                return false;
+            }
+            TimeInterpolator interpolator = animator.getInterpolator();
+            int kind = getInterpolatorKind(interpolator, out float param);
+            if (kind == INTERPOLATOR_NONE)
+            {
+                // each path has its own table, so its lane is mapped up front with the
+                // O(1) lookup and blended as if it were linear
+                if (interpolator == null || interpolator.GetType() != typeof(PathInterpolator))
+                {
+                    return false;
+                }
+                kind = INTERPOLATOR_LINEAR;
+                fraction = interpolator.getInterpolation(fraction);
+            }
+            PropertyValuesHolder[] values = animator.mValues;
+            int numValues = values == null ? 0 : values.Length;
+            for (int i = 0; i < numValues; ++i)
+            {
+                if (values[i].getBatchedChannel() == CHANNEL_NONE)
+                {
+                    return false;
+                }
+            }
+
+            if (mCount == mAnimators.Length)
+            {
+                int capacity = mCount * 2;
+                Array.Resize(ref mAnimators, capacity);
+                Array.Resize(ref mKinds, capacity);
+                Array.Resize(ref mParams, capacity);
+                Array.Resize(ref mInputs, capacity);
+                Array.Resize(ref mFractions, capacity);
+            }
+            int lane = mCount++;
+            mAnimators[lane] = animator;
+            mKinds[lane] = kind;
+            mParams[lane] = param;
+            mInputs[lane] = fraction;
+
+            for (int i = 0; i < numValues; ++i)
+            {
+                PropertyValuesHolder holder = values[i];
+                KeyframeSet keyframes = (KeyframeSet)holder.mKeyframes;
+                switch (holder.getBatchedChannel())
+                {
+                    case CHANNEL_FLOAT:
+                        mFloats.add(lane,
+                                ((FloatKeyframe)keyframes.mFirstKeyframe).getFloatValue(),
+                                ((FloatKeyframe)keyframes.mLastKeyframe).getFloatValue(),
+                                holder);
+                        break;
+                    case CHANNEL_INT:
+                        mInts.add(lane,
+                                ((IntKeyframe)keyframes.mFirstKeyframe).getIntValue(),
+                                ((IntKeyframe)keyframes.mLastKeyframe).getIntValue(),
+                                holder);
+                        break;
+                    case CHANNEL_ARGB:
+                        mArgbs.add(lane,
+                                ((IntKeyframe)keyframes.mFirstKeyframe).getIntValue(),
+                                ((IntKeyframe)keyframes.mLastKeyframe).getIntValue(),
+                                holder);
+                        break;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Stops collecting, calculates the values of every animator added since begin() and
+         * hands them to the animators that are still running.
+         */
+        internal void end()
+        {
+            mCollecting = false;
+            if (mCount == 0)
+            {
+                return;
+            }
+            try
+            {
+                evaluate();
+                apply();
+            }
+            finally
+            {
+                clear();
+            }
+        }
+
+        private void clear()
+        {
+            Array.Clear(mAnimators, 0, mCount);
+            mCount = 0;
+            mFloats.clear();
+            mInts.clear();
+            mArgbs.clear();
+        }
+
+        private void apply()
+        {
+            int floats = 0, ints = 0, argbs = 0;
+            for (int lane = 0; lane < mCount; lane++)
+            {
+                ValueAnimator animator = mAnimators[lane];
+                // an earlier animator may have ended or canceled this one from a listener
+                bool running = animator.isRunning();
+                for (; floats < mFloats.mCount && mFloats.mLane[floats] == lane; floats++)
+                {
+                    if (running)
+                    {
+                        mFloats.mHolder[floats].setBatchedValue(mFloats.mValue[floats]);
+                    }
+                }
+                for (; ints < mInts.mCount && mInts.mLane[ints] == lane; ints++)
+                {
+                    if (running)
+                    {
+                        mInts.mHolder[ints].setBatchedValue(mInts.mValue[ints]);
+                    }
+                }
+                for (; argbs < mArgbs.mCount && mArgbs.mLane[argbs] == lane; argbs++)
+                {
+                    if (running)
+                    {
+                        mArgbs.mHolder[argbs].setBatchedValue(mArgbs.mValue[argbs]);
+                    }
+                }
+                if (running)
+                {
+                    animator.animateBatchedValue(mFractions[lane]);
+                }
+            }
+        }
+
+        private unsafe void evaluate()
+        {
+            fixed (int* kinds = mKinds)
+            fixed (float* parameters = mParams, inputs = mInputs, fractions = mFractions)
+            {
+                Native.Additional.SkKernel_animatorInterpolate(kinds, parameters, inputs, fractions, mCount);
+                if (mFloats.mCount > 0)
+                {
+                    fixed (int* lane = mFloats.mLane)
+                    fixed (float* from = mFloats.mFrom, to = mFloats.mTo, value = mFloats.mValue)
+                    {
+                        Native.Additional.SkKernel_animatorLerp(fractions, lane, from, to, value, mFloats.mCount);
+                    }
+                }
+                if (mArgbs.mCount > 0)
+                {
+                    fixed (int* lane = mArgbs.mLane, from = mArgbs.mFrom, to = mArgbs.mTo, value = mArgbs.mValue)
+                    {
+                        Native.Additional.SkKernel_animatorArgb(fractions, lane, from, to, value, mArgbs.mCount);
+                    }
+                }
+            }
+            // IntEvaluator truncates, which is cheaper here than a trip to the kernel
+            for (int i = 0; i < mInts.mCount; i++)
+            {
+                int from = mInts.mFrom[i];
+                mInts.mValue[i] = (int)(from + mFractions[mInts.mLane[i]] * (mInts.mTo[i] - from));
+            }
+        }
+
+        /**
+         * Returns the SkKernel_AnimatorInterpolator kind of a built in interpolator and its
+         * parameter, or INTERPOLATOR_NONE for any other interpolator, including subclasses of
+         * the built in ones.
+         */
+        internal static int getInterpolatorKind(TimeInterpolator interpolator, out float param)
+        {
+            param = 0;
+            if (interpolator == null)
+            {
+                return INTERPOLATOR_NONE;
+            }
+            Type type = interpolator.GetType();
+            if (type == typeof(AccelerateDecelerateInterpolator))
+            {
+                return INTERPOLATOR_ACCELERATE_DECELERATE;
+            }
+            if (type == typeof(LinearInterpolator))
+            {
+                return INTERPOLATOR_LINEAR;
+            }
+            if (type == typeof(AccelerateInterpolator))
+            {
+                param = (float)((AccelerateInterpolator)interpolator).mDoubleFactor;
+                return INTERPOLATOR_ACCELERATE;
+            }
+            if (type == typeof(DecelerateInterpolator))
+            {
+                param = 2 * ((DecelerateInterpolator)interpolator).mFactor;
+                return INTERPOLATOR_DECELERATE;
+            }
+            if (type == typeof(AnticipateInterpolator))
+            {
+                param = ((AnticipateInterpolator)interpolator).mTension;
+                return INTERPOLATOR_ANTICIPATE;
+            }
+            if (type == typeof(OvershootInterpolator))
+            {
+                param = ((OvershootInterpolator)interpolator).mTension;
+                return INTERPOLATOR_OVERSHOOT;
+            }
+            if (type == typeof(AnticipateOvershootInterpolator))
+            {
+                param = ((AnticipateOvershootInterpolator)interpolator).mTension;
+                return INTERPOLATOR_ANTICIPATE_OVERSHOOT;
+            }
+            if (type == typeof(BounceInterpolator))
+            {
+                return INTERPOLATOR_BOUNCE;
+            }
+            if (type == typeof(CycleInterpolator))
+            {
+                param = ((CycleInterpolator)interpolator).mCycles;
+                return INTERPOLATOR_CYCLE;
+            }
+            return INTERPOLATOR_NONE;
+        }
+    }
+}
@@ -1064,6 +1064,24 @@ namespace AndroidUI.AnimationFramework.Animator
             }
         }
 
+        override
+        internal void animateBatchedValue(float fraction)
+        {
+            Object target = getTarget();
+            if (mTarget != null && target == null)
+            {
+                cancel();
+                return;
+            }
+
+            base.animateBatchedValue(fraction);
+            int numValues = mValues.Length;
+            for (int i = 0; i < numValues; ++i)
+            {
+                mValues[i].setAnimatedValue(target);
+            }
+        }
+
         override
         internal bool isInitialized()
         {
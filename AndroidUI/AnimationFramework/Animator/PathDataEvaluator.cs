@@ -0,0 +1,41 @@
+﻿/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+using AndroidUI.Exceptions;
+
+namespace AndroidUI.AnimationFramework.Animator
+{
+    /**
+     * PathData evaluator for morphing vector drawable paths. The same PathData is returned
+     * from every evaluate() call, so a morph frame interpolates in place without allocating.
+     */
+    internal class PathDataEvaluator : TypeEvaluator<PathParser.PathData>
+    {
+        private readonly PathParser.PathData mPathData = new();
+
+        public object evaluate(float fraction, object startValue, object endValue)
+        {
+            if (!PathParser.interpolatePathData(mPathData, (PathParser.PathData)startValue,
+                (PathParser.PathData)endValue, fraction))
+            {
+                throw new IllegalArgumentException("Can't interpolate between"
+                        + " two incompatible pathData");
+            }
+            return mPathData;
+        }
+    }
+}
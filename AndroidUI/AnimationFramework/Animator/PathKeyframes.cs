@@ -34,18 +34,19 @@ namespace AndroidUI.AnimationFramework.Animator
      * Typically, the returned type is a SkiaSharp.SKPoint, but the individual components can be extracted
      * as either an IntKeyframes or FloatKeyframes.
      * </p>
+     * <p>
+     * The approximation is held by a PathSampler, which is shared by every PathKeyframes made
+     * from the same path and answers many fractions in one call through
+     * {@link #getPositions(ReadOnlySpan{float}, Span{SkiaSharp.SKPoint}, Span{SkiaSharp.SKPoint})}.
+     * </p>
      * @hide
      */
     public class PathKeyframes : Keyframes
     {
-        private const int FRACTION_OFFSET = 0;
-        private const int X_OFFSET = 1;
-        private const int Y_OFFSET = 2;
-        private const int NUM_COMPONENTS = 3;
         private static readonly List<Keyframe> EMPTY_KEYFRAMES = new List<Keyframe>();
 
         private SkiaSharp.SKPoint mTempPoint = new SkiaSharp.SKPoint();
-        private float[] mKeyframeData;
+        private PathSampler mSampler;
 
         public PathKeyframes(Graphics.Path path) : this(path, 0.5f)
         {
@@ -57,7 +58,7 @@ namespace AndroidUI.AnimationFramework.Animator
             {
                 throw new IllegalArgumentException("The path must not be null or empty");
             }
-            mKeyframeData = path.approximate(error);
+            mSampler = new PathSampler(path.approximate(error));
         }
 
         public List<Keyframe> getKeyframes()
@@ -67,73 +68,22 @@ namespace AndroidUI.AnimationFramework.Animator
 
         public Object getValue(float fraction)
         {
-            int numPoints = mKeyframeData.Length / 3;
-            if (fraction < 0)
-            {
-                return interpolateInRange(fraction, 0, 1);
-            }
-            else if (fraction > 1)
-            {
-                return interpolateInRange(fraction, numPoints - 2, numPoints - 1);
-            }
-            else if (fraction == 0)
-            {
-                return pointForIndex(0);
-            }
-            else if (fraction == 1)
-            {
-                return pointForIndex(numPoints - 1);
-            }
-            else
-            {
-                // Binary search for the correct section
-                int low = 0;
-                int high = numPoints - 1;
-
-                while (low <= high)
-                {
-                    int mid = (low + high) / 2;
-                    float midFraction = mKeyframeData[(mid * NUM_COMPONENTS) + FRACTION_OFFSET];
-
-                    if (fraction < midFraction)
-                    {
-                        high = mid - 1;
-                    }
-                    else if (fraction > midFraction)
-                    {
-                        low = mid + 1;
-                    }
-                    else
-                    {
-                        return pointForIndex(mid);
-                    }
-                }
-
-                // now high is below the fraction and low is above the fraction
-                return interpolateInRange(fraction, high, low);
-            }
+            mTempPoint = mSampler.sample(fraction);
+            return mTempPoint;
         }
 
-        private SkiaSharp.SKPoint interpolateInRange(float fraction, int startIndex, int endIndex)
+        /**
+         * Finds the point along the Path at each fraction, the same points getValue() gives,
+         * and the direction of the Path at those points.
+         *
+         * @param fractions The fractions of the length of the Path to find points at.
+         * @param positions Receives the points, must be at least as long as fractions.
+         * @param tangents Receives unit vectors along the Path at each point, or is empty
+         *                 when they are not wanted.
+         */
+        public void getPositions(ReadOnlySpan<float> fractions, Span<SkiaSharp.SKPoint> positions, Span<SkiaSharp.SKPoint> tangents)
         {
-            int startBase = (startIndex * NUM_COMPONENTS);
-            int endBase = (endIndex * NUM_COMPONENTS);
-
-            float startFraction = mKeyframeData[startBase + FRACTION_OFFSET];
-            float endFraction = mKeyframeData[endBase + FRACTION_OFFSET];
-
-            float intervalFraction = (fraction - startFraction) / (endFraction - startFraction);
-
-            float startX = mKeyframeData[startBase + X_OFFSET];
-            float endX = mKeyframeData[endBase + X_OFFSET];
-            float startY = mKeyframeData[startBase + Y_OFFSET];
-            float endY = mKeyframeData[endBase + Y_OFFSET];
-
-            float x = interpolate(intervalFraction, startX, endX);
-            float y = interpolate(intervalFraction, startY, endY);
-
-            mTempPoint.Set(x, y);
-            return mTempPoint;
+            mSampler.sample(fractions, positions, tangents);
         }
 
         virtual public void setEvaluator(ITypeEvaluator evaluator)
@@ -149,28 +99,10 @@ namespace AndroidUI.AnimationFramework.Animator
         {
             PathKeyframes clone = (PathKeyframes)Utils.ICloneable.Clone(this);
             clone.mTempPoint = new SkiaSharp.SKPoint();
-            if (mKeyframeData != null)
-            {
-                clone.mKeyframeData = (float[])mKeyframeData.Clone();
-            }
+            // the sampler is immutable, clones share it
             return clone;
         }
 
-        private SkiaSharp.SKPoint pointForIndex(int index)
-        {
-            int base_ = (index * NUM_COMPONENTS);
-            int xOffset = base_ + X_OFFSET;
-            int yOffset = base_ + Y_OFFSET;
-            mTempPoint.Set(mKeyframeData[xOffset], mKeyframeData[yOffset]);
-            return mTempPoint;
-        }
-
-        private static float interpolate(float fraction, float startValue, float endValue)
-        {
-            float diff = endValue - startValue;
-            return startValue + (diff * fraction);
-        }
-
         class XI : IntKeyframes
         {
             PathKeyframes outer;
@@ -0,0 +1,101 @@
+﻿using SkiaSharp;
+
+namespace AndroidUI.AnimationFramework.Animator
+{
+    /**
+     * The arc length table of a path approximation, answering the position and tangent
+     * along the path at any fraction of its length.
+     *
+     * Tables are shared by content, every sampler built from an identical approximation
+     * holds the same native table, so animators moving along the same path keep one copy
+     * of it. A sampler is immutable and may be shared freely, its table is released when
+     * the sampler is finalized.
+     */
+    internal sealed unsafe class PathSampler
+    {
+        private void* mNative;
+
+        /**
+         * Creates a sampler for an approximation made by Graphics.Path.approximate(),
+         * holding (fraction, x, y) for each point.
+         */
+        internal PathSampler(float[] approximation)
+        {
+            fixed (float* a = approximation)
+            {
+                mNative = Native.Additional.SkKernel_pathSamplerAcquire(a, approximation.Length / 3);
+            }
+            if (mNative == null)
+            {
+                throw new Exceptions.IllegalArgumentException("The approximation must hold at least 2 points");
+            }
+        }
+
+        ~PathSampler()
+        {
+            Native.Additional.SkKernel_pathSamplerRelease(mNative);
+            mNative = null;
+        }
+
+        /**
+         * Returns the position along the path at a fraction of its length.
+         */
+        internal SKPoint sample(float fraction)
+        {
+            SKPoint position;
+            Native.Additional.SkKernel_pathSamplerSample(mNative, &fraction, (float*)&position, null, 1);
+            GC.KeepAlive(this);
+            return position;
+        }
+
+        /**
+         * Fills positions, and tangents unless it is empty, for each fraction. The tangents
+         * are unit vectors along the segment each position lies on.
+         */
+        internal void sample(ReadOnlySpan<float> fractions, Span<SKPoint> positions, Span<SKPoint> tangents)
+        {
+            if (positions.Length < fractions.Length)
+            {
+                throw new Exceptions.IllegalArgumentException("positions must hold at least " + fractions.Length + " points");
+            }
+            if (!tangents.IsEmpty && tangents.Length < fractions.Length)
+            {
+                throw new Exceptions.IllegalArgumentException("tangents must be empty or hold at least " + fractions.Length + " points");
+            }
+            fixed (float* f = fractions)
+            fixed (SKPoint* p = positions)
+            fixed (SKPoint* t = tangents)
+            {
+                Native.Additional.SkKernel_pathSamplerSample(mNative, f, (float*)p, (float*)t, fractions.Length);
+            }
+            GC.KeepAlive(this);
+        }
+
+        private static long stat(int index)
+        {
+            long* stats = stackalloc long[4];
+            Native.Additional.SkKernel_pathSamplerStats(stats);
+            return stats[index];
+        }
+
+        /**
+         * The number of samplers that found an existing table
+         */
+        internal static long getHitCount() => stat(0);
+
+        /**
+         * The number of samplers that built a new table
+         */
+        internal static long getMissCount() => stat(1);
+
+        /**
+         * The bytes held by live tables
+         */
+        internal static long getByteCount() => stat(2);
+
+        /**
+         * The number of live tables
+         */
+        internal static long getEntryCount() => stat(3);
+    }
+}
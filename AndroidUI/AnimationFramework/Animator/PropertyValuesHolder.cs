@@ -1501,9 +1501,11 @@ namespace AndroidUI.AnimationFramework.Animator
             if (mEvaluator == null)
             {
                 // We already handle int and float automatically, but not their Object
-                // equivalents
+                // equivalents. Path data is morphed by an evaluator of its own, as it returns
+                // one reused PathData each holder needs a separate one
                 mEvaluator = (mValueType == typeof(int)) ? sIntEvaluator :
                         (mValueType == typeof(float)) ? sFloatEvaluator :
+                        (mValueType == typeof(PathParser.PathData)) ? new PathDataEvaluator() :
                         null;
             }
             if (mEvaluator != null)
@@ -1542,6 +1544,51 @@ namespace AndroidUI.AnimationFramework.Animator
             mAnimatedValue = mConverter == null ? value : mConverter.convert(value);
         }
 
+        /**
+         * Returns the kind of channel AnimatorBatch can calculate the value of this holder as,
+         * one of the AnimatorBatch.CHANNEL_ constants. Only float and int holders animating
+         * between two keyframes with a built in evaluator are batched.
+         */
+        virtual internal int getBatchedChannel()
+        {
+            return AnimatorBatch.CHANNEL_NONE;
+        }
+
+        /**
+         * Returns true if this holder animates between two keyframes of the given set type with
+         * no keyframe interpolator, no converter and an evaluator of exactly the given type.
+         */
+        internal bool hasBatchedKeyframes(Type keyframeSetType, Type evaluatorType)
+        {
+            if (mConverter != null || mKeyframes == null || mKeyframes.GetType() != keyframeSetType)
+            {
+                return false;
+            }
+            KeyframeSet keyframes = (KeyframeSet)mKeyframes;
+            return keyframes.mNumKeyframes == 2
+                    && keyframes.mFirstKeyframe.getFraction() == 0
+                    && keyframes.mLastKeyframe.getFraction() == 1
+                    && keyframes.mLastKeyframe.getInterpolator() == null
+                    && keyframes.mEvaluator != null
+                    && keyframes.mEvaluator.GetType() == evaluatorType;
+        }
+
+        /**
+         * Stores a value calculated by AnimatorBatch in place of calculateValue().
+         */
+        virtual internal void setBatchedValue(float value)
+        {
+            mAnimatedValue = value;
+        }
+
+        /**
+         * Stores a value calculated by AnimatorBatch in place of calculateValue().
+         */
+        virtual internal void setBatchedValue(int value)
+        {
+            mAnimatedValue = value;
+        }
+
         /**
          * Sets the name of the property that will be animated. This name is used to derive
          * a setter function that will be called to set animated values.
@@ -1742,6 +1789,26 @@ namespace AndroidUI.AnimationFramework.Animator
                 mIntAnimatedValue = mIntKeyframes.getIntValue(fraction);
             }
 
+            override
+            internal int getBatchedChannel()
+            {
+                if (hasBatchedKeyframes(typeof(IntKeyframeSet), typeof(IntEvaluator)))
+                {
+                    return AnimatorBatch.CHANNEL_INT;
+                }
+                if (hasBatchedKeyframes(typeof(IntKeyframeSet), typeof(ArgbEvaluator)))
+                {
+                    return AnimatorBatch.CHANNEL_ARGB;
+                }
+                return AnimatorBatch.CHANNEL_NONE;
+            }
+
+            override
+            internal void setBatchedValue(int value)
+            {
+                mIntAnimatedValue = value;
+            }
+
             override
             internal object getAnimatedValue()
             {
@@ -1872,6 +1939,20 @@ namespace AndroidUI.AnimationFramework.Animator
                 mFloatAnimatedValue = mFloatKeyframes.getFloatValue(fraction);
             }
 
+            override
+            internal int getBatchedChannel()
+            {
+                return hasBatchedKeyframes(typeof(FloatKeyframeSet), typeof(FloatEvaluator))
+                        ? AnimatorBatch.CHANNEL_FLOAT
+                        : AnimatorBatch.CHANNEL_NONE;
+            }
+
+            override
+            internal void setBatchedValue(float value)
+            {
+                mFloatAnimatedValue = value;
+            }
+
             override
             internal object getAnimatedValue()
             {
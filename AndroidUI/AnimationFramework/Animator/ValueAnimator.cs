@@ -220,6 +220,12 @@ namespace AndroidUI.AnimationFramework.Animator
          */
         private bool mSelfPulse = true;
 
+        /**
+         * Whether or not the values of the animator are calculated with those of every other
+         * batched animator in one pass at the end of the animation frame.
+         */
+        private bool mBatchedEvaluation = false;
+
         /**
          * Whether or not the animator has been requested to start without pulsing. This flag gets set
          * in startWithoutPulsing(), and reset in start().
@@ -1067,6 +1073,35 @@ namespace AndroidUI.AnimationFramework.Animator
             return mInterpolator;
         }
 
+        /**
+         * Opts this animator in to batched evaluation. The values of every batched animator
+         * running on a frame are calculated together in one native pass once all animators have
+         * been pulsed, after which each animator sets its values and notifies its update listeners
+         * in the order the animators were pulsed.
+         *
+         * <p>Only animators using a built in interpolator and animating float, int or argb values
+         * between two keyframes are batched, any other animator, and the final frame of any
+         * animator, is calculated as usual. A batched animator should not be seeked from the
+         * update listener of another animator, the batched values of the frame would replace
+         * the seeked ones.</p>
+         *
+         * @param batched whether the values of this animator are calculated in a batch
+         */
+        public void setBatchedEvaluation(bool batched)
+        {
+            mBatchedEvaluation = batched;
+        }
+
+        /**
+         * Returns whether this animator is opted in to batched evaluation.
+         *
+         * @see #setBatchedEvaluation(bool)
+         */
+        public bool isBatchedEvaluation()
+        {
+            return mBatchedEvaluation;
+        }
+
         /**
          * The type evaluator to be used when calculating the animated values of this animation.
          * The system will automatically assign a float or int evaluator based on the type
@@ -1491,7 +1526,13 @@ namespace AndroidUI.AnimationFramework.Animator
                 mOverallFraction = clampFraction(fraction);
                 float currentIterationFraction = getCurrentIterationFraction(
                         mOverallFraction, mReversing);
-                animateValue(currentIterationFraction);
+                // The last frame is never batched, the end listeners that follow it expect the
+                // final values to be set.
+                if (done || !mBatchedEvaluation || !mSelfPulse
+                        || !getAnimationHandler().getBatch().add(this, currentIterationFraction))
+                {
+                    animateValue(currentIterationFraction);
+                }
             }
             return done;
         }
@@ -1731,6 +1772,23 @@ namespace AndroidUI.AnimationFramework.Animator
             {
                 mValues[i].calculateValue(fraction);
             }
+            notifyUpdateListeners();
+        }
+
+        /**
+         * The counterpart of animateValue() for a batched animator, called by AnimatorBatch once
+         * it has interpolated the fraction and stored the values calculated from it in mValues.
+         *
+         * @param fraction The interpolated fraction of the animation.
+         */
+        virtual internal void animateBatchedValue(float fraction)
+        {
+            mCurrentFraction = fraction;
+            notifyUpdateListeners();
+        }
+
+        private void notifyUpdateListeners()
+        {
             if (mUpdateListeners != null)
             {
                 int numListeners = mUpdateListeners.Count;
@@ -23,8 +23,8 @@ namespace AndroidUI.AnimationFramework.Interpolators
      */
     public class AccelerateInterpolator : BaseInterpolator, Utils.ICloneable
     {
-        private float mFactor;
-        private double mDoubleFactor;
+        internal float mFactor;
+        internal double mDoubleFactor;
 
         virtual public AccelerateInterpolator Clone()
         {
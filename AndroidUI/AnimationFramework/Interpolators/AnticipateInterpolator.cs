@@ -21,7 +21,7 @@ namespace AndroidUI.AnimationFramework.Interpolators
      */
     public class AnticipateInterpolator : BaseInterpolator
     {
-        private readonly float mTension;
+        internal readonly float mTension;
 
         public AnticipateInterpolator()
         {
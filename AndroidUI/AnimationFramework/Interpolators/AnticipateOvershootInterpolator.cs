@@ -22,7 +22,7 @@ namespace AndroidUI.AnimationFramework.Interpolators
      */
     public class AnticipateOvershootInterpolator : BaseInterpolator, Utils.ICloneable
     {
-        private float mTension;
+        internal float mTension;
 
         virtual public AnticipateOvershootInterpolator Clone()
         {
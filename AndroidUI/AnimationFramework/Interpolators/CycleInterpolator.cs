@@ -40,6 +40,6 @@ namespace AndroidUI.AnimationFramework.Interpolators
             return (float)Math.Sin(2 * mCycles * Math.PI * input);
         }
 
-        private float mCycles;
+        internal float mCycles;
     }
 }
\ No newline at end of file
@@ -60,6 +60,6 @@ namespace AndroidUI.AnimationFramework.Interpolators
             return result;
         }
 
-        private float mFactor = 1.0f;
+        internal float mFactor = 1.0f;
     }
 }
\ No newline at end of file
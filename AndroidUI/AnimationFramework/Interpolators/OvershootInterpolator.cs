@@ -22,7 +22,7 @@ namespace AndroidUI.AnimationFramework.Interpolators
      */
     public class OvershootInterpolator : BaseInterpolator, Utils.ICloneable
     {
-        private float mTension;
+        internal float mTension;
 
         virtual public OvershootInterpolator Clone()
         {
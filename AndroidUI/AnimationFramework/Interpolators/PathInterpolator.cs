@@ -15,6 +15,9 @@
  */
 
 using AndroidUI.Exceptions;
+using AndroidUI.Skia;
+using SkiaSharp;
+using static AndroidUI.Native;
 
 namespace AndroidUI.AnimationFramework.Interpolators
 {
@@ -44,6 +47,14 @@ namespace AndroidUI.AnimationFramework.Interpolators
 
         private float[] mY; // y coordinates in the line
 
+        // The number of equal steps of x the line is resampled into for lookup.
+        internal const int TABLE_INTERVALS = 1024;
+
+        // y of the line at x = i / TABLE_INTERVALS, null when the line has a vertical
+        // jump that a linear blend between samples would smear. Never written after
+        // construction so clones share it.
+        private float[] mTable;
+
         virtual public PathInterpolator Clone()
         {
             PathInterpolator obj = (PathInterpolator)Utils.ICloneable.Clone(this);
@@ -92,18 +103,41 @@ namespace AndroidUI.AnimationFramework.Interpolators
 
         private void initQuad(float controlX, float controlY)
         {
-            Graphics.Path path = new();
-            path.moveTo(0, 0);
-            path.quadTo(controlX, controlY, 1f, 1f);
-            initPath(path);
+            Span<SKPoint> pts = stackalloc SKPoint[] {
+                new(0, 0), new(controlX, controlY), new(1, 1)
+            };
+            SKPoint[] points = new SKPoint[SKTessellator.MAX_SEGMENTS + 1];
+            SKTessellator.tessellateQuads(pts, stackalloc int[] { SKTessellator.MAX_SEGMENTS }, points, Span<SKPoint>.Empty);
+            initCurve(points);
         }
 
         private void initCubic(float x1, float y1, float x2, float y2)
         {
-            Graphics.Path path = new();
-            path.moveTo(0, 0);
-            path.cubicTo(x1, y1, x2, y2, 1f, 1f);
-            initPath(path);
+            Span<SKPoint> pts = stackalloc SKPoint[] {
+                new(0, 0), new(x1, y1), new(x2, y2), new(1, 1)
+            };
+            SKPoint[] points = new SKPoint[SKTessellator.MAX_SEGMENTS + 1];
+            SKTessellator.tessellateCubics(pts, stackalloc int[] { SKTessellator.MAX_SEGMENTS }, points, Span<SKPoint>.Empty);
+            initCurve(points);
+        }
+
+        private void initCurve(SKPoint[] points)
+        {
+            mX = new float[points.Length];
+            mY = new float[points.Length];
+            float prevX = 0;
+            for (int i = 0; i < points.Length; i++)
+            {
+                float x = points[i].X;
+                if (x < prevX)
+                {
+                    throw new IllegalArgumentException("The Path cannot loop back on itself.");
+                }
+                mX[i] = x;
+                mY[i] = points[i].Y;
+                prevX = x;
+            }
+            initTable();
         }
 
         private void initPath(Graphics.Path path)
@@ -142,6 +176,26 @@ namespace AndroidUI.AnimationFramework.Interpolators
                 prevX = x;
                 prevFraction = fraction;
             }
+            initTable();
+        }
+
+        private void initTable()
+        {
+            for (int i = 1; i < mX.Length; i++)
+            {
+                if (mX[i] == mX[i - 1] && mY[i] != mY[i - 1])
+                {
+                    // keep the exact search, a table would turn the jump into a slope
+                    return;
+                }
+            }
+            float[] table = new float[TABLE_INTERVALS + 1];
+            for (int i = 1; i < TABLE_INTERVALS; i++)
+            {
+                table[i] = search(i / (float)TABLE_INTERVALS);
+            }
+            table[TABLE_INTERVALS] = 1;
+            mTable = table;
         }
 
         /**
@@ -164,6 +218,51 @@ namespace AndroidUI.AnimationFramework.Interpolators
             {
                 return 1;
             }
+            else if (mTable == null || float.IsNaN(t))
+            {
+                return search(t);
+            }
+            float position = t * TABLE_INTERVALS;
+            int index = Math.Min((int)position, TABLE_INTERVALS - 1);
+            float fraction = position - index;
+            float startY = mTable[index];
+            float endY = mTable[index + 1];
+            return startY + (fraction * (endY - startY));
+        }
+
+        /**
+         * Interpolates every value of <code>input</code> into the same index of
+         * <code>output</code>, giving the same results as {@link #getInterpolation(float)}
+         * but many values in one call.
+         *
+         * @param input The x coordinates to find the y coordinates of.
+         * @param output Receives the y coordinates, must be at least as long as input.
+         */
+        public unsafe void getInterpolation(ReadOnlySpan<float> input, Span<float> output)
+        {
+            if (output.Length < input.Length)
+            {
+                throw new IllegalArgumentException("output must hold at least " + input.Length + " values");
+            }
+            if (mTable == null)
+            {
+                for (int i = 0; i < input.Length; i++)
+                {
+                    output[i] = getInterpolation(input[i]);
+                }
+                return;
+            }
+            fixed (float* table = mTable)
+            fixed (float* i = input)
+            fixed (float* o = output)
+            {
+                Additional.SkKernel_interpolatorLookup(table, mTable.Length, i, o, input.Length);
+            }
+        }
+
+        // Finds y at x = t in the line, t is within (0, 1).
+        private float search(float t)
+        {
             // Do a binary search for the correct x to interpolate between.
             int startIndex = 0;
             int endIndex = mX.Length - 1;
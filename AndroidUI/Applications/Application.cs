@@ -14,8 +14,10 @@
  * limitations under the License.
  */
 
+using AndroidUI.AnimationFramework.Animation;
 using AndroidUI.Execution;
 using AndroidUI.Input;
+using AndroidUI.OS;
 using AndroidUI.Utils;
 using AndroidUI.Utils.Widgets;
 using AndroidUI.Widgets;
@@ -38,6 +40,13 @@ namespace AndroidUI.Applications
         public Handler Handler => handler;
         public Looper Looper => looper;
 
+        readonly FrameClock frameClock = new();
+
+        /**
+         * The clock frame times come from, set its refresh rate to the display's.
+         */
+        public FrameClock FrameClock => frameClock;
+
         public Application()
         {
             context = new(this);
@@ -132,7 +141,25 @@ namespace AndroidUI.Applications
 
         }
 
-        public void invalidate() => applicationDelegate?.invalidate();
+        public void invalidate()
+        {
+            frameClock.requestFrame();
+            if (!frameClock.isPacing())
+            {
+                applicationDelegate?.invalidate();
+            }
+        }
+
+        /**
+         * Lets the frame clock decide when the host draws, for hosts without vsync.
+         *
+         * Invalidations are then gathered up and passed on to the host once per frame,
+         * at the frame clock's refresh rate.
+         */
+        public void setFramePacingEnabled(bool enabled)
+        {
+            frameClock.setFrameListener(enabled ? () => applicationDelegate?.invalidate() : null);
+        }
 
         public void INTERNAL_ERROR(string error) => applicationDelegate?.INTERNAL_ERROR(error);
 
@@ -163,9 +190,18 @@ namespace AndroidUI.Applications
             }
             if (context.mAttachInfo.mViewRootImpl.hasContent())
             {
+                // Everything drawn in this frame, animations included, sees the frame's time.
+                AnimationUtils.lockAnimationClock(context, frameClock.toMillis(frameClock.beginFrame()));
                 if (System.Diagnostics.Debugger.IsAttached)
                 {
-                    context.mAttachInfo.mViewRootImpl.draw(canvas);
+                    try
+                    {
+                        context.mAttachInfo.mViewRootImpl.draw(canvas);
+                    }
+                    finally
+                    {
+                        AnimationUtils.unlockAnimationClock(context);
+                    }
                 }
                 else
                 {
@@ -177,6 +213,10 @@ namespace AndroidUI.Applications
                     {
                         Log.v("Application", "Caught exception while drawing: " + e);
                     }
+                    finally
+                    {
+                        AnimationUtils.unlockAnimationClock(context);
+                    }
                 }
             }
         }
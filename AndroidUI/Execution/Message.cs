@@ -137,6 +137,14 @@ namespace AndroidUI.Execution
         /*package*/
         internal Message next;
 
+        // the MessageQueue's schedule, see MessageSchedule
+        internal Message heapChild;
+        internal Message heapSibling;
+        internal Message heapPrev;
+        internal Message handlerNext;
+        internal Message handlerPrev;
+        internal long seq;
+
 
         /** @hide */
         internal static readonly object sPoolSync = new();
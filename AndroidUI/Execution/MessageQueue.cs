@@ -40,7 +40,7 @@ namespace AndroidUI.Execution
 
         private IntPtr mPtr; // used by native code
 
-        Message mMessages;
+        private readonly MessageSchedule mSchedule = new();
         private List<IdleHandler> mIdleHandlers = new();
         private SparseArray<FileDescriptorRecord> mFileDescriptorRecords;
         private IdleHandler[] mPendingIdleHandlers;
@@ -49,43 +49,64 @@ namespace AndroidUI.Execution
         // Indicates whether next() is blocked waiting in pollOnce() with a non-zero timeout.
         private bool mBlocked;
 
+        // Messages enqueued from any thread without taking LOCK, newest first and linked
+        // through Message.next. They are moved into mSchedule by whoever next holds LOCK.
+        private Message mInbox;
+
         // The next barrier token.
         // Barriers are indicated by messages with a null target whose arg1 field carries the token.
         private int mNextBarrierToken;
 
-        private static IntPtr nativeInit()
+        // The number of ready file descriptors collected by a single poll.
+        private const int POLL_BATCH = 16;
+
+        private static unsafe IntPtr nativeInit()
         {
-            //var s = new HPSocket.Udp.UdpServer();
-
-            //var sock = new System.Net.Sockets.Socket(
-            //    System.Net.Sockets.AddressFamily.Unix,
-            //    System.Net.Sockets.SocketType.Dgram,
-            //    System.Net.Sockets.ProtocolType.Udp
-            //);
-            //return sock;
-            return new IntPtr(1);
+            IntPtr ptr = (IntPtr)Native.Additional.SkKernel_looperCreate();
+            if (ptr == IntPtr.Zero)
+            {
+                throw new IllegalStateException("Failed to create the native looper");
+            }
+            return ptr;
         }
-        private static void nativeDestroy(IntPtr ptr)
+        private static unsafe void nativeDestroy(IntPtr ptr)
         {
+            Native.Additional.SkKernel_looperDestroy((void*)ptr);
         }
 
         /*non-static for callbacks*/
-        private void nativePollOnce(IntPtr ptr, int timeoutMillis)
+        private unsafe void nativePollOnce(IntPtr ptr, int timeoutMillis)
         {
-            //throw new NotImplementedException();
+            int* fds = stackalloc int[POLL_BATCH];
+            int* events = stackalloc int[POLL_BATCH];
+            int count = Native.Additional.SkKernel_looperPollOnce((void*)ptr, timeoutMillis, fds, events, POLL_BATCH);
+            if (count < 0)
+            {
+                Log.w(TAG, "Native looper poll failed");
+                return;
+            }
+            // The native looper hands back ready descriptors instead of calling into managed code,
+            // dispatch them here and let it know which events to keep watching.
+            for (int i = 0; i < count; i++)
+            {
+                int newWatchedEvents = dispatchEvents(fds[i], events[i]);
+                nativeSetFileDescriptorEvents(ptr, fds[i], newWatchedEvents);
+            }
         }
-        private static void nativeWake(IntPtr ptr)
+        private static unsafe void nativeWake(IntPtr ptr)
         {
-            //throw new NotImplementedException();
+            Native.Additional.SkKernel_looperWake((void*)ptr);
         }
-        private static bool nativeIsPolling(IntPtr ptr)
+        private static unsafe bool nativeIsPolling(IntPtr ptr)
         {
-            return false;
-            //throw new NotImplementedException();
+            return Native.Additional.SkKernel_looperIsPolling((void*)ptr);
         }
-        private static void nativeSetFileDescriptorEvents(IntPtr ptr, int fd, int events)
+        private static unsafe void nativeSetFileDescriptorEvents(IntPtr ptr, int fd, int events)
         {
-            //throw new NotImplementedException();
+            if (!Native.Additional.SkKernel_looperSetFileDescriptorEvents((void*)ptr, fd, events))
+            {
+                Log.w(TAG, "Failed to watch file descriptor " + fd + " for events " + events);
+            }
         }
 
         internal MessageQueue(bool quitAllowed)
@@ -103,7 +124,7 @@ namespace AndroidUI.Execution
         // Must only be called on the looper thread or the finalizer.
         private void dispose()
         {
-            if (mPtr != null)
+            if (mPtr != IntPtr.Zero)
             {
                 nativeDestroy(mPtr);
                 mPtr = IntPtr.Zero;
@@ -120,8 +141,10 @@ namespace AndroidUI.Execution
         public bool isIdle()
         {
             lock (LOCK) {
+                drainInboxLocked();
                 long now = NanoTime.currentTimeMillis();
-                return mMessages == null || now < mMessages.when;
+                Message first = mSchedule.peek();
+                return first == null || now < first.when;
             }
         }
 
@@ -362,7 +385,7 @@ namespace AndroidUI.Execution
             // This can happen if the application tries to restart a looper after quit
             // which is not supported.
             IntPtr ptr = mPtr;
-            if (ptr == null)
+            if (ptr == IntPtr.Zero)
             {
                 return null;
             }
@@ -376,23 +399,16 @@ namespace AndroidUI.Execution
                     //Binder.flushPendingCommands();
                 }
 
-                nativePollOnce(ptr, nextPollTimeoutMillis);
+                // The UI loop is driven by the host's frame loop, only collect what is ready.
+                nativePollOnce(ptr, 0);
 
                 lock (LOCK)
                 {
+                    drainInboxLocked();
                     // Try to retrieve the next message.  Return if found.
                     long now = NanoTime.currentTimeMillis();
-                    Message prevMsg = null;
-                    Message msg = mMessages;
-                    if (msg != null && msg.target == null)
-                    {
-                        // Stalled by a barrier.  Find the next asynchronous message in the queue.
-                        do
-                        {
-                            prevMsg = msg;
-                            msg = msg.next;
-                        } while (msg != null && !msg.isAsynchronous());
-                    }
+                    // If stalled by a barrier this is the next asynchronous message in the queue.
+                    Message msg = mSchedule.peekDeliverable();
                     if (msg != null)
                     {
                         if (now < msg.when)
@@ -405,15 +421,7 @@ namespace AndroidUI.Execution
                         {
                             // Got a message.
                             mBlocked = false;
-                            if (prevMsg != null)
-                            {
-                                prevMsg.next = msg.next;
-                            }
-                            else
-                            {
-                                mMessages = msg.next;
-                            }
-                            msg.next = null;
+                            mSchedule.remove(msg);
                             if (DEBUG) Log.v(TAG, "Returning message: " + msg);
                             msg.markInUse();
                             msg.waiting = false;
@@ -437,7 +445,7 @@ namespace AndroidUI.Execution
                     // Idle handles only run if the queue is empty or if the first message
                     // in the queue (possibly a barrier) is due to be handled in the future.
                     if (pendingIdleHandlerCount < 0
-                            && (mMessages == null || now < mMessages.when))
+                            && (mSchedule.peek() == null || now < mSchedule.peek().when))
                     {
                         pendingIdleHandlerCount = mIdleHandlers.Count;
                     }
@@ -454,7 +462,10 @@ namespace AndroidUI.Execution
                             return msg;
                         }
 
-                        mBlocked = true;
+                        if (!markBlockedLocked())
+                        {
+                            nextPollTimeoutMillis = 0;
+                        }
                         continue;
                     }
 
@@ -506,7 +517,7 @@ namespace AndroidUI.Execution
             // This can happen if the application tries to restart a looper after quit
             // which is not supported.
             IntPtr ptr = mPtr;
-            if (ptr == null)
+            if (ptr == IntPtr.Zero)
             {
                 return null;
             }
@@ -523,19 +534,11 @@ namespace AndroidUI.Execution
                 nativePollOnce(ptr, nextPollTimeoutMillis);
 
                 lock (LOCK) {
+                    drainInboxLocked();
                     // Try to retrieve the next message.  Return if found.
                     long now = NanoTime.currentTimeMillis();
-                    Message prevMsg = null;
-                    Message msg = mMessages;
-                    if (msg != null && msg.target == null)
-                    {
-                        // Stalled by a barrier.  Find the next asynchronous message in the queue.
-                        do
-                        {
-                            prevMsg = msg;
-                            msg = msg.next;
-                        } while (msg != null && !msg.isAsynchronous());
-                    }
+                    // If stalled by a barrier this is the next asynchronous message in the queue.
+                    Message msg = mSchedule.peekDeliverable();
                     if (msg != null)
                     {
                         if (now < msg.when)
@@ -547,15 +550,7 @@ namespace AndroidUI.Execution
                         {
                             // Got a message.
                             mBlocked = false;
-                            if (prevMsg != null)
-                            {
-                                prevMsg.next = msg.next;
-                            }
-                            else
-                            {
-                                mMessages = msg.next;
-                            }
-                            msg.next = null;
+                            mSchedule.remove(msg);
                             if (DEBUG) Log.v(TAG, "Returning message: " + msg);
                             msg.markInUse();
                             return msg;
@@ -578,14 +573,17 @@ namespace AndroidUI.Execution
                     // Idle handles only run if the queue is empty or if the first message
                     // in the queue (possibly a barrier) is due to be handled in the future.
                     if (pendingIdleHandlerCount < 0
-                            && (mMessages == null || now < mMessages.when))
+                            && (mSchedule.peek() == null || now < mSchedule.peek().when))
                     {
                         pendingIdleHandlerCount = mIdleHandlers.Count;
                     }
                     if (pendingIdleHandlerCount <= 0)
                     {
                         // No idle handlers to run.  Loop and wait some more.
-                        mBlocked = true;
+                        if (!markBlockedLocked())
+                        {
+                            nextPollTimeoutMillis = 0;
+                        }
                         continue;
                     }
 
@@ -642,7 +640,10 @@ namespace AndroidUI.Execution
                 {
                     return;
                 }
-                mQuitting = true;
+                // Set mQuitting before taking the inbox, a producer that pushes after this drain
+                // is then sure to see it and take its message back out in enqueueMessage.
+                Volatile.Write(ref mQuitting, true);
+                moveInboxLocked();
 
                 if (safe)
                 {
@@ -691,32 +692,13 @@ namespace AndroidUI.Execution
             // Enqueue a new sync barrier token.
             // We don't need to wake the queue because the purpose of a barrier is to stall it.
             lock (LOCK) {
+                drainInboxLocked();
                 int token = mNextBarrierToken++;
                 Message msg = Message.obtain();
                 msg.markInUse();
                 msg.when = when;
                 msg.arg1 = token;
-
-                Message prev = null;
-                Message p = mMessages;
-                if (when != 0)
-                {
-                    while (p != null && p.when <= when)
-                    {
-                        prev = p;
-                        p = p.next;
-                    }
-                }
-                if (prev != null)
-                { // invariant: p == prev.next
-                    msg.next = p;
-                    prev.next = msg;
-                }
-                else
-                {
-                    msg.next = p;
-                    mMessages = msg;
-                }
+                mSchedule.insert(msg);
                 return token;
             }
         }
@@ -736,29 +718,17 @@ namespace AndroidUI.Execution
             // Remove a sync barrier token from the queue.
             // If the queue is no longer stalled by a barrier then wake it.
             lock (LOCK) {
-                Message prev = null;
-                Message p = mMessages;
-                while (p != null && (p.target != null || p.arg1 != token))
-                {
-                    prev = p;
-                    p = p.next;
-                }
+                drainInboxLocked();
+                Message p = mSchedule.findBarrier(token);
                 if (p == null)
                 {
                     throw new IllegalStateException("The specified message queue synchronization "
                             + " barrier token has not been posted or has already been removed.");
                 }
-                bool needWake;
-                if (prev != null)
-                {
-                    prev.next = p.next;
-                    needWake = false;
-                }
-                else
-                {
-                    mMessages = p.next;
-                    needWake = mMessages == null || mMessages.target != null;
-                }
+                bool wasFirst = mSchedule.peek() == p;
+                mSchedule.remove(p);
+                Message first = mSchedule.peek();
+                bool needWake = wasFirst && (first == null || first.target != null);
                 p.recycleUnchecked();
 
                 // If the loop is quitting then it is already awake.
@@ -777,63 +747,144 @@ namespace AndroidUI.Execution
                 throw new IllegalArgumentException("Message must have a target.");
             }
 
-            lock (LOCK) {
-                if (msg.isInUse())
-                {
-                    throw new IllegalStateException(msg + " This message is already in use.");
+            if (msg.isInUse())
+            {
+                throw new IllegalStateException(msg + " This message is already in use.");
+            }
+
+            if (Volatile.Read(ref mQuitting))
+            {
+                IllegalStateException e = new(
+                        msg.target + " sending message to a Handler on a dead thread");
+                Log.w(TAG, e.ToString());
+                msg.recycle();
+                return false;
+            }
+
+            msg.markInUse();
+            msg.when = when;
+
+            // Push onto the inbox, the looper sorts it into the queue when it drains it.
+            Message head;
+            do
+            {
+                head = Volatile.Read(ref mInbox);
+                msg.next = head;
+            } while (Interlocked.CompareExchange(ref mInbox, msg, head) != head);
+
+            // A quit that started before the push leaves the message in the inbox, take it back out
+            // unless the quit already moved it into the queue.
+            if (Volatile.Read(ref mQuitting))
+            {
+                lock (LOCK) {
+                    if (removeFromInboxLocked(msg))
+                    {
+                        IllegalStateException e = new(
+                                msg.target + " sending message to a Handler on a dead thread");
+                        Log.w(TAG, e.ToString());
+                        msg.recycleUnchecked();
+                        return false;
+                    }
                 }
+                return true;
+            }
 
-                if (mQuitting)
-                {
-                    IllegalStateException e = new(
-                            msg.target + " sending message to a Handler on a dead thread");
-                    Log.w(TAG, e.ToString());
-                    msg.recycle();
-                    return false;
+            // Only the message that made the inbox non empty needs to wake the looper, it looks at
+            // the inbox again after marking itself blocked so it cannot miss this one.
+            // Waking takes LOCK so a looper that has since quit is never woken after dispose.
+            if (head == null && Volatile.Read(ref mBlocked))
+            {
+                lock (LOCK) {
+                    // We can assume mPtr != 0 when mQuitting is false.
+                    if (!mQuitting)
+                    {
+                        nativeWake(mPtr);
+                    }
                 }
+            }
+            return true;
+        }
 
-                msg.markInUse();
-                msg.when = when;
-                Message p = mMessages;
-                bool needWake;
-                if (p == null || when == 0 || when < p.when)
+        // Marks next() as about to block. Returns false if messages arrived in the inbox
+        // whose producers saw the looper as running, in which case it must poll without waiting.
+        private bool markBlockedLocked()
+        {
+            Volatile.Write(ref mBlocked, true);
+            Interlocked.MemoryBarrier();
+            return Volatile.Read(ref mInbox) == null;
+        }
+
+        // Once quitting the inbox only holds messages whose producers are yet to take them back
+        // out, so it is left alone.
+        private void drainInboxLocked()
+        {
+            if (!mQuitting)
+            {
+                moveInboxLocked();
+            }
+        }
+
+        // Removes msg from the inbox, returns false if it is no longer there.
+        // Only called once quitting, when the producers are the only ones touching the inbox,
+        // the other messages are pushed back for their own producers to find.
+        private bool removeFromInboxLocked(Message msg)
+        {
+            Message list = Interlocked.Exchange(ref mInbox, null);
+            Message rest = null;
+            Message tail = null;
+            bool found = false;
+            while (list != null)
+            {
+                Message n = list.next;
+                if (list == msg)
                 {
-                    // New head, wake up the event queue if blocked.
-                    msg.next = p;
-                    mMessages = msg;
-                    needWake = mBlocked;
+                    found = true;
                 }
                 else
                 {
-                    // Inserted within the middle of the queue.  Usually we don't have to wake
-                    // up the event queue unless there is a barrier at the head of the queue
-                    // and the message is the earliest asynchronous message in the queue.
-                    needWake = mBlocked && p.target == null && msg.isAsynchronous();
-                    Message prev;
-                    for(;;)
-                    {
-                        prev = p;
-                        p = p.next;
-                        if (p == null || when < p.when)
-                        {
-                            break;
-                        }
-                        if (needWake && p.isAsynchronous())
-                        {
-                            needWake = false;
-                        }
-                    }
-                    msg.next = p; // invariant: p == prev.next
-                    prev.next = msg;
+                    list.next = rest;
+                    tail ??= list;
+                    rest = list;
                 }
-
-                // We can assume mPtr != 0 because mQuitting is false.
-                if (needWake)
+                list = n;
+            }
+            msg.next = null;
+            if (rest != null)
+            {
+                Message head;
+                do
                 {
-                    nativeWake(mPtr);
-                }
+                    head = Volatile.Read(ref mInbox);
+                    tail.next = head;
+                } while (Interlocked.CompareExchange(ref mInbox, rest, head) != head);
+            }
+            return found;
+        }
+
+        private void moveInboxLocked()
+        {
+            Message msg = Interlocked.Exchange(ref mInbox, null);
+            if (msg == null)
+            {
+                return;
+            }
+
+            // The inbox is newest first, reverse it so messages keep the order they were sent in.
+            Message ordered = null;
+            while (msg != null)
+            {
+                Message n = msg.next;
+                msg.next = ordered;
+                ordered = msg;
+                msg = n;
+            }
+            while (ordered != null)
+            {
+                Message n = ordered.next;
+                ordered.next = null;
+                mSchedule.insert(ordered);
+                ordered = n;
             }
-            return true;
         }
 
         internal bool hasMessages(Handler h, int what, object obj)
@@ -844,14 +895,13 @@ namespace AndroidUI.Execution
             }
 
             lock (LOCK) {
-                Message p = mMessages;
-                while (p != null)
+                drainInboxLocked();
+                for (Message p = mSchedule.first(h); p != null; p = p.handlerNext)
                 {
-                    if (p.target == h && p.what == what && (obj == null || p.obj == obj))
+                    if (p.what == what && (obj == null || p.obj == obj))
                     {
                         return true;
                     }
-                    p = p.next;
                 }
                 return false;
             }
@@ -865,14 +915,13 @@ namespace AndroidUI.Execution
             }
 
             lock (LOCK) {
-                Message p = mMessages;
-                while (p != null)
+                drainInboxLocked();
+                for (Message p = mSchedule.first(h); p != null; p = p.handlerNext)
                 {
-                    if (p.target == h && p.what == what && (obj == null || obj.Equals(p.obj)))
+                    if (p.what == what && (obj == null || obj.Equals(p.obj)))
                     {
                         return true;
                     }
-                    p = p.next;
                 }
                 return false;
             }
@@ -886,14 +935,13 @@ namespace AndroidUI.Execution
             }
 
             lock (LOCK) {
-                Message p = mMessages;
-                while (p != null)
+                drainInboxLocked();
+                for (Message p = mSchedule.first(h); p != null; p = p.handlerNext)
                 {
-                    if (p.target == h && p.callback == r && (obj == null || p.obj == obj))
+                    if (p.callback == r && (obj == null || p.obj == obj))
                     {
                         return true;
                     }
-                    p = p.next;
                 }
                 return false;
             }
@@ -907,16 +955,8 @@ namespace AndroidUI.Execution
             }
 
             lock (LOCK) {
-                Message p = mMessages;
-                while (p != null)
-                {
-                    if (p.target == h)
-                    {
-                        return true;
-                    }
-                    p = p.next;
-                }
-                return false;
+                drainInboxLocked();
+                return mSchedule.first(h) != null;
             }
         }
 
@@ -928,32 +968,15 @@ namespace AndroidUI.Execution
             }
 
             lock (LOCK) {
-                Message p = mMessages;
-
-                // Remove all messages at front.
-                while (p != null && p.target == h && p.what == what
-                       && (obj == null || p.obj == obj))
-                {
-                    Message n = p.next;
-                    mMessages = n;
-                    p.recycleUnchecked();
-                    p = n;
-                }
-
-                // Remove all messages after front.
+                drainInboxLocked();
+                Message p = mSchedule.first(h);
                 while (p != null)
                 {
-                    Message n = p.next;
-                    if (n != null)
+                    Message n = p.handlerNext;
+                    if (p.what == what && (obj == null || p.obj == obj))
                     {
-                        if (n.target == h && n.what == what
-                            && (obj == null || n.obj == obj))
-                        {
-                            Message nn = n.next;
-                            n.recycleUnchecked();
-                            p.next = nn;
-                            continue;
-                        }
+                        mSchedule.remove(p);
+                        p.recycleUnchecked();
                     }
                     p = n;
                 }
@@ -968,32 +991,15 @@ namespace AndroidUI.Execution
             }
 
             lock (LOCK) {
-                Message p = mMessages;
-
-                // Remove all messages at front.
-                while (p != null && p.target == h && p.what == what
-                       && (obj == null || obj.Equals(p.obj)))
-                {
-                    Message n = p.next;
-                    mMessages = n;
-                    p.recycleUnchecked();
-                    p = n;
-                }
-
-                // Remove all messages after front.
+                drainInboxLocked();
+                Message p = mSchedule.first(h);
                 while (p != null)
                 {
-                    Message n = p.next;
-                    if (n != null)
+                    Message n = p.handlerNext;
+                    if (p.what == what && (obj == null || obj.Equals(p.obj)))
                     {
-                        if (n.target == h && n.what == what
-                            && (obj == null || obj.Equals(n.obj)))
-                        {
-                            Message nn = n.next;
-                            n.recycleUnchecked();
-                            p.next = nn;
-                            continue;
-                        }
+                        mSchedule.remove(p);
+                        p.recycleUnchecked();
                     }
                     p = n;
                 }
@@ -1008,32 +1014,15 @@ namespace AndroidUI.Execution
             }
 
             lock (LOCK) {
-                Message p = mMessages;
-
-                // Remove all messages at front.
-                while (p != null && p.target == h && p.callback == r
-                       && (obj == null || p.obj == obj))
-                {
-                    Message n = p.next;
-                    mMessages = n;
-                    p.recycleUnchecked();
-                    p = n;
-                }
-
-                // Remove all messages after front.
+                drainInboxLocked();
+                Message p = mSchedule.first(h);
                 while (p != null)
                 {
-                    Message n = p.next;
-                    if (n != null)
+                    Message n = p.handlerNext;
+                    if (p.callback == r && (obj == null || p.obj == obj))
                     {
-                        if (n.target == h && n.callback == r
-                            && (obj == null || n.obj == obj))
-                        {
-                            Message nn = n.next;
-                            n.recycleUnchecked();
-                            p.next = nn;
-                            continue;
-                        }
+                        mSchedule.remove(p);
+                        p.recycleUnchecked();
                     }
                     p = n;
                 }
@@ -1049,32 +1038,15 @@ namespace AndroidUI.Execution
 
             lock (LOCK)
             {
-                Message p = mMessages;
-
-                // Remove all messages at front.
-                while (p != null && p.target == h && p.callback == r
-                       && p.what == what)
-                {
-                    Message n = p.next;
-                    mMessages = n;
-                    p.recycleUnchecked();
-                    p = n;
-                }
-
-                // Remove all messages after front.
+                drainInboxLocked();
+                Message p = mSchedule.first(h);
                 while (p != null)
                 {
-                    Message n = p.next;
-                    if (n != null)
+                    Message n = p.handlerNext;
+                    if (p.callback == r && p.what == what)
                     {
-                        if (n.target == h && n.callback == r
-                            && n.what == what)
-                        {
-                            Message nn = n.next;
-                            n.recycleUnchecked();
-                            p.next = nn;
-                            continue;
-                        }
+                        mSchedule.remove(p);
+                        p.recycleUnchecked();
                     }
                     p = n;
                 }
@@ -1089,32 +1061,15 @@ namespace AndroidUI.Execution
             }
 
             lock (LOCK) {
-                Message p = mMessages;
-
-                // Remove all messages at front.
-                while (p != null && p.target == h && p.callback == r
-                       && (obj == null || obj.Equals(p.obj)))
-                {
-                    Message n = p.next;
-                    mMessages = n;
-                    p.recycleUnchecked();
-                    p = n;
-                }
-
-                // Remove all messages after front.
+                drainInboxLocked();
+                Message p = mSchedule.first(h);
                 while (p != null)
                 {
-                    Message n = p.next;
-                    if (n != null)
+                    Message n = p.handlerNext;
+                    if (p.callback == r && (obj == null || obj.Equals(p.obj)))
                     {
-                        if (n.target == h && n.callback == r
-                            && (obj == null || obj.Equals(n.obj)))
-                        {
-                            Message nn = n.next;
-                            n.recycleUnchecked();
-                            p.next = nn;
-                            continue;
-                        }
+                        mSchedule.remove(p);
+                        p.recycleUnchecked();
                     }
                     p = n;
                 }
@@ -1130,31 +1085,15 @@ namespace AndroidUI.Execution
             }
 
             lock (LOCK) {
-                Message p = mMessages;
-
-                // Remove all messages at front.
-                while (p != null && p.target == h
-                        && (obj == null || p.obj == obj))
-                {
-                    Message n = p.next;
-                    mMessages = n;
-                    p.recycleUnchecked();
-                    p = n;
-                }
-
-                // Remove all messages after front.
+                drainInboxLocked();
+                Message p = mSchedule.first(h);
                 while (p != null)
                 {
-                    Message n = p.next;
-                    if (n != null)
+                    Message n = p.handlerNext;
+                    if (obj == null || p.obj == obj)
                     {
-                        if (n.target == h && (obj == null || n.obj == obj))
-                        {
-                            Message nn = n.next;
-                            n.recycleUnchecked();
-                            p.next = nn;
-                            continue;
-                        }
+                        mSchedule.remove(p);
+                        p.recycleUnchecked();
                     }
                     p = n;
                 }
@@ -1169,31 +1108,15 @@ namespace AndroidUI.Execution
             }
 
             lock (LOCK) {
-                Message p = mMessages;
-
-                // Remove all messages at front.
-                while (p != null && p.target == h
-                        && (obj == null || obj.Equals(p.obj)))
-                {
-                    Message n = p.next;
-                    mMessages = n;
-                    p.recycleUnchecked();
-                    p = n;
-                }
-
-                // Remove all messages after front.
+                drainInboxLocked();
+                Message p = mSchedule.first(h);
                 while (p != null)
                 {
-                    Message n = p.next;
-                    if (n != null)
+                    Message n = p.handlerNext;
+                    if (obj == null || obj.Equals(p.obj))
                     {
-                        if (n.target == h && (obj == null || obj.Equals(n.obj)))
-                        {
-                            Message nn = n.next;
-                            n.recycleUnchecked();
-                            p.next = nn;
-                            continue;
-                        }
+                        mSchedule.remove(p);
+                        p.recycleUnchecked();
                     }
                     p = n;
                 }
@@ -1202,51 +1125,12 @@ namespace AndroidUI.Execution
 
         private void removeAllMessagesLocked()
         {
-            Message p = mMessages;
-            while (p != null)
-            {
-                Message n = p.next;
-                p.recycleUnchecked();
-                p = n;
-            }
-            mMessages = null;
+            mSchedule.removeAfter(long.MinValue, m => m.recycleUnchecked());
         }
 
         private void removeAllFutureMessagesLocked()
         {
-            long now = NanoTime.currentTimeMillis();
-            Message p = mMessages;
-            if (p != null)
-            {
-                if (p.when > now)
-                {
-                    removeAllMessagesLocked();
-                }
-                else
-                {
-                    Message n;
-                    for(;;)
-                    {
-                        n = p.next;
-                        if (n == null)
-                        {
-                            return;
-                        }
-                        if (n.when > now)
-                        {
-                            break;
-                        }
-                        p = n;
-                    }
-                    p.next = null;
-                    do
-                    {
-                        p = n;
-                        n = p.next;
-                        p.recycleUnchecked();
-                    } while (n != null);
-                }
-            }
+            mSchedule.removeAfter(NanoTime.currentTimeMillis(), m => m.recycleUnchecked());
         }
 
         /**
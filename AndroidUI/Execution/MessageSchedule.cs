@@ -0,0 +1,273 @@
+﻿namespace AndroidUI.Execution
+{
+    /**
+     * The pending messages of a {@link MessageQueue}, ordered by delivery time.
+     *
+     * Messages are kept in two pairing heaps, one holding synchronous messages and sync
+     * barriers, the other holding asynchronous messages, so the first message a barrier
+     * lets through is found without scanning. Insertion is O(1) and removing any message,
+     * including the first, is O(log n) amortized.
+     *
+     * Messages with the same delivery time keep the order they were inserted in, except
+     * that messages with a time of 0 go in front of everything, newest first, exactly as
+     * the linked list MessageQueue used to keep did.
+     *
+     * Every message is also linked into a list for its handler, or recorded by token if
+     * it is a barrier, so looking up or removing the messages of one handler only visits
+     * that handler's messages.
+     *
+     * Not thread safe, MessageQueue only touches it while holding its lock.
+     */
+    internal sealed class MessageSchedule
+    {
+        private Message mSync;
+        private Message mAsync;
+        private long mNextSeq;
+        private int mCount;
+        private readonly Dictionary<Handler, Message> mByHandler = new(ReferenceEqualityComparer.Instance);
+        private readonly Dictionary<int, Message> mBarriers = new();
+
+        internal int count => mCount;
+
+        /**
+         * The first message, which may be a barrier, or null if there are none.
+         */
+        internal Message peek()
+        {
+            if (mSync == null)
+            {
+                return mAsync;
+            }
+            if (mAsync == null)
+            {
+                return mSync;
+            }
+            return before(mAsync, mSync) ? mAsync : mSync;
+        }
+
+        /**
+         * The first message that may be delivered, skipping synchronous messages
+         * stalled behind a barrier, or null if there are none.
+         */
+        internal Message peekDeliverable()
+        {
+            Message first = peek();
+            if (first != null && first.target == null)
+            {
+                // Stalled by a barrier, every asynchronous message comes after it.
+                return mAsync;
+            }
+            return first;
+        }
+
+        /**
+         * The messages targeting the given handler, linked through handlerNext,
+         * in no particular order.
+         */
+        internal Message first(Handler h)
+        {
+            return mByHandler.TryGetValue(h, out Message m) ? m : null;
+        }
+
+        internal Message findBarrier(int token)
+        {
+            return mBarriers.TryGetValue(token, out Message m) ? m : null;
+        }
+
+        internal void insert(Message msg)
+        {
+            // A time of 0 means in front of everything, including earlier messages with a time of 0.
+            mNextSeq++;
+            msg.seq = msg.when == 0 ? -mNextSeq : mNextSeq;
+
+            if (msg.target == null)
+            {
+                mBarriers[msg.arg1] = msg;
+                mSync = mSync == null ? msg : link(mSync, msg);
+            }
+            else
+            {
+                if (mByHandler.TryGetValue(msg.target, out Message head))
+                {
+                    msg.handlerNext = head;
+                    head.handlerPrev = msg;
+                }
+                mByHandler[msg.target] = msg;
+                if (msg.isAsynchronous())
+                {
+                    mAsync = mAsync == null ? msg : link(mAsync, msg);
+                }
+                else
+                {
+                    mSync = mSync == null ? msg : link(mSync, msg);
+                }
+            }
+            mCount++;
+        }
+
+        internal void remove(Message msg)
+        {
+            if (msg.target == null)
+            {
+                mBarriers.Remove(msg.arg1);
+                mSync = remove(mSync, msg);
+            }
+            else
+            {
+                if (msg.handlerPrev != null)
+                {
+                    msg.handlerPrev.handlerNext = msg.handlerNext;
+                }
+                else if (msg.handlerNext != null)
+                {
+                    mByHandler[msg.target] = msg.handlerNext;
+                }
+                else
+                {
+                    mByHandler.Remove(msg.target);
+                }
+                if (msg.handlerNext != null)
+                {
+                    msg.handlerNext.handlerPrev = msg.handlerPrev;
+                }
+                msg.handlerPrev = null;
+                msg.handlerNext = null;
+
+                if (msg.isAsynchronous())
+                {
+                    mAsync = remove(mAsync, msg);
+                }
+                else
+                {
+                    mSync = remove(mSync, msg);
+                }
+            }
+            mCount--;
+        }
+
+        /**
+         * Removes every message whose delivery time is after now, or every message if
+         * now is long.MinValue, and hands each to the given action.
+         */
+        internal void removeAfter(long now, Action<Message> removed)
+        {
+            List<Message> matches = new();
+            foreach (Message head in mByHandler.Values)
+            {
+                for (Message p = head; p != null; p = p.handlerNext)
+                {
+                    if (p.when > now)
+                    {
+                        matches.Add(p);
+                    }
+                }
+            }
+            foreach (Message barrier in mBarriers.Values)
+            {
+                if (barrier.when > now)
+                {
+                    matches.Add(barrier);
+                }
+            }
+            foreach (Message m in matches)
+            {
+                remove(m);
+                removed(m);
+            }
+        }
+
+        private static bool before(Message a, Message b)
+        {
+            return a.when < b.when || (a.when == b.when && a.seq < b.seq);
+        }
+
+        // Links two heap roots, the later becomes the first child of the earlier.
+        private static Message link(Message a, Message b)
+        {
+            if (before(b, a))
+            {
+                (a, b) = (b, a);
+            }
+            b.heapPrev = a;
+            b.heapSibling = a.heapChild;
+            if (a.heapChild != null)
+            {
+                a.heapChild.heapPrev = b;
+            }
+            a.heapChild = b;
+            return a;
+        }
+
+        private static Message remove(Message root, Message msg)
+        {
+            Message children = msg.heapChild;
+            if (msg != root)
+            {
+                // heapPrev is the parent of a first child, otherwise the previous sibling.
+                if (msg.heapPrev.heapChild == msg)
+                {
+                    msg.heapPrev.heapChild = msg.heapSibling;
+                }
+                else
+                {
+                    msg.heapPrev.heapSibling = msg.heapSibling;
+                }
+                if (msg.heapSibling != null)
+                {
+                    msg.heapSibling.heapPrev = msg.heapPrev;
+                }
+            }
+            msg.heapChild = null;
+            msg.heapSibling = null;
+            msg.heapPrev = null;
+
+            Message merged = mergePairs(children);
+            if (msg == root)
+            {
+                return merged;
+            }
+            return merged == null ? root : link(root, merged);
+        }
+
+        // The standard two pass merge of a list of siblings into one heap.
+        private static Message mergePairs(Message first)
+        {
+            if (first == null)
+            {
+                return null;
+            }
+
+            // Link siblings in pairs left to right, collecting the results in reverse.
+            Message pairs = null;
+            while (first != null)
+            {
+                Message a = first;
+                Message b = a.heapSibling;
+                first = b?.heapSibling;
+                a.heapSibling = null;
+                a.heapPrev = null;
+                if (b != null)
+                {
+                    b.heapSibling = null;
+                    b.heapPrev = null;
+                    a = link(a, b);
+                }
+                a.heapSibling = pairs;
+                pairs = a;
+            }
+
+            // Then link the pairs right to left.
+            Message result = pairs;
+            pairs = pairs.heapSibling;
+            result.heapSibling = null;
+            while (pairs != null)
+            {
+                Message n = pairs.heapSibling;
+                pairs.heapSibling = null;
+                result = link(result, pairs);
+                pairs = n;
+            }
+            return result;
+        }
+    }
+}
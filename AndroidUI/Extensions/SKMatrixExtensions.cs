@@ -0,0 +1,194 @@
+﻿using AndroidUI.Utils;
+using SkiaSharp;
+using static AndroidUI.Native;
+
+namespace AndroidUI.Extensions
+{
+    /// <summary>
+    /// batched matrix mapping, each call classifies the matrix once and maps the whole span natively
+    /// <br></br>
+    /// SKMatrix is 9 sequential floats in the same order as SkMatrix so it is passed by pointer
+    /// </summary>
+    public static class SKMatrixExtensions
+    {
+        [Flags]
+        public enum TypeMask
+        {
+            Identity = 0,
+            Translate = 0x01,
+            Scale = 0x02,
+            Affine = 0x04,
+            Perspective = 0x08,
+        }
+
+        /** Returns a bit field describing the transformations the matrix may
+            perform. The bit field is computed conservatively, so it may include
+            false positives. For example, when kPerspective_Mask is set, all
+            other bits are set.
+
+            @return  kIdentity_Mask, or combinations of: kTranslate_Mask, kScale_Mask,
+                     kAffine_Mask, kPerspective_Mask
+        */
+        public static unsafe TypeMask getType(this ref SKMatrix matrix)
+        {
+            fixed (SKMatrix* m = &matrix)
+            {
+                return (TypeMask)Additional.SkKernel_matrixGetType((float*)m);
+            }
+        }
+
+        /** Returns true if SkMatrix at most scales and translates. SkMatrix may be identity,
+            contain only scale elements, only translate elements, or both. SkMatrix form is:
+
+                | scale-x    0    translate-x |
+                |    0    scale-y translate-y |
+                |    0       0         1      |
+
+            @return  true if SkMatrix is identity; or scales, translates, or both
+        */
+        public static bool IsScaleTranslate(this ref SKMatrix matrix)
+        {
+            return (matrix.getType() & ~(TypeMask.Scale | TypeMask.Translate)) == 0;
+        }
+
+        /// <summary>
+        /// maps src into dst, dst may be the same memory as src
+        /// </summary>
+        public static unsafe void mapPoints(this ref SKMatrix matrix, Span<SKPoint> dst, ReadOnlySpan<SKPoint> src)
+        {
+            if (dst.Length < src.Length)
+            {
+                throw new ArgumentOutOfRangeException(nameof(dst), "dst length (" + dst.Length + ") is less than src length (" + src.Length + ")");
+            }
+            fixed (SKMatrix* m = &matrix)
+            fixed (SKPoint* d = dst)
+            fixed (SKPoint* s = src)
+            {
+                Additional.SkKernel_mapPoints((float*)m, (float*)d, (float*)s, src.Length);
+            }
+        }
+
+        /// <summary>
+        /// maps pts in place
+        /// </summary>
+        public static void mapPoints(this ref SKMatrix matrix, Span<SKPoint> pts)
+        {
+            matrix.mapPoints(pts, pts);
+        }
+
+        /// <summary>
+        /// maps a single point, avoids allocating an array for SKMatrix.MapPoints
+        /// </summary>
+        public static unsafe SKPoint mapXY(this ref SKMatrix matrix, float x, float y)
+        {
+            SKPoint p = new(x, y);
+            fixed (SKMatrix* m = &matrix)
+            {
+                Additional.SkKernel_mapPoints((float*)m, (float*)&p, (float*)&p, 1);
+            }
+            return p;
+        }
+
+        /// <summary>
+        /// maps points stored as separate x and y arrays, the destinations may be the same memory as the sources
+        /// </summary>
+        public static unsafe void mapXY(this ref SKMatrix matrix, ReadOnlySpan<float> srcX, ReadOnlySpan<float> srcY, Span<float> dstX, Span<float> dstY)
+        {
+            int count = srcX.Length;
+            if (srcY.Length != count || dstX.Length < count || dstY.Length < count)
+            {
+                throw new ArgumentOutOfRangeException(nameof(srcY), "x and y spans must have matching lengths");
+            }
+            fixed (SKMatrix* m = &matrix)
+            fixed (float* sx = srcX)
+            fixed (float* sy = srcY)
+            fixed (float* dx = dstX)
+            fixed (float* dy = dstY)
+            {
+                Additional.SkKernel_mapXY((float*)m, sx, sy, dx, dy, count);
+            }
+        }
+
+        /// <summary>
+        /// maps every rect in src and stores its sorted bounds in dst, dst may be the same memory as src
+        /// </summary>
+        public static unsafe void mapRects(this ref SKMatrix matrix, Span<SKRect> dst, ReadOnlySpan<SKRect> src)
+        {
+            if (dst.Length < src.Length)
+            {
+                throw new ArgumentOutOfRangeException(nameof(dst), "dst length (" + dst.Length + ") is less than src length (" + src.Length + ")");
+            }
+            fixed (SKMatrix* m = &matrix)
+            fixed (SKRect* d = dst)
+            fixed (SKRect* s = src)
+            {
+                Additional.SkKernel_mapRects((float*)m, (float*)d, (float*)s, src.Length);
+            }
+        }
+
+        /// <summary>
+        /// maps rect in place, unlike SKMatrix.MapRect(RectF) the result is written back into rect
+        /// </summary>
+        public static unsafe void mapRect(this ref SKMatrix matrix, RectF rect)
+        {
+            SKRect r = new(rect.left, rect.top, rect.right, rect.bottom);
+            fixed (SKMatrix* m = &matrix)
+            {
+                Additional.SkKernel_mapRects((float*)m, (float*)&r, (float*)&r, 1);
+            }
+            rect.set(r.Left, r.Top, r.Right, r.Bottom);
+        }
+
+        /// <summary>
+        /// maps src[i] by matrices[i] and stores the sorted bounds in dst[i]
+        /// </summary>
+        public static unsafe void mapRects(ReadOnlySpan<SKMatrix> matrices, Span<SKRect> dst, ReadOnlySpan<SKRect> src)
+        {
+            if (matrices.Length < src.Length || dst.Length < src.Length)
+            {
+                throw new ArgumentOutOfRangeException(nameof(src), "matrices and dst must be at least as long as src (" + src.Length + ")");
+            }
+            fixed (SKMatrix* m = matrices)
+            fixed (SKRect* d = dst)
+            fixed (SKRect* s = src)
+            {
+                Additional.SkKernel_mapRectsPerMatrix((float*)m, (float*)d, (float*)s, src.Length);
+            }
+        }
+
+        /** Returns geometric mean radius of ellipse formed by constructing circle of
+            size radius, and mapping constructed circle with SkMatrix. The result squared is
+            equal to the major axis length times the minor axis length.
+            Result is not meaningful if SkMatrix contains perspective elements.
+
+            @param radius  circle size to map
+            @return        average mapped radius
+        */
+        public static unsafe float mapRadius(this ref SKMatrix matrix, float radius)
+        {
+            float r = radius;
+            fixed (SKMatrix* m = &matrix)
+            {
+                Additional.SkKernel_mapRadius((float*)m, &r, &r, 1);
+            }
+            return r;
+        }
+
+        /// <summary>
+        /// maps every radius in src, see <see cref="mapRadius(ref SKMatrix, float)"/>
+        /// </summary>
+        public static unsafe void mapRadius(this ref SKMatrix matrix, Span<float> dst, ReadOnlySpan<float> src)
+        {
+            if (dst.Length < src.Length)
+            {
+                throw new ArgumentOutOfRangeException(nameof(dst), "dst length (" + dst.Length + ") is less than src length (" + src.Length + ")");
+            }
+            fixed (SKMatrix* m = &matrix)
+            fixed (float* d = dst)
+            fixed (float* s = src)
+            {
+                Additional.SkKernel_mapRadius((float*)m, d, s, src.Length);
+            }
+        }
+    }
+}
@@ -111,40 +111,28 @@ namespace AndroidUI.Extensions
                 return true;
             }
 
-            Sk4s min, max;
-            if ((count & 1).toBool())
+            // the whole point array is handed to native code in a single call,
+            // walking it two points at a time through Sk4s costs several
+            // P/Invoke transitions and native allocations per step
+            SKPoint[] array = pts.GetArray() as SKPoint[];
+            int offset = pts.offset;
+            if (array == null || array.Length - offset < count)
             {
-                min = max = new Sk4s(pts[0].X, pts[0].Y, pts[0].X, pts[0].Y);
-                pts += 1;
-                count -= 1;
-            }
-            else
-            {
-                min = max = Sk4s.Load(pts.MapToArray(SKUtils.createSKPointMapper()));
-                pts += 2;
-                count -= 2;
+                // not backed by a flat SKPoint[], copy it into one
+                array = new SKPoint[count];
+                pts.Copy(array, count);
+                offset = 0;
             }
 
-            Sk4s accum = min * 0;
-            while (count != 0)
+            bool all_finite;
+            unsafe
             {
-                Sk4s xy = Sk4s.Load(pts.MapToArray(SKUtils.createSKPointMapper()));
-                accum = accum * xy;
-                min = Sk4s.Min(min, xy);
-                max = Sk4s.Max(max, xy);
-                pts += 2;
-                count -= 2;
-            }
-
-            bool all_finite = (accum * 0 == 0).AllTrue();
-            if (all_finite)
-            {
-                point.SetLTRB(MathF.Min(min[0], min[2]), MathF.Min(min[1], min[3]),
-                              MathF.Max(max[0], max[2]), MathF.Max(max[1], max[3]));
-            }
-            else
-            {
-                point = SKRect.Empty;
+                float* ltrb = stackalloc float[4];
+                fixed (SKPoint* p = &array[offset])
+                {
+                    all_finite = Additional.SkKernel_computeBounds((float*)p, count, ltrb);
+                }
+                point.SetLTRB(ltrb[0], ltrb[1], ltrb[2], ltrb[3]);
             }
             return all_finite;
         }
@@ -12,6 +12,10 @@ namespace AndroidUI.Graphics
         internal GRContext graphicsContext;
         internal SKSurface surface;
 
+        // the recording behind this canvas while a View records its display list into it,
+        // the render nodes of the View's children are recorded into it by reference
+        internal RecordingCanvas2 displayListRecorder;
+
         private int densityDPI;
         private bool ownsSurface;
 
@@ -0,0 +1,366 @@
+﻿using AndroidUI.Applications;
+using AndroidUI.Execution;
+using AndroidUI.Utils;
+
+namespace AndroidUI.Graphics
+{
+    /**
+     * Decodes bitmaps on a bounded pool of worker threads instead of the thread that
+     * wants them.
+     *
+     * Requests with a higher priority are decoded first, requests of equal priority in
+     * the order they were made. A list raises the priority of the items that scroll into
+     * view, and lowers or cancels the ones that scroll out of it.
+     *
+     * A finished bitmap is posted to the Handler given with its request and handed to the
+     * request's callback on that Handler's Looper, the callback receives null if the image
+     * could not be decoded. The callback of a cancelled request is never called.
+     *
+     * The codecs decode straight into the pixels of the Bitmap that is delivered, files are
+     * decoded out of a memory mapping and byte arrays in place, neither the encoded data
+     * nor the pixels are copied on the way.
+     */
+    public sealed class BitmapDecodeQueue : IDisposable
+    {
+        public const int PRIORITY_DEFAULT = 0;
+        public const int PRIORITY_VISIBLE = 10;
+
+        private const int STATE_PENDING = 0;
+        private const int STATE_DECODING = 1;
+        private const int STATE_POSTED = 2;
+        private const int STATE_DELIVERED = 3;
+        private const int STATE_CANCELLED = 4;
+
+        /**
+         * A decode that has been queued.
+         */
+        public sealed class Request
+        {
+            private readonly BitmapDecodeQueue mQueue;
+            internal readonly Func<Context, BitmapFactory.Options, Bitmap> mDecode;
+            internal readonly BitmapFactory.Options mOptions;
+            private readonly Handler mHandler;
+            private readonly Runnable<Request, Bitmap> mCallback;
+            private CancellationTokenRegistration mRegistration;
+            internal readonly long mSequence;
+            // guarded by the queue's lock
+            internal int mPriority;
+            internal int mState;
+
+            internal Request(
+                BitmapDecodeQueue queue, Func<Context, BitmapFactory.Options, Bitmap> decode,
+                BitmapFactory.Options options, int priority, Handler handler,
+                Runnable<Request, Bitmap> callback, long sequence
+            )
+            {
+                mQueue = queue;
+                mDecode = decode;
+                mOptions = options;
+                mPriority = priority;
+                mHandler = handler;
+                mCallback = callback;
+                mSequence = sequence;
+            }
+
+            internal void register(CancellationToken cancellationToken)
+            {
+                if (cancellationToken.CanBeCanceled)
+                {
+                    mRegistration = cancellationToken.Register(() => cancel());
+                }
+            }
+
+            public int getPriority()
+            {
+                lock (mQueue.mLock)
+                {
+                    return mPriority;
+                }
+            }
+
+            /**
+             * Changes the priority of a request that has not started decoding yet.
+             */
+            public void setPriority(int priority)
+            {
+                mQueue.reprioritize(this, priority);
+            }
+
+            /**
+             * Cancels the request. A request that is still queued is dropped, a request
+             * that is decoding, or whose bitmap is on its way to the Handler, has its bitmap
+             * recycled instead of delivered.
+             *
+             * @return false if the bitmap has already been delivered.
+             */
+            public bool cancel()
+            {
+                lock (mQueue.mLock)
+                {
+                    switch (mState)
+                    {
+                        case STATE_DELIVERED:
+                            return false;
+                        case STATE_CANCELLED:
+                            return true;
+                        case STATE_PENDING:
+                            mQueue.mPendingCount--;
+                            break;
+                        case STATE_DECODING:
+                            mOptions?.requestCancelDecode();
+                            break;
+                    }
+                    mState = STATE_CANCELLED;
+                }
+                mRegistration.Dispose();
+                return true;
+            }
+
+            public bool isCancelled()
+            {
+                lock (mQueue.mLock)
+                {
+                    return mState == STATE_CANCELLED;
+                }
+            }
+
+            internal void deliver(Bitmap bitmap)
+            {
+                lock (mQueue.mLock)
+                {
+                    if (mState != STATE_DECODING)
+                    {
+                        bitmap?.recycle();
+                        return;
+                    }
+                    mState = STATE_POSTED;
+                }
+                if (!mHandler.post(() => onDelivered(bitmap)))
+                {
+                    // the Looper has quit
+                    bitmap?.recycle();
+                }
+            }
+
+            private void onDelivered(Bitmap bitmap)
+            {
+                lock (mQueue.mLock)
+                {
+                    if (mState != STATE_POSTED)
+                    {
+                        bitmap?.recycle();
+                        return;
+                    }
+                    mState = STATE_DELIVERED;
+                }
+                mRegistration.Dispose();
+                mCallback.Invoke(this, bitmap);
+            }
+        }
+
+        private readonly Context mContext;
+        private readonly int mMaxWorkers;
+        private readonly object mLock = new();
+        // keyed by (-priority, sequence), a request whose priority changed is queued again
+        // and its old entry is skipped
+        private readonly PriorityQueue<Request, (int, long)> mRequests = new();
+        private readonly List<Thread> mWorkers = new();
+        private int mIdleWorkers;
+        private int mPendingCount;
+        private long mNextSequence;
+        private bool mQuit;
+
+        /**
+         * @param maxWorkers the most threads that decode at once.
+         */
+        public BitmapDecodeQueue(Context context, int maxWorkers)
+        {
+            if (maxWorkers <= 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(maxWorkers), "a decode queue needs at least one worker");
+            }
+            mContext = context;
+            mMaxWorkers = maxWorkers;
+        }
+
+        /**
+         * Creates a queue with a worker for every processor but one, up to 4.
+         */
+        public BitmapDecodeQueue(Context context) : this(context, Math.Clamp(Environment.ProcessorCount - 1, 1, 4))
+        {
+        }
+
+        /**
+         * Queues a {@link BitmapFactory#decodeFile} of pathName.
+         */
+        public Request decodeFile(
+            string pathName, BitmapFactory.Options opts, int priority,
+            Handler handler, Runnable<Request, Bitmap> callback,
+            CancellationToken cancellationToken = default
+        )
+        {
+            return enqueue((context, options) => BitmapFactory.decodeFile(context, pathName, options),
+                opts, priority, handler, callback, cancellationToken);
+        }
+
+        /**
+         * Queues a {@link BitmapFactory#decodeByteArray} of data. The array is read in place
+         * and must not be modified until the callback has been called or the request has
+         * been cancelled.
+         */
+        public Request decodeByteArray(
+            byte[] data, int offset, int length, BitmapFactory.Options opts, int priority,
+            Handler handler, Runnable<Request, Bitmap> callback,
+            CancellationToken cancellationToken = default
+        )
+        {
+            if ((offset | length) < 0 || data.Length < offset + length)
+            {
+                throw new IndexOutOfRangeException();
+            }
+            return enqueue((context, options) => BitmapFactory.decodeByteArray(context, data, offset, length, options),
+                opts, priority, handler, callback, cancellationToken);
+        }
+
+        private Request enqueue(
+            Func<Context, BitmapFactory.Options, Bitmap> decode, BitmapFactory.Options opts, int priority,
+            Handler handler, Runnable<Request, Bitmap> callback, CancellationToken cancellationToken
+        )
+        {
+            ArgumentNullException.ThrowIfNull(handler);
+            ArgumentNullException.ThrowIfNull(callback);
+            BitmapFactory.Options.validate(opts);
+            Request request;
+            lock (mLock)
+            {
+                if (mQuit)
+                {
+                    throw new ObjectDisposedException(nameof(BitmapDecodeQueue));
+                }
+                request = new(this, decode, opts, priority, handler, callback, mNextSequence++);
+                mRequests.Enqueue(request, (-priority, request.mSequence));
+                mPendingCount++;
+                if (mIdleWorkers == 0 && mWorkers.Count < mMaxWorkers)
+                {
+                    Thread worker = new(work)
+                    {
+                        IsBackground = true,
+                        Name = "BitmapDecodeQueue #" + mWorkers.Count
+                    };
+                    mWorkers.Add(worker);
+                    worker.Start();
+                }
+                else
+                {
+                    Monitor.Pulse(mLock);
+                }
+            }
+            // registered outside of the lock, an already cancelled token cancels right away
+            request.register(cancellationToken);
+            return request;
+        }
+
+        private void reprioritize(Request request, int priority)
+        {
+            lock (mLock)
+            {
+                if (request.mPriority == priority)
+                {
+                    return;
+                }
+                request.mPriority = priority;
+                if (request.mState == STATE_PENDING)
+                {
+                    mRequests.Enqueue(request, (-priority, request.mSequence));
+                }
+            }
+        }
+
+        /**
+         * Returns how many requests are waiting to be decoded.
+         */
+        public int getPendingCount()
+        {
+            lock (mLock)
+            {
+                return mPendingCount;
+            }
+        }
+
+        // returns null once the queue has been disposed
+        private Request take()
+        {
+            lock (mLock)
+            {
+                while (true)
+                {
+                    if (mQuit)
+                    {
+                        return null;
+                    }
+                    while (mRequests.TryDequeue(out Request request, out (int, long) key))
+                    {
+                        // cancelled, or queued again with another priority
+                        if (request.mState != STATE_PENDING || key.Item1 != -request.mPriority)
+                        {
+                            continue;
+                        }
+                        request.mState = STATE_DECODING;
+                        mPendingCount--;
+                        return request;
+                    }
+                    mIdleWorkers++;
+                    Monitor.Wait(mLock);
+                    mIdleWorkers--;
+                }
+            }
+        }
+
+        private void work()
+        {
+            Request request;
+            while ((request = take()) != null)
+            {
+                Bitmap bitmap = null;
+                try
+                {
+                    bitmap = request.mDecode(mContext, request.mOptions);
+                }
+                catch (Exception e)
+                {
+                    Log.e("BitmapDecodeQueue", "Unable to decode: " + e);
+                }
+                request.deliver(bitmap);
+            }
+        }
+
+        /**
+         * Cancels every queued request and stops the workers once their current decode
+         * is finished, the requests already decoding are still delivered.
+         */
+        public void Dispose()
+        {
+            List<Request> cancelled = new();
+            lock (mLock)
+            {
+                if (mQuit)
+                {
+                    return;
+                }
+                mQuit = true;
+                while (mRequests.TryDequeue(out Request request, out _))
+                {
+                    if (request.mState == STATE_PENDING)
+                    {
+                        cancelled.Add(request);
+                    }
+                }
+                Monitor.PulseAll(mLock);
+            }
+            foreach (Request request in cancelled)
+            {
+                request.cancel();
+            }
+        }
+    }
+}
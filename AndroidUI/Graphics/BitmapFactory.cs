@@ -520,6 +520,23 @@ namespace AndroidUI.Graphics
             FileStream stream = null;
             try
             {
+                // decode straight out of a mapping of the file when it can be mapped
+                using MappedPng png = pathName == null ? null : MappedPng.open(pathName);
+                if (png != null)
+                {
+                    bm = nativeDecodeMapped(context, png, opts,
+                            Options.nativeInBitmap(opts),
+                            Options.nativeColorSpace(opts));
+
+                    if (bm == null && opts != null && opts.inBitmap != null)
+                    {
+                        throw new IllegalArgumentException("Problem decoding into existing bitmap");
+                    }
+
+                    setDensityFromOptions(context, bm, opts);
+                    return bm;
+                }
+
                 stream = new FileStream(pathName, FileMode.Open);
                 bm = decodeStream(context, stream, opts);
             }
@@ -941,7 +958,7 @@ namespace AndroidUI.Graphics
             return decodeFileDescriptor(context, fd, null);
         }
 
-        static string getMimeType(SKEncodedImageFormat format)
+        internal static string getMimeType(SKEncodedImageFormat format)
         {
             switch (format)
             {
@@ -1189,7 +1206,7 @@ namespace AndroidUI.Graphics
         }
 
         private static Bitmap doDecode(Context context, SKStreamRewindable stream, bool hasPadding, out int[] padding, Options options,
-            SKBitmap bitmapHandle, SKColorSpace colorSpaceHandle)
+            SKBitmap bitmapHandle, SKColorSpace colorSpaceHandle, MappedPng mapped = null)
         {
             padding = null;
 
@@ -1255,7 +1272,12 @@ namespace AndroidUI.Graphics
             using NinePatchPeeker peeker = new();
             SKCodecResult result_;
 
-            using SKCodec c = SKCodec.Create(stream, out result_, peeker);
+            // a mapped PNG hands out its nine patch chunks in place, the codec then has
+            // no chunks to copy
+            bool chunksRead = mapped != null && peeker.ReadChunks(mapped);
+            using SKCodec c = chunksRead
+                ? SKCodec.Create(stream, out result_)
+                : SKCodec.Create(stream, out result_, peeker);
 
             if (c == null)
             {
@@ -1502,33 +1524,60 @@ namespace AndroidUI.Graphics
             }
 
             SKBitmap decodingBitmap = new();
-            if (!decodingBitmap.SetInfo(bitmapInfo) ||
-                    !decodingBitmap.TryAllocPixels(decodeAllocator))
-            {
-                // SkAndroidCodec should recommend a valid SkImageInfo, so setInfo()
-                // should only only fail if the calculated value for rowBytes is too
-                // large.
-                // tryAllocPixels() can fail due to OOM on the Java heap, OOM on the
-                // native heap, or the recycled javaBitmap being too small to reuse.
-                return null;
+            SKBitmap outputBitmap = new();
+
+            // A scaled decode into a new bitmap streams the scanlines through the
+            // resampler, sampleSize and the density scale are applied in the same
+            // pass and the full size image is never allocated.
+            bool streamed = false;
+            if (willScale && javaBitmap == null && !isHardware && ScanlineDecoder.canResample(bitmapInfo))
+            {
+                using ScanlineDecoder scanlineDecoder = ScanlineDecoder.start(
+                    c, decodeInfo, SKRectI.Create(c.Info.Size), scaledWidth, scaledHeight
+                );
+                if (scanlineDecoder != null)
+                {
+                    if (!outputBitmap.SetInfo(bitmapInfo.WithSize(scaledWidth, scaledHeight)) ||
+                            !outputBitmap.TryAllocPixels(defaultAllocator))
+                    {
+                        Console.WriteLine("allocation failed for scaled bitmap");
+                        return null;
+                    }
+                    scanlineDecoder.decode(outputBitmap);
+                    streamed = true;
+                }
             }
 
-            // Use SkAndroidCodec to perform the decode.
-            SKAndroidCodecOptions codecOptions = new();
-            codecOptions.ZeroInitialized = decodeAllocator == defaultAllocator ?
-                    SKZeroInitialized.Yes : SKZeroInitialized.No;
-            codecOptions.SampleSize = sampleSize;
-            SKCodecResult result = codec.GetAndroidPixels(
-                decodeInfo, decodingBitmap.GetPixels(), decodingBitmap.RowBytes, codecOptions
-            );
-            switch (result)
+            if (!streamed)
             {
-                case SKCodecResult.Success:
-                case SKCodecResult.IncompleteInput:
-                    break;
-                default:
-                    Console.WriteLine("codec.GetAndroidPixels() failed.");
+                if (!decodingBitmap.SetInfo(bitmapInfo) ||
+                        !decodingBitmap.TryAllocPixels(decodeAllocator))
+                {
+                    // SkAndroidCodec should recommend a valid SkImageInfo, so setInfo()
+                    // should only only fail if the calculated value for rowBytes is too
+                    // large.
+                    // tryAllocPixels() can fail due to OOM on the Java heap, OOM on the
+                    // native heap, or the recycled javaBitmap being too small to reuse.
                     return null;
+                }
+
+                // Use SkAndroidCodec to perform the decode.
+                SKAndroidCodecOptions codecOptions = new();
+                codecOptions.ZeroInitialized = decodeAllocator == defaultAllocator ?
+                        SKZeroInitialized.Yes : SKZeroInitialized.No;
+                codecOptions.SampleSize = sampleSize;
+                SKCodecResult result = codec.GetAndroidPixels(
+                    decodeInfo, decodingBitmap.GetPixels(), decodingBitmap.RowBytes, codecOptions
+                );
+                switch (result)
+                {
+                    case SKCodecResult.Success:
+                    case SKCodecResult.IncompleteInput:
+                        break;
+                    default:
+                        Console.WriteLine("codec.GetAndroidPixels() failed.");
+                        return null;
+                }
             }
 
             // This is weird so let me explain: we could use the scale parameter
@@ -1536,8 +1585,8 @@ namespace AndroidUI.Graphics
             // Dalvik code has always behaved. We simply recreate the behavior here.
             // The result is slightly different from simply using scale because of
             // the 0.5f rounding bias applied when computing the target image size
-            float scaleX = scaledWidth / (float)decodingBitmap.Width;
-            float scaleY = scaledHeight / (float)decodingBitmap.Height;
+            float scaleX = scaledWidth / (float)size.Width;
+            float scaleY = scaledHeight / (float)size.Height;
 
             byte[] ninePatchChunk = null;
             if (peeker.HasPatch)
@@ -1586,8 +1635,7 @@ namespace AndroidUI.Graphics
                 }
             }
 
-            SKBitmap outputBitmap = new();
-            if (willScale)
+            if (willScale && !streamed)
             {
                 // Set the allocator for the outputBitmap.
                 SKBitmap.Allocator outputAllocator;
@@ -1639,7 +1687,7 @@ namespace AndroidUI.Graphics
                 */
                 canvas.DrawImage(i, 0.0f, 0.0f, paint);
             }
-            else
+            else if (!streamed)
             {
                 SKUtils.Swap(ref outputBitmap, ref decodingBitmap);
             }
@@ -1776,7 +1824,14 @@ namespace AndroidUI.Graphics
             }
             */
 
-            SKBitmap tmp = new(info, SKBitmapAllocFlags.ZeroPixels);
+            // the pixels come from the pool, a buffer released by a recycled bitmap is
+            // reused when it is large enough
+            SKBitmap tmp = new();
+            if (!BitmapPool.installPixels(tmp, info))
+            {
+                tmp.Dispose();
+                tmp = new(info, SKBitmapAllocFlags.ZeroPixels);
+            }
             bitmap.SetInfo(info, tmp.RowBytes);
             bitmap.SetPixelRef(tmp.PixelRef, 0, 0);
             return tmp;
@@ -2106,21 +2161,31 @@ namespace AndroidUI.Graphics
             return doDecode(context, b, out padding, options, inBitmapHandle, colorSpaceHandle);
         }
 
+        static Bitmap nativeDecodeMapped(
+            Context context, MappedPng png,
+            Options options, SKBitmap inBitmapHandle, SKColorSpace colorSpaceHandle)
+        {
+            // the stream reads the mapping in place
+            using SKData data = png.asData();
+            using SKMemoryStream stream = new(data);
+            return doDecode(context, stream, false, out _, options, inBitmapHandle, colorSpaceHandle, png);
+        }
+
         static Bitmap nativeDecodeByteArray(
             Context context, MemoryPointer<byte> byteArray,
             int offset, int length,
             Options options, SKBitmap inBitmapHandle, SKColorSpace colorSpaceHandle)
         {
-            byte[] bytes = offset switch
-            {
-                // offset is zero, we dont need to copy, grab underlying array
-                0 => (byte[])byteArray.GetArray(),
-                // offset is not zero, we need to copy
-                _ => (byteArray + offset).ToArray(),
-            };
-            MemoryStream m = new(bytes, 0, length);
-            using SKFrontBufferedManagedStream a = new(m, length, false);
-            return doDecode(context, a, options, inBitmapHandle, colorSpaceHandle);
+            // the codec reads the caller's array in place, it stays pinned for the decode
+            unsafe
+            {
+                fixed (byte* bytes = (byte[])byteArray.GetArray())
+                {
+                    using SKData data = SKData.Create((IntPtr)(bytes + offset), length);
+                    using SKMemoryStream stream = new(data);
+                    return doDecode(context, stream, options, inBitmapHandle, colorSpaceHandle);
+                }
+            }
         }
     }
 }
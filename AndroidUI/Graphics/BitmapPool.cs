@@ -0,0 +1,216 @@
+﻿using SkiaSharp;
+
+namespace AndroidUI.Graphics
+{
+    /**
+     * A process wide, thread safe pool of bitmap pixel memory.
+     *
+     * Every bitmap BitmapFactory allocates takes its pixels from the pool. When the
+     * bitmap is recycled, or collected, and nothing else still draws from its pixels,
+     * the memory goes back to the pool instead of to the system, and the next decode
+     * that fits reuses it. This is the automatic form of
+     * {@link BitmapFactory.Options#inBitmap}: any released buffer whose size class holds
+     * the new bitmap's byte count is compatible, whatever its old width, height or config.
+     *
+     * Sizes are rounded up to classes 4 per power of two apart, so a reused buffer wastes
+     * at most a quarter of itself. Buffers are 64 byte aligned, and large buffers use huge
+     * pages when the system provides them.
+     *
+     * Released buffers are kept within a byte budget. The pool also trims itself when
+     * a full garbage collection finds the process under memory pressure.
+     */
+    public static unsafe class BitmapPool
+    {
+        /**
+         * The device is running low on memory, half of the released buffers are freed.
+         */
+        public const int TRIM_MEMORY_RUNNING_LOW = 10;
+
+        /**
+         * The device is about to run out of memory, every released buffer is freed.
+         */
+        public const int TRIM_MEMORY_RUNNING_CRITICAL = 15;
+
+        /**
+         * The app is no longer visible, half of the released buffers are freed.
+         */
+        public const int TRIM_MEMORY_UI_HIDDEN = 20;
+
+        /**
+         * The app is in the background, every released buffer is freed.
+         */
+        public const int TRIM_MEMORY_BACKGROUND = 40;
+
+        private static readonly SKBitmapReleaseDelegate sRelease = (address, context) => release(address);
+
+        static BitmapPool()
+        {
+            MemoryPressureWatcher.start();
+        }
+
+        /**
+         * Returns 64 byte aligned pixel memory of at least bytes bytes, or IntPtr.Zero if
+         * the system is out of memory. The memory must be given back to release().
+         */
+        internal static IntPtr acquire(long bytes, bool zero)
+        {
+            return (IntPtr)Native.Additional.SkKernel_pixelPoolAcquire(bytes, zero);
+        }
+
+        internal static void release(IntPtr pixels)
+        {
+            Native.Additional.SkKernel_pixelPoolRelease((void*)pixels);
+        }
+
+        /**
+         * Installs zeroed pooled pixels for info into bitmap, the pixels go back to the
+         * pool when the bitmap's pixel ref is destroyed.
+         */
+        internal static bool installPixels(SKBitmap bitmap, SKImageInfo info)
+        {
+            long bytes = info.BytesSize64;
+            if (bytes <= 0)
+            {
+                return false;
+            }
+            IntPtr pixels = acquire(bytes, true);
+            if (pixels == IntPtr.Zero)
+            {
+                return false;
+            }
+            if (!bitmap.InstallPixels(info, pixels, info.RowBytes, sRelease, null))
+            {
+                // the release proc is called on failure too
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * The size a request for bytes bytes is rounded up to.
+         */
+        public static long getSizeClass(long bytes)
+        {
+            return Native.Additional.SkKernel_pixelPoolSizeClass(bytes);
+        }
+
+        /**
+         * Sets how many bytes of released buffers are kept, 0 frees them as soon as they
+         * are released.
+         */
+        public static void setBudget(long bytes)
+        {
+            Native.Additional.SkKernel_pixelPoolSetBudget(bytes);
+        }
+
+        /**
+         * Frees the least recently released buffers until at most keepBytes are kept.
+         */
+        public static void trimToSize(long keepBytes)
+        {
+            Native.Additional.SkKernel_pixelPoolTrim(keepBytes);
+        }
+
+        /**
+         * Frees every released buffer.
+         */
+        public static void clear()
+        {
+            trimToSize(0);
+        }
+
+        /**
+         * Trims the pool for a ComponentCallbacks2 style memory level.
+         */
+        public static void trimMemory(int level)
+        {
+            if (level >= TRIM_MEMORY_BACKGROUND || level == TRIM_MEMORY_RUNNING_CRITICAL)
+            {
+                clear();
+            }
+            else if (level >= TRIM_MEMORY_RUNNING_LOW)
+            {
+                trimToSize(getPooledByteCount() / 2);
+            }
+        }
+
+        /**
+         * Enables or disables huge pages for buffers allocated from now on, enabled by default.
+         */
+        public static void setHugePagesEnabled(bool enabled)
+        {
+            Native.Additional.SkKernel_pixelPoolSetHugePages(enabled);
+        }
+
+        private static long stat(int index)
+        {
+            long* stats = stackalloc long[5];
+            Native.Additional.SkKernel_pixelPoolStats(stats);
+            return stats[index];
+        }
+
+        /**
+         * The number of allocations that reused a released buffer
+         */
+        public static long getHitCount() => stat(0);
+
+        /**
+         * The number of allocations that needed a new buffer
+         */
+        public static long getMissCount() => stat(1);
+
+        /**
+         * The fraction of allocations that reused a released buffer, 0 before any allocation
+         */
+        public static float getHitRate()
+        {
+            long hits = getHitCount();
+            long total = hits + getMissCount();
+            return total == 0 ? 0 : hits / (float)total;
+        }
+
+        /**
+         * The bytes of released buffers kept for reuse
+         */
+        public static long getPooledByteCount() => stat(2);
+
+        /**
+         * The number of released buffers kept for reuse
+         */
+        public static long getPooledCount() => stat(3);
+
+        /**
+         * The bytes of buffers held by bitmaps
+         */
+        public static long getInUseByteCount() => stat(4);
+
+        // registers itself for finalization again every time it is finalized, so it
+        // settles in the oldest generation and runs after every full collection, the
+        // pool is trimmed when the collection finds the process close to its memory limit
+        private sealed class MemoryPressureWatcher
+        {
+            internal static void start()
+            {
+                _ = new MemoryPressureWatcher();
+            }
+
+            ~MemoryPressureWatcher()
+            {
+                if (Environment.HasShutdownStarted)
+                {
+                    return;
+                }
+                GCMemoryInfo info = GC.GetGCMemoryInfo();
+                if (info.MemoryLoadBytes >= info.HighMemoryLoadThresholdBytes)
+                {
+                    clear();
+                }
+                else if (info.MemoryLoadBytes >= info.HighMemoryLoadThresholdBytes * 3 / 4)
+                {
+                    trimToSize(getPooledByteCount() / 2);
+                }
+                GC.ReRegisterForFinalize(this);
+            }
+        }
+    }
+}
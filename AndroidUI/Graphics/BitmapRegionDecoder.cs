@@ -0,0 +1,300 @@
+﻿/*
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+using AndroidUI.Applications;
+using AndroidUI.Exceptions;
+using AndroidUI.Utils;
+using SkiaSharp;
+
+namespace AndroidUI.Graphics
+{
+    /**
+     * BitmapRegionDecoder can be used to decode a rectangle region from an image.
+     * BitmapRegionDecoder is particularly useful when an original image is large and
+     * you only need parts of the image.
+     *
+     * <p>To create a BitmapRegionDecoder, call newInstance(...).
+     * Given a BitmapRegionDecoder, users can call decodeRegion() repeatedly
+     * to get a decoded Bitmap of the specified region.
+     *
+     * <p>Only the rows of the image down to the bottom of the region are decoded, a
+     * strip at a time, and they are resampled into the region's bitmap as they are
+     * decoded, the memory used is the region's bitmap plus one strip. A codec that cannot
+     * decode scanlines, WebP's, decodes the region whole at full size and it is then
+     * resampled.
+     *
+     * <p>Regions are decoded to {@link Bitmap.Config#ARGB_8888}, premultiplied.
+     */
+    public sealed class BitmapRegionDecoder
+    {
+        private readonly Context mContext;
+        private SKCodec mCodec;
+        private SKData mData;
+        private MappedPng mMapped;
+        private bool mRecycled;
+        // ensures that the codec is only decoding one region at a time
+        private readonly object mNativeLock = new();
+
+        private BitmapRegionDecoder(Context context, SKData data, MappedPng mapped)
+        {
+            mContext = context;
+            mData = data;
+            mMapped = mapped;
+            mCodec = data == null ? null : SKCodec.Create(data);
+            if (mCodec == null)
+            {
+                data?.Dispose();
+                mapped?.Dispose();
+                throw new IOException("Image format not supported");
+            }
+        }
+
+        /**
+         * Create a BitmapRegionDecoder from the specified byte array.
+         * Currently only the JPEG, PNG, WebP and HEIF formats are supported.
+         *
+         * @param data byte array of compressed image data.
+         * @param offset offset into data for where the decoder should begin
+         *               parsing.
+         * @param length the number of bytes, beginning at offset, to parse
+         * @throws IOException if the image format is not supported or can not be decoded.
+         */
+        public static BitmapRegionDecoder newInstance(Context context, byte[] data, int offset, int length)
+        {
+            if ((offset | length) < 0 || data.Length < offset + length)
+            {
+                throw new IndexOutOfRangeException();
+            }
+            return new BitmapRegionDecoder(context, SKData.CreateCopy(new ReadOnlySpan<byte>(data, offset, length)), null);
+        }
+
+        /**
+         * Create a BitmapRegionDecoder from an input stream.
+         * The stream's position will be where ever it was after the encoded data
+         * was read.
+         * Currently only the JPEG, PNG, WebP and HEIF formats are supported.
+         *
+         * @param stream the input stream that holds the raw data
+         *           to be decoded into a BitmapRegionDecoder.
+         * @throws IOException if the image format is not supported or can not be decoded.
+         */
+        public static BitmapRegionDecoder newInstance(Context context, Stream stream)
+        {
+            ArgumentNullException.ThrowIfNull(stream);
+            return new BitmapRegionDecoder(context, SKData.Create(stream), null);
+        }
+
+        /**
+         * Create a BitmapRegionDecoder from a file path.
+         * Currently only the JPEG, PNG, WebP and HEIF formats are supported.
+         *
+         * <p>The file is mapped and decoded in place, it is never read into memory as a whole.
+         *
+         * @param pathName complete path name for the file to be decoded.
+         * @throws IOException if the image format is not supported or can not be decoded.
+         */
+        public static BitmapRegionDecoder newInstance(Context context, string pathName)
+        {
+            MappedPng mapped = MappedPng.open(pathName);
+            if (mapped == null)
+            {
+                throw new IOException("Unable to open " + pathName);
+            }
+            return new BitmapRegionDecoder(context, mapped.asData(), mapped);
+        }
+
+        /**
+         * Decodes a rectangle region in the image specified by rect.
+         *
+         * @param rect The rectangle that specified the region to be decode.
+         * @param options null-ok; Options that control downsampling.
+         *             inPurgeable is not supported.
+         * @return The decoded bitmap, or null if the image data could not be
+         *         decoded.
+         * @throws IllegalArgumentException if {@link BitmapFactory.Options#inPreferredConfig}
+         *         is {@link android.graphics.Bitmap.Config#HARDWARE}
+         *         and {@link BitmapFactory.Options#inMutable} is set, if the specified color space
+         *         is not {@link ColorSpace.Model#RGB RGB}, or if the specified color space's transfer
+         *         function is not an {@link ColorSpace.Rgb.TransferParameters ICC parametric curve}
+         */
+        public Bitmap decodeRegion(Rect rect, BitmapFactory.Options options)
+        {
+            BitmapFactory.Options.validate(options);
+            lock (mNativeLock)
+            {
+                checkRecycled("decodeRegion called on pre-recycled instance");
+                if (rect.right <= 0 || rect.bottom <= 0 || rect.left >= getWidth()
+                        || rect.top >= getHeight())
+                {
+                    throw new IllegalArgumentException("rectangle is outside the image");
+                }
+                return nativeDecodeRegion(rect, options);
+            }
+        }
+
+        /** Returns the original image's width */
+        public int getWidth()
+        {
+            lock (mNativeLock)
+            {
+                checkRecycled("getWidth called on pre-recycled instance");
+                return mCodec.Info.Width;
+            }
+        }
+
+        /** Returns the original image's height */
+        public int getHeight()
+        {
+            lock (mNativeLock)
+            {
+                checkRecycled("getHeight called on pre-recycled instance");
+                return mCodec.Info.Height;
+            }
+        }
+
+        /**
+         * Frees up the memory associated with this region decoder, and mark the
+         * region decoder as "dead", meaning it will throw an exception if decodeRegion(),
+         * getWidth() or getHeight() is called.
+         *
+         * <p>This operation cannot be reversed, so it should only be called if you are
+         * sure there are no further uses for the region decoder. This is an advanced call,
+         * and normally need not be called, since the normal GC process will free up this
+         * memory when there are no more references to this region decoder.
+         */
+        public void recycle()
+        {
+            lock (mNativeLock)
+            {
+                if (!mRecycled)
+                {
+                    // the codec reads the data, which may read the mapping
+                    mCodec.Dispose();
+                    mData.Dispose();
+                    mMapped?.Dispose();
+                    mCodec = null;
+                    mData = null;
+                    mMapped = null;
+                    mRecycled = true;
+                }
+            }
+        }
+
+        /**
+         * Returns true if this region decoder has been recycled.
+         * If so, then it is an error to try use its method.
+         *
+         * @return true if the region decoder has been recycled
+         */
+        public bool isRecycled()
+        {
+            return mRecycled;
+        }
+
+        /**
+         * Called by methods that want to throw an exception if the region decoder
+         * has already been recycled.
+         */
+        private void checkRecycled(string errorMessage)
+        {
+            if (mRecycled)
+            {
+                throw new IllegalStateException(errorMessage);
+            }
+        }
+
+        private Bitmap nativeDecodeRegion(Rect rect, BitmapFactory.Options options)
+        {
+            int sampleSize = 1;
+            SKColorType colorType = SKImageInfo.PlatformColorType;
+            bool isMutable = false;
+            if (options != null)
+            {
+                sampleSize = options.inSampleSize;
+                if (sampleSize <= 0)
+                {
+                    sampleSize = 1;
+                }
+
+                // initialize these, in case we fail later on
+                options.outWidth = -1;
+                options.outHeight = -1;
+                options.outMimeType = null;
+                options.outConfig = null;
+                options.outColorSpace = null;
+
+                SKColorType prefColorType = (SKColorType)options.inPreferredConfig.nativeInt;
+                if (prefColorType == SKColorType.Rgba8888 || prefColorType == SKColorType.Bgra8888)
+                {
+                    colorType = prefColorType;
+                }
+                isMutable = options.inMutable;
+            }
+
+            SKImageInfo codecInfo = mCodec.Info;
+            SKRectI subset = SKRectI.Intersect(
+                new SKRectI(rect.left, rect.top, rect.right, rect.bottom), SKRectI.Create(codecInfo.Size)
+            );
+            int width = sampledDimension(subset.Width, sampleSize);
+            int height = sampledDimension(subset.Height, sampleSize);
+
+            SKImageInfo info = new(
+                width, height, colorType,
+                codecInfo.AlphaType == SKAlphaType.Opaque ? SKAlphaType.Opaque : SKAlphaType.Premul,
+                BitmapFactory.Options.nativeColorSpace(options) ?? codecInfo.ColorSpace
+            );
+
+            using BitmapFactory.ZeroInitHeapAllocator allocator = new();
+            SKBitmap bitmap = new();
+            if (!bitmap.SetInfo(info) || !bitmap.TryAllocPixels(allocator))
+            {
+                return null;
+            }
+
+            // IncompleteInput still produces a bitmap, the codec fills the missing rows
+            using (ScanlineDecoder decoder = ScanlineDecoder.start(mCodec, info, subset, width, height))
+            {
+                SKCodecResult result = decoder != null
+                    ? decoder.decode(bitmap)
+                    : ScanlineDecoder.decodeSubset(mCodec, info, subset, bitmap);
+                if (result != SKCodecResult.Success && result != SKCodecResult.IncompleteInput)
+                {
+                    Console.WriteLine("codec cannot decode the subset, unable to decode region: " + result);
+                    bitmap.Dispose();
+                    return null;
+                }
+            }
+
+            if (options != null)
+            {
+                options.outWidth = width;
+                options.outHeight = height;
+                options.outMimeType = BitmapFactory.getMimeType(mCodec.EncodedFormat);
+                options.outConfig = Bitmap.Config.ARGB_8888;
+            }
+
+            BitmapFactory.BitmapCreateFlags flags = BitmapFactory.BitmapCreateFlags.kBitmapCreateFlag_Premultiplied;
+            if (isMutable) flags |= BitmapFactory.BitmapCreateFlags.kBitmapCreateFlag_Mutable;
+            return BitmapFactory.createBitmap(mContext, allocator.getStorageObjAndReset(), flags, null, null, -1, false);
+        }
+
+        // the size of a sampled dimension, as SkAndroidCodec computes it
+        private static int sampledDimension(int size, int sampleSize)
+        {
+            return sampleSize > size ? 1 : size / sampleSize;
+        }
+    }
+}
@@ -187,20 +187,22 @@ namespace AndroidUI.Graphics
             }
         }
 
-        public unsafe void DrawNinePatch(NinePatch patch, Rect dst, SKPaint paint)
+        public void DrawNinePatch(NinePatch patch, Rect dst, SKPaint paint)
         {
             Bitmap bitmap = patch.getBitmap();
             throwIfCannotDraw(bitmap);
-            DrawNinePatch(bitmap.getNativeInstance(), patch.mNativeChunk,
+            bool valid = patch.getLattice(out SKLattice lattice);
+            DrawNinePatch(bitmap.getNativeInstance(), lattice, valid,
                     dst.left, dst.top, dst.right, dst.bottom, paint,
                     Bitmap.DENSITY_NONE, patch.getDensity());
         }
 
-        public unsafe void DrawNinePatch(NinePatch patch, RectF dst, SKPaint paint)
+        public void DrawNinePatch(NinePatch patch, RectF dst, SKPaint paint)
         {
             Bitmap bitmap = patch.getBitmap();
             throwIfCannotDraw(bitmap);
-            DrawNinePatch(bitmap.getNativeInstance(), patch.mNativeChunk,
+            bool valid = patch.getLattice(out SKLattice lattice);
+            DrawNinePatch(bitmap.getNativeInstance(), lattice, valid,
                     dst.left, dst.top, dst.right, dst.bottom, paint,
                     Bitmap.DENSITY_NONE, patch.getDensity());
         }
@@ -210,10 +212,30 @@ namespace AndroidUI.Graphics
             float left, float top, float right, float bottom,
             SKPaint paint, int dstDensity, int srcDensity
         )
+        {
+            bool valid = NinePatch.BuildLattice(nativeChunk, bitmap.Width, bitmap.Height, out SKLattice lattice);
+            DrawNinePatch(bitmap, lattice, valid, left, top, right, bottom, paint, dstDensity, srcDensity);
+        }
+
+        public unsafe void DrawNinePatch(
+            SKBitmap bitmap, sbyte* chunk,
+            float dstLeft, float dstTop, float dstRight, float dstBottom,
+            SKPaint paint
+        )
+        {
+            bool valid = NinePatch.BuildLattice(chunk, bitmap.Width, bitmap.Height, out SKLattice lattice);
+            DrawNinePatch(bitmap, lattice, valid, dstLeft, dstTop, dstRight, dstBottom, paint);
+        }
+
+        private void DrawNinePatch(
+            SKBitmap bitmap, SKLattice lattice, bool valid,
+            float left, float top, float right, float bottom,
+            SKPaint paint, int dstDensity, int srcDensity
+        )
         {
             if (dstDensity == srcDensity || dstDensity == 0 || srcDensity == 0)
             {
-                DrawNinePatch(bitmap, nativeChunk, left, top, right, bottom, paint);
+                DrawNinePatch(bitmap, lattice, valid, left, top, right, bottom, paint);
             }
             else
             {
@@ -225,44 +247,28 @@ namespace AndroidUI.Graphics
                 SKPaint filteredPaint = paint == null ? new SKPaint() : paint;
                 filteredPaint.FilterQuality = SKFilterQuality.Low;
 
-                DrawNinePatch(bitmap, nativeChunk, 0, 0, (right - left) / scale, (bottom - top) / scale, filteredPaint);
+                DrawNinePatch(bitmap, lattice, valid, 0, 0, (right - left) / scale, (bottom - top) / scale, filteredPaint);
                 Restore();
             }
         }
 
-        public unsafe void DrawNinePatch(
-            SKBitmap bitmap, sbyte* chunk,
+        private void DrawNinePatch(
+            SKBitmap bitmap, SKLattice lattice, bool valid,
             float dstLeft, float dstTop, float dstRight, float dstBottom,
             SKPaint paint
         )
         {
-            SKLattice lattice = new();
-            NinePatch.SetLatticeDivs(ref lattice, chunk, bitmap.Width, bitmap.Height);
-
-            lattice.RectTypes = null;
-            lattice.Colors = null;
-            int numFlags = 0;
-            int numColors = NinePatch.NumColors(chunk);
-            byte XCount = NinePatch.NumXDivs(chunk);
-            byte YCount = NinePatch.NumYDivs(chunk);
-            if (numColors > 0 && numColors == NinePatch.NumDistinctRects(ref lattice, chunk))
+            SKRect dst = new(dstLeft, dstTop, dstRight, dstBottom);
+            var image = bitmap.AsImage();
+            if (valid)
             {
-                // We can expect the framework to give us a color for every distinct rect.
-                // Skia requires a flag for every rect.
-                numFlags = (XCount + 1) * (YCount + 1);
+                DrawImageLattice(image, lattice, dst, paint);
             }
-
-            SKLatticeRectType[] flags = new SKLatticeRectType[numFlags];
-            SKColor[] colors = new SKColor[numColors];
-            if (numFlags > 0)
+            else
             {
-                NinePatch.SetLatticeFlags(ref lattice, flags, numFlags, chunk, colors);
+                // Skia stretches the whole image when the lattice is invalid
+                DrawImage(image, dst, paint);
             }
-
-            lattice.Bounds = null;
-            SKRect dst = SKRect.Create(dstLeft, dstTop, dstRight, dstBottom);
-            var image = bitmap.AsImage();
-            DrawImageLattice(image, lattice, dst, paint);
         }
 
 
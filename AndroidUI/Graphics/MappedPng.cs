@@ -0,0 +1,140 @@
+﻿using SkiaSharp;
+using System.Text;
+
+namespace AndroidUI.Graphics
+{
+    /**
+     * A memory mapped image file. When the file is a PNG its chunk list is walked once,
+     * without reading the pixel data, and the nine patch chunks can be read straight
+     * out of the mapping.
+     *
+     * The mapping is copy on write, fixing up the byte order of the nine patch chunk
+     * never reaches the file.
+     */
+    internal sealed unsafe class MappedPng : IDisposable
+    {
+        private void* mHandle;
+
+        private MappedPng(void* handle)
+        {
+            mHandle = handle;
+        }
+
+        ~MappedPng()
+        {
+            Dispose(false);
+        }
+
+        /**
+         * Maps the file at the given path.
+         *
+         * @return null if the file cannot be opened or is empty.
+         */
+        public static MappedPng open(string path)
+        {
+            ArgumentNullException.ThrowIfNull(path);
+            int byteCount = Encoding.UTF8.GetByteCount(path);
+            byte[] bytes = new byte[checked(byteCount + 1)];
+            int written = Encoding.UTF8.GetBytes(path, bytes);
+            bytes[written] = 0;
+            void* handle;
+            fixed (byte* p = bytes)
+            {
+                handle = Native.Additional.SkKernel_pngMapFile(p);
+            }
+            return handle == null ? null : new MappedPng(handle);
+        }
+
+        private void* handle => mHandle != null ? mHandle : throw new ObjectDisposedException(nameof(MappedPng));
+
+        /**
+         * Returns true if the file starts with the PNG signature.
+         */
+        public bool isPng()
+        {
+            return Native.Additional.SkKernel_pngIsPng(handle);
+        }
+
+        public long getLength()
+        {
+            long length;
+            Native.Additional.SkKernel_pngData(handle, &length);
+            return length;
+        }
+
+        /**
+         * Wraps the mapped file without copying it. The data must not be used after
+         * this MappedPng is disposed.
+         */
+        public SKData asData()
+        {
+            long length;
+            byte* data = Native.Additional.SkKernel_pngData(handle, &length);
+            return SKData.Create((IntPtr)data, length);
+        }
+
+        /**
+         * Returns the data of the first chunk with the given 4 character tag, as stored
+         * in the file, or an empty span if there is none. The span is a view into the
+         * mapping.
+         */
+        public ReadOnlySpan<byte> getChunk(string tag)
+        {
+            if (tag == null || tag.Length != 4)
+            {
+                throw new ArgumentException("a PNG chunk tag is 4 characters", nameof(tag));
+            }
+            byte* t = stackalloc byte[4];
+            for (int i = 0; i < 4; i++)
+            {
+                t[i] = (byte)tag[i];
+            }
+            uint length;
+            byte* data = Native.Additional.SkKernel_pngChunk(handle, t, &length);
+            return data == null ? ReadOnlySpan<byte>.Empty : new ReadOnlySpan<byte>(data, (int)length);
+        }
+
+        /**
+         * Returns the Res_png_9patch of the npTc chunk in device order, or null if the
+         * file has none. The patch lives in the mapping and must not be freed.
+         */
+        public void* getNinePatch(out nuint size)
+        {
+            uint s;
+            void* patch = Native.Additional.SkKernel_pngNinePatch(handle, &s);
+            size = s;
+            return patch;
+        }
+
+        /**
+         * Reads the npLb and npOl chunks, insets that are not present are left untouched.
+         *
+         * @return false if the file has neither.
+         */
+        public bool getInsets(int[] opticalInsets, int[] outlineInsets, ref float outlineRadius, ref byte outlineAlpha)
+        {
+            fixed (int* optical = opticalInsets)
+            fixed (int* outline = outlineInsets)
+            fixed (float* radius = &outlineRadius)
+            fixed (byte* alpha = &outlineAlpha)
+            {
+                return Native.Additional.SkKernel_pngInsets(handle, optical, outline, radius, alpha);
+            }
+        }
+
+        private void Dispose(bool disposing)
+        {
+            if (mHandle != null)
+            {
+                Native.Additional.SkKernel_pngUnmap(mHandle);
+                mHandle = null;
+            }
+        }
+
+        public void Dispose()
+        {
+            Dispose(true);
+            GC.SuppressFinalize(this);
+        }
+    }
+}
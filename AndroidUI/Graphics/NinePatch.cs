@@ -15,7 +15,6 @@
  */
 
 using AndroidUI.Extensions;
-using AndroidUI.Skia;
 using AndroidUI.Utils;
 using AndroidUI.Utils.Arrays;
 using AndroidUI.Utils.Graphics;
@@ -100,6 +99,17 @@ namespace AndroidUI.Graphics
         private Paint mPaint;
         private string mSrcName;
 
+        // the lattice only depends on the chunk and the bitmap size
+        private SKLattice mLattice;
+        private bool mLatticeValid;
+        private int mLatticeWidth = -1;
+        private int mLatticeHeight = -1;
+
+        // the most recently used cell layouts, a list of nine patch backgrounds
+        // usually draws every item at the same few sizes
+        private const int MAX_CACHED_CELLS = 4;
+        private readonly NinePatchLattice[] mCells = new NinePatchLattice[MAX_CACHED_CELLS];
+
         /**
          * Create a drawable projection from a bitmap to nine patches.
          *
@@ -124,15 +134,16 @@ namespace AndroidUI.Graphics
         {
             mBitmap = bitmap;
             mSrcName = srcName;
-            mNativeChunk = validateNinePatchChunk(chunk);
+            // identical chunks share one validated patch
+            mNativeChunk = NinePatchChunkCache.acquire(chunk);
         }
 
         ~NinePatch()
         {
             if (mNativeChunk != null)
             {
-                // only attempt to destroy correctly initilized chunks
-                nativeFinalize(mNativeChunk);
+                // only attempt to release correctly initilized chunks
+                NinePatchChunkCache.release(mNativeChunk);
                 mNativeChunk = null;
             }
         }
@@ -252,6 +263,60 @@ namespace AndroidUI.Graphics
             return mBitmap.hasAlpha();
         }
 
+        /**
+         * Returns the cells of this NinePatch stretched to the given size, positioned at
+         * (0, 0). The cells are cached per size, so repeatedly asking for the same size
+         * does not recompute them.
+         *
+         * @param width The width of the area the NinePatch is drawn to.
+         * @param height The height of the area the NinePatch is drawn to.
+         */
+        public NinePatchLattice getLattice(int width, int height)
+        {
+            NinePatchLattice cells;
+            for (int i = 0; i < MAX_CACHED_CELLS; i++)
+            {
+                cells = mCells[i];
+                if (cells == null)
+                {
+                    break;
+                }
+                if (cells.getWidth() == width && cells.getHeight() == height)
+                {
+                    if (i != 0)
+                    {
+                        Array.Copy(mCells, 0, mCells, 1, i);
+                        mCells[0] = cells;
+                    }
+                    return cells;
+                }
+            }
+            cells = new NinePatchLattice(mNativeChunk, mBitmap.getWidth(), mBitmap.getHeight(), width, height);
+            Array.Copy(mCells, 0, mCells, 1, MAX_CACHED_CELLS - 1);
+            mCells[0] = cells;
+            return cells;
+        }
+
+        /**
+         * Returns the lattice Canvas hands to Skia, built once per bitmap size.
+         *
+         * @return false if Skia would reject the lattice, the bitmap should then be
+         * drawn stretched.
+         */
+        internal bool getLattice(out SKLattice lattice)
+        {
+            int width = mBitmap.getWidth();
+            int height = mBitmap.getHeight();
+            if (width != mLatticeWidth || height != mLatticeHeight)
+            {
+                mLatticeValid = BuildLattice(mNativeChunk, width, height, out mLattice);
+                mLatticeWidth = width;
+                mLatticeHeight = height;
+            }
+            lattice = mLattice;
+            return mLatticeValid;
+        }
+
         /**
          * Returns a {@link Region} representing the parts of the NinePatch that are
          * completely transparent.
@@ -265,8 +330,28 @@ namespace AndroidUI.Graphics
         public Region getTransparentRegion(Rect bounds)
         {
             ArgumentNullException.ThrowIfNull(bounds);
-            SKRegion r = nativeGetTransparentRegion(mBitmap.getNativeInstance(), mNativeChunk, ref bounds);
-            return r != null ? new Region(r) : null;
+            NinePatchLattice cells = getLattice(bounds.width(), bounds.height());
+            ReadOnlySpan<SKRect> rects = cells.getRects();
+            Span<SKRectI> transparent = cells.getCellCount() <= 64
+                ? stackalloc SKRectI[cells.getCellCount()]
+                : new SKRectI[cells.getCellCount()];
+            int count = 0;
+            for (int i = 0; i < cells.getCellCount(); i++)
+            {
+                SKRect dst = rects[i * 2 + 1];
+                if (cells.getRectType(i) == SKLatticeRectType.Transparent && !dst.IsEmpty)
+                {
+                    dst.Offset(bounds.left, bounds.top);
+                    transparent[count++] = dst.Round();
+                }
+            }
+            if (count == 0)
+            {
+                return null;
+            }
+            Region region = new();
+            region.setRects(transparent[..count], Region.Op.UNION);
+            return region;
         }
 
         /**
@@ -285,20 +370,6 @@ namespace AndroidUI.Graphics
             }
         }
 
-        /**
-         * Validates the 9-patch chunk and throws an exception if the chunk is invalid.
-         * If validation is successful, this method returns a native Res_png_9patch*
-         * object used by the renderers.
-         */
-        private static unsafe sbyte* validateNinePatchChunk(byte[] chunk)
-        {
-            fixed (byte* c = chunk)
-            {
-                return Native.Additional.SkNinePatchGlue_validateNinePatchChunk((sbyte*)c, chunk.Length);
-            }
-        }
-        private static unsafe void nativeFinalize(sbyte* chunk) => Native.Additional.SkNinePatchGlue_finalize(chunk);
-
         internal static byte NumXDivs(sbyte* chunk)
         {
             unsafe
@@ -365,150 +436,63 @@ namespace AndroidUI.Graphics
 
         internal static uint[] ColorsAsArray(sbyte* chunk, int truncate = 0) => Arrays.FromNative<uint>(Colors(chunk), NumColors(chunk) - truncate);
 
-        internal static void SetLatticeDivs(ref SKLattice lattice, sbyte* chunk, int width, int height)
-        {
-            byte XCount = NumXDivs(chunk);
-            byte YCount = NumYDivs(chunk);
-            lattice.XDivs = XDivsAsArray(chunk);
-            lattice.YDivs = XDivsAsArray(chunk);
-            // We'll often see ninepatches where the last div is equal to the width or height.
-            // This doesn't provide any additional information and is not supported by Skia.
-            if (XCount > 0 && width == lattice.XDivs[XCount - 1])
-            {
-                lattice.XDivs = XDivsAsArray(chunk, 1);
-            }
-            if (YCount > 0 && height == lattice.YDivs[YCount - 1])
-            {
-                lattice.XDivs = XDivsAsArray(chunk, 1);
-            }
-        }
-
-        internal static int NumDistinctRects(ref SKLattice lattice, sbyte* chunk)
+        /**
+         * Builds the lattice Skia draws the chunk with, for a bitmap of the given size.
+         *
+         * @return false if Skia would reject the lattice.
+         */
+        internal static bool BuildLattice(sbyte* chunk, int width, int height, out SKLattice lattice)
         {
-            int xRects;
             byte XCount = NumXDivs(chunk);
             byte YCount = NumYDivs(chunk);
-            if (XCount > 0)
-            {
-                xRects = 0 == lattice.XDivs[0] ? XCount : XCount + 1;
-            }
-            else
+            int[] xDivs = new int[XCount];
+            int[] yDivs = new int[YCount];
+            int maxFlags = (XCount + 1) * (YCount + 1);
+            SKLatticeRectType[] flags = null;
+            SKColor[] colors = null;
+            bool valid;
+            int* counts = stackalloc int[3];
+            byte[] types = new byte[maxFlags];
+            uint[] argb = new uint[maxFlags];
+            fixed (int* x = xDivs)
+            fixed (int* y = yDivs)
+            fixed (byte* t = types)
+            fixed (uint* c = argb)
             {
-                xRects = 1;
+                valid = Native.Additional.SkKernel_ninePatchLattice(chunk, width, height, x, y, t, c, counts);
             }
 
-            int yRects;
-            if (YCount > 0)
-            {
-                yRects = 0 == lattice.YDivs[0] ? YCount : YCount + 1;
-            }
-            else
+            // We'll often see ninepatches where the last div is equal to the width or height.
+            // This doesn't provide any additional information and is not supported by Skia.
+            if (counts[0] != XCount)
             {
-                yRects = 1;
+                Array.Resize(ref xDivs, counts[0]);
             }
-            return xRects * yRects;
-        }
-
-        internal static void SetLatticeFlags(ref SKLattice lattice, MemoryPointer<SKLatticeRectType> flags,
-                                           int numFlags, sbyte* chunk, MemoryPointer<SKColor> colors)
-        {
-            lattice.RectTypes = (SKLatticeRectType[])flags.GetArray();
-            lattice.Colors = (SKColor[])colors.GetArray();
-            flags.Fill(0, numFlags);
-            colors.Fill(0, numFlags);
-
-            byte XCount = NumXDivs(chunk);
-            byte YCount = NumYDivs(chunk);
-
-            bool needPadRow = YCount > 0 && 0 == lattice.YDivs[0];
-            bool needPadCol = XCount > 0 && 0 == lattice.XDivs[0];
-
-            int yCount = YCount;
-            if (needPadRow)
+            if (counts[1] != YCount)
             {
-                // Skip flags for the degenerate first row of rects.
-                flags += XCount + 1;
-                colors += XCount + 1;
-                yCount--;
+                Array.Resize(ref yDivs, counts[1]);
             }
-
-            int i = 0;
-            bool setFlags = false;
-            uint[] colors_ = ColorsAsArray(chunk);
-            for (int y = 0; y < yCount + 1; y++)
+            int numFlags = counts[2];
+            if (numFlags > 0)
             {
-                for (int x = 0; x < XCount + 1; x++)
+                flags = new SKLatticeRectType[numFlags];
+                colors = new SKColor[numFlags];
+                for (int i = 0; i < numFlags; i++)
                 {
-                    if (0 == x && needPadCol)
-                    {
-                        // First rect of each column is degenerate, skip the flag.
-                        flags++;
-                        colors++;
-                        continue;
-                    }
-
-                    uint currentColor = colors_[i++];
-                    if (0 == currentColor)
-                    {
-                        flags[0] = SKLatticeRectType.Transparent;
-                        setFlags = true;
-                    }
-                    else if (1 != currentColor)
-                    {
-                        flags[0] = SKLatticeRectType.FixedColor;
-                        colors[0] = currentColor;
-                        setFlags = true;
-                    }
-
-                    flags++;
-                    colors++;
+                    flags[i] = (SKLatticeRectType)types[i];
+                    colors[i] = argb[i];
                 }
             }
 
-            if (!setFlags)
-            {
-                lattice.RectTypes = null;
-                lattice.Colors = null;
-            }
-        }
-
-
-        private static unsafe SKRegion nativeGetTransparentRegion(SKBitmap bitmapHandle, sbyte* chunk, ref Rect location)
-        {
-            SKRect dst = location.ToSKRect();
-
-            SKLattice lattice = new();
-            SKRectI src = SKRectI.Create(bitmapHandle.Width, bitmapHandle.Height);
-            lattice.Bounds = src;
-            SetLatticeDivs(ref lattice, chunk, bitmapHandle.Width, bitmapHandle.Height);
-            lattice.RectTypes = null;
-            lattice.Colors = null;
-
-            SKRegion region = null;
-            if (SKLatticeIter.Valid(bitmapHandle.Width, bitmapHandle.Height, ref lattice))
+            lattice = new SKLattice
             {
-                SKLatticeIter iter = new(ref lattice, ref dst);
-                if (iter.numRectsToDraw == NumColors(chunk))
-                {
-                    SKRect dummy = new();
-                    SKRect iterDst = new();
-                    int index = 0;
-                    uint[] colors = ColorsAsArray(chunk);
-                    while (iter.next(ref dummy, ref iterDst))
-                    {
-                        if (0 == colors[index++] && !iterDst.IsEmpty)
-                        {
-                            if (region == null)
-                            {
-                                region = new SKRegion();
-                            }
-
-                            region.Op(iterDst.Round(), SKRegionOperation.Union);
-                        }
-                    }
-                }
-            }
-            return region;
+                XDivs = xDivs,
+                YDivs = yDivs,
+                RectTypes = flags,
+                Colors = colors,
+                Bounds = null
+            };
+            return valid;
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+﻿namespace AndroidUI.Graphics
+{
+    /**
+     * A process wide, thread safe cache of validated nine patch chunks.
+     *
+     * Identical chunks share one immutable native patch, found by content rather than
+     * by the array they came from, and each scale of a chunk is computed once. Released
+     * patches are kept within a byte budget, so decoding the same resource again is a
+     * cache hit.
+     */
+    public static unsafe class NinePatchChunkCache
+    {
+        /**
+         * Returns the shared native patch for a chunk, scaled when scaleX or scaleY is
+         * not 1, or null if the chunk is not a valid nine patch chunk. Every patch
+         * returned must be given back to release().
+         */
+        internal static sbyte* acquire(sbyte* chunk, int length, float scaleX = 1, float scaleY = 1, int scaledWidth = 0, int scaledHeight = 0)
+        {
+            return Native.Additional.SkKernel_ninePatchCacheAcquire(chunk, length, scaleX, scaleY, scaledWidth, scaledHeight);
+        }
+
+        internal static sbyte* acquire(byte[] chunk)
+        {
+            fixed (byte* c = chunk)
+            {
+                return acquire((sbyte*)c, chunk.Length);
+            }
+        }
+
+        internal static void release(void* patch)
+        {
+            Native.Additional.SkKernel_ninePatchCacheRelease(patch);
+        }
+
+        /**
+         * The serialized size of a patch returned by acquire()
+         */
+        internal static int sizeOf(void* patch)
+        {
+            return Native.Additional.SkKernel_ninePatchCacheSize(patch);
+        }
+
+        /**
+         * Sets how many bytes of released patches are kept, 0 drops them all.
+         */
+        public static void setBudget(long bytes)
+        {
+            Native.Additional.SkKernel_ninePatchCacheSetBudget(bytes);
+        }
+
+        private static long stat(int index)
+        {
+            long* stats = stackalloc long[4];
+            Native.Additional.SkKernel_ninePatchCacheStats(stats);
+            return stats[index];
+        }
+
+        /**
+         * The number of acquires that found an existing patch
+         */
+        public static long getHitCount() => stat(0);
+
+        /**
+         * The number of acquires that validated, and possibly scaled, a new patch
+         */
+        public static long getMissCount() => stat(1);
+
+        /**
+         * The bytes held by cached patches, including released ones still kept
+         */
+        public static long getByteCount() => stat(2);
+
+        /**
+         * The number of cached patches, including released ones still kept
+         */
+        public static long getEntryCount() => stat(3);
+    }
+}
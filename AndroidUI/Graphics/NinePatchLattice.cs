@@ -0,0 +1,90 @@
+﻿using SkiaSharp;
+
+namespace AndroidUI.Graphics
+{
+    /**
+     * The cells of a NinePatch stretched to a given size: every src / dst rect pair,
+     * including the transparent ones, along with its rect type and fixed color.
+     *
+     * The cells are computed natively in a single call and are positioned at (0, 0),
+     * offset them by the left and top of the destination when drawing.
+     *
+     * @see NinePatch#getLattice(int, int)
+     */
+    public sealed class NinePatchLattice
+    {
+        private readonly int mWidth;
+        private readonly int mHeight;
+        private readonly int mCount;
+
+        // src, dst pairs
+        private readonly SKRect[] mRects;
+        private readonly byte[] mRectTypes;
+        private readonly SKColor[] mColors;
+
+        internal unsafe NinePatchLattice(sbyte* chunk, int bitmapWidth, int bitmapHeight, int width, int height)
+        {
+            mWidth = width;
+            mHeight = height;
+
+            float* dst = stackalloc float[4] { 0, 0, width, height };
+            int count = (NinePatch.NumXDivs(chunk) + 1) * (NinePatch.NumYDivs(chunk) + 1);
+            mRects = new SKRect[count * 2];
+            mRectTypes = new byte[count];
+            mColors = new SKColor[count];
+            fixed (SKRect* rects = mRects)
+            fixed (byte* types = mRectTypes)
+            fixed (SKColor* colors = mColors)
+            {
+                // a chunk never has more cells than its divs allow
+                mCount = Native.Additional.SkKernel_ninePatchCells(chunk, bitmapWidth, bitmapHeight, dst, (float*)rects, types, (uint*)colors, count);
+            }
+        }
+
+        /**
+         * The width the cells are stretched to
+         */
+        public int getWidth() => mWidth;
+
+        /**
+         * The height the cells are stretched to
+         */
+        public int getHeight() => mHeight;
+
+        /**
+         * The number of cells, including the transparent ones
+         */
+        public int getCellCount() => mCount;
+
+        /**
+         * The area of the bitmap drawn by the cell
+         */
+        public SKRect getSrc(int cell) => mRects[checkCell(cell) * 2];
+
+        /**
+         * The area the cell is drawn to
+         */
+        public SKRect getDst(int cell) => mRects[checkCell(cell) * 2 + 1];
+
+        public SKLatticeRectType getRectType(int cell) => (SKLatticeRectType)mRectTypes[checkCell(cell)];
+
+        /**
+         * The color filling the cell when its rect type is FixedColor, otherwise transparent
+         */
+        public SKColor getColor(int cell) => mColors[checkCell(cell)];
+
+        /**
+         * All cells as src, dst pairs
+         */
+        public ReadOnlySpan<SKRect> getRects() => new(mRects, 0, mCount * 2);
+
+        private int checkCell(int cell)
+        {
+            if ((uint)cell >= (uint)mCount)
+            {
+                throw new ArgumentOutOfRangeException(nameof(cell));
+            }
+            return cell;
+        }
+    }
+}
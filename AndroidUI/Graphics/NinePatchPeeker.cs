@@ -29,10 +29,38 @@ namespace AndroidUI.Graphics
 
         protected override void DisposeNative()
         {
-            Native.Additional.SkNinePatchGlue_delete(mPatch);
+            if (mOwnsPatch)
+            {
+                Native.Additional.SkNinePatchGlue_delete(mPatch);
+            }
+            NinePatchChunkCache.release(mScaledPatch);
             base.DisposeNative();
         }
 
+        /**
+         * Takes the nine patch chunks straight from a mapped file instead of having the
+         * codec copy them through ReadChunk. The patch stays in the mapping, which must
+         * outlive this peeker.
+         *
+         * @return false if the file is not a PNG, the codec should then be given this
+         * peeker as usual.
+         */
+        internal bool ReadChunks(MappedPng png)
+        {
+            if (!png.isPng())
+            {
+                return false;
+            }
+            if (mOwnsPatch)
+            {
+                Native.Additional.SkNinePatchGlue_delete(mPatch);
+            }
+            mPatch = png.getNinePatch(out mPatchSize);
+            mOwnsPatch = false;
+            mHasInsets = png.getInsets(mOpticalInsets, mOutlineInsets, ref mOutlineRadius, ref mOutlineAlpha);
+            return true;
+        }
+
         protected override bool ReadChunk(string tag, IntPtr data, IntPtr length)
         {
             // NPatch
@@ -82,22 +110,32 @@ namespace AndroidUI.Graphics
                 int[] padding = new int[4];
                 fixed (int* mPadding = padding)
                 {
-                    Native.Additional.SkNinePatchGlue_getPadding(mPatch, &mPadding);
+                    Native.Additional.SkNinePatchGlue_getPadding(Patch, &mPadding);
                 }
                 return padding;
             }
         }
 
+        /**
+         * Scales the patch. Scaled patches come from the NinePatchChunkCache, so every
+         * decode of a resource at the same density shares one scaled patch.
+         */
         public void Scale(float scaleX, float scaleY, int scaledWidth, int scaledHeight)
         {
-            Native.Additional.SkNinePatchGlue_scale(mPatch, scaleX, scaleY, scaledWidth, scaledHeight);
+            NinePatchChunkCache.release(mScaledPatch);
+            mScaledPatch = NinePatchChunkCache.acquire((sbyte*)mPatch, (int)mPatchSize, scaleX, scaleY, scaledWidth, scaledHeight);
+            if (mScaledPatch == null)
+            {
+                // not a chunk the cache accepts, scale it where it is
+                Native.Additional.SkNinePatchGlue_scale(mPatch, scaleX, scaleY, scaledWidth, scaledHeight);
+            }
         }
 
         public void CopyInto<T>(T[] dest) where T : unmanaged
         {
             fixed (void* data = dest)
             {
-                Native.Memcpy(data, mPatch, PatchSize);
+                Native.Memcpy(data, Patch, PatchSize);
             }
         }
 
@@ -105,13 +143,18 @@ namespace AndroidUI.Graphics
         {
             fixed (void* data = dest)
             {
-                Native.Memcpy(data, mPatch, length);
+                Native.Memcpy(data, Patch, length);
             }
         }
 
-        public nuint SerializedSize => HasPatch ? Native.Additional.SkNinePatchGlue_serializedSize(mPatch) : 0;
+        public nuint SerializedSize => HasPatch ? Native.Additional.SkNinePatchGlue_serializedSize(Patch) : 0;
+
+        // the scaled patch once Scale() has been called
+        private void* Patch => mScaledPatch != null ? mScaledPatch : mPatch;
 
         private void* mPatch = null;
+        private bool mOwnsPatch = true;
+        private void* mScaledPatch = null;
         private nuint mPatchSize;
         private bool mHasInsets;
         public bool HasPatch => mPatch != null;
@@ -0,0 +1,223 @@
+﻿using SkiaSharp;
+
+namespace AndroidUI.Graphics
+{
+    public partial class RecordingCanvas2
+    {
+        // The bounds of every recorded draw, in the space the recording started in, so
+        // playback can skip the draws that fall outside its clip, see CommandBuffer.Playback.
+        //
+        // Bounds are conservative, a draw whose extent cannot be known cheaply, or that a
+        // layer may spread, is given UNBOUNDED and is never skipped. A draw falling wholly
+        // outside the clip is given an empty rectangle, it draws nothing and is dropped when
+        // the recording is optimized.
+
+        internal static readonly SKRect UNBOUNDED = new(float.NegativeInfinity, float.NegativeInfinity, float.PositiveInfinity, float.PositiveInfinity);
+
+        private readonly List<SKRect> mBounds = new();
+
+        // the record index of each draw in mBounds
+        private readonly List<int> mDraws = new();
+
+        // SetMatrix and ResetMatrix replace the matrix of the playback canvas rather than
+        // concatenating to it, after either the recording no longer knows where it draws
+        private bool mAbsoluteMatrix;
+
+        // the save counts to restore to that close a layer whose paint may move pixels
+        private readonly Stack<int> mSpreadingLayers = new();
+
+        // the device bounds of the clip set by the recorded clips, and of each saved clip,
+        // the size of the recording canvas is not a clip, playback may show more than it
+        private SKRect mClip = UNBOUNDED;
+        private readonly Stack<SKRect> mClips = new();
+
+        private unsafe void record<T>(COMMANDS command, T payload, SKRect bounds, SKPaint paint = null) where T : unmanaged
+        {
+            record(command, payload);
+            mDraws.Add(Native.Additional.SkKernel_commandArenaCount(mArena) - 1);
+            mBounds.Add(bound(bounds, paint, false));
+        }
+
+        private unsafe void recordStroke<T>(COMMANDS command, T payload, SKRect bounds, SKPaint paint) where T : unmanaged
+        {
+            record(command, payload);
+            mDraws.Add(Native.Additional.SkKernel_commandArenaCount(mArena) - 1);
+            mBounds.Add(bound(bounds, paint, true));
+        }
+
+        private void resetBounds()
+        {
+            mBounds.Clear();
+            mDraws.Clear();
+            mAbsoluteMatrix = false;
+            mSpreadingLayers.Clear();
+            mClip = UNBOUNDED;
+            mClips.Clear();
+        }
+
+        private void saved()
+        {
+            mClips.Push(mClip);
+        }
+
+        private void savedLayer(int count, SKPaint paint)
+        {
+            mClips.Push(mClip);
+            if (float.IsPositiveInfinity(outset(paint, false)))
+            {
+                mSpreadingLayers.Push(count);
+            }
+        }
+
+        private void restored()
+        {
+            while (mSpreadingLayers.Count > 0 && mSpreadingLayers.Peek() >= SaveCount)
+            {
+                mSpreadingLayers.Pop();
+            }
+            while (mClips.Count >= SaveCount)
+            {
+                mClip = mClips.Pop();
+            }
+        }
+
+        private void clipped(SKRect rect, SKClipOperation operation)
+        {
+            // a difference can only shrink the clip, the bounds kept are still correct
+            if (operation != SKClipOperation.Intersect || mAbsoluteMatrix || !finite(rect))
+            {
+                return;
+            }
+            SKRect device = map(TotalMatrix, rect.Standardized);
+            if (!finite(device))
+            {
+                return;
+            }
+            // an aliased clip rounds its edges to the nearest pixel, possibly outwards
+            device.Inflate(1, 1);
+            mClip = intersect(mClip, device);
+        }
+
+        private static bool finite(SKRect rect)
+        {
+            return float.IsFinite(rect.Left) && float.IsFinite(rect.Top) && float.IsFinite(rect.Right) && float.IsFinite(rect.Bottom);
+        }
+
+        // SKRect.IsEmpty only compares with SKRect.Empty
+        internal static bool empty(SKRect rect)
+        {
+            return !(rect.Left < rect.Right && rect.Top < rect.Bottom);
+        }
+
+        // the area a and b share, SKRect.Empty when they share none
+        internal static SKRect intersect(SKRect a, SKRect b)
+        {
+            SKRect r = new(Math.Max(a.Left, b.Left), Math.Max(a.Top, b.Top), Math.Min(a.Right, b.Right), Math.Min(a.Bottom, b.Bottom));
+            return empty(r) ? SKRect.Empty : r;
+        }
+
+        // how far past its geometry a paint can draw, like SkStrokeRec::GetInflationRadius,
+        // lines and points are stroked whatever the style of their paint
+        private static float outset(SKPaint paint, bool stroke)
+        {
+            if (paint == null)
+            {
+                return 0;
+            }
+            if (paint.ImageFilter != null || paint.MaskFilter != null || paint.PathEffect != null)
+            {
+                return float.PositiveInfinity;
+            }
+            if (!stroke && paint.Style == SKPaintStyle.Fill)
+            {
+                return 0;
+            }
+            float width = paint.StrokeWidth;
+            if (width == 0)
+            {
+                // hairline
+                return 1;
+            }
+            float multiplier = 1;
+            if (paint.StrokeJoin == SKStrokeJoin.Miter)
+            {
+                multiplier = Math.Max(multiplier, paint.StrokeMiter);
+            }
+            if (paint.StrokeCap == SKStrokeCap.Square)
+            {
+                multiplier = Math.Max(multiplier, MathF.Sqrt(2));
+            }
+            return width / 2 * multiplier;
+        }
+
+        private SKRect bound(SKRect rect, SKPaint paint, bool stroke)
+        {
+            if (mAbsoluteMatrix)
+            {
+                return UNBOUNDED;
+            }
+            SKRect device = UNBOUNDED;
+            float radius = outset(paint, stroke);
+            if (finite(rect) && !float.IsPositiveInfinity(radius))
+            {
+                rect = rect.Standardized;
+                rect.Inflate(radius, radius);
+                device = map(TotalMatrix, rect);
+                // antialiasing may touch one more pixel past each edge
+                device.Inflate(1, 1);
+                if (!finite(device))
+                {
+                    device = UNBOUNDED;
+                }
+            }
+            // what falls outside the clip is not drawn, not even into a layer that spreads it
+            device = intersect(device, mClip);
+            if (empty(device))
+            {
+                return SKRect.Empty;
+            }
+            return mSpreadingLayers.Count > 0 ? UNBOUNDED : device;
+        }
+
+        // a rectangle seen through a perspective may wrap around the viewer
+        private static SKRect map(SKMatrix matrix, SKRect rect)
+        {
+            if (matrix.Persp0 != 0 || matrix.Persp1 != 0 || matrix.Persp2 != 1)
+            {
+                return UNBOUNDED;
+            }
+            return matrix.MapRect(rect);
+        }
+
+        private static SKRect bound(SKPoint[] points)
+        {
+            if (points == null || points.Length == 0)
+            {
+                return SKRect.Empty;
+            }
+            SKRect rect = new(points[0].X, points[0].Y, points[0].X, points[0].Y);
+            foreach (SKPoint point in points)
+            {
+                rect.Left = Math.Min(rect.Left, point.X);
+                rect.Top = Math.Min(rect.Top, point.Y);
+                rect.Right = Math.Max(rect.Right, point.X);
+                rect.Bottom = Math.Max(rect.Bottom, point.Y);
+            }
+            return rect;
+        }
+
+        private static SKRect bound(SKPath path)
+        {
+            if (path == null)
+            {
+                return SKRect.Empty;
+            }
+            // an inverse fill covers everything outside the path
+            if (path.FillType == SKPathFillType.InverseWinding || path.FillType == SKPathFillType.InverseEvenOdd)
+            {
+                return UNBOUNDED;
+            }
+            return path.Bounds;
+        }
+    }
+}
@@ -61,6 +61,7 @@
             SKEW_POINT,
             TRANSLATE_XY,
             TRANSLATE_POINT,
+            DRAW_RENDER_NODE,
         }
     }
 }
\ No newline at end of file
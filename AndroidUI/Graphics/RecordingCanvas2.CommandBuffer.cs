@@ -1,28 +1,204 @@
 ﻿using AndroidUI.Utils;
 using SkiaSharp;
+using System.Buffers;
 
 namespace AndroidUI.Graphics
 {
     public partial class RecordingCanvas2
     {
-        public class CommandBuffer : Disposable
+        public unsafe class CommandBuffer : Disposable
         {
-            internal MemoryReader mem;
+            // the records, held by an arena of the buffer's own or by a mapped file
+            private void* mArena;
+            private IDisposable mMapping;
+            private readonly int* mData;
+            private readonly int mSize;
+            private readonly int mCount;
 
-            public CommandBuffer(MemoryReader reader)
+            private readonly Objects mObjectTable;
+            private readonly object[] mObjects;
+
+            // an r-tree over the bounds of the draws, and the bounds and record index of
+            // each draw
+            private void* mIndex;
+            private readonly SKRect[] mBounds;
+            private readonly int[] mDraws;
+
+            internal CommandBuffer(void* arena, SKRect[] bounds, int[] draws, Objects objects)
+                : this(Native.Additional.SkKernel_commandArenaData(arena), Native.Additional.SkKernel_commandArenaSize(arena),
+                      Native.Additional.SkKernel_commandArenaCount(arena), bounds, draws, objects, null)
             {
-                this.mem = reader;
+                mArena = arena;
+            }
+
+            internal CommandBuffer(int* data, int size, int count, SKRect[] bounds, int[] draws, Objects objects, IDisposable mapping)
+            {
+                mData = data;
+                mSize = size;
+                mCount = count;
+                mMapping = mapping;
+                mBounds = bounds;
+                mDraws = draws;
+                fixed (SKRect* b = bounds)
+                {
+                    mIndex = Native.Additional.SkKernel_rtreeCreate((float*)b, bounds.Length);
+                }
+                mObjectTable = objects;
+                mObjects = objects.snapshot();
+                ContentBounds = SKRect.Empty;
+                foreach (SKRect b in bounds)
+                {
+                    if (finite(b) && !empty(b))
+                    {
+                        ContentBounds = empty(ContentBounds) ? b : SKRect.Union(ContentBounds, b);
+                    }
+                }
+                DrawsRenderNodes = Array.Exists(mObjects, o => o is RenderNode);
+                Unbounded = drawsUnbounded();
+            }
+
+            // a render node is recorded unbounded as it may move, it damages its own area
+            private bool drawsUnbounded()
+            {
+                int* record = mData;
+                int index = 0;
+                for (int i = 0; i < mDraws.Length; i++)
+                {
+                    if (finite(mBounds[i]))
+                    {
+                        continue;
+                    }
+                    for (; index < mDraws[i]; index++)
+                    {
+                        record += HEADER + record[1];
+                    }
+                    if ((COMMANDS)record[0] != COMMANDS.DRAW_RENDER_NODE)
+                    {
+                        return true;
+                    }
+                }
+                return false;
             }
 
             protected override void OnDispose()
             {
-                mem.Dispose();
+                Native.Additional.SkKernel_commandArenaDestroy(mArena);
+                mArena = null;
+                Native.Additional.SkKernel_rtreeDestroy(mIndex);
+                mIndex = null;
+                // the objects of a mapped file may point into it, so go first
+                mObjectTable.release();
+                mMapping?.Dispose();
+                mMapping = null;
                 base.OnDispose();
             }
 
-            internal void PrepareMem()
+            /// <summary>
+            /// the size of the recorded commands in bytes, not counting the objects they use
+            /// </summary>
+            public long Length => mSize;
+
+            /// <summary>
+            /// the number of recorded commands
+            /// </summary>
+            public int Count => mCount;
+
+            /// <summary>
+            /// the number of distinct objects the recorded commands use
+            /// </summary>
+            internal int ObjectCount => mObjects.Length;
+
+            /// <summary>
+            /// the union of the bounds of the draws that have finite bounds, in the space the
+            /// buffer was recorded in
+            /// </summary>
+            internal SKRect ContentBounds { get; }
+
+            /// <summary>
+            /// true when a draw other than a render node has no bounds, such as a paint
+            /// filling the clip or a layer spreading its pixels, ContentBounds then does not
+            /// cover everything the buffer draws
+            /// </summary>
+            internal bool Unbounded { get; }
+
+            /// <summary>
+            /// true when the buffer draws render nodes by reference
+            /// </summary>
+            internal bool DrawsRenderNodes { get; }
+
+            /// <summary>
+            /// the number of draws the last playback skipped, as they fell outside the clip
+            /// of the canvas played back to, of whichever started last when playbacks overlap
+            /// </summary>
+            public int CulledCount { get; private set; }
+
+            /// <summary>
+            /// the number of draws the last playback issued, see CulledCount
+            /// </summary>
+            public int DrawnCount { get; private set; }
+
+            /// <summary>
+            /// writes the buffer as a display list file, which Map can replay without
+            /// parsing it, see RecordingCanvas2.DisplayListFile.cs for the format
+            /// <br/>
+            /// a file cannot refer to a render node, when flatten is true the display list of
+            /// each node the buffer draws is written in its place, under the node's matrix and
+            /// alpha as they are now, otherwise the nodes make it throw NotSupportedException
+            /// <br/>
+            /// throws NotSupportedException as well for an image whose pixels cannot be read,
+            /// such as one backed by a texture of a lost context
+            /// </summary>
+            public void WriteTo(Stream stream, bool flatten = false)
+            {
+                if (stream == null)
+                {
+                    throw new ArgumentNullException(nameof(stream));
+                }
+                if (flatten && Array.Exists(mObjects, o => o is RenderNode))
+                {
+                    // playing into a recording that inlines nodes copies the buffer with
+                    // every node drawn in place, nodes nested in nodes included
+                    using RecordingCanvas2 recorder = new() { mInlineRenderNodes = true };
+                    Playback(recorder);
+                    using CommandBuffer flat = recorder.GetCommandBuffer();
+                    flat.WriteTo(stream);
+                    return;
+                }
+                DisplayListFile.write(stream, mData, mSize, mCount, mBounds, mDraws, mObjects);
+            }
+
+            /// <summary>
+            /// writes the buffer as a display list file at path, replacing any file there,
+            /// see WriteTo(Stream, bool)
+            /// </summary>
+            public void WriteTo(string path, bool flatten = false)
+            {
+                if (path == null)
+                {
+                    throw new ArgumentNullException(nameof(path));
+                }
+                using FileStream stream = new(path, FileMode.Create, FileAccess.Write);
+                WriteTo(stream, flatten);
+            }
+
+            /// <summary>
+            /// maps a display list file written by WriteTo, its commands and images are used
+            /// where they lie in the file until the buffer is disposed
+            /// </summary>
+            /// <exception cref="InvalidDataException">the file is not a display list file or
+            /// has a version this build cannot read</exception>
+            public static CommandBuffer Map(string path)
+            {
+                if (path == null)
+                {
+                    throw new ArgumentNullException(nameof(path));
+                }
+                return DisplayListFile.map(path);
+            }
+
+            private T get<T>(int handle) where T : class
             {
-                mem.Position = 0;
+                return handle < 0 ? null : (T)mObjects[handle];
             }
 
             public void Playback(SKCanvas canvas)
@@ -32,387 +208,310 @@ namespace AndroidUI.Graphics
                     throw new ArgumentNullException(nameof(canvas));
                 }
 
-                mem.Position = 0;
-                while (mem.Position != mem.Length)
+                // only the draws sharing some area with the clip are issued, every other
+                // command is replayed so the canvas ends in the state the recording did
+                //
+                // a recording played into another is copied whole, the clip of a recording
+                // canvas is only its size, the outer recording is culled when it is played
+                //
+                // nothing of the buffer changes while it plays, the draws found are the call's
+                // own, so a buffer may be played on several threads at once or from within
+                // itself, through a drawable or picture
+                if (canvas is RecordingCanvas2)
+                {
+                    DrawnCount = mDraws.Length;
+                    CulledCount = 0;
+                    replay(canvas, null, mDraws.Length);
+                    return;
+                }
+                int[] visibleDraws = ArrayPool<int>.Shared.Rent(Math.Max(mDraws.Length, 1));
+                try
+                {
+                    SKRect clip = canvas.LocalClipBounds;
+                    int found;
+                    fixed (int* v = visibleDraws)
+                    {
+                        found = Native.Additional.SkKernel_rtreeSearch(mIndex, (float*)&clip, v);
+                    }
+                    DrawnCount = found;
+                    CulledCount = mDraws.Length - found;
+                    replay(canvas, visibleDraws, found);
+                }
+                finally
+                {
+                    ArrayPool<int>.Shared.Return(visibleDraws);
+                }
+            }
+
+            // plays the records, skipping the draws not in visibleDraws unless it is null
+            private void replay(SKCanvas canvas, int[] visibleDraws, int found)
+            {
+                bool cull = visibleDraws != null;
+                int index = -1;
+                int draw = 0;
+                int visible = 0;
+
+                int* record = mData;
+                int* end = record + mSize / sizeof(int);
+                while (record < end)
                 {
-                    COMMANDS command = (COMMANDS)mem.ReadByte();
+                    COMMANDS command = (COMMANDS)record[0];
+                    void* payload = record + HEADER;
+                    record += HEADER + record[1];
+                    index++;
+                    if (cull && draw < mDraws.Length && mDraws[draw] == index)
+                    {
+                        bool hit = visible < found && visibleDraws[visible] == draw;
+                        draw++;
+                        if (!hit)
+                        {
+                            continue;
+                        }
+                        visible++;
+                    }
                     switch (command)
                     {
                         case COMMANDS.CLEAR:
-                            canvas.Clear(mem.ReadSKColor());
+                            canvas.Clear(*(SKColor*)payload);
                             break;
                         case COMMANDS.CLEARF:
-                            canvas.Clear(mem.ReadSKColorF());
+                            canvas.Clear(*(SKColorF*)payload);
                             break;
                         case COMMANDS.CLIP_PATH:
                             {
-                                SKPath path = mem.ReadSKPath();
-                                canvas.ClipPath(
-                                    path,
-                                    (SKClipOperation)mem.ReadByte(),
-                                    mem.ReadBoolean()
-                                );
-                                path?.Dispose();
+                                ClipRecord* r = (ClipRecord*)payload;
+                                canvas.ClipPath(get<SKPath>(r->handle), (SKClipOperation)r->operation, r->antialias != 0);
                                 break;
                             }
                         case COMMANDS.CLIP_RECT:
-                            canvas.ClipRect(
-                                mem.ReadSKRect(),
-                                (SKClipOperation)mem.ReadByte(),
-                                mem.ReadBoolean()
-                            );
-                            break;
-                        case COMMANDS.CLIP_ROUND_RECT:
                             {
-                                SKRoundRect rect = mem.ReadSKRoundRect();
-                                canvas.ClipRoundRect(
-                                    rect,
-                                    (SKClipOperation)mem.ReadByte(),
-                                    mem.ReadBoolean()
-                                );
-                                rect?.Dispose();
+                                ClipRectRecord* r = (ClipRectRecord*)payload;
+                                canvas.ClipRect(r->rect, (SKClipOperation)r->operation, r->antialias != 0);
                                 break;
                             }
-                        case COMMANDS.CLIP_REGION:
+                        case COMMANDS.CLIP_ROUND_RECT:
                             {
-                                SKRegion region = mem.ReadSKRegion();
-                                canvas.ClipRegion(
-                                    region,
-                                    (SKClipOperation)mem.ReadByte()
-                                );
-                                region?.Dispose();
+                                ClipRecord* r = (ClipRecord*)payload;
+                                canvas.ClipRoundRect(get<SKRoundRect>(r->handle), (SKClipOperation)r->operation, r->antialias != 0);
                                 break;
                             }
-                        case COMMANDS.CONCAT:
+                        case COMMANDS.CLIP_REGION:
                             {
-                                SKMatrix m = mem.ReadSKMatrix();
-                                canvas.Concat(ref m);
+                                ClipRecord* r = (ClipRecord*)payload;
+                                canvas.ClipRegion(get<SKRegion>(r->handle), (SKClipOperation)r->operation);
                                 break;
                             }
+                        case COMMANDS.CONCAT:
+                            canvas.Concat(ref *(SKMatrix*)payload);
+                            break;
                         case COMMANDS.DRAW_ANNOTATION:
                             {
-                                var rect = mem.ReadSKRect();
-                                var key = mem.ReadString();
-                                var value = mem.ReadSKData();
-                                canvas.DrawAnnotation(rect, key, value);
-                                value?.Dispose();
+                                AnnotationRecord* r = (AnnotationRecord*)payload;
+                                canvas.DrawAnnotation(r->rect, get<string>(r->key), get<SKData>(r->value));
                                 break;
                             }
                         case COMMANDS.DRAW_ARC:
                             {
-                                var oval = mem.ReadSKRect();
-                                var startAngle = mem.ReadSingle();
-                                var sweepAngle = mem.ReadSingle();
-                                var useCenter = mem.ReadBoolean();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawArc(oval, startAngle, sweepAngle, useCenter, paint);
-                                paint?.Dispose();
+                                ArcRecord* r = (ArcRecord*)payload;
+                                canvas.DrawArc(r->oval, r->startAngle, r->sweepAngle, r->useCenter != 0, get<SKPaint>(r->paint));
                                 break;
                             }
-
                         case COMMANDS.DRAW_ATLAS:
                             {
-                                var atlas = mem.ReadSKImage();
-                                SKRect[] sprites = mem.ReadSKRectArray();
-                                SKRotationScaleMatrix[] transforms = mem.ReadSKRotationScaleMatrixArray();
-                                SKColor[] colors = mem.ReadSKColorArray();
-                                var mode = (SKBlendMode)mem.ReadByte();
-
-                                SKRect? cullRect;
-                                if (mem.ReadNullable())
-                                {
-                                    cullRect = null;
-                                }
-                                else
-                                {
-                                    cullRect = mem.ReadSKRect();
-                                }
-
-                                var paint = mem.ReadSKPaint();
-
-                                if (cullRect == null)
+                                AtlasRecord* r = (AtlasRecord*)payload;
+                                var atlas = get<SKImage>(r->atlas);
+                                var sprites = get<SKRect[]>(r->sprites);
+                                var transforms = get<SKRotationScaleMatrix[]>(r->transforms);
+                                var colors = get<SKColor[]>(r->colors);
+                                var paint = get<SKPaint>(r->paint);
+                                if (r->hasCullRect == 0)
                                 {
-                                    canvas.DrawAtlas(atlas, sprites, transforms, colors, mode, paint);
+                                    canvas.DrawAtlas(atlas, sprites, transforms, colors, (SKBlendMode)r->mode, paint);
                                 }
                                 else
                                 {
-                                    canvas.DrawAtlas(atlas, sprites, transforms, colors, mode, cullRect.Value, paint);
+                                    canvas.DrawAtlas(atlas, sprites, transforms, colors, (SKBlendMode)r->mode, r->cullRect, paint);
                                 }
-
-                                atlas?.Dispose();
-                                paint?.Dispose();
-
                                 break;
                             }
                         case COMMANDS.DRAW_CIRCLE:
                             {
-                                var cx = mem.ReadSingle();
-                                var cy = mem.ReadSingle();
-                                var radius = mem.ReadSingle();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawCircle(cx, cy, radius, paint);
-                                paint?.Dispose();
+                                CircleRecord* r = (CircleRecord*)payload;
+                                canvas.DrawCircle(r->cx, r->cy, r->radius, get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_COLOR:
-                            canvas.DrawColor(
-                                mem.ReadSKColor(),
-                                (SKBlendMode)mem.ReadByte()
-                            );
-                            break;
+                            {
+                                ColorRecord* r = (ColorRecord*)payload;
+                                canvas.DrawColor(r->color, (SKBlendMode)r->mode);
+                                break;
+                            }
                         case COMMANDS.DRAW_COLORF:
-                            canvas.DrawColor(
-                                mem.ReadSKColorF(),
-                                (SKBlendMode)mem.ReadByte()
-                            );
-                            break;
+                            {
+                                ColorFRecord* r = (ColorFRecord*)payload;
+                                canvas.DrawColor(r->color, (SKBlendMode)r->mode);
+                                break;
+                            }
                         case COMMANDS.DRAW_DRAWABLE:
                             {
-                                var drawable = mem.ReadSKDrawable();
-                                var matrix = mem.ReadSKMatrix();
-                                canvas.DrawDrawable(drawable, ref matrix);
-                                drawable?.Dispose();
+                                MatrixRecord* r = (MatrixRecord*)payload;
+                                canvas.DrawDrawable(get<SKDrawable>(r->handle), ref r->matrix);
                                 break;
                             }
                         case COMMANDS.DRAW_IMAGE_SKRECT_SKPAINT:
                             {
-                                var image = mem.ReadSKImage();
-                                var dest = mem.ReadSKRect();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawImage(image, dest, paint);
-                                image?.Dispose();
-                                paint?.Dispose();
+                                ImageRectRecord* r = (ImageRectRecord*)payload;
+                                canvas.DrawImage(get<SKImage>(r->image), r->dest, get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_IMAGE_SKRECT_SKRECT_SKPAINT:
                             {
-                                var image = mem.ReadSKImage();
-                                var source = mem.ReadSKRect();
-                                var dest = mem.ReadSKRect();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawImage(image, source, dest, paint);
-                                image?.Dispose();
-                                paint?.Dispose();
+                                ImageSourceRectRecord* r = (ImageSourceRectRecord*)payload;
+                                canvas.DrawImage(get<SKImage>(r->image), r->source, r->dest, get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_IMAGE_FLOAT_FLOAT_SKPAINT:
                             {
-                                var image = mem.ReadSKImage();
-                                float x = mem.ReadSingle();
-                                float y = mem.ReadSingle();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawImage(image, x, y, paint);
-                                image?.Dispose();
-                                paint?.Dispose();
+                                ObjectAtRecord* r = (ObjectAtRecord*)payload;
+                                canvas.DrawImage(get<SKImage>(r->handle), r->x, r->y, get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_IMAGE_LATTICE:
                             {
-                                var image = mem.ReadSKImage();
-                                var lattice = mem.ReadSKLattice();
-                                var dst = mem.ReadSKRect();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawImageLattice(image, lattice, dst, paint);
-                                image?.Dispose();
-                                paint?.Dispose();
+                                ImageLatticeRecord* r = (ImageLatticeRecord*)payload;
+                                canvas.DrawImageLattice(get<SKImage>(r->image), (SKLattice)mObjects[r->lattice], r->dest, get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_IMAGE_NINEPATCH:
                             {
-                                var image = mem.ReadSKImage();
-                                var center = mem.ReadSKRectI();
-                                var dst = mem.ReadSKRect();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawImageNinePatch(image, center, dst, paint);
-                                image?.Dispose();
-                                paint?.Dispose();
+                                ImageNinePatchRecord* r = (ImageNinePatchRecord*)payload;
+                                canvas.DrawImageNinePatch(get<SKImage>(r->image), r->center, r->dest, get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_LINE:
                             {
-                                var x0 = mem.ReadSingle();
-                                var y0 = mem.ReadSingle();
-                                var x1 = mem.ReadSingle();
-                                var y1 = mem.ReadSingle();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawLine(x0, y0, x1, y1, paint);
-                                paint?.Dispose();
+                                LineRecord* r = (LineRecord*)payload;
+                                canvas.DrawLine(r->x0, r->y0, r->x1, r->y1, get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_LINK_DESTINATION_ANNOTATION:
                             {
-                                var rect = mem.ReadSKRect();
-                                var data = mem.ReadSKData();
-                                canvas.DrawLinkDestinationAnnotation(rect, data);
-                                data?.Dispose();
+                                RectDataRecord* r = (RectDataRecord*)payload;
+                                canvas.DrawLinkDestinationAnnotation(r->rect, get<SKData>(r->data));
                                 break;
                             }
                         case COMMANDS.DRAW_NAMED_DESTINATION_ANNOTATION:
                             {
-                                var point = mem.ReadSKPoint();
-                                var data = mem.ReadSKData();
-                                canvas.DrawNamedDestinationAnnotation(point, data);
-                                data?.Dispose();
+                                PointDataRecord* r = (PointDataRecord*)payload;
+                                canvas.DrawNamedDestinationAnnotation(r->point, get<SKData>(r->data));
                                 break;
                             }
                         case COMMANDS.DRAW_OVAL:
                             {
-                                var rect = mem.ReadSKRect();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawOval(rect, paint);
-                                paint?.Dispose();
+                                RectRecord* r = (RectRecord*)payload;
+                                canvas.DrawOval(r->rect, get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_PAINT:
-                            {
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawPaint(paint);
-                                paint?.Dispose();
-                                break;
-                            }
+                            canvas.DrawPaint(get<SKPaint>(*(int*)payload));
+                            break;
                         case COMMANDS.DRAW_PATCH:
                             {
-                                var cubics = mem.ReadSKPointArray();
-                                var colors = mem.ReadSKColorArray();
-                                var texCoords = mem.ReadSKPointArray();
-                                var mode = (SKBlendMode)mem.ReadByte();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawPatch(cubics, colors, texCoords, mode, paint);
-                                paint?.Dispose();
+                                PatchRecord* r = (PatchRecord*)payload;
+                                canvas.DrawPatch(
+                                    get<SKPoint[]>(r->cubics),
+                                    get<SKColor[]>(r->colors),
+                                    get<SKPoint[]>(r->texCoords),
+                                    (SKBlendMode)r->mode,
+                                    get<SKPaint>(r->paint)
+                                );
                                 break;
                             }
                         case COMMANDS.DRAW_PATH:
                             {
-                                var path = mem.ReadSKPath();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawPath(path, paint);
-                                path?.Dispose();
-                                paint?.Dispose();
+                                ObjectRecord* r = (ObjectRecord*)payload;
+                                canvas.DrawPath(get<SKPath>(r->handle), get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_PICTURE_WITH_MATRIX:
                             {
-                                var picture = mem.ReadSKPicture();
-                                var matrix = mem.ReadSKMatrix();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawPicture(picture, ref matrix, paint);
-                                picture?.Dispose();
-                                paint?.Dispose();
+                                MatrixRecord* r = (MatrixRecord*)payload;
+                                canvas.DrawPicture(get<SKPicture>(r->handle), ref r->matrix, get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_PICTURE:
                             {
-                                var picture = mem.ReadSKPicture();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawPicture(picture, paint);
-                                picture?.Dispose();
-                                paint?.Dispose();
+                                ObjectRecord* r = (ObjectRecord*)payload;
+                                canvas.DrawPicture(get<SKPicture>(r->handle), get<SKPaint>(r->paint));
                                 break;
                             }
+                        case COMMANDS.DRAW_RENDER_NODE:
+                            get<RenderNode>(((ObjectRecord*)payload)->handle).draw(canvas);
+                            break;
                         case COMMANDS.DRAW_POINT:
                             {
-                                var x = mem.ReadSingle();
-                                var y = mem.ReadSingle();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawPoint(x, y, paint);
-                                paint?.Dispose();
+                                PointRecord* r = (PointRecord*)payload;
+                                canvas.DrawPoint(r->x, r->y, get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_POINTS:
                             {
-                                var mode = (SKPointMode)mem.ReadByte();
-                                var points = mem.ReadSKPointArray();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawPoints(mode, points, paint);
-                                paint?.Dispose();
+                                ModeRecord* r = (ModeRecord*)payload;
+                                canvas.DrawPoints((SKPointMode)r->mode, get<SKPoint[]>(r->handle), get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_RECT__XYWH:
                             {
-                                var x = mem.ReadSingle();
-                                var y = mem.ReadSingle();
-                                var w = mem.ReadSingle();
-                                var h = mem.ReadSingle();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawRect(x, y, w, h, paint);
-                                paint?.Dispose();
+                                XYWHRecord* r = (XYWHRecord*)payload;
+                                canvas.DrawRect(r->x, r->y, r->w, r->h, get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_RECT__RECT:
                             {
-                                var rect = mem.ReadSKRect();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawRect(rect, paint);
-                                paint?.Dispose();
+                                RectRecord* r = (RectRecord*)payload;
+                                canvas.DrawRect(r->rect, get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_REGION:
                             {
-                                var region = mem.ReadSKRegion();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawRegion(region, paint);
-                                region?.Dispose();
-                                paint?.Dispose();
+                                ObjectRecord* r = (ObjectRecord*)payload;
+                                canvas.DrawRegion(get<SKRegion>(r->handle), get<SKPaint>(r->paint));
                                 break;
                             }
-
                         case COMMANDS.DRAW_ROUNDED_RECT__RECT_XY:
                             {
-                                var rect = mem.ReadSKRect();
-                                var rx = mem.ReadSingle();
-                                var ry = mem.ReadSingle();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawRoundRect(rect, rx, ry, paint);
-                                paint?.Dispose();
+                                RoundRectXYRecord* r = (RoundRectXYRecord*)payload;
+                                canvas.DrawRoundRect(r->rect, r->rx, r->ry, get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_ROUNDED_RECT:
                             {
-                                var rect = mem.ReadSKRoundRect();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawRoundRect(rect, paint);
-                                rect?.Dispose();
-                                paint?.Dispose();
+                                ObjectRecord* r = (ObjectRecord*)payload;
+                                canvas.DrawRoundRect(get<SKRoundRect>(r->handle), get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_ROUNDED_RECT_DIFFERENCE:
                             {
-                                var outer = mem.ReadSKRoundRect();
-                                var inner = mem.ReadSKRoundRect();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawRoundRectDifference(outer, inner, paint);
-                                outer?.Dispose();
-                                inner?.Dispose();
-                                paint?.Dispose();
+                                RoundRectDifferenceRecord* r = (RoundRectDifferenceRecord*)payload;
+                                canvas.DrawRoundRectDifference(get<SKRoundRect>(r->outer), get<SKRoundRect>(r->inner), get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_TEXTBLOB:
                             {
-                                var blob = mem.ReadSKTextBlob();
-                                var x = mem.ReadSingle();
-                                var y = mem.ReadSingle();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawText(blob, x, y, paint);
-                                blob?.Dispose();
-                                paint?.Dispose();
+                                ObjectAtRecord* r = (ObjectAtRecord*)payload;
+                                canvas.DrawText(get<SKTextBlob>(r->handle), r->x, r->y, get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DRAW_URL_ANNOTATION:
                             {
-                                var rect = mem.ReadSKRect();
-                                var data = mem.ReadSKData();
-                                canvas.DrawUrlAnnotation(rect, data);
-                                data?.Dispose();
+                                RectDataRecord* r = (RectDataRecord*)payload;
+                                canvas.DrawUrlAnnotation(r->rect, get<SKData>(r->data));
                                 break;
                             }
                         case COMMANDS.DRAW_VERTICES:
                             {
-                                var vertices = mem.ReadSKVertices();
-                                var mode = (SKBlendMode)mem.ReadByte();
-                                var paint = mem.ReadSKPaint();
-                                canvas.DrawVertices(vertices, mode, paint);
-                                vertices?.Dispose();
-                                paint?.Dispose();
+                                ModeRecord* r = (ModeRecord*)payload;
+                                canvas.DrawVertices(get<SKVertices>(r->handle), (SKBlendMode)r->mode, get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.DISCARD:
@@ -428,59 +527,62 @@ namespace AndroidUI.Graphics
                             canvas.Restore();
                             break;
                         case COMMANDS.RESTORE_TO_COUNT:
-                            canvas.RestoreToCount(mem.ReadInt32());
+                            canvas.RestoreToCount(*(int*)payload);
                             break;
                         case COMMANDS.ROTATE_DEGREES:
-                            canvas.RotateDegrees(mem.ReadSingle());
+                            canvas.RotateDegrees(*(float*)payload);
                             break;
                         case COMMANDS.ROTATE_RADIANS:
-                            canvas.RotateRadians(mem.ReadSingle());
+                            canvas.RotateRadians(*(float*)payload);
                             break;
                         case COMMANDS.SAVE:
                             canvas.Save();
                             break;
                         case COMMANDS.SAVE_LAYER:
-                            {
-                                var paint = mem.ReadSKPaint();
-                                canvas.SaveLayer(paint);
-                                paint?.Dispose();
-                                break;
-                            }
+                            canvas.SaveLayer(get<SKPaint>(*(int*)payload));
+                            break;
                         case COMMANDS.SAVE_LAYER_RECT:
                             {
-                                var limit = mem.ReadSKRect();
-                                var paint = mem.ReadSKPaint();
-                                canvas.SaveLayer(limit, paint);
-                                paint?.Dispose();
+                                RectRecord* r = (RectRecord*)payload;
+                                canvas.SaveLayer(r->rect, get<SKPaint>(r->paint));
                                 break;
                             }
                         case COMMANDS.SCALE:
-                            canvas.Scale(mem.ReadSingle());
+                            canvas.Scale(*(float*)payload);
                             break;
                         case COMMANDS.SCALE_XY:
-                            canvas.Scale(mem.ReadSingle(), mem.ReadSingle());
-                            break;
+                            {
+                                SKPoint* s = (SKPoint*)payload;
+                                canvas.Scale(s->X, s->Y);
+                                break;
+                            }
                         case COMMANDS.SCALE_POINT:
-                            canvas.Scale(mem.ReadSKPoint());
+                            canvas.Scale(*(SKPoint*)payload);
                             break;
                         case COMMANDS.SET_MATRIX:
-                            canvas.SetMatrix(mem.ReadSKMatrix());
+                            canvas.SetMatrix(*(SKMatrix*)payload);
                             break;
                         case COMMANDS.SKEW_XY:
-                            canvas.Skew(mem.ReadSingle(), mem.ReadSingle());
-                            break;
+                            {
+                                SKPoint* s = (SKPoint*)payload;
+                                canvas.Skew(s->X, s->Y);
+                                break;
+                            }
                         case COMMANDS.SKEW_POINT:
-                            canvas.Skew(mem.ReadSKPoint());
+                            canvas.Skew(*(SKPoint*)payload);
                             break;
                         case COMMANDS.TRANSLATE_XY:
-                            canvas.Translate(mem.ReadSingle(), mem.ReadSingle());
-                            break;
+                            {
+                                SKPoint* t = (SKPoint*)payload;
+                                canvas.Translate(t->X, t->Y);
+                                break;
+                            }
                         case COMMANDS.TRANSLATE_POINT:
-                            canvas.Translate(mem.ReadSKPoint());
+                            canvas.Translate(*(SKPoint*)payload);
                             break;
                     }
                 }
             }
         }
     }
-}
\ No newline at end of file
+}
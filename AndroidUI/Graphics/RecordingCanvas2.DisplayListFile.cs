@@ -0,0 +1,746 @@
+﻿using SkiaSharp;
+using System.IO.MemoryMappedFiles;
+using System.Runtime.InteropServices;
+
+namespace AndroidUI.Graphics
+{
+    public partial class RecordingCanvas2
+    {
+        /**
+         * The display list file, a command buffer stored so it can be replayed in place from
+         * a memory mapping, see CommandBuffer.WriteTo and CommandBuffer.Map.
+         *
+         * Everything is little endian. The file starts with a header, the magic "AUDL", the
+         * major and minor version as shorts and the number of sections, then a table of
+         * sections, each a tag, a count, and the offset and size in bytes of its contents.
+         * Every section starts on a 16 byte boundary.
+         *
+         * COMMANDS   the records exactly as the command arena holds them, count records
+         * DRAWS      the record index of each draw, an int each
+         * BOUNDS     the bounds of each draw, 4 floats each, see RecordingCanvas2.Bounds.cs
+         * OBJECTS    an entry per object handle, its kind, an index into IMAGES for an image,
+         *            and the offset and size in DATA of its serialized form otherwise
+         * IMAGES     an entry per image, its width, height, color type, alpha type and row
+         *            bytes, then the offset and size in DATA of its pixels and color space
+         * TYPEFACES  an entry per distinct typeface, its offset and size in DATA
+         * DATA       every item an entry refers to, each on a 16 byte boundary
+         *
+         * Objects are serialized as MemoryWriter does, except typefaces, which are written
+         * as their index in TYPEFACES so a typeface used by many paints is stored once.
+         * Images are stored as raw pixels, a mapped image uses them where they lie.
+         *
+         * A reader refuses a major version other than its own and skips sections it does
+         * not know, a minor version may only add sections. It walks COMMANDS and DRAWS once
+         * before using them, so a record it replays always has a known command, the payload
+         * of that command and handles to objects the file holds of the kinds it expects.
+         */
+        internal static unsafe class DisplayListFile
+        {
+            // "AUDL" read as a little endian uint
+            internal const uint MAGIC = 0x4C445541;
+            internal const ushort MAJOR_VERSION = 1;
+            internal const ushort MINOR_VERSION = 0;
+            internal const int ALIGNMENT = 16;
+
+            private const int HEADER_SIZE = 16;
+            private const int SECTION_SIZE = 24;
+            private const int OBJECT_SIZE = 24;
+            private const int IMAGE_SIZE = 56;
+            private const int TYPEFACE_SIZE = 16;
+
+            internal enum Section : uint
+            {
+                COMMANDS = 1,
+                DRAWS = 2,
+                BOUNDS = 3,
+                OBJECTS = 4,
+                IMAGES = 5,
+                TYPEFACES = 6,
+                DATA = 7,
+            }
+
+            // the kinds of object, each read and written as Objects interns it
+            private enum Kind : uint
+            {
+                PAINT = 1,
+                PATH = 2,
+                IMAGE = 3,
+                REGION = 4,
+                ROUND_RECT = 5,
+                DATA = 6,
+                DRAWABLE = 7,
+                PICTURE = 8,
+                TEXT_BLOB = 9,
+                VERTICES = 10,
+                LATTICE = 11,
+                STRING = 12,
+                POINTS = 13,
+                COLORS = 14,
+                RECTS = 15,
+                TRANSFORMS = 16,
+            }
+
+            // a word of a payload holding an object handle, and the kind of object it refers to,
+            // required when playback uses it without checking for null
+            private readonly record struct Handle(int word, Kind kind, bool required);
+
+            // the payload of each command in words and the words of it holding object handles,
+            // null for a command a file cannot hold, see RecordingCanvas2.Records.cs
+            private static readonly (int words, Handle[] handles)[] PAYLOADS = payloads();
+
+            private static (int words, Handle[] handles) payload<T>(params (string field, Kind kind)[] handles) where T : unmanaged
+            {
+                // a lattice is a struct, it is recorded boxed and is never null
+                return (sizeof(T) / sizeof(int), Array.ConvertAll(handles, handle => new Handle(
+                    (int)Marshal.OffsetOf<T>(handle.field) / sizeof(int), handle.kind, handle.kind == Kind.LATTICE
+                )));
+            }
+
+            private static (int words, Handle[] handles)[] payloads()
+            {
+                (int words, Handle[] handles) none = (0, Array.Empty<Handle>());
+                (int words, Handle[] handles) paint = (1, new[] { new Handle(0, Kind.PAINT, false) });
+                var payloads = new (int words, Handle[] handles)[Enum.GetValues<COMMANDS>().Length];
+                payloads[(int)COMMANDS.CLEAR] = payload<SKColor>();
+                payloads[(int)COMMANDS.CLEARF] = payload<SKColorF>();
+                payloads[(int)COMMANDS.CLIP_PATH] = payload<ClipRecord>(("handle", Kind.PATH));
+                payloads[(int)COMMANDS.CLIP_RECT] = payload<ClipRectRecord>();
+                payloads[(int)COMMANDS.CLIP_REGION] = payload<ClipRecord>(("handle", Kind.REGION));
+                payloads[(int)COMMANDS.CLIP_ROUND_RECT] = payload<ClipRecord>(("handle", Kind.ROUND_RECT));
+                payloads[(int)COMMANDS.CONCAT] = payload<SKMatrix>();
+                payloads[(int)COMMANDS.DISCARD] = none;
+                payloads[(int)COMMANDS.FLUSH] = none;
+                payloads[(int)COMMANDS.DRAW_ANNOTATION] = payload<AnnotationRecord>(("key", Kind.STRING), ("value", Kind.DATA));
+                payloads[(int)COMMANDS.DRAW_ARC] = payload<ArcRecord>(("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_ATLAS] = payload<AtlasRecord>(("atlas", Kind.IMAGE), ("sprites", Kind.RECTS), ("transforms", Kind.TRANSFORMS), ("colors", Kind.COLORS), ("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_CIRCLE] = payload<CircleRecord>(("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_COLOR] = payload<ColorRecord>();
+                payloads[(int)COMMANDS.DRAW_COLORF] = payload<ColorFRecord>();
+                payloads[(int)COMMANDS.DRAW_DRAWABLE] = payload<MatrixRecord>(("handle", Kind.DRAWABLE), ("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_IMAGE_FLOAT_FLOAT_SKPAINT] = payload<ObjectAtRecord>(("handle", Kind.IMAGE), ("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_IMAGE_SKRECT_SKPAINT] = payload<ImageRectRecord>(("image", Kind.IMAGE), ("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_IMAGE_SKRECT_SKRECT_SKPAINT] = payload<ImageSourceRectRecord>(("image", Kind.IMAGE), ("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_IMAGE_LATTICE] = payload<ImageLatticeRecord>(("image", Kind.IMAGE), ("lattice", Kind.LATTICE), ("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_IMAGE_NINEPATCH] = payload<ImageNinePatchRecord>(("image", Kind.IMAGE), ("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_LINE] = payload<LineRecord>(("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_LINK_DESTINATION_ANNOTATION] = payload<RectDataRecord>(("data", Kind.DATA));
+                payloads[(int)COMMANDS.DRAW_NAMED_DESTINATION_ANNOTATION] = payload<PointDataRecord>(("data", Kind.DATA));
+                payloads[(int)COMMANDS.DRAW_OVAL] = payload<RectRecord>(("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_PAINT] = paint;
+                payloads[(int)COMMANDS.DRAW_PATCH] = payload<PatchRecord>(("cubics", Kind.POINTS), ("colors", Kind.COLORS), ("texCoords", Kind.POINTS), ("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_PATH] = payload<ObjectRecord>(("handle", Kind.PATH), ("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_PICTURE_WITH_MATRIX] = payload<MatrixRecord>(("handle", Kind.PICTURE), ("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_PICTURE] = payload<ObjectRecord>(("handle", Kind.PICTURE), ("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_POINT] = payload<PointRecord>(("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_POINTS] = payload<ModeRecord>(("handle", Kind.POINTS), ("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_RECT__XYWH] = payload<XYWHRecord>(("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_RECT__RECT] = payload<RectRecord>(("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_REGION] = payload<ObjectRecord>(("handle", Kind.REGION), ("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_ROUNDED_RECT__RECT_XY] = payload<RoundRectXYRecord>(("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_ROUNDED_RECT] = payload<ObjectRecord>(("handle", Kind.ROUND_RECT), ("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_ROUNDED_RECT_DIFFERENCE] = payload<RoundRectDifferenceRecord>(("outer", Kind.ROUND_RECT), ("inner", Kind.ROUND_RECT), ("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_TEXTBLOB] = payload<ObjectAtRecord>(("handle", Kind.TEXT_BLOB), ("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.DRAW_URL_ANNOTATION] = payload<RectDataRecord>(("data", Kind.DATA));
+                payloads[(int)COMMANDS.DRAW_VERTICES] = payload<ModeRecord>(("handle", Kind.VERTICES), ("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.RESET_MATRIX] = none;
+                payloads[(int)COMMANDS.RESTORE] = none;
+                payloads[(int)COMMANDS.RESTORE_TO_COUNT] = payload<int>();
+                payloads[(int)COMMANDS.ROTATE_DEGREES] = payload<float>();
+                payloads[(int)COMMANDS.ROTATE_RADIANS] = payload<float>();
+                payloads[(int)COMMANDS.SAVE] = none;
+                payloads[(int)COMMANDS.SAVE_LAYER] = paint;
+                payloads[(int)COMMANDS.SAVE_LAYER_RECT] = payload<RectRecord>(("paint", Kind.PAINT));
+                payloads[(int)COMMANDS.SCALE] = payload<float>();
+                payloads[(int)COMMANDS.SCALE_XY] = payload<SKPoint>();
+                payloads[(int)COMMANDS.SCALE_POINT] = payload<SKPoint>();
+                payloads[(int)COMMANDS.SET_MATRIX] = payload<SKMatrix>();
+                payloads[(int)COMMANDS.SKEW_XY] = payload<SKPoint>();
+                payloads[(int)COMMANDS.SKEW_POINT] = payload<SKPoint>();
+                payloads[(int)COMMANDS.TRANSLATE_XY] = payload<SKPoint>();
+                payloads[(int)COMMANDS.TRANSLATE_POINT] = payload<SKPoint>();
+                // a render node is never written, CommandBuffer.WriteTo draws it in place
+                return payloads;
+            }
+
+            // walks the commands once, so playback can trust every record header and handle,
+            // objects holds the OBJECTS entries
+            private static void checkCommands(int* commands, long size, int count, byte* objects, int objectCount)
+            {
+                if (size % sizeof(int) != 0)
+                {
+                    throw new InvalidDataException("display list file commands are malformed");
+                }
+                int* record = commands;
+                int* end = commands + size / sizeof(int);
+                int records = 0;
+                while (record < end)
+                {
+                    if (end - record < HEADER)
+                    {
+                        throw new InvalidDataException("display list file command " + records + " is truncated");
+                    }
+                    int command = record[0];
+                    if ((uint)command >= (uint)PAYLOADS.Length || PAYLOADS[command].handles == null)
+                    {
+                        throw new InvalidDataException("display list file command " + records + " is unknown, id " + command);
+                    }
+                    var payload = PAYLOADS[command];
+                    if (record[1] != payload.words || end - record - HEADER < payload.words)
+                    {
+                        throw new InvalidDataException("display list file command " + records + " has a malformed payload");
+                    }
+                    foreach (Handle field in payload.handles)
+                    {
+                        int handle = record[HEADER + field.word];
+                        if (handle < (field.required ? 0 : -1) || handle >= objectCount)
+                        {
+                            throw new InvalidDataException("display list file command " + records + " refers to a missing object");
+                        }
+                        if (handle >= 0 && (Kind)(*(uint*)(objects + OBJECT_SIZE * (long)handle)) != field.kind)
+                        {
+                            throw new InvalidDataException("display list file command " + records + " refers to a " + field.kind + " of another kind");
+                        }
+                    }
+                    record += HEADER + payload.words;
+                    records++;
+                }
+                if (records != count)
+                {
+                    throw new InvalidDataException("display list file holds " + records + " commands, expected " + count);
+                }
+            }
+
+            private static void checkDraws(int* draws, int drawCount, int count)
+            {
+                int last = -1;
+                for (int i = 0; i < drawCount; i++)
+                {
+                    if (draws[i] <= last || draws[i] >= count)
+                    {
+                        throw new InvalidDataException("display list file draw " + i + " is malformed");
+                    }
+                    last = draws[i];
+                }
+            }
+
+            private static void requireLittleEndian()
+            {
+                // records and tables are used in place, they are only readable as they lie on
+                // a little endian machine
+                if (!BitConverter.IsLittleEndian)
+                {
+                    throw new PlatformNotSupportedException("display list files need a little endian machine");
+                }
+            }
+
+            private static long align(long offset)
+            {
+                return (offset + ALIGNMENT - 1) & ~(long)(ALIGNMENT - 1);
+            }
+
+            private sealed class BytesComparer : IEqualityComparer<byte[]>
+            {
+                internal static readonly BytesComparer Instance = new();
+
+                public bool Equals(byte[] a, byte[] b)
+                {
+                    return a.AsSpan().SequenceEqual(b);
+                }
+
+                public int GetHashCode(byte[] bytes)
+                {
+                    HashCode h = new();
+                    h.AddBytes(bytes);
+                    return h.ToHashCode();
+                }
+            }
+
+            // writes the serialized objects to DATA, and typefaces as an index into TYPEFACES
+            private sealed class DataWriter : MemoryWriter
+            {
+                internal readonly List<byte[]> Typefaces = new();
+                private readonly Dictionary<byte[], int> mIndices = new(BytesComparer.Instance);
+
+                internal DataWriter(Stream output) : base(output, true)
+                {
+                }
+
+                public override void WriteSKTypeface(SKTypeface typeface)
+                {
+                    if (WriteNullable(typeface))
+                    {
+                        using SKData data = typeface.Serialize();
+                        byte[] bytes = data.ToArray();
+                        if (!mIndices.TryGetValue(bytes, out int index))
+                        {
+                            index = Typefaces.Count;
+                            Typefaces.Add(bytes);
+                            mIndices.Add(bytes, index);
+                        }
+                        Write(index);
+                    }
+                }
+
+                internal void pad()
+                {
+                    Flush();
+                    while (BaseStream.Position % ALIGNMENT != 0)
+                    {
+                        BaseStream.WriteByte(0);
+                    }
+                }
+            }
+
+            private sealed class DataReader : MemoryReader
+            {
+                private readonly Func<int, SKTypeface> mTypeface;
+
+                internal DataReader(Stream input, Func<int, SKTypeface> typeface) : base(input, true)
+                {
+                    mTypeface = typeface;
+                }
+
+                public override SKTypeface ReadSKTypeface()
+                {
+                    if (ReadNullable()) return null;
+                    return mTypeface(ReadInt32());
+                }
+            }
+
+            private static Kind kindOf(object value)
+            {
+                return value switch
+                {
+                    SKPaint => Kind.PAINT,
+                    SKPath => Kind.PATH,
+                    SKImage => Kind.IMAGE,
+                    SKRegion => Kind.REGION,
+                    SKRoundRect => Kind.ROUND_RECT,
+                    SKData => Kind.DATA,
+                    SKDrawable => Kind.DRAWABLE,
+                    SKPicture => Kind.PICTURE,
+                    SKTextBlob => Kind.TEXT_BLOB,
+                    SKVertices => Kind.VERTICES,
+                    SKLattice => Kind.LATTICE,
+                    string => Kind.STRING,
+                    SKPoint[] => Kind.POINTS,
+                    SKColor[] => Kind.COLORS,
+                    SKRect[] => Kind.RECTS,
+                    SKRotationScaleMatrix[] => Kind.TRANSFORMS,
+                    _ => throw new NotSupportedException("a display list file cannot store a " + value.GetType()),
+                };
+            }
+
+            private static void writeObject(DataWriter writer, Kind kind, object value)
+            {
+                switch (kind)
+                {
+                    case Kind.PAINT: writer.WriteSKPaint((SKPaint)value); break;
+                    case Kind.PATH: writer.WriteSKPath((SKPath)value); break;
+                    case Kind.REGION: writer.WriteSKRegion((SKRegion)value); break;
+                    case Kind.ROUND_RECT: writer.WriteSKRoundRect((SKRoundRect)value); break;
+                    case Kind.DATA: writer.WriteSKData((SKData)value); break;
+                    case Kind.DRAWABLE: writer.WriteSKDrawable((SKDrawable)value); break;
+                    case Kind.PICTURE: writer.WriteSKPicture((SKPicture)value); break;
+                    case Kind.TEXT_BLOB: writer.WriteSKTextBlob((SKTextBlob)value); break;
+                    case Kind.VERTICES: writer.WriteSKVertices((SKVertices)value); break;
+                    case Kind.LATTICE: writer.WriteSKLattice((SKLattice)value); break;
+                    case Kind.STRING: writer.Write((string)value); break;
+                    case Kind.POINTS: writer.WriteSKPointArray((SKPoint[])value); break;
+                    case Kind.COLORS: writer.WriteSKColorArray((SKColor[])value); break;
+                    case Kind.RECTS: writer.WriteSKRectArray((SKRect[])value); break;
+                    case Kind.TRANSFORMS: writer.WriteSKSKRotationScaleMatrixArray((SKRotationScaleMatrix[])value); break;
+                }
+            }
+
+            private static object readObject(DataReader reader, Kind kind)
+            {
+                return kind switch
+                {
+                    Kind.PAINT => reader.ReadSKPaint(),
+                    Kind.PATH => reader.ReadSKPath(),
+                    Kind.REGION => reader.ReadSKRegion(),
+                    Kind.ROUND_RECT => reader.ReadSKRoundRect(),
+                    Kind.DATA => reader.ReadSKData(),
+                    Kind.DRAWABLE => reader.ReadSKDrawable(),
+                    Kind.PICTURE => reader.ReadSKPicture(),
+                    Kind.TEXT_BLOB => reader.ReadSKTextBlob(),
+                    Kind.VERTICES => reader.ReadSKVertices(),
+                    Kind.LATTICE => reader.ReadSKLattice(),
+                    Kind.STRING => reader.ReadString(),
+                    Kind.POINTS => reader.ReadSKPointArray(),
+                    Kind.COLORS => reader.ReadSKColorArray(),
+                    Kind.RECTS => reader.ReadSKRectArray(),
+                    Kind.TRANSFORMS => reader.ReadSKRotationScaleMatrixArray(),
+                    _ => throw new InvalidDataException("unknown object kind " + (uint)kind),
+                };
+            }
+
+            private struct ImageEntry
+            {
+                public SKImageInfo info;
+                public long rowBytes;
+                public long pixels;
+                public long pixelsSize;
+                public long colorSpace;
+                public long colorSpaceSize;
+            }
+
+            private static ImageEntry writeImage(DataWriter writer, SKImage image)
+            {
+                SKImage raster = image;
+                SKPixmap pixmap = new();
+                try
+                {
+                    if (!raster.PeekPixels(pixmap))
+                    {
+                        raster = image.ToRasterImage(true);
+                        if (raster == null || !raster.PeekPixels(pixmap))
+                        {
+                            throw new NotSupportedException("cannot read the pixels of an image to store it");
+                        }
+                    }
+                    ImageEntry entry = new() { info = pixmap.Info, rowBytes = pixmap.RowBytes };
+                    writer.pad();
+                    entry.pixels = writer.BaseStream.Position;
+                    entry.pixelsSize = pixmap.BytesSize;
+                    writer.BaseStream.Write(pixmap.GetPixelSpan());
+                    if (pixmap.ColorSpace != null)
+                    {
+                        using SKData colorSpace = pixmap.ColorSpace.Serialize();
+                        writer.pad();
+                        entry.colorSpace = writer.BaseStream.Position;
+                        entry.colorSpaceSize = colorSpace.Size;
+                        writer.BaseStream.Write(colorSpace.Span);
+                    }
+                    return entry;
+                }
+                finally
+                {
+                    pixmap.Dispose();
+                    if (raster != image)
+                    {
+                        raster?.Dispose();
+                    }
+                }
+            }
+
+            internal static void write(Stream stream, int* commands, int size, int count, SKRect[] bounds, int[] draws, object[] objects)
+            {
+                requireLittleEndian();
+
+                using MemoryStream data = new();
+                using DataWriter writer = new(data);
+                List<ImageEntry> images = new();
+                Dictionary<SKImage, int> imageIndices = new();
+                (Kind kind, int index, long offset, long size)[] entries = new (Kind, int, long, long)[objects.Length];
+                for (int i = 0; i < objects.Length; i++)
+                {
+                    Kind kind = kindOf(objects[i]);
+                    if (kind == Kind.IMAGE)
+                    {
+                        SKImage image = (SKImage)objects[i];
+                        if (!imageIndices.TryGetValue(image, out int index))
+                        {
+                            index = images.Count;
+                            images.Add(writeImage(writer, image));
+                            imageIndices.Add(image, index);
+                        }
+                        entries[i] = (kind, index, 0, 0);
+                        continue;
+                    }
+                    writer.pad();
+                    long start = data.Position;
+                    writeObject(writer, kind, objects[i]);
+                    writer.Flush();
+                    entries[i] = (kind, -1, start, data.Position - start);
+                }
+                (long offset, long size)[] typefaces = new (long, long)[writer.Typefaces.Count];
+                for (int i = 0; i < typefaces.Length; i++)
+                {
+                    writer.pad();
+                    typefaces[i] = (data.Position, writer.Typefaces[i].Length);
+                    data.Write(writer.Typefaces[i]);
+                }
+                writer.Flush();
+
+                // lay the sections out one after another
+                (Section tag, int count, long size)[] sections = {
+                    (Section.COMMANDS, count, size),
+                    (Section.DRAWS, draws.Length, draws.Length * sizeof(int)),
+                    (Section.BOUNDS, bounds.Length, bounds.Length * sizeof(SKRect)),
+                    (Section.OBJECTS, entries.Length, entries.Length * OBJECT_SIZE),
+                    (Section.IMAGES, images.Count, images.Count * IMAGE_SIZE),
+                    (Section.TYPEFACES, typefaces.Length, typefaces.Length * TYPEFACE_SIZE),
+                    (Section.DATA, 0, data.Length),
+                };
+                long[] offsets = new long[sections.Length];
+                long end = HEADER_SIZE + SECTION_SIZE * sections.Length;
+                for (int i = 0; i < sections.Length; i++)
+                {
+                    offsets[i] = align(end);
+                    end = offsets[i] + sections[i].size;
+                }
+
+                using BinaryWriter output = new(stream, System.Text.Encoding.UTF8, true);
+                long position = 0;
+                void pad(long offset)
+                {
+                    for (; position < offset; position++)
+                    {
+                        output.Write((byte)0);
+                    }
+                }
+                void bytes(ReadOnlySpan<byte> span)
+                {
+                    output.Write(span);
+                    position += span.Length;
+                }
+
+                output.Write(MAGIC);
+                output.Write(MAJOR_VERSION);
+                output.Write(MINOR_VERSION);
+                output.Write(sections.Length);
+                output.Write(0);
+                position = HEADER_SIZE;
+                for (int i = 0; i < sections.Length; i++)
+                {
+                    output.Write((uint)sections[i].tag);
+                    output.Write(sections[i].count);
+                    output.Write(offsets[i]);
+                    output.Write(sections[i].size);
+                    position += SECTION_SIZE;
+                }
+
+                pad(offsets[0]);
+                bytes(new ReadOnlySpan<byte>(commands, size));
+                pad(offsets[1]);
+                bytes(MemoryMarshal.AsBytes(draws.AsSpan()));
+                pad(offsets[2]);
+                bytes(MemoryMarshal.AsBytes(bounds.AsSpan()));
+                pad(offsets[3]);
+                foreach (var entry in entries)
+                {
+                    output.Write((uint)entry.kind);
+                    output.Write(entry.index);
+                    output.Write(entry.offset);
+                    output.Write(entry.size);
+                    position += OBJECT_SIZE;
+                }
+                pad(offsets[4]);
+                foreach (ImageEntry image in images)
+                {
+                    output.Write(image.info.Width);
+                    output.Write(image.info.Height);
+                    output.Write((int)image.info.ColorType);
+                    output.Write((int)image.info.AlphaType);
+                    output.Write(image.rowBytes);
+                    output.Write(image.pixels);
+                    output.Write(image.pixelsSize);
+                    output.Write(image.colorSpace);
+                    output.Write(image.colorSpaceSize);
+                    position += IMAGE_SIZE;
+                }
+                pad(offsets[5]);
+                foreach (var typeface in typefaces)
+                {
+                    output.Write(typeface.offset);
+                    output.Write(typeface.size);
+                    position += TYPEFACE_SIZE;
+                }
+                pad(offsets[6]);
+                bytes(data.GetBuffer().AsSpan(0, (int)data.Length));
+                output.Flush();
+            }
+
+            private sealed class Mapping : IDisposable
+            {
+                private MemoryMappedFile mFile;
+                private MemoryMappedViewAccessor mView;
+                internal readonly byte* Pointer;
+                internal readonly long Length;
+
+                internal Mapping(string path)
+                {
+                    Length = new FileInfo(path).Length;
+                    if (Length < HEADER_SIZE)
+                    {
+                        throw new InvalidDataException("not a display list file, too short");
+                    }
+                    mFile = MemoryMappedFile.CreateFromFile(path, FileMode.Open, null, 0, MemoryMappedFileAccess.Read);
+                    mView = mFile.CreateViewAccessor(0, 0, MemoryMappedFileAccess.Read);
+                    byte* pointer = null;
+                    mView.SafeMemoryMappedViewHandle.AcquirePointer(ref pointer);
+                    Pointer = pointer + mView.PointerOffset;
+                }
+
+                public void Dispose()
+                {
+                    if (mView != null)
+                    {
+                        mView.SafeMemoryMappedViewHandle.ReleasePointer();
+                        mView.Dispose();
+                        mFile.Dispose();
+                        mView = null;
+                        mFile = null;
+                    }
+                }
+            }
+
+            internal static CommandBuffer map(string path)
+            {
+                requireLittleEndian();
+
+                Mapping mapping = new(path);
+                Objects objects = null;
+                try
+                {
+                    byte* file = mapping.Pointer;
+                    if (*(uint*)file != MAGIC)
+                    {
+                        throw new InvalidDataException("not a display list file");
+                    }
+                    ushort major = *(ushort*)(file + 4);
+                    if (major != MAJOR_VERSION)
+                    {
+                        throw new InvalidDataException("display list file version " + major + " is not supported, expected version " + MAJOR_VERSION);
+                    }
+                    long sectionCount = *(uint*)(file + 8);
+                    if (HEADER_SIZE + SECTION_SIZE * sectionCount > mapping.Length)
+                    {
+                        throw new InvalidDataException("display list file is truncated");
+                    }
+
+                    Dictionary<Section, (int count, long offset, long size)> sections = new();
+                    for (long i = 0; i < sectionCount; i++)
+                    {
+                        byte* section = file + HEADER_SIZE + SECTION_SIZE * i;
+                        Section tag = (Section)(*(uint*)section);
+                        int count = *(int*)(section + 4);
+                        long offset = *(long*)(section + 8);
+                        long size = *(long*)(section + 16);
+                        if (count < 0 || offset < 0 || size < 0 || offset % ALIGNMENT != 0 || offset > mapping.Length - size)
+                        {
+                            throw new InvalidDataException("display list file section " + (uint)tag + " is malformed");
+                        }
+                        sections[tag] = (count, offset, size);
+                    }
+                    (int count, long offset, long size) require(Section tag, int entrySize)
+                    {
+                        if (!sections.TryGetValue(tag, out var section))
+                        {
+                            throw new InvalidDataException("display list file has no " + tag + " section");
+                        }
+                        if (entrySize != 0 && section.size != (long)section.count * entrySize)
+                        {
+                            throw new InvalidDataException("display list file section " + tag + " is malformed");
+                        }
+                        return section;
+                    }
+
+                    var commands = require(Section.COMMANDS, 0);
+                    var draws = require(Section.DRAWS, sizeof(int));
+                    var bounds = require(Section.BOUNDS, sizeof(SKRect));
+                    var objectEntries = require(Section.OBJECTS, OBJECT_SIZE);
+                    var imageEntries = require(Section.IMAGES, IMAGE_SIZE);
+                    var typefaceEntries = require(Section.TYPEFACES, TYPEFACE_SIZE);
+                    var data = require(Section.DATA, 0);
+                    if (commands.size > int.MaxValue || draws.count != bounds.count)
+                    {
+                        throw new InvalidDataException("display list file is malformed");
+                    }
+
+                    checkCommands((int*)(file + commands.offset), commands.size, commands.count, file + objectEntries.offset, objectEntries.count);
+                    checkDraws((int*)(file + draws.offset), draws.count, commands.count);
+
+                    byte* dataStart = file + data.offset;
+                    byte* item(long offset, long size)
+                    {
+                        if (offset < 0 || size < 0 || offset > data.size - size)
+                        {
+                            throw new InvalidDataException("display list file refers past its data");
+                        }
+                        return dataStart + offset;
+                    }
+
+                    SKTypeface[] typefaces = new SKTypeface[typefaceEntries.count];
+                    SKTypeface typeface(int index)
+                    {
+                        if ((uint)index >= (uint)typefaces.Length)
+                        {
+                            throw new InvalidDataException("display list file refers to a missing typeface");
+                        }
+                        if (typefaces[index] == null)
+                        {
+                            long* entry = (long*)(file + typefaceEntries.offset + TYPEFACE_SIZE * (long)index);
+                            using SKData bytes = SKData.CreateCopy(new ReadOnlySpan<byte>(item(entry[0], entry[1]), (int)entry[1]));
+                            typefaces[index] = SKTypeface.Deserialize(bytes);
+                        }
+                        return typefaces[index];
+                    }
+
+                    objects = new();
+                    for (int i = 0; i < objectEntries.count; i++)
+                    {
+                        byte* entry = file + objectEntries.offset + OBJECT_SIZE * (long)i;
+                        Kind kind = (Kind)(*(uint*)entry);
+                        int index = *(int*)(entry + 4);
+                        long offset = *(long*)(entry + 8);
+                        long size = *(long*)(entry + 16);
+                        if (kind != Kind.IMAGE)
+                        {
+                            using UnmanagedMemoryStream stream = new(item(offset, size), size);
+                            using DataReader reader = new(stream, typeface);
+                            objects.add(readObject(reader, kind));
+                            continue;
+                        }
+                        if ((uint)index >= (uint)imageEntries.count)
+                        {
+                            throw new InvalidDataException("display list file refers to a missing image");
+                        }
+                        byte* image = file + imageEntries.offset + IMAGE_SIZE * (long)index;
+                        int* dimensions = (int*)image;
+                        long* layout = (long*)(image + 16);
+                        long rowBytes = layout[0];
+                        if (dimensions[0] <= 0 || dimensions[1] <= 0 || rowBytes > int.MaxValue || layout[4] > int.MaxValue)
+                        {
+                            throw new InvalidDataException("display list file image is malformed");
+                        }
+                        SKColorSpace colorSpace = null;
+                        if (layout[4] != 0)
+                        {
+                            using SKData bytes = SKData.CreateCopy(new ReadOnlySpan<byte>(item(layout[3], layout[4]), (int)layout[4]));
+                            colorSpace = SKColorSpace.Deserialize(bytes);
+                        }
+                        SKImageInfo info = new(dimensions[0], dimensions[1], (SKColorType)dimensions[2], (SKAlphaType)dimensions[3], colorSpace);
+                        // the sizes come from the file, SKImageInfo computes them in ints
+                        long minRowBytes = checked((long)info.Width * info.BytesPerPixel);
+                        long pixelsSize = checked(rowBytes * info.Height);
+                        if (info.BytesPerPixel <= 0 || rowBytes < minRowBytes || pixelsSize > layout[2])
+                        {
+                            throw new InvalidDataException("display list file image is malformed");
+                        }
+                        // the pixels are used where they lie, the buffer keeps the mapping
+                        // alive until its objects are released
+                        SKImage pixels = SKImage.FromPixels(info, (IntPtr)item(layout[1], layout[2]), (int)rowBytes);
+                        if (pixels == null)
+                        {
+                            throw new InvalidDataException("display list file image cannot be read");
+                        }
+                        objects.add(pixels);
+                    }
+
+                    SKRect[] drawBounds = new ReadOnlySpan<SKRect>(file + bounds.offset, bounds.count).ToArray();
+                    int[] drawRecords = new ReadOnlySpan<int>(file + draws.offset, draws.count).ToArray();
+                    return new CommandBuffer((int*)(file + commands.offset), (int)commands.size, commands.count, drawBounds, drawRecords, objects, mapping);
+                }
+                catch
+                {
+                    objects?.release();
+                    mapping.Dispose();
+                    throw;
+                }
+            }
+        }
+    }
+}
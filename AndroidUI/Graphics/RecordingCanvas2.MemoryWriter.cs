@@ -72,7 +72,7 @@ namespace AndroidUI.Graphics
                 return raster;
             }
 
-            public SKTypeface ReadSKTypeface()
+            public virtual SKTypeface ReadSKTypeface()
             {
                 if (ReadNullable()) return null;
                 using var data = ReadSKData();
@@ -524,7 +524,7 @@ namespace AndroidUI.Graphics
                 }
             }
 
-            public void WriteSKTypeface(SKTypeface typeface)
+            public virtual void WriteSKTypeface(SKTypeface typeface)
             {
                 if (WriteNullable(typeface))
                 {
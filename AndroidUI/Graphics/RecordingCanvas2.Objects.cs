@@ -0,0 +1,139 @@
+﻿namespace AndroidUI.Graphics
+{
+    public partial class RecordingCanvas2
+    {
+        /**
+         * The objects a recording refers to by handle.
+         *
+         * An object is serialized once when it is recorded and read back into a copy the
+         * recording owns, so the caller may change or dispose it afterwards. Objects that
+         * serialize alike share one handle, a paint used by a hundred draws is stored once.
+         *
+         * The table is shared by the recording and every command buffer taken from it, it
+         * is only ever appended to and disposes its objects once all of them are done.
+         */
+        internal sealed class Objects
+        {
+            private readonly struct Key : IEquatable<Key>
+            {
+                private readonly Type type;
+                private readonly byte[] bytes;
+                private readonly int hash;
+
+                public Key(Type type, byte[] bytes)
+                {
+                    this.type = type;
+                    this.bytes = bytes;
+                    HashCode h = new();
+                    h.Add(type);
+                    h.AddBytes(bytes);
+                    hash = h.ToHashCode();
+                }
+
+                public bool Equals(Key other)
+                {
+                    return type == other.type && bytes.AsSpan().SequenceEqual(other.bytes);
+                }
+
+                public override bool Equals(object obj)
+                {
+                    return obj is Key other && Equals(other);
+                }
+
+                public override int GetHashCode()
+                {
+                    return hash;
+                }
+            }
+
+            private readonly List<object> mObjects = new();
+            private readonly Dictionary<Key, int> mHandles = new();
+            private readonly MemoryStream mScratch = new();
+            private readonly MemoryWriter mWriter;
+            private int mRefs = 1;
+
+            internal Objects()
+            {
+                mWriter = new(mScratch, true);
+            }
+
+            internal int Count => mObjects.Count;
+
+            /**
+             * Returns the handle of an object that serializes like value, adding a copy of
+             * value if there is none, or -1 if value is null.
+             */
+            internal int intern<T>(T value, Action<MemoryWriter, T> write, Func<MemoryReader, T> read)
+            {
+                if (value == null)
+                {
+                    return -1;
+                }
+                mScratch.SetLength(0);
+                write(mWriter, value);
+                mWriter.Flush();
+                Key key = new(typeof(T), mScratch.ToArray());
+                if (mHandles.TryGetValue(key, out int handle))
+                {
+                    return handle;
+                }
+                mScratch.Position = 0;
+                using (MemoryReader reader = new(mScratch, true))
+                {
+                    mObjects.Add(read(reader));
+                }
+                handle = mObjects.Count - 1;
+                mHandles.Add(key, handle);
+                return handle;
+            }
+
+            /**
+             * Adds an object as is, returning its handle, for objects read back from a display
+             * list file, which were interned when written, and for render nodes, which are
+             * drawn by reference and never disposed by the table
+             */
+            internal int add(object value)
+            {
+                mObjects.Add(value);
+                return mObjects.Count - 1;
+            }
+
+            /**
+             * The object of a handle, null for -1
+             */
+            internal object get(int handle)
+            {
+                return handle < 0 ? null : mObjects[handle];
+            }
+
+            /**
+             * The objects added so far, indexed by handle
+             */
+            internal object[] snapshot()
+            {
+                return mObjects.ToArray();
+            }
+
+            internal void acquire()
+            {
+                Interlocked.Increment(ref mRefs);
+            }
+
+            internal void release()
+            {
+                if (Interlocked.Decrement(ref mRefs) != 0)
+                {
+                    return;
+                }
+                foreach (object o in mObjects)
+                {
+                    (o as IDisposable)?.Dispose();
+                }
+                mObjects.Clear();
+                mHandles.Clear();
+                mWriter.Dispose();
+                mScratch.Dispose();
+            }
+        }
+    }
+}
@@ -0,0 +1,305 @@
+﻿using SkiaSharp;
+
+namespace AndroidUI.Graphics
+{
+    public partial class RecordingCanvas2
+    {
+        // The pass run over a recording when a command buffer is taken from it, it rewrites
+        // the recorded commands into mOptimized without changing what they draw.
+        //
+        // - a draw falling wholly outside the clip is dropped
+        // - a Save whose Restore follows with nothing but matrix and clip changes between is
+        //   dropped along with them
+        // - each run of draws with no state change between is reordered so draws sharing a
+        //   paint are drawn together, a draw never moves past one it may overlap, see
+        //   SkDrawBatchKernel.h
+        // - aliased rectangle fills sharing a paint become one path while they do not
+        //   overlap, and an image drawn at several points with one paint becomes one atlas
+
+        private unsafe struct Op
+        {
+            public int* record;
+
+            // the index of the draw in mBounds, -1 for any other command
+            public int draw;
+
+            public COMMANDS command => (COMMANDS)record[0];
+
+            public void* payload => record + HEADER;
+
+            // see RecordingCanvas2.Records.cs
+            public int paint => command switch
+            {
+                COMMANDS.CLEAR or COMMANDS.CLEARF or COMMANDS.DRAW_COLOR or COMMANDS.DRAW_COLORF => -1,
+                _ => record[HEADER + record[1] - 1],
+            };
+        }
+
+        private unsafe void optimize(List<SKRect> bounds, List<int> draws)
+        {
+            List<Op> ops = new(Native.Additional.SkKernel_commandArenaCount(mArena));
+            int* record = Native.Additional.SkKernel_commandArenaData(mArena);
+            int* end = record + Native.Additional.SkKernel_commandArenaSize(mArena) / sizeof(int);
+            int draw = 0;
+            while (record < end)
+            {
+                Op op = new() { record = record, draw = -1 };
+                if (draw < mDraws.Count && mDraws[draw] == ops.Count)
+                {
+                    op.draw = draw++;
+                }
+                ops.Add(op);
+                record += HEADER + record[1];
+            }
+
+            bool[] removed = new bool[ops.Count];
+            for (int i = 0; i < ops.Count; i++)
+            {
+                if (ops[i].draw >= 0 && empty(mBounds[ops[i].draw]))
+                {
+                    removed[i] = true;
+                }
+            }
+            removeEmptySaves(ops, removed);
+
+            Native.Additional.SkKernel_commandArenaReset(mOptimized);
+            List<Op> run = new();
+            for (int i = 0; i < ops.Count; i++)
+            {
+                if (removed[i])
+                {
+                    continue;
+                }
+                if (ops[i].draw >= 0)
+                {
+                    run.Add(ops[i]);
+                    continue;
+                }
+                emitRun(run, bounds, draws);
+                Native.Additional.SkKernel_commandArenaAppend(mOptimized, ops[i].record[0], ops[i].record + HEADER, ops[i].record[1]);
+            }
+            emitRun(run, bounds, draws);
+        }
+
+        private static unsafe void removeEmptySaves(List<Op> ops, bool[] removed)
+        {
+            // the open saves, and whether anything but a matrix or clip change followed each
+            List<int> saves = new();
+            List<bool> used = new();
+            for (int i = 0; i < ops.Count; i++)
+            {
+                if (removed[i])
+                {
+                    continue;
+                }
+                switch (ops[i].command)
+                {
+                    case COMMANDS.SAVE:
+                        saves.Add(i);
+                        used.Add(false);
+                        break;
+                    case COMMANDS.SAVE_LAYER:
+                    case COMMANDS.SAVE_LAYER_RECT:
+                        // restoring even an empty layer may draw, through its paint
+                        saves.Add(i);
+                        used.Add(true);
+                        break;
+                    case COMMANDS.RESTORE:
+                        if (saves.Count == 0)
+                        {
+                            break;
+                        }
+                        int save = saves[^1];
+                        bool wasUsed = used[^1];
+                        saves.RemoveAt(saves.Count - 1);
+                        used.RemoveAt(used.Count - 1);
+                        if (!wasUsed)
+                        {
+                            Array.Fill(removed, true, save, i - save + 1);
+                        }
+                        else if (used.Count > 0)
+                        {
+                            used[^1] = true;
+                        }
+                        break;
+                    case COMMANDS.RESTORE_TO_COUNT:
+                        // the saves it closes depend on the canvas played back to, keep them all
+                        saves.Clear();
+                        used.Clear();
+                        break;
+                    case COMMANDS.CLIP_PATH:
+                    case COMMANDS.CLIP_RECT:
+                    case COMMANDS.CLIP_REGION:
+                    case COMMANDS.CLIP_ROUND_RECT:
+                    case COMMANDS.CONCAT:
+                    case COMMANDS.RESET_MATRIX:
+                    case COMMANDS.ROTATE_DEGREES:
+                    case COMMANDS.ROTATE_RADIANS:
+                    case COMMANDS.SCALE:
+                    case COMMANDS.SCALE_XY:
+                    case COMMANDS.SCALE_POINT:
+                    case COMMANDS.SET_MATRIX:
+                    case COMMANDS.SKEW_XY:
+                    case COMMANDS.SKEW_POINT:
+                    case COMMANDS.TRANSLATE_XY:
+                    case COMMANDS.TRANSLATE_POINT:
+                        break;
+                    default:
+                        if (used.Count > 0)
+                        {
+                            used[^1] = true;
+                        }
+                        break;
+                }
+            }
+        }
+
+        private unsafe void emitRun(List<Op> run, List<SKRect> bounds, List<int> draws)
+        {
+            if (run.Count == 0)
+            {
+                return;
+            }
+            int[] order = new int[run.Count];
+            if (run.Count == 1)
+            {
+                order[0] = 0;
+            }
+            else
+            {
+                SKRect[] rects = new SKRect[run.Count];
+                int[] keys = new int[run.Count];
+                for (int i = 0; i < run.Count; i++)
+                {
+                    rects[i] = mBounds[run[i].draw];
+                    keys[i] = run[i].paint;
+                }
+                fixed (SKRect* r = rects)
+                fixed (int* k = keys)
+                fixed (int* o = order)
+                {
+                    Native.Additional.SkKernel_drawBatchOrder((float*)r, k, run.Count, o);
+                }
+            }
+            for (int i = 0; i < order.Length;)
+            {
+                i = emitMerged(run, order, i, bounds, draws);
+            }
+            run.Clear();
+        }
+
+        private unsafe void emitDraw<T>(COMMANDS command, T payload, SKRect bound, List<SKRect> bounds, List<int> draws) where T : unmanaged
+        {
+            Native.Additional.SkKernel_commandArenaAppend(mOptimized, (int)command, (int*)&payload, sizeof(T) / sizeof(int));
+            draws.Add(Native.Additional.SkKernel_commandArenaCount(mOptimized) - 1);
+            bounds.Add(bound);
+        }
+
+        private static unsafe SKRect rectOf(Op op)
+        {
+            if (op.command == COMMANDS.DRAW_RECT__RECT)
+            {
+                return ((RectRecord*)op.payload)->rect.Standardized;
+            }
+            XYWHRecord* r = (XYWHRecord*)op.payload;
+            return SKRect.Create(r->x, r->y, r->w, r->h).Standardized;
+        }
+
+        private static bool mergesRects(SKPaint paint)
+        {
+            // aliased fills of rectangles and of a path of them touch the same pixels
+            return paint != null && !paint.IsAntialias && paint.Style == SKPaintStyle.Fill
+                && paint.PathEffect == null && paint.MaskFilter == null && paint.ImageFilter == null;
+        }
+
+        private static bool mergesImages(SKPaint paint)
+        {
+            return paint == null || (!paint.IsAntialias && paint.Shader == null && paint.ColorFilter == null
+                && paint.PathEffect == null && paint.MaskFilter == null && paint.ImageFilter == null);
+        }
+
+        // emits the draw at order[i], merged with those following it where it can be, and
+        // returns the position after the last draw emitted
+        private unsafe int emitMerged(List<Op> run, int[] order, int i, List<SKRect> bounds, List<int> draws)
+        {
+            Op first = run[order[i]];
+            int paint = first.paint;
+            SKRect union = mBounds[first.draw];
+            int end = i + 1;
+            bool rect = first.command == COMMANDS.DRAW_RECT__RECT || first.command == COMMANDS.DRAW_RECT__XYWH;
+            if (rect && mergesRects(mObjects.get(paint) as SKPaint))
+            {
+                // blending twice where two rectangles overlap differs from a path covering both
+                for (; end < order.Length; end++)
+                {
+                    Op next = run[order[end]];
+                    if ((next.command != COMMANDS.DRAW_RECT__RECT && next.command != COMMANDS.DRAW_RECT__XYWH) || next.paint != paint)
+                    {
+                        break;
+                    }
+                    SKRect bound = mBounds[next.draw];
+                    if (!empty(intersect(union, bound)))
+                    {
+                        break;
+                    }
+                    union = SKRect.Union(union, bound);
+                }
+                if (end - i > 1)
+                {
+                    using SKPath path = new();
+                    for (int k = i; k < end; k++)
+                    {
+                        path.AddRect(rectOf(run[order[k]]));
+                    }
+                    emitDraw(COMMANDS.DRAW_PATH, new ObjectRecord { handle = intern(path), paint = paint }, union, bounds, draws);
+                    return end;
+                }
+            }
+            // a null image is recorded as handle -1, there is no atlas to draw from
+            else if (first.command == COMMANDS.DRAW_IMAGE_FLOAT_FLOAT_SKPAINT && ((ObjectAtRecord*)first.payload)->handle >= 0 && mergesImages(mObjects.get(paint) as SKPaint))
+            {
+                int image = ((ObjectAtRecord*)first.payload)->handle;
+                for (; end < order.Length; end++)
+                {
+                    Op next = run[order[end]];
+                    if (next.command != COMMANDS.DRAW_IMAGE_FLOAT_FLOAT_SKPAINT || ((ObjectAtRecord*)next.payload)->handle != image || next.paint != paint)
+                    {
+                        break;
+                    }
+                    union = SKRect.Union(union, mBounds[next.draw]);
+                }
+                if (end - i > 1)
+                {
+                    SKImage atlas = (SKImage)mObjects.get(image);
+                    SKRect[] sprites = new SKRect[end - i];
+                    SKRotationScaleMatrix[] transforms = new SKRotationScaleMatrix[end - i];
+                    SKRect cull = SKRect.Empty;
+                    for (int k = i; k < end; k++)
+                    {
+                        ObjectAtRecord* r = (ObjectAtRecord*)run[order[k]].payload;
+                        sprites[k - i] = SKRect.Create(atlas.Width, atlas.Height);
+                        transforms[k - i] = SKRotationScaleMatrix.CreateTranslation(r->x, r->y);
+                        SKRect dest = SKRect.Create(r->x, r->y, atlas.Width, atlas.Height);
+                        cull = k == i ? dest : SKRect.Union(cull, dest);
+                    }
+                    emitDraw(COMMANDS.DRAW_ATLAS, new AtlasRecord
+                    {
+                        atlas = image,
+                        sprites = intern(sprites),
+                        transforms = intern(transforms),
+                        colors = -1,
+                        mode = (int)SKBlendMode.Modulate,
+                        hasCullRect = 1,
+                        cullRect = cull,
+                        paint = paint
+                    }, union, bounds, draws);
+                    return end;
+                }
+            }
+            Native.Additional.SkKernel_commandArenaAppend(mOptimized, first.record[0], first.record + HEADER, first.record[1]);
+            draws.Add(Native.Additional.SkKernel_commandArenaCount(mOptimized) - 1);
+            bounds.Add(mBounds[first.draw]);
+            return i + 1;
+        }
+    }
+}
@@ -0,0 +1,230 @@
+﻿using SkiaSharp;
+using System.Runtime.InteropServices;
+
+namespace AndroidUI.Graphics
+{
+    public partial class RecordingCanvas2
+    {
+        // The payloads of recorded commands, each is stored as is in the command arena and
+        // read in place during playback, so every field is a 4 byte value or a struct of them.
+        //
+        // Objects are recorded as handles into the objects of the recording, -1 for null,
+        // and flags as ints. The paint of a draw is always its last field, the optimizer
+        // reads it there.
+        //
+        // Commands whose payload is a single SkiaSharp struct or value record it directly.
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct ObjectRecord
+        {
+            public int handle;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct ObjectAtRecord
+        {
+            public int handle;
+            public float x;
+            public float y;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct ClipRecord
+        {
+            public int handle;
+            public int operation;
+            public int antialias;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct ClipRectRecord
+        {
+            public SKRect rect;
+            public int operation;
+            public int antialias;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct RectRecord
+        {
+            public SKRect rect;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct XYWHRecord
+        {
+            public float x;
+            public float y;
+            public float w;
+            public float h;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct LineRecord
+        {
+            public float x0;
+            public float y0;
+            public float x1;
+            public float y1;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct CircleRecord
+        {
+            public float cx;
+            public float cy;
+            public float radius;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct PointRecord
+        {
+            public float x;
+            public float y;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct ArcRecord
+        {
+            public SKRect oval;
+            public float startAngle;
+            public float sweepAngle;
+            public int useCenter;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct RoundRectXYRecord
+        {
+            public SKRect rect;
+            public float rx;
+            public float ry;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct RoundRectDifferenceRecord
+        {
+            public int outer;
+            public int inner;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct ColorRecord
+        {
+            public SKColor color;
+            public int mode;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct ColorFRecord
+        {
+            public SKColorF color;
+            public int mode;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct ImageRectRecord
+        {
+            public int image;
+            public SKRect dest;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct ImageSourceRectRecord
+        {
+            public int image;
+            public SKRect source;
+            public SKRect dest;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct ImageLatticeRecord
+        {
+            public int image;
+            public int lattice;
+            public SKRect dest;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct ImageNinePatchRecord
+        {
+            public int image;
+            public SKRectI center;
+            public SKRect dest;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct MatrixRecord
+        {
+            public int handle;
+            public SKMatrix matrix;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct AtlasRecord
+        {
+            public int atlas;
+            public int sprites;
+            public int transforms;
+            public int colors;
+            public int mode;
+            public int hasCullRect;
+            public SKRect cullRect;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct PatchRecord
+        {
+            public int cubics;
+            public int colors;
+            public int texCoords;
+            public int mode;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct ModeRecord
+        {
+            public int handle;
+            public int mode;
+            public int paint;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct AnnotationRecord
+        {
+            public SKRect rect;
+            public int key;
+            public int value;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct RectDataRecord
+        {
+            public SKRect rect;
+            public int data;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct PointDataRecord
+        {
+            public SKPoint point;
+            public int data;
+        }
+    }
+}
@@ -5,7 +5,15 @@ namespace AndroidUI.Graphics
 {
     public partial class RecordingCanvas2 : Canvas
     {
-        protected MemoryWriter mem = new(new MemoryStream(), false);
+        // header words of a record, the command then the payload length in words
+        private const int HEADER = 2;
+
+        // the recorded commands, see RecordingCanvas2.Records.cs for their payloads
+        private unsafe void* mArena = Native.Additional.SkKernel_commandArenaCreate();
+        private Objects mObjects = new();
+
+        // the commands rewritten by the optimizer, see RecordingCanvas2.Optimizer.cs
+        private unsafe void* mOptimized = Native.Additional.SkKernel_commandArenaCreate();
 
         public RecordingCanvas2()
         {
@@ -27,282 +35,281 @@ namespace AndroidUI.Graphics
             height = h;
         }
 
-        protected override void OnDispose()
+        protected override unsafe void OnDispose()
         {
-            mem.Dispose();
+            Native.Additional.SkKernel_commandArenaDestroy(mArena);
+            mArena = null;
+            Native.Additional.SkKernel_commandArenaDestroy(mOptimized);
+            mOptimized = null;
+            mObjects.release();
             base.OnDispose();
         }
 
+        private unsafe void record(COMMANDS command)
+        {
+            Native.Additional.SkKernel_commandArenaAppend(mArena, (int)command, null, 0);
+        }
+
+        private unsafe void record<T>(COMMANDS command, T payload) where T : unmanaged
+        {
+            Native.Additional.SkKernel_commandArenaAppend(mArena, (int)command, (int*)&payload, sizeof(T) / sizeof(int));
+        }
+
+        private int intern(SKPaint paint) => mObjects.intern(paint, (w, v) => w.WriteSKPaint(v), r => r.ReadSKPaint());
+        private int intern(SKPath path) => mObjects.intern(path, (w, v) => w.WriteSKPath(v), r => r.ReadSKPath());
+        private int intern(SKImage image) => mObjects.intern(image, (w, v) => w.WriteSKImage(v), r => r.ReadSKImage());
+        private int intern(SKRegion region) => mObjects.intern(region, (w, v) => w.WriteSKRegion(v), r => r.ReadSKRegion());
+        private int intern(SKRoundRect rect) => mObjects.intern(rect, (w, v) => w.WriteSKRoundRect(v), r => r.ReadSKRoundRect());
+        private int intern(SKData data) => mObjects.intern(data, (w, v) => w.WriteSKData(v), r => r.ReadSKData());
+        private int intern(SKDrawable drawable) => mObjects.intern(drawable, (w, v) => w.WriteSKDrawable(v), r => r.ReadSKDrawable());
+        private int intern(SKPicture picture) => mObjects.intern(picture, (w, v) => w.WriteSKPicture(v), r => r.ReadSKPicture());
+        private int intern(SKTextBlob blob) => mObjects.intern(blob, (w, v) => w.WriteSKTextBlob(v), r => r.ReadSKTextBlob());
+        private int intern(SKVertices vertices) => mObjects.intern(vertices, (w, v) => w.WriteSKVertices(v), r => r.ReadSKVertices());
+        private int intern(SKLattice lattice) => mObjects.intern<object>(lattice, (w, v) => w.WriteSKLattice((SKLattice)v), r => r.ReadSKLattice());
+        private int intern(string text) => mObjects.intern(text, (w, v) => w.Write(v), r => r.ReadString());
+        private int intern(SKPoint[] points) => mObjects.intern(points, (w, v) => w.WriteSKPointArray(v), r => r.ReadSKPointArray());
+        private int intern(SKColor[] colors) => mObjects.intern(colors, (w, v) => w.WriteSKColorArray(v), r => r.ReadSKColorArray());
+        private int intern(SKRect[] rects) => mObjects.intern(rects, (w, v) => w.WriteSKRectArray(v), r => r.ReadSKRectArray());
+        private int intern(SKRotationScaleMatrix[] transforms) => mObjects.intern(transforms, (w, v) => w.WriteSKSKRotationScaleMatrixArray(v), r => r.ReadSKRotationScaleMatrixArray());
+
         public override void Clear(SKColor color)
         {
-            mem.Write((byte)COMMANDS.CLEAR);
-            mem.WriteSKColor(color);
+            record(COMMANDS.CLEAR, color, UNBOUNDED);
         }
 
         public override void Clear(SKColorF color)
         {
-            mem.Write((byte)COMMANDS.CLEARF);
-            mem.WriteSKColorF(color);
+            record(COMMANDS.CLEARF, color, UNBOUNDED);
         }
 
         public override void DrawAnnotation(SKRect rect, string key, SKData value)
         {
-            mem.Write((byte)COMMANDS.DRAW_ANNOTATION);
-            mem.WriteSKRect(rect);
-            mem.Write(key);
-            mem.WriteSKData(value);
+            record(COMMANDS.DRAW_ANNOTATION, new AnnotationRecord { rect = rect, key = intern(key), value = intern(value) });
         }
 
         public override void DrawArc(SKRect oval, float startAngle, float sweepAngle, bool useCenter, SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.DRAW_ARC);
-            mem.WriteSKRect(oval);
-            mem.Write(startAngle);
-            mem.Write(sweepAngle);
-            mem.Write(useCenter);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_ARC, new ArcRecord
+            {
+                oval = oval,
+                startAngle = startAngle,
+                sweepAngle = sweepAngle,
+                useCenter = useCenter ? 1 : 0,
+                paint = intern(paint)
+            }, oval, paint);
         }
 
         public override unsafe void DrawAtlas(SKImage atlas, SKRect[] sprites, SKRotationScaleMatrix[] transforms, SKColor[] colors, SKBlendMode mode, SKRect* cullRect, SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.DRAW_ATLAS);
-            mem.WriteSKImage(atlas);
-            mem.WriteSKRectArray(sprites);
-            mem.WriteSKSKRotationScaleMatrixArray(transforms);
-            mem.WriteSKColorArray(colors);
-
-            mem.Write((byte)mode);
-
-            if (mem.WriteNullable(cullRect))
+            record(COMMANDS.DRAW_ATLAS, new AtlasRecord
             {
-                mem.WriteSKRect(*cullRect);
-            }
-
-            mem.WriteSKPaint(paint);
+                atlas = intern(atlas),
+                sprites = intern(sprites),
+                transforms = intern(transforms),
+                colors = intern(colors),
+                mode = (int)mode,
+                hasCullRect = cullRect != null ? 1 : 0,
+                cullRect = cullRect != null ? *cullRect : default,
+                paint = intern(paint)
+            }, cullRect != null ? *cullRect : UNBOUNDED, paint);
         }
 
         public override void DrawCircle(float cx, float cy, float radius, SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.DRAW_CIRCLE);
-            mem.Write(cx);
-            mem.Write(cy);
-            mem.Write(radius);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_CIRCLE, new CircleRecord { cx = cx, cy = cy, radius = radius, paint = intern(paint) }, new SKRect(cx - radius, cy - radius, cx + radius, cy + radius), paint);
         }
 
         public override void DrawColor(SKColor color, SKBlendMode mode = SKBlendMode.Src)
         {
-            mem.Write((byte)COMMANDS.DRAW_COLOR);
-            mem.WriteSKColor(color);
-            mem.Write((byte)mode);
+            record(COMMANDS.DRAW_COLOR, new ColorRecord { color = color, mode = (int)mode }, UNBOUNDED);
         }
 
         public override void DrawColor(SKColorF color, SKBlendMode mode = SKBlendMode.Src)
         {
-            mem.Write((byte)COMMANDS.DRAW_COLORF);
-            mem.WriteSKColorF(color);
-            mem.Write((byte)mode);
+            record(COMMANDS.DRAW_COLORF, new ColorFRecord { color = color, mode = (int)mode }, UNBOUNDED);
         }
 
         public override void DrawDrawable(SKDrawable drawable, ref SKMatrix matrix)
         {
-            mem.Write((byte)COMMANDS.DRAW_DRAWABLE);
-            mem.WriteSKDrawable(drawable);
-            mem.WriteSKMatrix(ref matrix);
+            record(COMMANDS.DRAW_DRAWABLE, new MatrixRecord { handle = intern(drawable), matrix = matrix, paint = -1 }, map(matrix, drawable?.Bounds ?? SKRect.Empty));
         }
 
         public override void DrawImage(SKImage image, SKRect dest, SKPaint paint = null)
         {
-            mem.Write((byte)COMMANDS.DRAW_IMAGE_SKRECT_SKPAINT);
-            mem.WriteSKImage(image);
-            mem.WriteSKRect(dest);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_IMAGE_SKRECT_SKPAINT, new ImageRectRecord { image = intern(image), dest = dest, paint = intern(paint) }, dest, paint);
         }
 
         public override void DrawImage(SKImage image, SKRect source, SKRect dest, SKPaint paint = null)
         {
-            mem.Write((byte)COMMANDS.DRAW_IMAGE_SKRECT_SKRECT_SKPAINT);
-            mem.WriteSKImage(image);
-            mem.WriteSKRect(source);
-            mem.WriteSKRect(dest);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_IMAGE_SKRECT_SKRECT_SKPAINT, new ImageSourceRectRecord
+            {
+                image = intern(image),
+                source = source,
+                dest = dest,
+                paint = intern(paint)
+            }, dest, paint);
         }
 
         public override void DrawImage(SKImage image, float x, float y, SKPaint paint = null)
         {
-            mem.Write((byte)COMMANDS.DRAW_IMAGE_FLOAT_FLOAT_SKPAINT);
-            mem.WriteSKImage(image);
-            mem.Write(x);
-            mem.Write(y);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_IMAGE_FLOAT_FLOAT_SKPAINT, new ObjectAtRecord { handle = intern(image), x = x, y = y, paint = intern(paint) }, SKRect.Create(x, y, image?.Width ?? 0, image?.Height ?? 0), paint);
         }
 
         public override void DrawImageLattice(SKImage image, SKLattice lattice, SKRect dst, SKPaint paint = null)
         {
-            mem.Write((byte)COMMANDS.DRAW_IMAGE_LATTICE);
-            mem.WriteSKImage(image);
-            mem.WriteSKLattice(lattice);
-            mem.WriteSKRect(dst);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_IMAGE_LATTICE, new ImageLatticeRecord
+            {
+                image = intern(image),
+                lattice = intern(lattice),
+                dest = dst,
+                paint = intern(paint)
+            }, dst, paint);
         }
 
         public override void DrawImageNinePatch(SKImage image, SKRectI center, SKRect dst, SKPaint paint = null)
         {
-            mem.Write((byte)COMMANDS.DRAW_IMAGE_NINEPATCH);
-            mem.WriteSKImage(image);
-            mem.WriteSKRectI(center);
-            mem.WriteSKRect(dst);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_IMAGE_NINEPATCH, new ImageNinePatchRecord
+            {
+                image = intern(image),
+                center = center,
+                dest = dst,
+                paint = intern(paint)
+            }, dst, paint);
         }
 
         public override void DrawLine(float x0, float y0, float x1, float y1, SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.DRAW_LINE);
-            mem.Write(x0);
-            mem.Write(y0);
-            mem.Write(x1);
-            mem.Write(y1);
-            mem.WriteSKPaint(paint);
+            recordStroke(COMMANDS.DRAW_LINE, new LineRecord { x0 = x0, y0 = y0, x1 = x1, y1 = y1, paint = intern(paint) }, new SKRect(x0, y0, x1, y1), paint);
         }
 
         public override void DrawLinkDestinationAnnotation(SKRect rect, SKData value)
         {
-            mem.Write((byte)COMMANDS.DRAW_LINK_DESTINATION_ANNOTATION);
-            mem.WriteSKRect(rect);
-            mem.WriteSKData(value);
+            record(COMMANDS.DRAW_LINK_DESTINATION_ANNOTATION, new RectDataRecord { rect = rect, data = intern(value) });
         }
 
         public override void DrawNamedDestinationAnnotation(SKPoint point, SKData value)
         {
-            mem.Write((byte)COMMANDS.DRAW_NAMED_DESTINATION_ANNOTATION);
-            mem.WriteSKPoint(point);
-            mem.WriteSKData(value);
+            record(COMMANDS.DRAW_NAMED_DESTINATION_ANNOTATION, new PointDataRecord { point = point, data = intern(value) });
         }
 
         public override void DrawOval(SKRect rect, SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.DRAW_OVAL);
-            mem.WriteSKRect(rect);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_OVAL, new RectRecord { rect = rect, paint = intern(paint) }, rect, paint);
         }
 
         public override void DrawPaint(SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.DRAW_PAINT);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_PAINT, intern(paint), UNBOUNDED);
         }
 
         public override void DrawPatch(SKPoint[] cubics, SKColor[] colors, SKPoint[] texCoords, SKBlendMode mode, SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.DRAW_PATCH);
-            mem.WriteSKPointArray(cubics);
-            mem.WriteSKColorArray(colors);
-            mem.WriteSKPointArray(texCoords);
-            mem.Write((byte)mode);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_PATCH, new PatchRecord
+            {
+                cubics = intern(cubics),
+                colors = intern(colors),
+                texCoords = intern(texCoords),
+                mode = (int)mode,
+                paint = intern(paint)
+            }, bound(cubics), paint);
         }
 
         public override void DrawPath(SKPath path, SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.DRAW_PATH);
-            mem.WriteSKPath(path);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_PATH, new ObjectRecord { handle = intern(path), paint = intern(paint) }, bound(path), paint);
         }
 
         public override void DrawPicture(SKPicture picture, ref SKMatrix matrix, SKPaint paint = null)
         {
-            mem.Write((byte)COMMANDS.DRAW_PICTURE_WITH_MATRIX);
-            mem.WriteSKPicture(picture);
-            mem.WriteSKMatrix(ref matrix);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_PICTURE_WITH_MATRIX, new MatrixRecord { handle = intern(picture), matrix = matrix, paint = intern(paint) }, map(matrix, picture?.CullRect ?? SKRect.Empty), paint);
         }
 
         public override void DrawPicture(SKPicture picture, SKPaint paint = null)
         {
-            mem.Write((byte)COMMANDS.DRAW_PICTURE);
-            mem.WriteSKPicture(picture);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_PICTURE, new ObjectRecord { handle = intern(picture), paint = intern(paint) }, picture?.CullRect ?? SKRect.Empty, paint);
+        }
+
+        // set when the recording is written to a display list file, which cannot refer to
+        // nodes, see CommandBuffer.WriteTo
+        internal bool mInlineRenderNodes;
+
+        /**
+         * Records a reference to a node, playback draws whatever display list and properties
+         * the node has by then, see RenderNode
+         */
+        public void DrawRenderNode(RenderNode node)
+        {
+            if (node == null)
+            {
+                throw new ArgumentNullException(nameof(node));
+            }
+            if (mInlineRenderNodes)
+            {
+                node.drawContent(this);
+                return;
+            }
+            // the node may be moved after this is recorded, only the clip bounds it
+            record(COMMANDS.DRAW_RENDER_NODE, new ObjectRecord { handle = mObjects.add(node), paint = -1 }, UNBOUNDED);
         }
 
         public override void DrawPoint(float x, float y, SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.DRAW_POINT);
-            mem.Write(x);
-            mem.Write(y);
-            mem.WriteSKPaint(paint);
+            recordStroke(COMMANDS.DRAW_POINT, new PointRecord { x = x, y = y, paint = intern(paint) }, new SKRect(x, y, x, y), paint);
         }
 
         public override void DrawPoints(SKPointMode mode, SKPoint[] points, SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.DRAW_POINTS);
-            mem.Write((byte)mode);
-            mem.WriteSKPointArray(points);
-            mem.WriteSKPaint(paint);
+            recordStroke(COMMANDS.DRAW_POINTS, new ModeRecord { handle = intern(points), mode = (int)mode, paint = intern(paint) }, bound(points), paint);
         }
 
         public override void DrawRect(float x, float y, float w, float h, SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.DRAW_RECT__XYWH);
-            mem.Write(x);
-            mem.Write(y);
-            mem.Write(w);
-            mem.Write(h);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_RECT__XYWH, new XYWHRecord { x = x, y = y, w = w, h = h, paint = intern(paint) }, SKRect.Create(x, y, w, h), paint);
         }
 
         public override void DrawRect(SKRect rect, SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.DRAW_RECT__RECT);
-            mem.WriteSKRect(rect);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_RECT__RECT, new RectRecord { rect = rect, paint = intern(paint) }, rect, paint);
         }
 
         public override void DrawRegion(SKRegion region, SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.DRAW_REGION);
-            mem.WriteSKRegion(region);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_REGION, new ObjectRecord { handle = intern(region), paint = intern(paint) }, region?.Bounds ?? SKRectI.Empty, paint);
         }
 
         public override void DrawRoundRect(SKRect rect, float rx, float ry, SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.DRAW_ROUNDED_RECT__RECT_XY);
-            mem.WriteSKRect(rect);
-            mem.Write(rx);
-            mem.Write(ry);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_ROUNDED_RECT__RECT_XY, new RoundRectXYRecord { rect = rect, rx = rx, ry = ry, paint = intern(paint) }, rect, paint);
         }
 
         public override void DrawRoundRect(SKRoundRect rect, SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.DRAW_ROUNDED_RECT);
-            mem.WriteSKRoundRect(rect);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_ROUNDED_RECT, new ObjectRecord { handle = intern(rect), paint = intern(paint) }, rect?.Rect ?? SKRect.Empty, paint);
         }
 
         public override void DrawRoundRectDifference(SKRoundRect outer, SKRoundRect inner, SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.DRAW_ROUNDED_RECT_DIFFERENCE);
-            mem.WriteSKRoundRect(outer);
-            mem.WriteSKRoundRect(inner);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_ROUNDED_RECT_DIFFERENCE, new RoundRectDifferenceRecord
+            {
+                outer = intern(outer),
+                inner = intern(inner),
+                paint = intern(paint)
+            }, outer?.Rect ?? SKRect.Empty, paint);
         }
 
         public override void DrawSurface(SKSurface surface, float x, float y, SKPaint paint = null)
         {
             // we cannot record the surface to draw it later cus GPU
             // so attempt to record it as an Image snapshot instead
-            var image = surface.Snapshot();
+            using var image = surface.Snapshot();
             DrawImage(image, x, y, paint);
         }
 
         public override void DrawText(SKTextBlob text, float x, float y, SKPaint paint)
         {
-            mem.Write(value: (byte)COMMANDS.DRAW_TEXTBLOB);
-            mem.WriteSKTextBlob(text);
-            mem.Write(x);
-            mem.Write(y);
-            mem.WriteSKPaint(paint);
+            SKRect bounds = text?.Bounds ?? SKRect.Empty;
+            bounds.Offset(x, y);
+            record(COMMANDS.DRAW_TEXTBLOB, new ObjectAtRecord { handle = intern(text), x = x, y = y, paint = intern(paint) }, bounds, paint);
         }
 
         public override void DrawToCanvas(BaseCanvas canvas, int x, int y, SKPaint paint = null)
@@ -317,69 +324,57 @@ namespace AndroidUI.Graphics
 
         public override void DrawUrlAnnotation(SKRect rect, SKData value)
         {
-            mem.Write(value: (byte)COMMANDS.DRAW_URL_ANNOTATION);
-            mem.WriteSKRect(rect);
-            mem.WriteSKData(value);
+            record(COMMANDS.DRAW_URL_ANNOTATION, new RectDataRecord { rect = rect, data = intern(value) });
         }
 
         public override void DrawVertices(SKVertices vertices, SKBlendMode mode, SKPaint paint)
         {
-            mem.Write(value: (byte)COMMANDS.DRAW_VERTICES);
-            mem.WriteSKVertices(vertices);
-            mem.Write((byte)mode);
-            mem.WriteSKPaint(paint);
+            record(COMMANDS.DRAW_VERTICES, new ModeRecord { handle = intern(vertices), mode = (int)mode, paint = intern(paint) }, UNBOUNDED, paint);
         }
 
         public override void Discard()
         {
-            mem.Write((byte)COMMANDS.DISCARD);
+            record(COMMANDS.DISCARD);
             base.Discard();
         }
 
         public override void Flush()
         {
-            mem.Write((byte)COMMANDS.FLUSH);
+            record(COMMANDS.FLUSH);
         }
 
         public override void ClipPath(SKPath path, SKClipOperation operation = SKClipOperation.Intersect, bool antialias = false)
         {
-            mem.Write((byte)COMMANDS.CLIP_PATH);
-            mem.WriteSKPath(path);
-            mem.Write((byte)operation);
-            mem.Write(antialias);
+            record(COMMANDS.CLIP_PATH, new ClipRecord { handle = intern(path), operation = (int)operation, antialias = antialias ? 1 : 0 });
             base.ClipPath(path, operation, antialias);
+            clipped(bound(path), operation);
         }
 
         public override void ClipRect(SKRect rect, SKClipOperation operation = SKClipOperation.Intersect, bool antialias = false)
         {
-            mem.Write((byte)COMMANDS.CLIP_RECT);
-            mem.WriteSKRect(rect);
-            mem.Write((byte)operation);
-            mem.Write(antialias);
+            record(COMMANDS.CLIP_RECT, new ClipRectRecord { rect = rect, operation = (int)operation, antialias = antialias ? 1 : 0 });
             base.ClipRect(rect, operation, antialias);
+            clipped(rect, operation);
         }
 
         public override void ClipRegion(SKRegion region, SKClipOperation operation = SKClipOperation.Intersect)
         {
-            mem.Write((byte)COMMANDS.CLIP_REGION);
-            mem.WriteSKRegion(region);
-            mem.Write((byte)operation);
+            record(COMMANDS.CLIP_REGION, new ClipRecord { handle = intern(region), operation = (int)operation });
+            // a region is in device space, it stays put while the playback matrix moves the draws,
+            // so like SetMatrix it says nothing about where they land and the clip is left alone
             base.ClipRegion(region, operation);
         }
 
         public override void ClipRoundRect(SKRoundRect rect, SKClipOperation operation = SKClipOperation.Intersect, bool antialias = false)
         {
-            mem.Write((byte)COMMANDS.CLIP_ROUND_RECT);
-            mem.WriteSKRoundRect(rect);
-            mem.Write((byte)operation);
-            mem.Write(antialias);
+            record(COMMANDS.CLIP_ROUND_RECT, new ClipRecord { handle = intern(rect), operation = (int)operation, antialias = antialias ? 1 : 0 });
             base.ClipRoundRect(rect, operation, antialias);
+            clipped(rect?.Rect ?? UNBOUNDED, operation);
         }
 
         public override void Concat(ref SKMatrix m)
         {
-            mem.Write((byte)COMMANDS.CONCAT);
-            mem.WriteSKMatrix(ref m);
+            record(COMMANDS.CONCAT, m);
             base.Concat(ref m);
         }
 
@@ -403,101 +398,97 @@ namespace AndroidUI.Graphics
 
         public override void ResetMatrix()
         {
-            mem.Write((byte)COMMANDS.RESET_MATRIX);
+            record(COMMANDS.RESET_MATRIX);
+            mAbsoluteMatrix = true;
             base.ResetMatrix();
         }
 
         public override void Restore()
         {
-            mem.Write((byte)COMMANDS.RESTORE);
+            record(COMMANDS.RESTORE);
             base.Restore();
+            restored();
         }
 
         public override void RestoreToCount(int count)
         {
-            mem.Write((byte)COMMANDS.RESTORE_TO_COUNT);
-            mem.Write(count);
+            record(COMMANDS.RESTORE_TO_COUNT, count);
             base.RestoreToCount(count);
+            restored();
         }
 
         public override void RotateDegrees(float degrees)
         {
-            mem.Write((byte)COMMANDS.ROTATE_DEGREES);
-            mem.Write(degrees);
+            record(COMMANDS.ROTATE_DEGREES, degrees);
             base.RotateDegrees(degrees);
         }
 
         public override void RotateRadians(float radians)
         {
-            mem.Write((byte)COMMANDS.ROTATE_RADIANS);
-            mem.Write(radians);
+            record(COMMANDS.ROTATE_RADIANS, radians);
             base.RotateRadians(radians);
         }
 
         public override int Save()
         {
-            mem.Write((byte)COMMANDS.SAVE);
-            return base.Save();
+            record(COMMANDS.SAVE);
+            int count = base.Save();
+            saved();
+            return count;
         }
 
         public override int SaveCount => base.SaveCount;
 
         public override int SaveLayer(SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.SAVE_LAYER);
-            mem.WriteSKPaint(paint);
-            return base.SaveLayer(paint);
+            record(COMMANDS.SAVE_LAYER, intern(paint));
+            int count = base.SaveLayer(paint);
+            savedLayer(count, paint);
+            return count;
         }
 
         public override int SaveLayer(SKRect limit, SKPaint paint)
         {
-            mem.Write((byte)COMMANDS.SAVE_LAYER_RECT);
-            mem.WriteSKRect(limit);
-            mem.WriteSKPaint(paint);
-            return base.SaveLayer(limit, paint);
+            record(COMMANDS.SAVE_LAYER_RECT, new RectRecord { rect = limit, paint = intern(paint) });
+            int count = base.SaveLayer(limit, paint);
+            savedLayer(count, paint);
+            return count;
         }
 
         public override void Scale(float s)
         {
-            mem.Write((byte)COMMANDS.SCALE);
-            mem.Write(s);
+            record(COMMANDS.SCALE, s);
             base.Scale(s);
         }
 
         public override void Scale(float sx, float sy)
         {
-            mem.Write((byte)COMMANDS.SCALE_XY);
-            mem.Write(sx);
-            mem.Write(sy);
+            record(COMMANDS.SCALE_XY, new SKPoint(sx, sy));
             base.Scale(sx, sy);
         }
 
         public override void Scale(SKPoint size)
         {
-            mem.Write((byte)COMMANDS.SCALE_POINT);
-            mem.WriteSKPoint(size);
+            record(COMMANDS.SCALE_POINT, size);
             base.Scale(size);
         }
 
         public override void SetMatrix(SKMatrix matrix)
         {
-            mem.Write((byte)COMMANDS.SET_MATRIX);
-            mem.WriteSKMatrix(ref matrix);
+            record(COMMANDS.SET_MATRIX, matrix);
+            mAbsoluteMatrix = true;
             base.SetMatrix(matrix);
         }
 
         public override void Skew(float sx, float sy)
         {
-            mem.Write((byte)COMMANDS.SKEW_XY);
-            mem.Write(sx);
-            mem.Write(sy);
+            record(COMMANDS.SKEW_XY, new SKPoint(sx, sy));
             base.Skew(sx, sy);
         }
 
         public override void Skew(SKPoint skew)
         {
-            mem.Write((byte)COMMANDS.SKEW_POINT);
-            mem.WriteSKPoint(skew);
+            record(COMMANDS.SKEW_POINT, skew);
             base.Skew(skew);
         }
 
@@ -505,39 +496,35 @@ namespace AndroidUI.Graphics
 
         public override void Translate(float dx, float dy)
         {
-            mem.Write((byte)COMMANDS.TRANSLATE_XY);
-            mem.Write(dx);
-            mem.Write(dy);
+            record(COMMANDS.TRANSLATE_XY, new SKPoint(dx, dy));
             base.Translate(dx, dy);
         }
 
         public override void Translate(SKPoint point)
         {
-            mem.Write((byte)COMMANDS.TRANSLATE_POINT);
-            mem.WriteSKPoint(point);
+            record(COMMANDS.TRANSLATE_POINT, point);
             base.Translate(point);
         }
 
-        public void ResetRecording()
+        public unsafe void ResetRecording()
         {
-            mem.Dispose();
-            mem = new(new MemoryStream(), false);
+            Native.Additional.SkKernel_commandArenaReset(mArena);
+            // buffers taken from the recording keep its objects alive
+            mObjects.release();
+            mObjects = new();
+            resetBounds();
         }
 
         /// <summary>
         /// creates a Command Buffer from the current recording
         /// </summary>
-        public CommandBuffer GetCommandBuffer()
+        public unsafe CommandBuffer GetCommandBuffer()
         {
-            MemoryStream src = (MemoryStream)mem.BaseStream;
-            MemoryStream dst = new();
-
-            var old = src.Position;
-            src.Position = 0;
-            src.CopyTo(dst);
-            src.Position = old;
-
-            return new CommandBuffer(new(dst, false));
+            List<SKRect> bounds = new(mBounds.Count);
+            List<int> draws = new(mDraws.Count);
+            optimize(bounds, draws);
+            mObjects.acquire();
+            return new CommandBuffer(Native.Additional.SkKernel_commandArenaCopy(mOptimized), bounds.ToArray(), draws.ToArray(), mObjects);
         }
     }
 }
\ No newline at end of file
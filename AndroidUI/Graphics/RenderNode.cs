@@ -0,0 +1,198 @@
+﻿using SkiaSharp;
+
+namespace AndroidUI.Graphics
+{
+    /**
+     * A display list drawn by reference, like Android's RenderNode.
+     *
+     * A RecordingCanvas2 records a node as a reference, so the node's display list and its
+     * position, matrix and alpha may be replaced after a recording drawing it was taken,
+     * and that recording draws the new ones. A View keeps one node for its whole life and
+     * records only its own list again when it is invalidated, the lists of its parents,
+     * which refer to its node, are kept.
+     *
+     * A node remembers where on the device it was last drawn, so a change to it can damage
+     * the area it covered and the area it will cover.
+     */
+    public sealed class RenderNode
+    {
+        private RecordingCanvas2.CommandBuffer mDisplayList;
+
+        // the area the display list covers, in the node's own space, unless it draws
+        // something without bounds, then it may cover anything its parent shows
+        private SKRect mBounds = SKRect.Empty;
+        private bool mUnbounded;
+
+        private float mX;
+        private float mY;
+        private SKMatrix mMatrix = SKMatrix.Identity;
+        private float mAlpha = 1;
+
+        // the device matrix the node was last drawn under, before its own properties, and
+        // the device area it covered then
+        private bool mDrawn;
+        private SKMatrix mParentMatrix;
+        private SKRect mDrawnBounds = SKRect.Empty;
+
+        public bool hasDisplayList()
+        {
+            return mDisplayList != null;
+        }
+
+        internal RecordingCanvas2.CommandBuffer getDisplayList()
+        {
+            return mDisplayList;
+        }
+
+        /**
+         * Replaces the display list, disposing the last one. The node covers width by
+         * height and anything the list draws beyond that.
+         */
+        public void setDisplayList(RecordingCanvas2.CommandBuffer displayList, int width, int height)
+        {
+            mDisplayList?.Dispose();
+            mDisplayList = displayList;
+            mBounds = new SKRect(0, 0, width, height);
+            mUnbounded = displayList != null && displayList.Unbounded;
+            if (displayList != null && !RecordingCanvas2.empty(displayList.ContentBounds))
+            {
+                mBounds = RecordingCanvas2.empty(mBounds) ? displayList.ContentBounds : SKRect.Union(mBounds, displayList.ContentBounds);
+            }
+        }
+
+        public void discardDisplayList()
+        {
+            setDisplayList(null, 0, 0);
+        }
+
+        /**
+         * Sets where the node is drawn, returns true if it moved
+         */
+        public bool setPosition(float x, float y)
+        {
+            if (mX == x && mY == y)
+            {
+                return false;
+            }
+            mX = x;
+            mY = y;
+            return true;
+        }
+
+        /**
+         * Sets the matrix applied before the position, returns true if it changed
+         */
+        public bool setMatrix(SKMatrix matrix)
+        {
+            if (mMatrix.Equals(matrix))
+            {
+                return false;
+            }
+            mMatrix = matrix;
+            return true;
+        }
+
+        /**
+         * Sets the alpha the node is drawn with, returns true if it changed
+         */
+        public bool setAlpha(float alpha)
+        {
+            if (mAlpha == alpha)
+            {
+                return false;
+            }
+            mAlpha = alpha;
+            return true;
+        }
+
+        public float getAlpha()
+        {
+            return mAlpha;
+        }
+
+        private SKMatrix local()
+        {
+            return SKMatrix.Concat(mMatrix, SKMatrix.CreateTranslation(mX, mY));
+        }
+
+        // the device area the display list covers under a parent matrix
+        private SKRect deviceBounds(SKMatrix parentMatrix)
+        {
+            if (mDisplayList == null)
+            {
+                return SKRect.Empty;
+            }
+            return mUnbounded ? RecordingCanvas2.UNBOUNDED : SKMatrix.Concat(parentMatrix, local()).MapRect(mBounds);
+        }
+
+        /**
+         * The device area to draw again for what changed since the node was last drawn,
+         * where it was then and where it is now, unbounded if it was never drawn as where
+         * it lands is not known yet, or if its display list draws without bounds
+         */
+        internal SKRect damage()
+        {
+            if (!mDrawn)
+            {
+                return mDisplayList == null ? SKRect.Empty : RecordingCanvas2.UNBOUNDED;
+            }
+            SKRect now = deviceBounds(mParentMatrix);
+            if (RecordingCanvas2.empty(mDrawnBounds))
+            {
+                return now;
+            }
+            return RecordingCanvas2.empty(now) ? mDrawnBounds : SKRect.Union(mDrawnBounds, now);
+        }
+
+        /**
+         * Draws the display list under the node's properties, a recording canvas records a
+         * reference to the node instead
+         */
+        public void draw(SKCanvas canvas)
+        {
+            if (canvas is RecordingCanvas2 recorder)
+            {
+                recorder.DrawRenderNode(this);
+                return;
+            }
+            mDrawn = true;
+            mParentMatrix = canvas.TotalMatrix;
+            mDrawnBounds = deviceBounds(mParentMatrix);
+            drawContent(canvas);
+        }
+
+        /**
+         * Draws the display list under the node's properties without remembering where,
+         * a recording that inlines nodes draws them through this
+         */
+        internal void drawContent(SKCanvas canvas)
+        {
+            if (mDisplayList == null)
+            {
+                return;
+            }
+            // restored one save at a time, an inlined block may be replayed at any depth
+            canvas.Save();
+            SKMatrix matrix = local();
+            canvas.Concat(ref matrix);
+            // what the node draws stays within the bounds it damages, the nodes it draws
+            // damage their own area and may lie outside it
+            if (!mUnbounded && !mDisplayList.DrawsRenderNodes)
+            {
+                canvas.ClipRect(mBounds);
+            }
+            bool layer = mAlpha < 1;
+            if (layer)
+            {
+                using SKPaint paint = new() { Color = SKColors.Black.WithAlpha((byte)Math.Round(mAlpha * 255)) };
+                canvas.SaveLayer(paint);
+            }
+            mDisplayList.Playback(canvas);
+            if (layer)
+            {
+                canvas.Restore();
+            }
+            canvas.Restore();
+        }
+    }
+}
@@ -0,0 +1,221 @@
+﻿using SkiaSharp;
+using System.Buffers;
+
+namespace AndroidUI.Graphics
+{
+    /**
+     * Decodes an image, or a rectangle of it, straight into a bitmap of another size.
+     * Scanlines are decoded a strip at a time and resampled as they arrive, only the
+     * destination and one strip of source rows are ever held, never the full size image.
+     *
+     * When the codec can scale while decoding (JPEG) the scanlines are decoded at the
+     * smallest size the codec supports that is not smaller than the destination.
+     */
+    internal sealed unsafe class ScanlineDecoder : IDisposable
+    {
+        // how many bytes of scanlines are decoded per strip
+        private const int STRIP_BYTES = 64 * 1024;
+
+        private readonly SKCodec mCodec;
+        private readonly SKImageInfo mScanlineInfo;
+        private readonly int mTop;
+        private readonly int mHeight;
+        private void* mResampler;
+
+        private ScanlineDecoder(SKCodec codec, SKImageInfo scanlineInfo, int top, int height, void* resampler)
+        {
+            mCodec = codec;
+            mScanlineInfo = scanlineInfo;
+            mTop = top;
+            mHeight = height;
+            mResampler = resampler;
+        }
+
+        ~ScanlineDecoder()
+        {
+            Dispose(false);
+        }
+
+        /**
+         * Returns true if pixels of the given info can be resampled, the resampler
+         * filters 4 channel 8 bit pixels and needs them premultiplied or opaque.
+         */
+        public static bool canResample(SKImageInfo info)
+        {
+            return (info.ColorType == SKColorType.Rgba8888 || info.ColorType == SKColorType.Bgra8888)
+                && info.AlphaType != SKAlphaType.Unpremul;
+        }
+
+        /**
+         * Starts decoding the subset of the codec's image, in the color type, alpha type
+         * and color space of info, to dstWidth x dstHeight pixels.
+         *
+         * @return null if the codec cannot decode scanlines top down, the caller should
+         *         decode the subset whole instead, see decodeSubset.
+         */
+        public static ScanlineDecoder start(SKCodec codec, SKImageInfo info, SKRectI subset, int dstWidth, int dstHeight)
+        {
+            if (!canResample(info) || subset.IsEmpty || dstWidth <= 0 || dstHeight <= 0)
+            {
+                return null;
+            }
+
+            SKSizeI full = codec.Info.Size;
+            SKSizeI scanlineSize = full;
+            SKRectI scanlineSubset = subset;
+            float desiredScale = Math.Max(dstWidth / (float)subset.Width, dstHeight / (float)subset.Height);
+            if (desiredScale < 1)
+            {
+                scanlineSize = codec.GetScaledDimensions(desiredScale);
+                if (scanlineSize != full)
+                {
+                    float sx = scanlineSize.Width / (float)full.Width;
+                    float sy = scanlineSize.Height / (float)full.Height;
+                    scanlineSubset = SKRectI.Intersect(
+                        new SKRectI(
+                            (int)MathF.Floor(subset.Left * sx), (int)MathF.Floor(subset.Top * sy),
+                            (int)MathF.Ceiling(subset.Right * sx), (int)MathF.Ceiling(subset.Bottom * sy)
+                        ),
+                        SKRectI.Create(scanlineSize)
+                    );
+                    if (scanlineSubset.IsEmpty)
+                    {
+                        return null;
+                    }
+                }
+            }
+
+            SKImageInfo scanlineInfo = info.WithSize(scanlineSize.Width, scanlineSize.Height);
+            if (codec.StartScanlineDecode(scanlineInfo) != SKCodecResult.Success
+                || codec.ScanlineOrder != SKCodecScanlineOrder.TopDown)
+            {
+                return null;
+            }
+
+            void* resampler = Native.Additional.SkKernel_resamplerCreate(
+                scanlineSubset.Left, scanlineSubset.Width, scanlineSubset.Height, dstWidth, dstHeight
+            );
+            if (resampler == null)
+            {
+                return null;
+            }
+            return new ScanlineDecoder(codec, scanlineInfo, scanlineSubset.Top, scanlineSubset.Height, resampler);
+        }
+
+        /**
+         * Decodes the subset of the codec's image into dst in one call and resamples it to
+         * the size of dst, for codecs that cannot decode scanlines top down, such as WebP.
+         * The subset is held at full size while it is resampled. It is widened to start on
+         * even coordinates, the only subsets WebP decodes.
+         *
+         * @return the codec's result, IncompleteInput still fills dst
+         */
+        public static SKCodecResult decodeSubset(SKCodec codec, SKImageInfo info, SKRectI subset, SKBitmap dst)
+        {
+            if (!canResample(info) || subset.IsEmpty || dst.Width <= 0 || dst.Height <= 0)
+            {
+                return SKCodecResult.InvalidParameters;
+            }
+
+            SKRectI decoded = new(subset.Left & ~1, subset.Top & ~1, subset.Right, subset.Bottom);
+            SKImageInfo decodedInfo = info.WithSize(decoded.Width, decoded.Height);
+            int rowBytes = decodedInfo.RowBytes;
+            byte[] pixels = ArrayPool<byte>.Shared.Rent(checked(decoded.Height * rowBytes));
+            void* resampler = null;
+            try
+            {
+                fixed (byte* p = pixels)
+                {
+                    SKCodecResult result = codec.GetPixels(decodedInfo, (IntPtr)p, rowBytes, new SKCodecOptions(decoded));
+                    if (result != SKCodecResult.Success && result != SKCodecResult.IncompleteInput)
+                    {
+                        return result;
+                    }
+                    resampler = Native.Additional.SkKernel_resamplerCreate(
+                        subset.Left - decoded.Left, subset.Width, subset.Height, dst.Width, dst.Height
+                    );
+                    if (resampler == null)
+                    {
+                        return SKCodecResult.InvalidParameters;
+                    }
+                    Native.Additional.SkKernel_resamplerPushRows(
+                        resampler, p + (long)(subset.Top - decoded.Top) * rowBytes, (nuint)rowBytes, subset.Height,
+                        (void*)dst.GetPixels(), (nuint)dst.RowBytes
+                    );
+                    return result;
+                }
+            }
+            finally
+            {
+                if (resampler != null)
+                {
+                    Native.Additional.SkKernel_resamplerDestroy(resampler);
+                }
+                ArrayPool<byte>.Shared.Return(pixels);
+            }
+        }
+
+        /**
+         * Decodes into dst, which must be dstWidth x dstHeight pixels of the color type
+         * given to start.
+         *
+         * @return IncompleteInput if the image data ends early, the missing rows are
+         *         filled by the codec.
+         */
+        public SKCodecResult decode(SKBitmap dst)
+        {
+            if (mResampler == null)
+            {
+                throw new ObjectDisposedException(nameof(ScanlineDecoder));
+            }
+
+            if (mTop > 0 && !mCodec.SkipScanlines(mTop))
+            {
+                return SKCodecResult.IncompleteInput;
+            }
+
+            SKCodecResult result = SKCodecResult.Success;
+            int rowBytes = mScanlineInfo.RowBytes;
+            int stripRows = Math.Clamp(STRIP_BYTES / rowBytes, 1, mHeight);
+            byte[] strip = ArrayPool<byte>.Shared.Rent(checked(stripRows * rowBytes));
+            try
+            {
+                fixed (byte* p = strip)
+                {
+                    void* pixels = (void*)dst.GetPixels();
+                    nuint dstRowBytes = (nuint)dst.RowBytes;
+                    for (int row = 0; row < mHeight; row += stripRows)
+                    {
+                        int count = Math.Min(stripRows, mHeight - row);
+                        // the codec fills the rows it could not decode, they are still resampled
+                        if (mCodec.GetScanlines((IntPtr)p, count, rowBytes) != count)
+                        {
+                            result = SKCodecResult.IncompleteInput;
+                        }
+                        Native.Additional.SkKernel_resamplerPushRows(mResampler, p, (nuint)rowBytes, count, pixels, dstRowBytes);
+                    }
+                }
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(strip);
+            }
+            return result;
+        }
+
+        private void Dispose(bool disposing)
+        {
+            if (mResampler != null)
+            {
+                Native.Additional.SkKernel_resamplerDestroy(mResampler);
+                mResampler = null;
+            }
+        }
+
+        public void Dispose()
+        {
+            Dispose(true);
+            GC.SuppressFinalize(this);
+        }
+    }
+}
@@ -0,0 +1,367 @@
+﻿using AndroidUI.Exceptions;
+using AndroidUI.Utils;
+
+namespace AndroidUI.OS
+{
+    /**
+     * A vsync source for hosts that do not have one.
+     *
+     * Frame times are phase locked to a refresh rate: each one is a whole number of frame
+     * periods after the clock started, on a native monotonic clock with nanosecond
+     * resolution. A frame drawn late still gets the deadline it belongs to, so animations
+     * advance by exactly one period per frame instead of by however long the host took.
+     *
+     * The host decides when to draw and calls {@link #beginFrame} to stamp the frame.
+     * When a frame listener is set the clock also paces drawing: requests made while a frame
+     * is already requested, or drawn but not yet begun, fold into that frame, and the
+     * listener is called on the clock's thread at the next deadline to have the host draw it.
+     *
+     * Frames begun more than one period after they were requested count as missed.
+     */
+    public sealed class FrameClock : IDisposable
+    {
+        private const string TAG = "FrameClock";
+
+        public const float DEFAULT_REFRESH_RATE = 60;
+
+        // Same as Choreographer's, the number of frames missed in one go before logging it.
+        private const int SKIPPED_FRAME_WARNING_LIMIT = 30;
+
+        // A delivered frame the host has not begun after this many periods is given up on.
+        private const int PENDING_FRAME_TIMEOUT_PERIODS = 4;
+
+        private readonly object LOCK = new();
+        private IntPtr mNative;
+        private bool mDisposed;
+
+        // The same moment on both clocks, to convert frame times to NanoTime.currentTimeMillis().
+        private readonly long mOriginNanos;
+        private readonly long mOriginMillis;
+
+        private long mFrameTimeNanos;
+        // When the first request since the last frame was made, 0 if there is none.
+        private long mRequestTimeNanos;
+        private long mMissedFrames;
+        private long mSkippedFrames;
+
+        // 0 waits for the host however long it takes, tests use it to not depend on timing
+        private int mPendingFrameTimeoutPeriods = PENDING_FRAME_TIMEOUT_PERIODS;
+
+        private Runnable mListener;
+        private Thread mThread;
+        private bool mFrameRequested;
+        private bool mFramePending;
+
+        public FrameClock() : this(DEFAULT_REFRESH_RATE)
+        {
+        }
+
+        public unsafe FrameClock(float refreshRate)
+        {
+            mNative = (IntPtr)Native.Additional.SkKernel_frameClockCreate(toPeriod(refreshRate));
+            if (mNative == IntPtr.Zero)
+            {
+                throw new IllegalStateException("Failed to create the native frame clock");
+            }
+            mOriginNanos = nowNanos();
+            mOriginMillis = NanoTime.currentTimeMillis();
+        }
+
+        ~FrameClock()
+        {
+            Dispose();
+        }
+
+        private static long toPeriod(float refreshRate)
+        {
+            if (!(refreshRate > 0))
+            {
+                throw new IllegalArgumentException("refresh rate must be positive, got " + refreshRate);
+            }
+            return (long)(1000000000.0 / refreshRate);
+        }
+
+        /**
+         * The monotonic time frame times are measured on, in nanoseconds.
+         */
+        public static long nowNanos()
+        {
+            return Native.Additional.SkKernel_frameClockNow();
+        }
+
+        /**
+         * Changes the refresh rate, frames stay phase locked to the last one.
+         */
+        public unsafe void setRefreshRate(float refreshRate)
+        {
+            long period = toPeriod(refreshRate);
+            lock (LOCK)
+            {
+                if (!mDisposed)
+                {
+                    Native.Additional.SkKernel_frameClockSetPeriod((void*)mNative, period);
+                }
+            }
+        }
+
+        public float getRefreshRate()
+        {
+            return (float)(1000000000.0 / getFramePeriodNanos());
+        }
+
+        public unsafe long getFramePeriodNanos()
+        {
+            lock (LOCK)
+            {
+                return mDisposed ? toPeriod(DEFAULT_REFRESH_RATE) : Native.Additional.SkKernel_frameClockGetPeriod((void*)mNative);
+            }
+        }
+
+        /**
+         * The time of the last frame begun, in nanoseconds of {@link #nowNanos}.
+         */
+        public long getFrameTimeNanos()
+        {
+            lock (LOCK)
+            {
+                return mFrameTimeNanos;
+            }
+        }
+
+        /**
+         * Converts a frame time to the {@link NanoTime#currentTimeMillis} time base used by
+         * messages and animations.
+         */
+        public long toMillis(long frameTimeNanos)
+        {
+            return mOriginMillis + (frameTimeNanos - mOriginNanos) / NanoTime.NANOS_PER_MS;
+        }
+
+        /**
+         * The number of deadlines that passed between frames being requested and begun.
+         */
+        public long getMissedFrameCount()
+        {
+            lock (LOCK)
+            {
+                return mMissedFrames;
+            }
+        }
+
+        /**
+         * The number of frame requests that were folded into a frame already on its way.
+         */
+        public long getSkippedFrameCount()
+        {
+            lock (LOCK)
+            {
+                return mSkippedFrames;
+            }
+        }
+
+        /**
+         * Stamps the frame about to be drawn with the latest deadline that has passed.
+         * Beginning more than one frame within a period stamps them all the same.
+         *
+         * @return the frame time in nanoseconds of {@link #nowNanos}
+         */
+        public unsafe long beginFrame()
+        {
+            lock (LOCK)
+            {
+                if (mDisposed)
+                {
+                    return mFrameTimeNanos;
+                }
+                long frameTimeNanos = Native.Additional.SkKernel_frameClockLatest((void*)mNative);
+                if (mRequestTimeNanos != 0)
+                {
+                    long missed = (frameTimeNanos - mRequestTimeNanos) / Native.Additional.SkKernel_frameClockGetPeriod((void*)mNative);
+                    if (missed > 0)
+                    {
+                        mMissedFrames += missed;
+                        if (missed >= SKIPPED_FRAME_WARNING_LIMIT)
+                        {
+                            Log.i(TAG, "Skipped " + missed + " frames!  "
+                                    + "The application may be doing too much work on its main thread.");
+                        }
+                    }
+                    mRequestTimeNanos = 0;
+                }
+                if (mFramePending)
+                {
+                    mFramePending = false;
+                    Monitor.PulseAll(LOCK);
+                }
+                mFrameTimeNanos = frameTimeNanos;
+                return frameTimeNanos;
+            }
+        }
+
+        /**
+         * Asks for a frame. When pacing, the frame listener is called at the next deadline,
+         * otherwise this only records when the frame was asked for.
+         */
+        public void requestFrame()
+        {
+            lock (LOCK)
+            {
+                if (mRequestTimeNanos == 0)
+                {
+                    mRequestTimeNanos = nowNanos();
+                }
+                if (mListener == null)
+                {
+                    return;
+                }
+                if (mFrameRequested || mFramePending)
+                {
+                    mSkippedFrames++;
+                }
+                if (!mFrameRequested)
+                {
+                    mFrameRequested = true;
+                    Monitor.PulseAll(LOCK);
+                }
+            }
+        }
+
+        internal void setPendingFrameTimeoutPeriods(int periods)
+        {
+            lock (LOCK)
+            {
+                mPendingFrameTimeoutPeriods = periods;
+                Monitor.PulseAll(LOCK);
+            }
+        }
+
+        /**
+         * Returns true if a frame listener is set and the clock decides when frames are drawn.
+         */
+        public bool isPacing()
+        {
+            lock (LOCK)
+            {
+                return mListener != null;
+            }
+        }
+
+        /**
+         * Sets the listener called on the clock's thread when a requested frame is due,
+         * it should have the host draw, which begins the frame. Null stops pacing.
+         */
+        public unsafe void setFrameListener(Runnable listener)
+        {
+            lock (LOCK)
+            {
+                if (mDisposed)
+                {
+                    return;
+                }
+                mListener = listener;
+                if (listener == null)
+                {
+                    mFrameRequested = false;
+                    mFramePending = false;
+                    Native.Additional.SkKernel_frameClockWake((void*)mNative);
+                    Monitor.PulseAll(LOCK);
+                }
+                else if (mThread == null)
+                {
+                    mThread = new Thread(run);
+                    mThread.IsBackground = true;
+                    mThread.Name = TAG;
+                    mThread.Start();
+                }
+            }
+        }
+
+        private unsafe void run()
+        {
+            for (;;)
+            {
+                Runnable listener;
+                lock (LOCK)
+                {
+                    while (!mDisposed && mListener != null && (!mFrameRequested || mFramePending))
+                    {
+                        if (mFramePending && mPendingFrameTimeoutPeriods > 0)
+                        {
+                            long timeout = Native.Additional.SkKernel_frameClockGetPeriod((void*)mNative)
+                                * mPendingFrameTimeoutPeriods / NanoTime.NANOS_PER_MS;
+                            if (!Monitor.Wait(LOCK, (int)timeout))
+                            {
+                                // The host dropped the frame, let the next request through.
+                                mFramePending = false;
+                            }
+                        }
+                        else
+                        {
+                            Monitor.Wait(LOCK);
+                        }
+                    }
+                    if (mDisposed || mListener == null)
+                    {
+                        mThread = null;
+                        if (mDisposed)
+                        {
+                            destroyNativeLocked();
+                        }
+                        return;
+                    }
+                }
+
+                // 0 when woken to stop pacing
+                if (Native.Additional.SkKernel_frameClockWait((void*)mNative) == 0)
+                {
+                    continue;
+                }
+
+                lock (LOCK)
+                {
+                    if (mDisposed || mListener == null || !mFrameRequested)
+                    {
+                        continue;
+                    }
+                    mFrameRequested = false;
+                    mFramePending = true;
+                    listener = mListener;
+                }
+                listener.Invoke();
+            }
+        }
+
+        private unsafe void destroyNativeLocked()
+        {
+            if (mNative != IntPtr.Zero)
+            {
+                Native.Additional.SkKernel_frameClockDestroy((void*)mNative);
+                mNative = IntPtr.Zero;
+            }
+        }
+
+        public unsafe void Dispose()
+        {
+            lock (LOCK)
+            {
+                if (mDisposed)
+                {
+                    return;
+                }
+                mDisposed = true;
+                mListener = null;
+                if (mThread == null)
+                {
+                    destroyNativeLocked();
+                }
+                else
+                {
+                    // the clock's thread destroys it once it is out of the native wait
+                    Native.Additional.SkKernel_frameClockWake((void*)mNative);
+                    Monitor.PulseAll(LOCK);
+                }
+            }
+            GC.SuppressFinalize(this);
+        }
+    }
+}
@@ -2,6 +2,7 @@
 using AndroidUI.Utils;
 using AndroidUI.Utils.Arrays;
 using SkiaSharp;
+using System.Runtime.InteropServices;
 using static AndroidUI.Native;
 using static AndroidUI.Utils.Skia.SKUtils;
 
@@ -269,6 +270,35 @@ namespace AndroidUI.Skia
             return to_point(new SKQuadCoeff(A, B, C).eval(t));
         }
 
+        /**
+         *  Tessellates this conic into a polyline within tol pixels of the curve.
+         *  Returns the points, including both end points. See SKTessellator.
+         */
+        public SKPoint[] tessellate(float tol)
+        {
+            return tessellate(tol, false, out _);
+        }
+
+        /**
+         *  Tessellates this conic into a polyline within tol pixels of the curve.
+         *  Returns the points, including both end points, and the tangent at each point.
+         */
+        public SKPoint[] tessellate(float tol, out SKPoint[] tangents)
+        {
+            return tessellate(tol, true, out tangents);
+        }
+
+        SKPoint[] tessellate(float tol, bool computeTangents, out SKPoint[] tangents)
+        {
+            Span<int> segments = stackalloc int[1];
+            ReadOnlySpan<float> w = MemoryMarshal.CreateReadOnlySpan(ref fW, 1);
+            int count = SKTessellator.countConics(fPts, w, tol, segments);
+            SKPoint[] pts = new SKPoint[count];
+            tangents = computeTangents ? new SKPoint[count] : null;
+            SKTessellator.tessellateConics(fPts, w, segments, pts, tangents);
+            return pts;
+        }
+
         void computeAsQuadError(ref SKPoint err)
         {
             float a = fW - 1;
@@ -384,10 +384,10 @@ namespace AndroidUI.Skia
         */
         public void mapDstScaleTranslate(ref SKMatrix matrix)
         {
-            Console.WriteLine("WARNING: mapDstScaleTranslate - matrix.IsScaleTranslate() is not yet ported, skipping check");
-            //if (!matrix.IsScaleTranslate()) {
-            //    throw new Exceptions.IllegalArgumentException("matrix must be scale translate");
-            //}
+            if (!matrix.IsScaleTranslate())
+            {
+                throw new Exceptions.IllegalArgumentException("matrix must be scale translate");
+            }
             float tx = matrix.TransX;
             float sx = matrix.ScaleX;
             for (int i = 0; i < fDstX.Length; i++)
@@ -0,0 +1,179 @@
+﻿using SkiaSharp;
+using static AndroidUI.Native;
+
+namespace AndroidUI.Skia
+{
+    /**
+     * Batched curve tessellation.
+     *
+     * Curves are independent, quads and conics take 3 points per curve and cubics take 4,
+     * conic weights are passed separately, one per conic.
+     *
+     * Tessellation is done in two passes, count* picks a segment count for every curve
+     * from the tolerance and returns the number of points tessellate* will emit, tessellate*
+     * then evaluates each curve at segments + 1 evenly spaced values of t, including both
+     * end points.
+     *
+     * Tangents are optional (pass an empty span), their length is arbitrary and only their
+     * direction should be used.
+     */
+    static class SKTessellator
+    {
+        /**
+         * the default maximum distance, in pixels, between a curve and its polyline
+         */
+        public const float DEFAULT_TOLERANCE = 0.25f;
+
+        /**
+         * the largest segment count a single curve will be split into
+         */
+        public const int MAX_SEGMENTS = 1024;
+
+        static void checkTolerance(float tolerance)
+        {
+            if (!(tolerance > 0) || float.IsInfinity(tolerance))
+            {
+                throw new Exception("tolerance must be a positive finite value");
+            }
+        }
+
+        static int checkCurves(int pointCount, int pointsPerCurve, int segmentsLength)
+        {
+            if (pointCount % pointsPerCurve != 0)
+            {
+                throw new Exception("point count (" + pointCount + ") must be a multiple of " + pointsPerCurve);
+            }
+            int count = pointCount / pointsPerCurve;
+            if (segmentsLength < count)
+            {
+                throw new Exception("segments must hold at least " + count + " values");
+            }
+            return count;
+        }
+
+        static void checkOutput(ReadOnlySpan<int> segments, int count, Span<SKPoint> outPoints, Span<SKPoint> outTangents)
+        {
+            long required = 0;
+            for (int i = 0; i < count; i++)
+            {
+                int n = segments[i];
+                if (n < 1 || n > MAX_SEGMENTS)
+                {
+                    throw new Exception("segment count must be between 1 and " + MAX_SEGMENTS + ", got " + n);
+                }
+                required += n + 1;
+            }
+            if (outPoints.Length < required)
+            {
+                throw new Exception("outPoints must hold at least " + required + " points");
+            }
+            if (!outTangents.IsEmpty && outTangents.Length < required)
+            {
+                throw new Exception("outTangents must be empty or hold at least " + required + " points");
+            }
+        }
+
+        /**
+         * computes the segment count of every quad and returns the total number of points
+         * tessellateQuads will emit
+         */
+        public static unsafe int countQuads(ReadOnlySpan<SKPoint> pts, float tolerance, Span<int> segments)
+        {
+            checkTolerance(tolerance);
+            int count = checkCurves(pts.Length, 3, segments.Length);
+            fixed (SKPoint* p = pts)
+            fixed (int* s = segments)
+            {
+                return Additional.SkKernel_quadSegmentCounts((float*)p, count, tolerance, s);
+            }
+        }
+
+        /**
+         * computes the segment count of every cubic and returns the total number of points
+         * tessellateCubics will emit
+         */
+        public static unsafe int countCubics(ReadOnlySpan<SKPoint> pts, float tolerance, Span<int> segments)
+        {
+            checkTolerance(tolerance);
+            int count = checkCurves(pts.Length, 4, segments.Length);
+            fixed (SKPoint* p = pts)
+            fixed (int* s = segments)
+            {
+                return Additional.SkKernel_cubicSegmentCounts((float*)p, count, tolerance, s);
+            }
+        }
+
+        /**
+         * computes the segment count of every conic and returns the total number of points
+         * tessellateConics will emit
+         */
+        public static unsafe int countConics(ReadOnlySpan<SKPoint> pts, ReadOnlySpan<float> weights, float tolerance, Span<int> segments)
+        {
+            checkTolerance(tolerance);
+            int count = checkCurves(pts.Length, 3, segments.Length);
+            if (weights.Length < count)
+            {
+                throw new Exception("weights must hold at least " + count + " values");
+            }
+            fixed (SKPoint* p = pts)
+            fixed (float* w = weights)
+            fixed (int* s = segments)
+            {
+                return Additional.SkKernel_conicSegmentCounts((float*)p, w, count, tolerance, s);
+            }
+        }
+
+        /**
+         * tessellates every quad into segments[i] + 1 points, returns the number of points written
+         */
+        public static unsafe int tessellateQuads(ReadOnlySpan<SKPoint> pts, ReadOnlySpan<int> segments, Span<SKPoint> outPoints, Span<SKPoint> outTangents)
+        {
+            int count = checkCurves(pts.Length, 3, segments.Length);
+            checkOutput(segments, count, outPoints, outTangents);
+            fixed (SKPoint* p = pts)
+            fixed (int* s = segments)
+            fixed (SKPoint* o = outPoints)
+            fixed (SKPoint* t = outTangents)
+            {
+                return Additional.SkKernel_tessellateQuads((float*)p, count, s, (float*)o, (float*)t);
+            }
+        }
+
+        /**
+         * tessellates every cubic into segments[i] + 1 points, returns the number of points written
+         */
+        public static unsafe int tessellateCubics(ReadOnlySpan<SKPoint> pts, ReadOnlySpan<int> segments, Span<SKPoint> outPoints, Span<SKPoint> outTangents)
+        {
+            int count = checkCurves(pts.Length, 4, segments.Length);
+            checkOutput(segments, count, outPoints, outTangents);
+            fixed (SKPoint* p = pts)
+            fixed (int* s = segments)
+            fixed (SKPoint* o = outPoints)
+            fixed (SKPoint* t = outTangents)
+            {
+                return Additional.SkKernel_tessellateCubics((float*)p, count, s, (float*)o, (float*)t);
+            }
+        }
+
+        /**
+         * tessellates every conic into segments[i] + 1 points, returns the number of points written
+         */
+        public static unsafe int tessellateConics(ReadOnlySpan<SKPoint> pts, ReadOnlySpan<float> weights, ReadOnlySpan<int> segments, Span<SKPoint> outPoints, Span<SKPoint> outTangents)
+        {
+            int count = checkCurves(pts.Length, 3, segments.Length);
+            if (weights.Length < count)
+            {
+                throw new Exception("weights must hold at least " + count + " values");
+            }
+            checkOutput(segments, count, outPoints, outTangents);
+            fixed (SKPoint* p = pts)
+            fixed (float* w = weights)
+            fixed (int* s = segments)
+            fixed (SKPoint* o = outPoints)
+            fixed (SKPoint* t = outTangents)
+            {
+                return Additional.SkKernel_tessellateConics((float*)p, w, count, s, (float*)o, (float*)t);
+            }
+        }
+    }
+}
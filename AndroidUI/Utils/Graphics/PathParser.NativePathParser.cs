@@ -14,6 +14,8 @@
 
 using AndroidUI.Utils;
 using AndroidUI.Utils.Graphics;
+using System.Buffers;
+using System.Text;
 
 namespace AndroidUI
 {
@@ -28,138 +30,6 @@ namespace AndroidUI
                 internal string failureMessage = "";
             };
 
-            static int nextStart(string s, int length, int startIndex) {
-                int index = startIndex;
-                while (index < length) {
-                    char c = s[index];
-                    // Note that 'e' or 'E' are not valid path commands, but could be
-                    // used for floating point numbers' scientific notation.
-                    // Therefore, when searching for next command, we should ignore 'e'
-                    // and 'E'.
-                    if ((((c - 'A') * (c - 'Z') <= 0) || ((c - 'a') * (c - 'z') <= 0)) && c != 'e' &&
-                        c != 'E') {
-                        return index;
-                    }
-                    index++;
-                }
-                return index;
-            }
-
-            /**
-             * Calculate the position of the next comma or space or negative sign
-             * @param s the string to search
-             * @param start the position to start searching
-             * @param result the result of the extraction, including the position of the
-             * the starting position of next number, whether it is ending with a '-'.
-             */
-            static void extract(ref int outEndPosition, out bool outEndWithNegOrDot, string s, int start,
-                                int end) {
-                // Now looking for ' ', ',', '.' or '-' from the start.
-                int currentIndex = start;
-                bool foundSeparator = false;
-                outEndWithNegOrDot = false;
-                bool secondDot = false;
-                bool isExponential = false;
-                for (; currentIndex < end; currentIndex++) {
-                    bool isPrevExponential = isExponential;
-                    isExponential = false;
-                    char currentChar = s[currentIndex];
-                    switch (currentChar) {
-                        case ' ':
-                        case ',':
-                            foundSeparator = true;
-                            break;
-                        case '-':
-                            // The negative sign following a 'e' or 'E' is not a separator.
-                            if (currentIndex != start && !isPrevExponential) {
-                                foundSeparator = true;
-                                outEndWithNegOrDot = true;
-                            }
-                            break;
-                        case '.':
-                            if (!secondDot) {
-                                secondDot = true;
-                            } else {
-                                // This is the second dot, and it is considered as a separator.
-                                foundSeparator = true;
-                                outEndWithNegOrDot = true;
-                            }
-                            break;
-                        case 'e':
-                        case 'E':
-                            isExponential = true;
-                            break;
-                    }
-                    if (foundSeparator) {
-                        break;
-                    }
-                }
-                // In the case where nothing is found, we put the end position to the end of
-                // our extract range. Otherwise, end position will be where separator is found.
-                outEndPosition = currentIndex;
-            }
-
-            static float parseFloat(ParseResult result, string startPtr,
-                                    int expectedLength) {
-                string endPtr = null;
-                float currentValue;
-                bool r = float.TryParse(startPtr, out currentValue);
-                if (float.IsInfinity(currentValue)) {
-                    result.failureOccurred = true;
-                    System.Text.StringBuilder b = new("Float out of range:  ");
-                    b.Append(startPtr, 0, expectedLength);
-                    result.failureMessage = b.ToString();
-                }
-                if (!r || endPtr == startPtr) {
-                    // No conversion is done.
-                    result.failureOccurred = true;
-                    System.Text.StringBuilder b = new("Float format error when parsing:  ");
-                    b.Append(startPtr, 0, expectedLength);
-                    result.failureMessage = b.ToString();
-                }
-                return currentValue;
-            }
-
-            /**
-             * Parse the floats in the string.
-             *
-             * @param s the string containing a command and list of floats
-             * @return true on success
-             */
-            static void getFloats(out List<float> outPoints, ParseResult result,
-                                  string pathStr, int start, int end) {
-                outPoints = new List<float>();
-                if (pathStr[start] == 'z' || pathStr[start] == 'Z') {
-                    return;
-                }
-                int startPosition = start + 1;
-                int endPosition = start;
-
-                // The startPosition should always be the first character of the
-                // current number, and endPosition is the character after the current
-                // number.
-                while (startPosition < end) {
-                    bool endWithNegOrDot;
-                    extract(ref endPosition, out endWithNegOrDot, pathStr, startPosition, end);
-
-                    if (startPosition < endPosition) {
-                        float currentValue = parseFloat(result, pathStr.Substring(startPosition), end - startPosition);
-                        if (result.failureOccurred) {
-                            return;
-                        }
-                        outPoints.Add(currentValue);
-                    }
-
-                    if (endWithNegOrDot) {
-                        // Keep the '-' or '.' sign with next number.
-                        startPosition = endPosition;
-                    } else {
-                        startPosition = endPosition + 1;
-                    }
-                }
-                return;
-            }
-
             internal static void validateVerbAndPoints(char verb, int points, ParseResult result)
             {
                 int numberOfPointsExpected = -1;
@@ -223,64 +93,139 @@ namespace AndroidUI
                                           points + " float(s) are found. ";
             }
 
+            const int PARSE_OK = 0;
+            const int PARSE_EMPTY = 1;
+            const int PARSE_BAD_VERB = 2;
+            const int PARSE_BAD_POINT_COUNT = 3;
+            const int PARSE_BAD_FLOAT = 4;
+            const int PARSE_FLOAT_OUT_OF_RANGE = 5;
+
             internal static void getPathDataFromAsciiString(out VectorDrawableUtils.Data data, ParseResult result,
                                                            string pathStr, int strLen)
             {
-                data = new();
                 if (pathStr == null)
                 {
+                    data = new();
                     result.failureOccurred = true;
                     result.failureMessage = "Path string cannot be NULL.";
                     return;
                 }
+                getPathDataFromUtf16(out data, result, pathStr.AsSpan(0, strLen));
+            }
 
-                int start = 0;
-                // Skip leading spaces.
-                while (char.IsWhiteSpace(pathStr[start]) && start < strLen)
+            /**
+             * Parses UTF-16 path data natively, verbs and floats are written straight into
+             * pooled scratch buffers and copied once into the resulting Data.
+             */
+            internal static unsafe void getPathDataFromUtf16(out VectorDrawableUtils.Data data, ParseResult result,
+                                                             ReadOnlySpan<char> pathStr)
+            {
+                int length = pathStr.Length;
+                // a path of N characters never holds more than N verbs or N floats
+                int capacity = Math.Max(length, 1);
+                char[] verbs = ArrayPool<char>.Shared.Rent(capacity);
+                int[] verbSizes = ArrayPool<int>.Shared.Rent(capacity);
+                float[] points = ArrayPool<float>.Shared.Rent(capacity);
+                try
                 {
-                    start++;
+                    int* info = stackalloc int[4];
+                    int status;
+                    fixed (char* s = pathStr)
+                    fixed (char* v = verbs)
+                    fixed (int* vs = verbSizes)
+                    fixed (float* p = points)
+                    {
+                        status = Native.Additional.SkKernel_parsePathDataUtf16(s, length, v, vs, capacity, p, capacity, info);
+                    }
+                    data = finishParse(status, info, verbs, verbSizes, points, result, pathStr);
                 }
-                if (start == strLen)
+                finally
                 {
-                    result.failureOccurred = true;
-                    result.failureMessage = "Path string cannot be empty.";
-                    return;
+                    ArrayPool<char>.Shared.Return(verbs);
+                    ArrayPool<int>.Shared.Return(verbSizes);
+                    ArrayPool<float>.Shared.Return(points);
                 }
-                int end = start + 1;
+            }
 
-                while (end < strLen)
+            /**
+             * Parses UTF-8 path data natively, as found in raw xml resources, without
+             * decoding it to a string first.
+             */
+            internal static unsafe void getPathDataFromUtf8(out VectorDrawableUtils.Data data, ParseResult result,
+                                                            ReadOnlySpan<byte> pathStr)
+            {
+                int length = pathStr.Length;
+                int capacity = Math.Max(length, 1);
+                char[] verbs = ArrayPool<char>.Shared.Rent(capacity);
+                int[] verbSizes = ArrayPool<int>.Shared.Rent(capacity);
+                float[] points = ArrayPool<float>.Shared.Rent(capacity);
+                try
                 {
-                    end = nextStart(pathStr, strLen, end);
-                    List<float> points;
-                    getFloats(out points, result, pathStr, start, end);
-                    validateVerbAndPoints(pathStr[start], points.Count, result);
-                    if (result.failureOccurred)
+                    int* info = stackalloc int[4];
+                    int status;
+                    fixed (byte* s = pathStr)
+                    fixed (char* v = verbs)
+                    fixed (int* vs = verbSizes)
+                    fixed (float* p = points)
                     {
-                        // If either verb or points is not valid, return immediately.
-                        result.failureMessage += "Failure occurred at position " + start +
-                                                  " of path: " + pathStr;
-                        return;
+                        status = Native.Additional.SkKernel_parsePathDataUtf8(s, length, v, vs, capacity, p, capacity, info);
+                    }
+                    // failures are rare, only decode the string to report them, the failure
+                    // position is a byte offset so it is converted to a char offset in the string
+                    if (status != PARSE_OK)
+                    {
+                        info[2] = Encoding.UTF8.GetCharCount(pathStr[..Math.Clamp(info[2], 0, length)]);
                     }
-                    data.verbs.Add(pathStr[start]);
-                    data.verbSizes.Add(points.Count);
-                    data.points.AddRange(points);
-                    start = end;
-                    end++;
+                    data = finishParse(status, info, verbs, verbSizes, points, result,
+                        status == PARSE_OK ? ReadOnlySpan<char>.Empty : Encoding.UTF8.GetString(pathStr));
                 }
+                finally
+                {
+                    ArrayPool<char>.Shared.Return(verbs);
+                    ArrayPool<int>.Shared.Return(verbSizes);
+                    ArrayPool<float>.Shared.Return(points);
+                }
+            }
 
-                if ((end - start) == 1 && start < strLen)
+            static unsafe VectorDrawableUtils.Data finishParse(int status, int* info, char[] verbs, int[] verbSizes,
+                                                               float[] points, ParseResult result, ReadOnlySpan<char> pathStr)
+            {
+                if (status == PARSE_OK)
                 {
-                    validateVerbAndPoints(pathStr[start], 0, result);
-                    if (result.failureOccurred)
-                    {
-                        // If either verb or points is not valid, return immediately.
-                        result.failureMessage += "Failure occurred at position " + start +
-                                                  " of path: " + pathStr;
-                        return;
-                    }
-                    data.verbs.Add(pathStr[start]);
-                    data.verbSizes.Add(0);
+                    return new(verbs.AsSpan(0, info[0]), verbSizes.AsSpan(0, info[0]), points.AsSpan(0, info[1]));
+                }
+
+                result.failureOccurred = true;
+                int position = info[2];
+                switch (status)
+                {
+                    case PARSE_EMPTY:
+                        result.failureMessage = "Path string cannot be empty.";
+                        return new();
+                    case PARSE_BAD_VERB:
+                    case PARSE_BAD_POINT_COUNT:
+                        result.failureOccurred = false;
+                        validateVerbAndPoints(pathStr[position], info[3], result);
+                        break;
+                    case PARSE_BAD_FLOAT:
+                    case PARSE_FLOAT_OUT_OF_RANGE:
+                        int end = position + 1;
+                        while (end < pathStr.Length && pathStr[end] != ' ' && pathStr[end] != ','
+                            && !char.IsLetter(pathStr[end]))
+                        {
+                            end++;
+                        }
+                        result.failureMessage = (status == PARSE_BAD_FLOAT
+                            ? "Float format error when parsing:  " : "Float out of range:  ")
+                            + pathStr[position..end].ToString() + " ";
+                        break;
+                    default:
+                        result.failureMessage = "Path data parser failed with status " + status + ". ";
+                        break;
                 }
+                result.failureMessage += "Failure occurred at position " + position +
+                                          " of path: " + pathStr.ToString();
+                return new();
             }
 
             internal static void dump(VectorDrawableUtils.Data data)
@@ -288,7 +233,7 @@ namespace AndroidUI
                 // Print out the path data.
                 int start = 0;
                 string os;
-                for (int i = 0; i < data.verbs.Count; i++)
+                for (int i = 0; i < data.verbs.Length; i++)
                 {
                     os = "";
                     os += data.verbs[i];
@@ -302,7 +247,7 @@ namespace AndroidUI
                 }
 
                 os = "";
-                for (int i = 0; i < data.points.Count; i++)
+                for (int i = 0; i < data.points.Length; i++)
                 {
                     os += data.points[i] + ", ";
                 }
@@ -322,7 +267,7 @@ namespace AndroidUI
                     return;
                 }
                 // Check if there is valid data coming out of parsing the string.
-                if (pathData.verbs.Count == 0)
+                if (pathData.verbs.Length == 0)
                 {
                     result.failureOccurred = true;
                     result.failureMessage = "No verbs found in the string for pathData: ";
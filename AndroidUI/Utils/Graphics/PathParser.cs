@@ -89,6 +89,20 @@ namespace AndroidUI
                 }
             }
 
+            /**
+             * Parses UTF-8 encoded path data, such as a pathData attribute read straight
+             * from a resource, without decoding it to a string first.
+             */
+            public PathData(ReadOnlySpan<byte> utf8PathString)
+            {
+                NativePathParser.ParseResult parseResult = new();
+                NativePathParser.getPathDataFromUtf8(out mNativePathData, parseResult, utf8PathString);
+                if (parseResult.failureOccurred)
+                {
+                    throw new IllegalArgumentException(parseResult.failureMessage);
+                }
+            }
+
             public VectorDrawableUtils.Data getNativePtr()
             {
                 return mNativePathData;
@@ -110,6 +110,28 @@ namespace AndroidUI.Utils.Graphics
             return mNativeRegion.SetRect(new SkiaSharp.SKRectI(left, top, right, bottom));
         }
 
+        /**
+         * Set the region to rects[0] op rects[1] op ... op rects[n - 1].
+         * The rects are combined in a single native sweep rather than one
+         * region operation per rect.
+         * Return true if the resulting region is non-empty.
+         */
+        public bool setRects(ReadOnlySpan<SkiaSharp.SKRectI> rects, Op op)
+        {
+            RunLengthRegion region = new();
+            region.setRects(rects, op);
+            region.toRegion(this);
+            return !region.isEmpty();
+        }
+
+        /** Set the region to the specified run length region.
+*/
+        public bool set(RunLengthRegion region)
+        {
+            region.toRegion(this);
+            return !region.isEmpty();
+        }
+
         /**
          * Set the region to the area described by the path and clip.
          * Return true if the resulting region is non-empty. This produces a region
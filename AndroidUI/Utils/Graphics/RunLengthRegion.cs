@@ -0,0 +1,296 @@
+﻿using AndroidUI.Exceptions;
+using SkiaSharp;
+using static AndroidUI.Native;
+
+namespace AndroidUI.Utils.Graphics
+{
+    /**
+     * A region stored as run length scanline bands in a flat int array, every operation
+     * runs natively over the whole region in one call.
+     *
+     * The array holds bands sorted top to bottom, each band is
+     * <code>top, bottom, intervalCount, left0, right0, left1, right1, ...</code>
+     * and a region has exactly one such form, so the array doubles as a compact
+     * serialized form (see getRuns() and setRuns()).
+     *
+     * Building a region from N rects is a single sweep instead of N region merges,
+     * which makes it suited to accumulating the dirty rects of a frame.
+     */
+    public class RunLengthRegion
+    {
+        private int[] mRuns = Array.Empty<int>();
+        private int mLength;
+
+        // the previous buffer, reused as the destination of the next operation
+        private int[] mScratch = Array.Empty<int>();
+
+        public RunLengthRegion()
+        {
+        }
+
+        public RunLengthRegion(RunLengthRegion region)
+        {
+            set(region);
+        }
+
+        public RunLengthRegion(int left, int top, int right, int bottom)
+        {
+            set(left, top, right, bottom);
+        }
+
+        public bool isEmpty()
+        {
+            return mLength == 0;
+        }
+
+        public void setEmpty()
+        {
+            mLength = 0;
+        }
+
+        public void set(RunLengthRegion region)
+        {
+            setRuns(region.getRuns());
+        }
+
+        public bool set(int left, int top, int right, int bottom)
+        {
+            Span<SKRectI> rect = stackalloc SKRectI[1];
+            rect[0] = new SKRectI(left, top, right, bottom);
+            return setRects(rect, Region.Op.UNION);
+        }
+
+        /**
+         * Set the region to rects[0] op rects[1] op ... op rects[n - 1], evaluated left
+         * to right, an empty rect acts as an empty region. Return true if the result
+         * is not empty.
+         */
+        public unsafe bool setRects(ReadOnlySpan<SKRectI> rects, Region.Op op)
+        {
+            fixed (SKRectI* r = rects)
+            {
+                int length;
+                fixed (int* s = mScratch)
+                {
+                    length = Additional.SkKernel_regionFromRects((int*)r, rects.Length, op.nativeInt, s, mScratch.Length);
+                }
+                if (length > mScratch.Length)
+                {
+                    mScratch = new int[grow(length)];
+                    fixed (int* s = mScratch)
+                    {
+                        Additional.SkKernel_regionFromRects((int*)r, rects.Length, op.nativeInt, s, mScratch.Length);
+                    }
+                }
+                swap(length);
+            }
+            return mLength != 0;
+        }
+
+        /**
+         * Perform the specified Op on this region and the specified region. Return
+         * true if the result of the op is not empty.
+         */
+        public bool op(RunLengthRegion region, Region.Op op)
+        {
+            return this.op(this, region, op);
+        }
+
+        /**
+         * Set this region to the result of performing the Op on the specified
+         * regions. Return true if the result is not empty.
+         */
+        public unsafe bool op(RunLengthRegion region1, RunLengthRegion region2, Region.Op op)
+        {
+            int length;
+            fixed (int* a = region1.mRuns)
+            fixed (int* b = region2.mRuns)
+            {
+                fixed (int* s = mScratch)
+                {
+                    length = Additional.SkKernel_regionOp(a, region1.mLength, b, region2.mLength, op.nativeInt, s, mScratch.Length);
+                }
+                if (length > mScratch.Length)
+                {
+                    mScratch = new int[grow(length)];
+                    fixed (int* s = mScratch)
+                    {
+                        Additional.SkKernel_regionOp(a, region1.mLength, b, region2.mLength, op.nativeInt, s, mScratch.Length);
+                    }
+                }
+            }
+            swap(length);
+            return mLength != 0;
+        }
+
+        private static int grow(int length)
+        {
+            return Math.Max(length, 16) * 3 / 2;
+        }
+
+        private void swap(int length)
+        {
+            (mRuns, mScratch) = (mScratch, mRuns);
+            mLength = length;
+        }
+
+        /**
+         * Return true if the region contains the specified point
+         */
+        public unsafe bool contains(int x, int y)
+        {
+            fixed (int* runs = mRuns)
+            {
+                return Additional.SkKernel_regionContains(runs, mLength, x, y);
+            }
+        }
+
+        /**
+         * Return true if every pixel of the rectangle is inside the region. Unlike
+         * Region.quickContains this is exact for complex regions too.
+         */
+        public unsafe bool contains(int left, int top, int right, int bottom)
+        {
+            fixed (int* runs = mRuns)
+            {
+                return Additional.SkKernel_regionContainsRect(runs, mLength, left, top, right, bottom);
+            }
+        }
+
+        public bool contains(Rect r)
+        {
+            return contains(r.left, r.top, r.right, r.bottom);
+        }
+
+        /**
+         * Return true if the region is empty, or if the specified rectangle does
+         * not intersect the region. The answer is exact.
+         */
+        public unsafe bool quickReject(int left, int top, int right, int bottom)
+        {
+            fixed (int* runs = mRuns)
+            {
+                return !Additional.SkKernel_regionIntersectsRect(runs, mLength, left, top, right, bottom);
+            }
+        }
+
+        public bool quickReject(Rect r)
+        {
+            return quickReject(r.left, r.top, r.right, r.bottom);
+        }
+
+        /**
+         * Return the number of rects getRects() produces
+         */
+        public unsafe int getRectCount()
+        {
+            fixed (int* runs = mRuns)
+            {
+                return Additional.SkKernel_regionGetRects(runs, mLength, null, 0);
+            }
+        }
+
+        /**
+         * Write the disjoint rects that make up this region, top to bottom and left
+         * to right, into rects. Return the number of rects in the region, nothing is
+         * written if rects is too small to hold them.
+         */
+        public unsafe int getRects(Span<SKRectI> rects)
+        {
+            fixed (int* runs = mRuns)
+            fixed (SKRectI* r = rects)
+            {
+                return Additional.SkKernel_regionGetRects(runs, mLength, (int*)r, rects.Length);
+            }
+        }
+
+        /**
+         * Set the Rect to the bounds of the region. If the region is empty, the
+         * Rect will be set to [0, 0, 0, 0]
+         */
+        public unsafe bool getBounds(Rect r)
+        {
+            if (r == null)
+            {
+                throw new NullReferenceException();
+            }
+            int* bounds = stackalloc int[4];
+            fixed (int* runs = mRuns)
+            {
+                Additional.SkKernel_regionGetBounds(runs, mLength, bounds);
+            }
+            r.set(bounds[0], bounds[1], bounds[2], bounds[3]);
+            return mLength != 0;
+        }
+
+        /**
+         * The serialized form of this region, valid until the region is next modified
+         */
+        public ReadOnlySpan<int> getRuns()
+        {
+            return new ReadOnlySpan<int>(mRuns, 0, mLength);
+        }
+
+        /**
+         * Set the region from a serialized form previously returned by getRuns()
+         */
+        public void setRuns(ReadOnlySpan<int> runs)
+        {
+            int i = 0;
+            while (i < runs.Length)
+            {
+                if (i + 3 > runs.Length || runs[i + 2] <= 0)
+                {
+                    throw new IllegalArgumentException("malformed region runs at index " + i);
+                }
+                i += 3 + runs[i + 2] * 2;
+            }
+            if (i != runs.Length)
+            {
+                throw new IllegalArgumentException("malformed region runs, last band is truncated");
+            }
+            if (mRuns.Length < runs.Length)
+            {
+                mRuns = new int[runs.Length];
+            }
+            runs.CopyTo(mRuns);
+            mLength = runs.Length;
+        }
+
+        /**
+         * Copy this region into a Region
+         */
+        public void toRegion(Region region)
+        {
+            int count = getRectCount();
+            if (count == 0)
+            {
+                region.setEmpty();
+                return;
+            }
+            SKRectI[] rects = new SKRectI[count];
+            getRects(rects);
+            region.mNativeRegion.SetRects(rects);
+        }
+
+        public override bool Equals(object obj)
+        {
+            return obj is RunLengthRegion region && getRuns().SequenceEqual(region.getRuns());
+        }
+
+        public override int GetHashCode()
+        {
+            HashCode hash = new();
+            foreach (int run in getRuns())
+            {
+                hash.Add(run);
+            }
+            return hash.ToHashCode();
+        }
+
+        public override string ToString()
+        {
+            return "RunLengthRegion(" + string.Join(", ", getRuns().ToArray()) + ")";
+        }
+    }
+}
@@ -18,17 +18,21 @@ namespace AndroidUI.Utils.Graphics
 {
     public class VectorDrawableUtils
     {
+        /**
+         * Parsed path data, stored as three compact arrays: the verbs in order, the number
+         * of floats that follow each verb, and every float in order.
+         */
         public class Data
         {
-            internal List<char> verbs;
-            internal List<int> verbSizes;
-            internal List<float> points;
+            internal char[] verbs;
+            internal int[] verbSizes;
+            internal float[] points;
 
             public Data()
             {
-                verbs = new();
-                verbSizes = new();
-                points = new();
+                verbs = Array.Empty<char>();
+                verbSizes = Array.Empty<int>();
+                points = Array.Empty<float>();
             }
 
             public Data(Data data)
@@ -36,19 +40,26 @@ namespace AndroidUI.Utils.Graphics
                 SetFrom(data);
             }
 
+            internal Data(ReadOnlySpan<char> verbs, ReadOnlySpan<int> verbSizes, ReadOnlySpan<float> points)
+            {
+                this.verbs = verbs.ToArray();
+                this.verbSizes = verbSizes.ToArray();
+                this.points = points.ToArray();
+            }
+
             public void SetFrom(Data data)
             {
-                verbs = new(data.verbs);
-                verbSizes = new(data.verbSizes);
-                points = new(data.points);
+                verbs = (char[])data.verbs.Clone();
+                verbSizes = (int[])data.verbSizes.Clone();
+                points = (float[])data.points.Clone();
             }
 
             public override bool Equals(object obj)
             {
                 return obj is Data data &&
-                       EqualityComparer<List<char>>.Default.Equals(verbs, data.verbs) &&
-                       EqualityComparer<List<int>>.Default.Equals(verbSizes, data.verbSizes) &&
-                       EqualityComparer<List<float>>.Default.Equals(points, data.points);
+                       EqualityComparer<char[]>.Default.Equals(verbs, data.verbs) &&
+                       EqualityComparer<int[]>.Default.Equals(verbSizes, data.verbSizes) &&
+                       EqualityComparer<float[]>.Default.Equals(points, data.points);
             }
 
             public override int GetHashCode()
@@ -65,7 +76,7 @@ namespace AndroidUI.Utils.Graphics
             public float ctrlPointY = 0;
             public float currentSegmentStartX = 0;
             public float currentSegmentStartY = 0;
-            public void addCommand(SkiaSharp.SKPath outPath, char previousCmd, char cmd, List<float> points,
+            public void addCommand(SkiaSharp.SKPath outPath, char previousCmd, char cmd, float[] points,
                             int start, int end)
             {
                 int incr = 2;
@@ -121,82 +132,82 @@ namespace AndroidUI.Utils.Graphics
                     switch (cmd)
                     {
                         case 'm':  // moveto - Start a new sub-path (relative)
-                            currentX += points.ElementAt(k + 0);
-                            currentY += points.ElementAt(k + 1);
+                            currentX += points[k + 0];
+                            currentY += points[k + 1];
                             if (k > start)
                             {
                                 // According to the spec, if a moveto is followed by multiple
                                 // pairs of coordinates, the subsequent pairs are treated as
                                 // implicit lineto commands.
-                                outPath.RLineTo(points.ElementAt(k + 0), points.ElementAt(k + 1));
+                                outPath.RLineTo(points[k + 0], points[k + 1]);
                             }
                             else
                             {
-                                outPath.RMoveTo(points.ElementAt(k + 0), points.ElementAt(k + 1));
+                                outPath.RMoveTo(points[k + 0], points[k + 1]);
                                 currentSegmentStartX = currentX;
                                 currentSegmentStartY = currentY;
                             }
                             break;
                         case 'M':  // moveto - Start a new sub-path
-                            currentX = points.ElementAt(k + 0);
-                            currentY = points.ElementAt(k + 1);
+                            currentX = points[k + 0];
+                            currentY = points[k + 1];
                             if (k > start)
                             {
                                 // According to the spec, if a moveto is followed by multiple
                                 // pairs of coordinates, the subsequent pairs are treated as
                                 // implicit lineto commands.
-                                outPath.LineTo(points.ElementAt(k + 0), points.ElementAt(k + 1));
+                                outPath.LineTo(points[k + 0], points[k + 1]);
                             }
                             else
                             {
-                                outPath.MoveTo(points.ElementAt(k + 0), points.ElementAt(k + 1));
+                                outPath.MoveTo(points[k + 0], points[k + 1]);
                                 currentSegmentStartX = currentX;
                                 currentSegmentStartY = currentY;
                             }
                             break;
                         case 'l':  // lineto - Draw a line from the current point (relative)
-                            outPath.RLineTo(points.ElementAt(k + 0), points.ElementAt(k + 1));
-                            currentX += points.ElementAt(k + 0);
-                            currentY += points.ElementAt(k + 1);
+                            outPath.RLineTo(points[k + 0], points[k + 1]);
+                            currentX += points[k + 0];
+                            currentY += points[k + 1];
                             break;
                         case 'L':  // lineto - Draw a line from the current point
-                            outPath.LineTo(points.ElementAt(k + 0), points.ElementAt(k + 1));
-                            currentX = points.ElementAt(k + 0);
-                            currentY = points.ElementAt(k + 1);
+                            outPath.LineTo(points[k + 0], points[k + 1]);
+                            currentX = points[k + 0];
+                            currentY = points[k + 1];
                             break;
                         case 'h':  // horizontal lineto - Draws a horizontal line (relative)
-                            outPath.RLineTo(points.ElementAt(k + 0), 0);
-                            currentX += points.ElementAt(k + 0);
+                            outPath.RLineTo(points[k + 0], 0);
+                            currentX += points[k + 0];
                             break;
                         case 'H':  // horizontal lineto - Draws a horizontal line
-                            outPath.LineTo(points.ElementAt(k + 0), currentY);
-                            currentX = points.ElementAt(k + 0);
+                            outPath.LineTo(points[k + 0], currentY);
+                            currentX = points[k + 0];
                             break;
                         case 'v':  // vertical lineto - Draws a vertical line from the current point (r)
-                            outPath.RLineTo(0, points.ElementAt(k + 0));
-                            currentY += points.ElementAt(k + 0);
+                            outPath.RLineTo(0, points[k + 0]);
+                            currentY += points[k + 0];
                             break;
                         case 'V':  // vertical lineto - Draws a vertical line from the current point
-                            outPath.LineTo(currentX, points.ElementAt(k + 0));
-                            currentY = points.ElementAt(k + 0);
+                            outPath.LineTo(currentX, points[k + 0]);
+                            currentY = points[k + 0];
                             break;
                         case 'c':  // curveto - Draws a cubic Bézier curve (relative)
-                            outPath.RCubicTo(points.ElementAt(k + 0), points.ElementAt(k + 1), points.ElementAt(k + 2),
-                                              points.ElementAt(k + 3), points.ElementAt(k + 4), points.ElementAt(k + 5));
+                            outPath.RCubicTo(points[k + 0], points[k + 1], points[k + 2],
+                                              points[k + 3], points[k + 4], points[k + 5]);
 
-                            ctrlPointX = currentX + points.ElementAt(k + 2);
-                            ctrlPointY = currentY + points.ElementAt(k + 3);
-                            currentX += points.ElementAt(k + 4);
-                            currentY += points.ElementAt(k + 5);
+                            ctrlPointX = currentX + points[k + 2];
+                            ctrlPointY = currentY + points[k + 3];
+                            currentX += points[k + 4];
+                            currentY += points[k + 5];
 
                             break;
                         case 'C':  // curveto - Draws a cubic Bézier curve
-                            outPath.CubicTo(points.ElementAt(k + 0), points.ElementAt(k + 1), points.ElementAt(k + 2),
-                                             points.ElementAt(k + 3), points.ElementAt(k + 4), points.ElementAt(k + 5));
-                            currentX = points.ElementAt(k + 4);
-                            currentY = points.ElementAt(k + 5);
-                            ctrlPointX = points.ElementAt(k + 2);
-                            ctrlPointY = points.ElementAt(k + 3);
+                            outPath.CubicTo(points[k + 0], points[k + 1], points[k + 2],
+                                             points[k + 3], points[k + 4], points[k + 5]);
+                            currentX = points[k + 4];
+                            currentY = points[k + 5];
+                            ctrlPointX = points[k + 2];
+                            ctrlPointY = points[k + 3];
                             break;
                         case 's':  // smooth curveto - Draws a cubic Bézier curve (reflective cp)
                             reflectiveCtrlPointX = 0;
@@ -207,12 +218,12 @@ namespace AndroidUI.Utils.Graphics
                                 reflectiveCtrlPointX = currentX - ctrlPointX;
                                 reflectiveCtrlPointY = currentY - ctrlPointY;
                             }
-                            outPath.RCubicTo(reflectiveCtrlPointX, reflectiveCtrlPointY, points.ElementAt(k + 0),
-                                              points.ElementAt(k + 1), points.ElementAt(k + 2), points.ElementAt(k + 3));
-                            ctrlPointX = currentX + points.ElementAt(k + 0);
-                            ctrlPointY = currentY + points.ElementAt(k + 1);
-                            currentX += points.ElementAt(k + 2);
-                            currentY += points.ElementAt(k + 3);
+                            outPath.RCubicTo(reflectiveCtrlPointX, reflectiveCtrlPointY, points[k + 0],
+                                              points[k + 1], points[k + 2], points[k + 3]);
+                            ctrlPointX = currentX + points[k + 0];
+                            ctrlPointY = currentY + points[k + 1];
+                            currentX += points[k + 2];
+                            currentY += points[k + 3];
                             break;
                         case 'S':  // shorthand/smooth curveto Draws a cubic Bézier curve(reflective cp)
                             reflectiveCtrlPointX = currentX;
@@ -223,28 +234,28 @@ namespace AndroidUI.Utils.Graphics
                                 reflectiveCtrlPointX = 2 * currentX - ctrlPointX;
                                 reflectiveCtrlPointY = 2 * currentY - ctrlPointY;
                             }
-                            outPath.CubicTo(reflectiveCtrlPointX, reflectiveCtrlPointY, points.ElementAt(k + 0),
-                                             points.ElementAt(k + 1), points.ElementAt(k + 2), points.ElementAt(k + 3));
-                            ctrlPointX = points.ElementAt(k + 0);
-                            ctrlPointY = points.ElementAt(k + 1);
-                            currentX = points.ElementAt(k + 2);
-                            currentY = points.ElementAt(k + 3);
+                            outPath.CubicTo(reflectiveCtrlPointX, reflectiveCtrlPointY, points[k + 0],
+                                             points[k + 1], points[k + 2], points[k + 3]);
+                            ctrlPointX = points[k + 0];
+                            ctrlPointY = points[k + 1];
+                            currentX = points[k + 2];
+                            currentY = points[k + 3];
                             break;
                         case 'q':  // Draws a quadratic Bézier (relative)
-                            outPath.RQuadTo(points.ElementAt(k + 0), points.ElementAt(k + 1), points.ElementAt(k + 2),
-                                             points.ElementAt(k + 3));
-                            ctrlPointX = currentX + points.ElementAt(k + 0);
-                            ctrlPointY = currentY + points.ElementAt(k + 1);
-                            currentX += points.ElementAt(k + 2);
-                            currentY += points.ElementAt(k + 3);
+                            outPath.RQuadTo(points[k + 0], points[k + 1], points[k + 2],
+                                             points[k + 3]);
+                            ctrlPointX = currentX + points[k + 0];
+                            ctrlPointY = currentY + points[k + 1];
+                            currentX += points[k + 2];
+                            currentY += points[k + 3];
                             break;
                         case 'Q':  // Draws a quadratic Bézier
-                            outPath.QuadTo(points.ElementAt(k + 0), points.ElementAt(k + 1), points.ElementAt(k + 2),
-                                            points.ElementAt(k + 3));
-                            ctrlPointX = points.ElementAt(k + 0);
-                            ctrlPointY = points.ElementAt(k + 1);
-                            currentX = points.ElementAt(k + 2);
-                            currentY = points.ElementAt(k + 3);
+                            outPath.QuadTo(points[k + 0], points[k + 1], points[k + 2],
+                                            points[k + 3]);
+                            ctrlPointX = points[k + 0];
+                            ctrlPointY = points[k + 1];
+                            currentX = points[k + 2];
+                            currentY = points[k + 3];
                             break;
                         case 't':  // Draws a quadratic Bézier curve(reflective control point)(relative)
                             reflectiveCtrlPointX = 0;
@@ -255,12 +266,12 @@ namespace AndroidUI.Utils.Graphics
                                 reflectiveCtrlPointX = currentX - ctrlPointX;
                                 reflectiveCtrlPointY = currentY - ctrlPointY;
                             }
-                            outPath.RQuadTo(reflectiveCtrlPointX, reflectiveCtrlPointY, points.ElementAt(k + 0),
-                                             points.ElementAt(k + 1));
+                            outPath.RQuadTo(reflectiveCtrlPointX, reflectiveCtrlPointY, points[k + 0],
+                                             points[k + 1]);
                             ctrlPointX = currentX + reflectiveCtrlPointX;
                             ctrlPointY = currentY + reflectiveCtrlPointY;
-                            currentX += points.ElementAt(k + 0);
-                            currentY += points.ElementAt(k + 1);
+                            currentX += points[k + 0];
+                            currentY += points[k + 1];
                             break;
                         case 'T':  // Draws a quadratic Bézier curve (reflective control point)
                             reflectiveCtrlPointX = currentX;
@@ -271,31 +282,31 @@ namespace AndroidUI.Utils.Graphics
                                 reflectiveCtrlPointX = 2 * currentX - ctrlPointX;
                                 reflectiveCtrlPointY = 2 * currentY - ctrlPointY;
                             }
-                            outPath.QuadTo(reflectiveCtrlPointX, reflectiveCtrlPointY, points.ElementAt(k + 0),
-                                            points.ElementAt(k + 1));
+                            outPath.QuadTo(reflectiveCtrlPointX, reflectiveCtrlPointY, points[k + 0],
+                                            points[k + 1]);
                             ctrlPointX = reflectiveCtrlPointX;
                             ctrlPointY = reflectiveCtrlPointY;
-                            currentX = points.ElementAt(k + 0);
-                            currentY = points.ElementAt(k + 1);
+                            currentX = points[k + 0];
+                            currentY = points[k + 1];
                             break;
                         case 'a':  // Draws an elliptical arc
                                    // (rx ry x-axis-rotation large-arc-flag sweep-flag x y)
-                            outPath.ArcTo(points.ElementAt(k + 0), points.ElementAt(k + 1), points.ElementAt(k + 2),
-                                           (SkiaSharp.SKPathArcSize)(points.ElementAt(k + 3) != 0).toInt(),
-                                           (SkiaSharp.SKPathDirection)(points.ElementAt(k + 4) == 0).toInt(),
-                                           points.ElementAt(k + 5) + currentX, points.ElementAt(k + 6) + currentY);
-                            currentX += points.ElementAt(k + 5);
-                            currentY += points.ElementAt(k + 6);
+                            outPath.ArcTo(points[k + 0], points[k + 1], points[k + 2],
+                                           (SkiaSharp.SKPathArcSize)(points[k + 3] != 0).toInt(),
+                                           (SkiaSharp.SKPathDirection)(points[k + 4] == 0).toInt(),
+                                           points[k + 5] + currentX, points[k + 6] + currentY);
+                            currentX += points[k + 5];
+                            currentY += points[k + 6];
                             ctrlPointX = currentX;
                             ctrlPointY = currentY;
                             break;
                         case 'A':  // Draws an elliptical arc
-                            outPath.ArcTo(points.ElementAt(k + 0), points.ElementAt(k + 1), points.ElementAt(k + 2),
-                                           (SkiaSharp.SKPathArcSize)(points.ElementAt(k + 3) != 0).toInt(),
-                                           (SkiaSharp.SKPathDirection)(points.ElementAt(k + 4) == 0).toInt(),
-                                           points.ElementAt(k + 5), points.ElementAt(k + 6));
-                            currentX = points.ElementAt(k + 5);
-                            currentY = points.ElementAt(k + 6);
+                            outPath.ArcTo(points[k + 0], points[k + 1], points[k + 2],
+                                           (SkiaSharp.SKPathArcSize)(points[k + 3] != 0).toInt(),
+                                           (SkiaSharp.SKPathDirection)(points[k + 4] == 0).toInt(),
+                                           points[k + 5], points[k + 6]);
+                            currentX = points[k + 5];
+                            currentY = points[k + 6];
                             ctrlPointX = currentX;
                             ctrlPointY = currentY;
                             break;
@@ -318,7 +329,7 @@ namespace AndroidUI.Utils.Graphics
             char previousCommand = 'm';
             int start = 0;
             outPath.Reset();
-            for (int i = 0; i < data.verbs.Count; i++)
+            for (int i = 0; i < data.verbs.Length; i++)
             {
                 int verbSize = data.verbSizes[i];
                 resolver.addCommand(outPath, previousCommand, data.verbs[i], data.points, start,
@@ -330,20 +341,8 @@ namespace AndroidUI.Utils.Graphics
 
         public static bool canMorph(Data morphFrom, Data morphTo)
         {
-            if (morphFrom.verbs.Count != morphTo.verbs.Count)
-            {
-                return false;
-            }
-
-            for (int i = 0; i < morphFrom.verbs.Count; i++)
-            {
-                if (morphFrom.verbs[i] != morphTo.verbs[i] ||
-                    morphFrom.verbSizes[i] != morphTo.verbSizes[i])
-                {
-                    return false;
-                }
-            }
-            return true;
+            return morphFrom.verbs.AsSpan().SequenceEqual(morphTo.verbs)
+                && morphFrom.verbSizes.AsSpan().SequenceEqual(morphTo.verbSizes);
         }
 
         /**
@@ -351,20 +350,28 @@ namespace AndroidUI.Utils.Graphics
          * <code>nodeFrom</code> and <code>nodeTo</code> according to the
          * <code>fraction</code>.
          *
+         * The points of both paths are blended natively in one pass, outData reuses its
+         * points array when it already has the right size so a morph frame does not allocate.
+         *
          * @param nodeFrom The start value as a PathVerb.
          * @param nodeTo The end value as a PathVerb
          * @param fraction The fraction to interpolate.
          */
-        public static void interpolatePaths(Data outData, Data from,
+        public static unsafe void interpolatePaths(Data outData, Data from,
                                                    Data to, float fraction)
         {
-            outData.points.EnsureCapacity(from.points.Count);
+            if (outData.points.Length != from.points.Length)
+            {
+                outData.points = new float[from.points.Length];
+            }
             outData.verbSizes = from.verbSizes;
             outData.verbs = from.verbs;
 
-            for (int i = 0; i < from.points.Count; i++)
+            fixed (float* f = from.points)
+            fixed (float* t = to.points)
+            fixed (float* o = outData.points)
             {
-                outData.points[i] = from.points[i] * (1 - fraction) + to.points[i] * fraction;
+                Native.Additional.SkKernel_interpolatePathPoints(f, t, o, from.points.Length, fraction);
             }
         }
 
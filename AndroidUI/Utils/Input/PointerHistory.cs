@@ -0,0 +1,224 @@
+﻿using AndroidUI.Utils.Lists;
+
+namespace AndroidUI.Utils.Input
+{
+    /**
+     * The movement history of the pointers of a velocity tracker strategy, kept by the native
+     * velocity kernel.
+     *
+     * Each pointer id of the most recent movement holds one of MAX_POINTERS slots and the
+     * kernel keeps a ring of the samples of each slot. The first estimator asked for after a
+     * movement estimates every pointer of that movement in one native call, solving the
+     * pointers together several at a time, and the estimators of the other pointers are
+     * answered from its results, so a fling of several fingers is fitted once per movement
+     * however many of its pointers are asked for.
+     */
+    internal sealed unsafe class PointerHistory
+    {
+        // SkKernel_VelocityStrategy
+        internal const int STRATEGY_IMPULSE = 0;
+        internal const int STRATEGY_LEAST_SQUARES = 1;
+
+        // SK_KERNEL_VELOCITY_MAX_DEGREE
+        internal const int MAX_DEGREE = 3;
+
+        private const int MAX_POINTERS = VelocityTrackerStrategy.MAX_POINTERS;
+        private const int ALL_SLOTS = (1 << MAX_POINTERS) - 1;
+
+        private void* mNative;
+        private readonly int mStrategy;
+        private readonly int mDegree;
+        private readonly int mWeighting;
+
+        // the pointer id held by each slot of mBits, the slots of the most recent movement
+        private readonly object[] mIds = new object[MAX_POINTERS];
+        private int mBits;
+        private readonly float[] mPositions = new float[MAX_POINTERS * 2];
+
+        // the estimates of the most recent movement, valid while mEstimated is set
+        private bool mEstimated;
+        private int mEstimatedBits;
+        private long mTime;
+        private readonly int[] mDegrees = new int[MAX_POINTERS];
+        private readonly float[] mConfidence = new float[MAX_POINTERS];
+        private readonly float[] mXCoeff = new float[MAX_POINTERS * (MAX_DEGREE + 1)];
+        private readonly float[] mYCoeff = new float[MAX_POINTERS * (MAX_DEGREE + 1)];
+
+        /**
+         * Creates an empty history estimated with strategy, degree and weighting, a
+         * LeastSquaresVelocityTrackerStrategy.Weighting, apply to STRATEGY_LEAST_SQUARES only.
+         */
+        internal PointerHistory(int strategy, int degree = 0, int weighting = 0)
+        {
+            if (strategy == STRATEGY_LEAST_SQUARES && (degree < 1 || degree > MAX_DEGREE))
+            {
+                throw new Exceptions.IllegalArgumentException("degree must be between 1 and " + MAX_DEGREE + ", got " + degree);
+            }
+            mStrategy = strategy;
+            mDegree = degree;
+            mWeighting = weighting;
+            mNative = Native.Additional.SkKernel_velocityCreate();
+        }
+
+        ~PointerHistory()
+        {
+            Native.Additional.SkKernel_velocityDestroy(mNative);
+            mNative = null;
+        }
+
+        private int slotOf(object id)
+        {
+            for (int slot = 0; slot < MAX_POINTERS; slot++)
+            {
+                if ((mBits & (1 << slot)) != 0 && Equals(mIds[slot], id))
+                {
+                    return slot;
+                }
+            }
+            return -1;
+        }
+
+        private void forget(int slots)
+        {
+            Native.Additional.SkKernel_velocityClear(mNative, slots);
+            GC.KeepAlive(this);
+            for (int slot = 0; slot < MAX_POINTERS; slot++)
+            {
+                if ((slots & (1 << slot)) != 0)
+                {
+                    mIds[slot] = null;
+                }
+            }
+            mBits &= ~slots;
+            mEstimated = false;
+        }
+
+        internal void clear()
+        {
+            forget(ALL_SLOTS);
+        }
+
+        internal void clearPointers(BitwiseList<object> idBits)
+        {
+            int slots = 0;
+            foreach (object id in idBits)
+            {
+                int slot = slotOf(id);
+                if (slot != -1)
+                {
+                    slots |= 1 << slot;
+                }
+            }
+            if (slots != 0)
+            {
+                forget(slots);
+            }
+        }
+
+        internal void addMovement(long eventTime, BitwiseList<object> idBits, Dictionary<object, NativeVelocityTracker.Position> positions)
+        {
+            int pointers = idBits.Count;
+            if (pointers > MAX_POINTERS)
+            {
+                throw new Exceptions.IllegalArgumentException("a movement can hold at most " + MAX_POINTERS + " pointers, got " + pointers);
+            }
+
+            // pointers still down keep their slots
+            int* held = stackalloc int[MAX_POINTERS];
+            int bits = 0;
+            for (int i = 0; i < pointers; i++)
+            {
+                held[i] = slotOf(idBits[i]);
+                if (held[i] != -1)
+                {
+                    bits |= 1 << held[i];
+                }
+            }
+
+            // new pointers take the lowest slot left, which starts from an empty ring
+            int fresh = 0;
+            for (int i = 0; i < pointers; i++)
+            {
+                if (held[i] != -1)
+                {
+                    continue;
+                }
+                int slot = 0;
+                while (((bits | fresh) & (1 << slot)) != 0)
+                {
+                    slot++;
+                }
+                fresh |= 1 << slot;
+                mIds[slot] = idBits[i];
+            }
+            if (fresh != 0)
+            {
+                Native.Additional.SkKernel_velocityClear(mNative, fresh);
+            }
+            bits |= fresh;
+
+            int count = 0;
+            for (int slot = 0; slot < MAX_POINTERS; slot++)
+            {
+                if ((bits & (1 << slot)) == 0)
+                {
+                    mIds[slot] = null;
+                    continue;
+                }
+                NativeVelocityTracker.Position position = positions[mIds[slot]];
+                mPositions[count++] = position.x;
+                mPositions[count++] = position.y;
+            }
+
+            fixed (float* p = mPositions)
+            {
+                Native.Additional.SkKernel_velocityAddMovement(mNative, eventTime, bits, p);
+            }
+            GC.KeepAlive(this);
+            mBits = bits;
+            mEstimated = false;
+        }
+
+        internal bool getEstimator(object id, NativeVelocityTracker.Estimator outEstimator)
+        {
+            outEstimator.clear();
+
+            int slot = slotOf(id);
+            if (slot == -1)
+            {
+                return false; // no data
+            }
+
+            if (!mEstimated)
+            {
+                long time;
+                fixed (int* degrees = mDegrees)
+                fixed (float* confidence = mConfidence)
+                fixed (float* x = mXCoeff)
+                fixed (float* y = mYCoeff)
+                {
+                    mEstimatedBits = Native.Additional.SkKernel_velocityEstimate(
+                        mNative, mStrategy, mDegree, mWeighting, &time, degrees, confidence, x, y
+                    );
+                }
+                GC.KeepAlive(this);
+                mTime = time;
+                mEstimated = true;
+            }
+            if ((mEstimatedBits & (1 << slot)) == 0)
+            {
+                return false;
+            }
+
+            outEstimator.time = mTime;
+            outEstimator.degree = mDegrees[slot];
+            outEstimator.confidence = mConfidence[slot];
+            for (int i = 0; i <= MAX_DEGREE; i++)
+            {
+                outEstimator.xCoeff[i] = mXCoeff[slot * (MAX_DEGREE + 1) + i];
+                outEstimator.yCoeff[i] = mYCoeff[slot * (MAX_DEGREE + 1) + i];
+            }
+            return true;
+        }
+    }
+}
@@ -475,6 +475,24 @@ namespace AndroidUI.Widgets
             internal RectF mTmpTransformRect;
             internal Transformation mTmpTransformation;
             internal View mRootView;
+
+            /**
+             * The device area render nodes changed since the last frame covered and cover
+             * now, and how many views recorded their display list again or kept it, see
+             * ViewRootImpl.drawFrame
+             */
+            internal SKRect mDamage = SKRect.Empty;
+            internal int mRecordedDisplayLists;
+            internal int mReusedDisplayLists;
+
+            internal void damage(SKRect rect)
+            {
+                if (rect.Left < rect.Right && rect.Top < rect.Bottom)
+                {
+                    mDamage = mDamage.Left < mDamage.Right && mDamage.Top < mDamage.Bottom ? SKRect.Union(mDamage, rect) : rect;
+                }
+            }
+
             /**
              * Global to the view hierarchy used as a temporary for dealing with
              * x/y points in the ViewGroup.invalidateChild implementation.
@@ -1726,6 +1744,8 @@ namespace AndroidUI.Widgets
         {
             mRenderNode?.Dispose();
             mRenderNode = null;
+            mAttachInfo?.damage(mDisplayListNode.damage());
+            mDisplayListNode.discardDisplayList();
             invalidate();
             //mRenderNode.discardDisplayList();
             //if (mBackgroundRenderNode != null)
@@ -6763,7 +6783,13 @@ namespace AndroidUI.Widgets
             //{
             // Layered parents should be invalidated. Escalate to a full invalidate (and note that
             // we do this after consuming any relevant flags from the originating descendant)
-            AddInvalidatedFlag(this);
+            //
+            // a parent recorded into a command buffer refers to the render node of the child,
+            // which records itself again, so the parent's list is kept
+            if (!ViewRootImpl.REPLACE_SKPICTURE_WITH_COMMAND_BUFFER)
+            {
+                AddInvalidatedFlag(this);
+            }
             mPrivateFlags |= PFLAG_DIRTY;
             // TODO: RESTORE ME ?
             //target = this;
@@ -6854,7 +6880,7 @@ namespace AndroidUI.Widgets
                     {
                         transformMatrix = childMatrix;
                     }
-                    transformMatrix.Value.MapRect(boundingRect);
+                    transformMatrix.Value.mapRect(boundingRect);
                     dirty.set((int)Math.Floor(boundingRect.left),
                             (int)Math.Floor(boundingRect.top),
                             (int)Math.Ceiling(boundingRect.right),
@@ -6900,7 +6926,7 @@ namespace AndroidUI.Widgets
                         {
                             RectF boundingRect = attachInfo.mTmpTransformRect;
                             boundingRect.set(dirty);
-                            m.Value.MapRect(boundingRect);
+                            m.Value.mapRect(boundingRect);
                             dirty.set((int)Math.Floor(boundingRect.left),
                                     (int)Math.Floor(boundingRect.top),
                                     (int)Math.Ceiling(boundingRect.right),
@@ -7709,23 +7735,34 @@ namespace AndroidUI.Widgets
         internal class InternalPicture : Disposable
         {
             public SKPicture picture;
-            public RecordingCanvas2.CommandBuffer commandBuffer;
 
-            public InternalPicture(SKPicture picture, RecordingCanvas2.CommandBuffer commandBuffer)
+            // the view's node, which owns the command buffer recorded for the view and
+            // outlives this
+            public RenderNode node;
+
+            public InternalPicture(SKPicture picture, RenderNode node)
             {
                 this.picture = picture;
-                this.commandBuffer = commandBuffer;
+                this.node = node;
             }
 
             protected override void OnDispose()
             {
                 picture?.Dispose();
-                commandBuffer?.Dispose();
             }
         }
 
         InternalPicture mRenderNode;
 
+        // the node the display list of the view is recorded into when command buffers
+        // replace pictures, parents refer to it so only the view records again when it is
+        // invalidated, see RenderNode
+        internal readonly RenderNode mDisplayListNode = new();
+
+        // the alpha of the animation the view was last drawn with, the node draws it along
+        // with the alpha of the view
+        private float mDisplayListNodeAnimationAlpha = 1;
+
         /**
          * This method is used to cause children of this View to restore or recreate their
          * display lists. It is called by getDisplayList() when the parent View does not need
@@ -7831,6 +7868,7 @@ namespace AndroidUI.Widgets
                     mPrivateFlags &= ~PFLAG_DIRTY_MASK;
                     dispatchGetDisplayList(hardwareCanvas);
 
+                    reusedDisplayList();
                     return mRenderNode; // no work needed
                 }
 
@@ -7859,6 +7897,7 @@ namespace AndroidUI.Widgets
                     canvas = new Canvas(Context, callback, true);
                     canvas.LogMethods = ViewRootImpl.LOG_COMMANDS;
                     canvas.AdoptHardwareAcceleratedCanvas(hardwareCanvas, width, height);
+                    canvas.displayListRecorder = recordingCanvas2;
                 }
                 else
                 {
@@ -7916,7 +7955,8 @@ namespace AndroidUI.Widgets
                 {
                     if (recordingCanvas == null)
                     {
-                        mRenderNode = new(null, recordingCanvas2.GetCommandBuffer());
+                        mDisplayListNode.setDisplayList(recordingCanvas2.GetCommandBuffer(), width, height);
+                        mRenderNode = new(null, mDisplayListNode);
                     }
                     else
                     {
@@ -7925,15 +7965,52 @@ namespace AndroidUI.Widgets
                     canvas.Dispose();
                     setDisplayListProperties(mRenderNode);
                 }
+                if (mAttachInfo != null)
+                {
+                    mAttachInfo.mRecordedDisplayLists++;
+                }
+                updateDisplayListNode(true);
             }
             else
             {
                 mPrivateFlags |= PFLAG_DRAWN | PFLAG_DRAWING_CACHE_VALID;
                 mPrivateFlags &= ~PFLAG_DIRTY_MASK;
+                reusedDisplayList();
             }
             return mRenderNode;
         }
 
+        private void reusedDisplayList()
+        {
+            if (mAttachInfo != null)
+            {
+                mAttachInfo.mReusedDisplayLists++;
+            }
+            updateDisplayListNode(false);
+        }
+
+        /**
+         * Pushes the position, matrix and alpha of the view to its render node, which draws
+         * them in place of its parent, and damages where the node was and is if it was
+         * recorded again or any of them changed.
+         */
+        private void updateDisplayListNode(bool recorded)
+        {
+            if (!ViewRootImpl.REPLACE_SKPICTURE_WITH_COMMAND_BUFFER)
+            {
+                return;
+            }
+            bool changed = mDisplayListNode.setPosition(getX(), getY());
+            changed |= mDisplayListNode.setMatrix(hasIdentityMatrix() ? SKMatrix.Identity : getMatrix().Value);
+            // a view whose onSetAlpha handles its alpha has drawn it into its display list
+            float alpha = (mPrivateFlags & PFLAG_ALPHA_SET) != 0 ? 1 : getFinalAlpha();
+            changed |= mDisplayListNode.setAlpha(alpha * mDisplayListNodeAnimationAlpha);
+            if (recorded || changed)
+            {
+                mAttachInfo?.damage(mDisplayListNode.damage());
+            }
+        }
+
         /**
          * This method is called by getDisplayList() when a display list is recorded for a View.
          * It pushes any properties to the RenderNode that aren't managed by the RenderNode.
@@ -9038,15 +9115,58 @@ namespace AndroidUI.Widgets
             // TODO: comment out?
             if (!child.hasIdentityMatrix())
             {
-                SKPoint[] points = new SKPoint[1];
-                points[0].X = point[0];
-                points[0].Y = point[1];
-                child.getInverseMatrix().MapPoints(points);
-                point[0] = points[0].X;
-                point[1] = points[0].Y;
+                SKMatrix inverse = child.getInverseMatrix();
+                SKPoint p = inverse.mapXY(point[0], point[1]);
+                point[0] = p.X;
+                point[1] = p.Y;
             }
         }
 
+        SKMatrix[] mTmpChildMatrices;
+        SKRect[] mTmpChildRects;
+
+        /**
+         * Computes the bounds of every child in this view's coordinate space, taking each
+         * child's transform matrix into account.
+         *
+         * All children are mapped in a single batch instead of one matrix call per child.
+         * The batch is staged in scratch arrays owned by this view, so like the rest of the
+         * view hierarchy this must only be called on the UI thread and is not reentrant.
+         *
+         * @param outBounds receives the bounds of child i at index i, must hold at least
+         *                  getChildCount() rects
+         * @return the number of rects written
+         * @hide
+         */
+        internal int getChildrenBoundsInParent(SKRect[] outBounds)
+        {
+            int count = mChildrenCount;
+            if (outBounds.Length < count)
+            {
+                throw new IllegalArgumentException("outBounds must hold at least " + count + " rects");
+            }
+            if (mTmpChildMatrices == null || mTmpChildMatrices.Length < count)
+            {
+                mTmpChildMatrices = new SKMatrix[count];
+                mTmpChildRects = new SKRect[count];
+            }
+            SKMatrix[] matrices = mTmpChildMatrices;
+            SKRect[] rects = mTmpChildRects;
+            for (int i = 0; i < count; i++)
+            {
+                View child = mChildren[i];
+                matrices[i] = child.hasIdentityMatrix() ? SKMatrix.Identity : child.getMatrix().Value;
+                rects[i] = new SKRect(0, 0, child.mRight - child.mLeft, child.mBottom - child.mTop);
+            }
+            SKMatrixExtensions.mapRects(matrices.AsSpan(0, count), outBounds, rects.AsSpan(0, count));
+            for (int i = 0; i < count; i++)
+            {
+                View child = mChildren[i];
+                outBounds[i].Offset(child.mLeft, child.mTop);
+            }
+            return count;
+        }
+
         readonly List<(View View, Touch Touch)> trackedViews = new();
 
         private bool stealed_touch__Tracking(Touch ev, int currentTouchCount, Touch.Data currentData, Touch.State currentState)
@@ -13674,6 +13794,7 @@ namespace AndroidUI.Widgets
             {
                 // Delay getting the display list until animation-driven alpha values are
                 // set up and possibly passed on to the view
+                mDisplayListNodeAnimationAlpha = transformToApply != null ? transformToApply.getAlpha() : 1;
                 renderNode = updateDisplayListIfDirty(canvas);
                 //if (!renderNode.hasDisplayList())
                 //{
@@ -13689,6 +13810,9 @@ namespace AndroidUI.Widgets
                 }
             }
 
+            // a render node applies the view's position and matrix itself when it is drawn
+            bool drawingWithNode = drawingWithRenderNode && renderNode.node != null;
+
             int sx = 0;
             int sy = 0;
             //if (!drawingWithRenderNode)
@@ -13775,6 +13899,7 @@ namespace AndroidUI.Widgets
                     }
 
                     if (!childHasIdentityMatrix
+                        && !drawingWithNode
                     // && !drawingWithRenderNode
                     )
                     {
@@ -13866,12 +13991,11 @@ namespace AndroidUI.Widgets
                     {
                         sparePaint.setAlpha(alpha.ToColorInt());
                     }
-                    if (renderNode.picture == null)
+                    if (drawingWithNode)
                     {
-                        canvas.SaveLayer(sparePaint);
-                        canvas.Translate(getX(), getY());
-                        renderNode.commandBuffer.Playback(canvas);
-                        canvas.Restore();
+                        // while the parent records, the node is recorded by reference so the
+                        // parent's list stays valid when only this view changes
+                        renderNode.node.draw(canvas.displayListRecorder ?? (SKCanvas)canvas);
                     }
                     else
                     {
@@ -16704,24 +16828,26 @@ namespace AndroidUI.Widgets
          */
         internal void invalidateViewProperty(bool invalidateParent, bool forceRedraw)
         {
-            //if (!isHardwareAccelerated()
-            //        //|| !mRenderNode.hasDisplayList()
-            //        || (mPrivateFlags & PFLAG_DRAW_ANIMATION) != 0)
-            //{
-            if (invalidateParent)
+            if (!ViewRootImpl.REPLACE_SKPICTURE_WITH_COMMAND_BUFFER
+                    || !mDisplayListNode.hasDisplayList()
+                    || (mPrivateFlags & PFLAG_DRAW_ANIMATION) != 0)
             {
-                invalidateParentCaches();
+                if (invalidateParent)
+                {
+                    invalidateParentCaches();
+                }
+                if (forceRedraw)
+                {
+                    mPrivateFlags |= PFLAG_DRAWN; // force another invalidation with the new orientation
+                }
+                invalidate(true);
             }
-            if (forceRedraw)
+            else
             {
-                mPrivateFlags |= PFLAG_DRAWN; // force another invalidation with the new orientation
+                // the new properties are pushed to the render node on the next frame, no
+                // display list needs recording again
+                damageInParent();
             }
-            invalidate(true);
-            //}
-            //else
-            //{
-            //    damageInParent();
-            //}
         }
 
         /**
@@ -54,6 +54,7 @@ namespace AndroidUI.Widgets
         public static bool REENCODE_SKPICTURE_TO_COMMAND_BUFFER = false;
         public static bool LOG_SERIALIZED_SIZE = false;
         public static bool LOG_COMMANDS = false;
+        public static bool LOG_FRAME_STATS = false;
         public static bool USE_GPU_FOR_OVERDRAW = true;
 
         private const string TAG = "ViewRootImpl";
@@ -176,6 +177,41 @@ namespace AndroidUI.Widgets
         bool mAppVisibilityChanged;
 
         // Variables to track frames per second, enabled via DEBUG_FPS flag
+        /**
+         * What drawing a frame through render nodes did, see drawFrame
+         */
+        public struct FrameStats
+        {
+            /**
+             * The views that recorded their display list again
+             */
+            public int RecordedViews;
+
+            /**
+             * The views that kept the display list of an earlier frame
+             */
+            public int ReusedViews;
+
+            /**
+             * The area of the window drawn again, empty when the last frame was shown as is
+             */
+            public SKRectI Damage;
+
+            public override string ToString()
+            {
+                return "recorded " + RecordedViews + " views, reused " + ReusedViews + " views, damage " + Damage;
+            }
+        }
+
+        /**
+         * The stats of the last frame drawn with REPLACE_SKPICTURE_WITH_COMMAND_BUFFER
+         */
+        public FrameStats LastFrameStats { get; private set; }
+
+        // the last frame drawn with render nodes, kept so the next draws only the damage
+        private SKSurface mFrame;
+        private SKImageInfo mFrameInfo;
+
         private long mFpsStartTime = -1;
         private long mFpsPrevTime = -1;
         private int mFpsNumFrames;
@@ -1692,6 +1728,7 @@ namespace AndroidUI.Widgets
             optionsPage.addView(CreateSettingsRow("Re-encode SKPicture to CommandBuffer", "Enabled", "Disabled", () => REENCODE_SKPICTURE_TO_COMMAND_BUFFER, value => { REENCODE_SKPICTURE_TO_COMMAND_BUFFER = value; }));
             optionsPage.addView(CreateSettingsRow("Log commands", "Enabled", "Disabled", () => LOG_COMMANDS, value => { LOG_COMMANDS = value; }));
             optionsPage.addView(CreateSettingsRow("Log total serialized recording size", "Enabled", "Disabled", () => LOG_SERIALIZED_SIZE, value => { LOG_SERIALIZED_SIZE = value; }));
+            optionsPage.addView(CreateSettingsRow("Log frame stats\n(requires [Replace SKPicture with CommandBuffer] to be Enabled)", "Enabled", "Disabled", () => LOG_FRAME_STATS, value => { LOG_FRAME_STATS = value; }));
             optionsPage.addView(CreateSettingsRow("Log SKNativeObject Allocations (expensive)", "Enabled", "Disabled", () => SkiaSharp.SKNativeObject.LOG_ALLOCATIONS, value => SKNativeObject.LOG_ALLOCATIONS = value));
             optionsPage.addView(CreateSettingsRow("Touch: Debug", "Enabled", "Disabled", () => Touch.DEBUG, value => Touch.DEBUG = value));
             optionsPage.addView(CreateSettingsRow("Touch: Debug - show TOUCH_MOVE events\n(requires [Touch: Debug] to be Enabled) (can flood)", "Enabled", "Disabled", () => Touch.PRINT_MOVED, value => Touch.PRINT_MOVED = value).setTagRecursively("TOUCH DEBUG"));
@@ -2445,7 +2482,8 @@ namespace AndroidUI.Widgets
                 //}
             }
 
-            Context.mAttachInfo.mDrawingTime = NanoTime.currentTimeMillis(); // currentTimeNanos() / NanoTime.NANOS_PER_MS; // mChoreographer.getFrameTimeNanos() / TimeUtils.NANOS_PER_MS;
+            // The animation clock is locked to the frame clock's frame time while drawing.
+            Context.mAttachInfo.mDrawingTime = AnimationFramework.Animation.AnimationUtils.currentAnimationTimeMillis(Context); // mChoreographer.getFrameTimeNanos() / TimeUtils.NANOS_PER_MS;
 
             bool useAsyncReport = false;
             if (!dirty.isEmpty() || mIsAnimating || accessibilityFocusDirty
@@ -2663,10 +2701,10 @@ half4 main(float2 coords) {
                     if (REPLACE_SKPICTURE_WITH_COMMAND_BUFFER)
                     {
                         var canvas = new LoggingCanvas(nWayCanvas, false, LOG_COMMANDS);
-                        displayList.commandBuffer.Playback(canvas);
+                        displayList.node.draw(canvas);
                         if (LOG_SERIALIZED_SIZE)
                         {
-                            Log.d("RECORD", "Command Buffer total serialized size: " + displayList.commandBuffer.mem.Length);
+                            Log.d("RECORD", "Command Buffer total serialized size: " + displayList.node.getDisplayList().Length);
                         }
                     }
                     else
@@ -2692,7 +2730,7 @@ half4 main(float2 coords) {
                             cmd.Playback(nWayCanvas);
                             if (LOG_SERIALIZED_SIZE)
                             {
-                                Log.d("RECORD", "Command Buffer total serialized size: " + cmd.mem.Length);
+                                Log.d("RECORD", "Command Buffer total serialized size: " + cmd.Length);
                             }
                             recorder.Dispose();
                         }
@@ -2735,11 +2773,10 @@ half4 main(float2 coords) {
                 {
                     if (REPLACE_SKPICTURE_WITH_COMMAND_BUFFER)
                     {
-                        var canvas = new LoggingCanvas(drawingCanvas, false, LOG_COMMANDS);
-                        displayList.commandBuffer.Playback(canvas);
+                        drawFrame(drawingCanvas, displayList.node);
                         if (LOG_SERIALIZED_SIZE)
                         {
-                            Log.d("RECORD", "Command Buffer total serialized size: " + displayList.commandBuffer.mem.Length);
+                            Log.d("RECORD", "Command Buffer total serialized size: " + displayList.node.getDisplayList().Length);
                         }
                     }
                     else
@@ -2771,7 +2808,7 @@ half4 main(float2 coords) {
                             cmd.Playback(drawingCanvas);
                             if (LOG_SERIALIZED_SIZE)
                             {
-                                Log.d("RECORD", "Command Buffer total serialized size: " + cmd.mem.Length);
+                                Log.d("RECORD", "Command Buffer total serialized size: " + cmd.Length);
                             }
                         }
                         recorder.Dispose();
@@ -2781,6 +2818,60 @@ half4 main(float2 coords) {
             view.mRecreateDisplayList = false;
         }
 
+        /**
+         * Draws the root render node into the frame kept from the last draw, clipped to the
+         * area the nodes that changed covered and cover now, then shows the frame.
+         *
+         * Nodes kept from the last frame are only replayed, and inside the damage only their
+         * draws that reach it are issued, see RecordingCanvas2.CommandBuffer.Playback.
+         */
+        private void drawFrame(Canvas drawingCanvas, RenderNode root)
+        {
+            View.AttachInfo attachInfo = Context.mAttachInfo;
+            int w = drawingCanvas.BaseLayerSize.Width;
+            int h = drawingCanvas.BaseLayerSize.Height;
+            SKRect damage = attachInfo.mDamage;
+            attachInfo.mDamage = SKRect.Empty;
+
+            if (mFrame == null || mFrameInfo.Width != w || mFrameInfo.Height != h)
+            {
+                mFrame?.Dispose();
+                mFrameInfo = new(w, h);
+                mFrame = drawingCanvas.graphicsContext != null
+                    ? SKSurface.Create(drawingCanvas.graphicsContext, false, mFrameInfo)
+                    : SKSurface.Create(mFrameInfo);
+                damage = new SKRect(0, 0, w, h);
+            }
+
+            // the damage may be unbounded, it is clamped to the window before rounding
+            SKRectI area = SKRectI.Ceiling(RecordingCanvas2.intersect(damage, new SKRect(0, 0, w, h)), true);
+            if (!area.IsEmpty)
+            {
+                // the clip is set through the forwarder so playback culls against it
+                using LoggingCanvas canvas = new(mFrame.Canvas, false, LOG_COMMANDS);
+                int count = canvas.Save();
+                canvas.ClipRect(new SKRect(area.Left, area.Top, area.Right, area.Bottom));
+                canvas.Clear(SKColors.Transparent);
+                root.draw(canvas);
+                canvas.RestoreToCount(count);
+                canvas.Flush();
+            }
+            drawingCanvas.DrawSurface(mFrame, 0, 0);
+
+            LastFrameStats = new FrameStats
+            {
+                RecordedViews = attachInfo.mRecordedDisplayLists,
+                ReusedViews = attachInfo.mReusedDisplayLists,
+                Damage = area,
+            };
+            attachInfo.mRecordedDisplayLists = 0;
+            attachInfo.mReusedDisplayLists = 0;
+            if (LOG_FRAME_STATS)
+            {
+                Log.d(TAG, "frame: " + LastFrameStats);
+            }
+        }
+
         internal List<Application.FrameCallback> mNextRtFrameCallbacks;
 
         private void updateRootDisplayList(Canvas canvas, View view,
@@ -2929,7 +3020,17 @@ half4 main(float2 coords) {
             }
 
             // invalidate AFTER traversal to ensure invalidation flag is added back
-            mView.invalidate();
+            //
+            // a view drawn through render nodes is drawn again as it is invalidated, the
+            // window only needs the next frame, which reuses what has not changed
+            if (REPLACE_SKPICTURE_WITH_COMMAND_BUFFER)
+            {
+                invalidate();
+            }
+            else
+            {
+                mView.invalidate();
+            }
         }
 
         public void invalidate()
@@ -0,0 +1,319 @@
+﻿using AndroidUI.AnimationFramework.Animation;
+using AndroidUI.AnimationFramework.Animator;
+using AndroidUI.AnimationFramework.Interpolators;
+using AndroidUI.Applications;
+using AndroidUI.Execution;
+using AndroidUI.Utils;
+using AndroidUITestFramework;
+
+namespace AndroidUITest
+{
+    class AnimatorTests : TestGroup
+    {
+        // pulses an AnimationHandler by hand at times chosen by the test
+        class ManualFrameProvider : AnimationHandler.AnimationFrameCallbackProvider
+        {
+            internal Application.FrameCallback callback;
+            internal long frameTime;
+
+            public void postFrameCallback(Application.FrameCallback callback) => this.callback = callback;
+            public void postCommitCallback(Runnable runnable) { }
+            public long getFrameTime() => frameTime;
+            public uint getFrameDelay() => 10;
+            public void setFrameDelay(uint delay) { }
+
+            internal void doFrame(long time)
+            {
+                frameTime = time;
+                Application.FrameCallback c = callback;
+                callback = null;
+                c?.doFrame(time * 1000000);
+            }
+        }
+
+        class _1_BatchedInterpolators : Test
+        {
+            public override void Run(TestGroup nullableInstance)
+            {
+                TimeInterpolator[] interpolators = {
+                    new LinearInterpolator(), new AccelerateDecelerateInterpolator(),
+                    new AccelerateInterpolator(), new AccelerateInterpolator(1.5f),
+                    new DecelerateInterpolator(), new DecelerateInterpolator(0.75f),
+                    new AnticipateInterpolator(), new OvershootInterpolator(),
+                    new AnticipateOvershootInterpolator(), new BounceInterpolator(),
+                    new CycleInterpolator(2)
+                };
+                int steps = 101;
+                int count = interpolators.Length * steps;
+                int[] kind = new int[count];
+                float[] param = new float[count];
+                float[] input = new float[count];
+                float[] output = new float[count];
+                // interleave the kinds, the kernel packs each kind into vectors itself
+                for (int i = 0; i < count; i++)
+                {
+                    kind[i] = AnimatorBatch.getInterpolatorKind(interpolators[i % interpolators.Length], out param[i]);
+                    Tools.AssertTrue(kind[i] != AnimatorBatch.INTERPOLATOR_NONE);
+                    input[i] = (i / interpolators.Length) / (float)(steps - 1);
+                }
+                unsafe
+                {
+                    fixed (int* k = kind)
+                    fixed (float* p = param, x = input, y = output)
+                    {
+                        AndroidUI.Native.Additional.SkKernel_animatorInterpolate(k, p, x, y, count);
+                    }
+                }
+                for (int i = 0; i < count; i++)
+                {
+                    TimeInterpolator interpolator = interpolators[i % interpolators.Length];
+                    float expected = interpolator.getInterpolation(input[i]);
+                    // the two interpolators taking a sine are approximated, the rest match exactly
+                    if (interpolator is AccelerateDecelerateInterpolator || interpolator is CycleInterpolator)
+                    {
+                        Tools.AssertTrue(Math.Abs(expected - output[i]) < 1e-6f);
+                    }
+                    else
+                    {
+                        Tools.AssertEqual(output[i], expected);
+                    }
+                }
+
+                // interpolators the kernel has no curve for are calculated as usual
+                Tools.AssertEqual(AnimatorBatch.getInterpolatorKind(new PathInterpolator(0.4f, 0, 0.2f, 1), out _), AnimatorBatch.INTERPOLATOR_NONE);
+            }
+        }
+
+        class _2_BatchedEvaluation : Test
+        {
+            public override void Run(TestGroup nullableInstance)
+            {
+                Exception failure = null;
+                Thread t = new(() =>
+                {
+                    try
+                    {
+                        run();
+                    }
+                    catch (Exception e)
+                    {
+                        failure = e;
+                    }
+                });
+                t.Start();
+                t.Join();
+                if (failure != null)
+                {
+                    throw failure;
+                }
+            }
+
+            static void run()
+            {
+                Context c = new();
+                Looper.prepare(c);
+                AnimationUtils.lockAnimationClock(c, 1000);
+                ManualFrameProvider provider = new();
+                AnimationHandler handler = new(c);
+                handler.setProvider(provider);
+
+                TimeInterpolator[] interpolators = {
+                    new LinearInterpolator(), new AccelerateInterpolator(),
+                    new OvershootInterpolator(), new BounceInterpolator()
+                };
+                List<ValueAnimator> plain = new();
+                List<ValueAnimator> batched = new();
+                int batchedInFrame = 0;
+                for (int batch = 0; batch < 2; batch++)
+                {
+                    List<ValueAnimator> list = batch == 0 ? plain : batched;
+                    for (int i = 0; i < interpolators.Length; i++)
+                    {
+                        list.Add(ValueAnimator.ofFloat(c, -10, 250.5f));
+                        list.Add(ValueAnimator.ofInt(c, 7, -300));
+                        list.Add(ValueAnimator.ofArgb(c, unchecked((int)0xFF102030), unchecked((int)0x80F0A0FF)));
+                    }
+                    for (int i = 0; i < list.Count; i++)
+                    {
+                        ValueAnimator animator = list[i];
+                        animator.setInterpolator(interpolators[(i / 3) % interpolators.Length]);
+                        animator.setDuration(1000);
+                        animator.setAnimationHandler(handler);
+                        animator.setBatchedEvaluation(batch == 1);
+                    }
+                }
+                batched[0].addUpdateListener(new UpdateListener(() => batchedInFrame = handler.getBatch().getCount()));
+                foreach (ValueAnimator animator in plain)
+                {
+                    animator.start();
+                }
+                foreach (ValueAnimator animator in batched)
+                {
+                    animator.start();
+                }
+
+                for (long time = 1000; time <= 2100; time += 50)
+                {
+                    batchedInFrame = 0;
+                    provider.doFrame(time);
+                    for (int i = 0; i < plain.Count; i++)
+                    {
+                        object expected = plain[i].getAnimatedValue();
+                        object actual = batched[i].getAnimatedValue();
+                        if (expected is float f)
+                        {
+                            Tools.AssertEqual((float)actual, f);
+                        }
+                        else
+                        {
+                            Tools.AssertEqual((int)actual, (int)expected);
+                        }
+                        Tools.AssertEqual(batched[i].getAnimatedFraction(), plain[i].getAnimatedFraction());
+                    }
+                    // the last frame ends the animators and is calculated as usual
+                    Tools.AssertEqual(batchedInFrame, time < 2000 ? batched.Count : 0);
+                }
+                foreach (ValueAnimator animator in batched)
+                {
+                    Tools.AssertFalse(animator.isRunning());
+                }
+                AnimationUtils.unlockAnimationClock(c);
+            }
+
+            class UpdateListener : ValueAnimator.AnimatorUpdateListener
+            {
+                readonly Action action;
+
+                public UpdateListener(Action action)
+                {
+                    this.action = action;
+                }
+
+                public void onAnimationUpdate(ValueAnimator animation)
+                {
+                    action();
+                }
+            }
+        }
+
+        class _3_PathInterpolatorTable : Test
+        {
+            static float cubic(float a, float b, float t)
+            {
+                float u = 1 - t;
+                return 3 * u * u * t * a + 3 * u * t * t * b + t * t * t;
+            }
+
+            public override void Run(TestGroup nullableInstance)
+            {
+                PathInterpolator interpolator = new(0.4f, 0, 0.2f, 1);
+                int count = 1000;
+                float[] input = new float[count];
+                float[] output = new float[count];
+                for (int i = 0; i < count; i++)
+                {
+                    input[i] = (i - 100) / (float)(count - 200);
+                }
+                input[7] = float.NaN;
+                interpolator.getInterpolation(input, output);
+                for (int i = 0; i < count; i++)
+                {
+                    float x = input[i];
+                    float y = interpolator.getInterpolation(x);
+                    // the batch lookup gives exactly what one lookup gives
+                    Tools.AssertTrue(output[i] == y || (float.IsNaN(output[i]) && float.IsNaN(y)));
+                    if (float.IsNaN(x) || x <= 0 || x >= 1)
+                    {
+                        continue;
+                    }
+                    // solve the curve for x and check the table is close to the exact y
+                    float lo = 0, hi = 1;
+                    for (int k = 0; k < 40; k++)
+                    {
+                        float mid = (lo + hi) / 2;
+                        if (cubic(0.4f, 0.2f, mid) < x)
+                        {
+                            lo = mid;
+                        }
+                        else
+                        {
+                            hi = mid;
+                        }
+                    }
+                    Tools.AssertTrue(Math.Abs(cubic(0, 1, lo) - y) < 1e-4f);
+                }
+                Tools.AssertEqual(interpolator.getInterpolation(0f), 0f);
+                Tools.AssertEqual(interpolator.getInterpolation(1f), 1f);
+                Tools.AssertTrue(float.IsNaN(output[7]));
+
+                // a vertical jump is kept sharp rather than blended across a table step
+                AndroidUI.Graphics.Path path = new();
+                path.lineTo(0.25f, 0.25f);
+                path.moveTo(0.25f, 0.5f);
+                path.lineTo(1f, 1f);
+                PathInterpolator jump = new(path);
+                Tools.AssertTrue(Math.Abs(jump.getInterpolation(0.2499f) - 0.2499f) < 1e-5f);
+                Tools.AssertTrue(Math.Abs(jump.getInterpolation(0.2501f) - 0.5001f) < 1e-4f);
+                jump.getInterpolation(input, output);
+                for (int i = 0; i < count; i++)
+                {
+                    float y = jump.getInterpolation(input[i]);
+                    Tools.AssertTrue(output[i] == y || (float.IsNaN(output[i]) && float.IsNaN(y)));
+                }
+
+                Tools.ExpectException<AndroidUI.Exceptions.IllegalArgumentException>(
+                    () => interpolator.getInterpolation(input, new float[count - 1])
+                );
+            }
+        }
+
+        class _4_PathKeyframesSampler : Test
+        {
+            public override void Run(TestGroup nullableInstance)
+            {
+                AndroidUI.Graphics.Path path = new();
+                path.moveTo(0, 0);
+                path.lineTo(137, 0);
+                path.lineTo(137, 137);
+
+                long hits = PathSampler.getHitCount();
+                long misses = PathSampler.getMissCount();
+                PathKeyframes first = KeyframeSet.ofPath(path);
+                PathKeyframes second = KeyframeSet.ofPath(path);
+                // the second keyframes reuse the table of the first
+                Tools.AssertEqual(PathSampler.getMissCount() - misses, 1L);
+                Tools.AssertEqual(PathSampler.getHitCount() - hits, 1L);
+
+                float[] fractions = { -0.25f, 0, 0.25f, 0.5f, 0.75f, 1, 1.25f };
+                SkiaSharp.SKPoint[] positions = new SkiaSharp.SKPoint[fractions.Length];
+                SkiaSharp.SKPoint[] tangents = new SkiaSharp.SKPoint[fractions.Length];
+                first.getPositions(fractions, positions, tangents);
+
+                SkiaSharp.SKPoint[] expectedPositions = {
+                    new(-68.5f, 0), new(0, 0), new(68.5f, 0), new(137, 0),
+                    new(137, 68.5f), new(137, 137), new(137, 205.5f)
+                };
+                SkiaSharp.SKPoint[] expectedTangents = {
+                    new(1, 0), new(1, 0), new(1, 0), new(0, 1),
+                    new(0, 1), new(0, 1), new(0, 1)
+                };
+                for (int i = 0; i < fractions.Length; i++)
+                {
+                    Tools.AssertEqual(positions[i], expectedPositions[i]);
+                    Tools.AssertEqual(tangents[i], expectedTangents[i]);
+                    Tools.AssertEqual((SkiaSharp.SKPoint)second.getValue(fractions[i]), positions[i]);
+                    Tools.AssertEqual((SkiaSharp.SKPoint)first.Clone().getValue(fractions[i]), positions[i]);
+                }
+
+                // tangents are optional
+                first.getPositions(fractions, positions, Span<SkiaSharp.SKPoint>.Empty);
+                Tools.AssertEqual(positions[4], expectedPositions[4]);
+                Tools.AssertEqual(first.createXFloatKeyframes().getFloatValue(0.75f), 137f);
+                Tools.AssertEqual(first.createYIntKeyframes().getIntValue(1), 137);
+                Tools.ExpectException<AndroidUI.Exceptions.IllegalArgumentException>(
+                    () => first.getPositions(fractions, new SkiaSharp.SKPoint[1], Span<SkiaSharp.SKPoint>.Empty)
+                );
+            }
+        }
+    }
+}
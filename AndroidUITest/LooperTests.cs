@@ -1,5 +1,6 @@
 ﻿using AndroidUI.Applications;
 using AndroidUI.Execution;
+using AndroidUI.Utils;
 using AndroidUITestFramework;
 
 namespace AndroidUITest
@@ -133,5 +134,364 @@ namespace AndroidUITest
                 t.Join();
             }
         }
+
+        class _4_BlocksUntilWoken : Test
+        {
+            public override void Run(TestGroup nullableInstance)
+            {
+                Context c = new();
+                Looper m = null;
+                Handler h = null;
+                ManualResetEventSlim prepared = new();
+                Thread t = new(() =>
+                {
+                    Looper.prepare(c);
+                    m = Looper.myLooper(c);
+                    h = new Handler(m);
+                    prepared.Set();
+                    Looper.loop(c);
+                });
+                t.Start();
+                prepared.Wait();
+
+                // an idle looper sleeps in the native poll instead of spinning
+                SpinWait.SpinUntil(() => m.mQueue.isPolling(), 1000);
+                Tools.AssertTrue(m.mQueue.isPolling());
+
+                ManualResetEventSlim posted = new();
+                h.post(() => posted.Set());
+                Tools.AssertTrue(posted.Wait(1000));
+
+                ManualResetEventSlim delayed = new();
+                var watch = System.Diagnostics.Stopwatch.StartNew();
+                h.postDelayed(() => delayed.Set(), 100);
+                Tools.AssertTrue(delayed.Wait(2000));
+                Tools.AssertTrue(watch.ElapsedMilliseconds >= 90);
+
+                m.quitSafely();
+                Tools.AssertTrue(t.Join(1000));
+            }
+        }
+
+        class _5_ConcurrentProducers : Test
+        {
+            public override void Run(TestGroup nullableInstance)
+            {
+                const int producers = 8;
+                const int messages = 2000;
+                Context c = new();
+                using LooperThread looper = new(c);
+
+                // messages from one producer arrive in the order that producer sent them
+                int[] last = new int[producers];
+                bool ordered = true;
+                CountdownEvent delivered = new(producers * messages);
+                Thread[] threads = new Thread[producers];
+                for (int t = 0; t < producers; t++)
+                {
+                    int producer = t;
+                    threads[t] = new(() =>
+                    {
+                        for (int i = 1; i <= messages; i++)
+                        {
+                            int sequence = i;
+                            looper.handler.post(() =>
+                            {
+                                ordered &= last[producer] + 1 == sequence;
+                                last[producer] = sequence;
+                                delivered.Signal();
+                            });
+                        }
+                    });
+                    threads[t].Start();
+                }
+                foreach (Thread thread in threads)
+                {
+                    thread.Join();
+                }
+                Tools.AssertTrue(delivered.Wait(10000));
+                Tools.AssertTrue(ordered);
+                Tools.AssertFalse(looper.handler.hasMessagesOrCallbacks());
+            }
+        }
+
+        class _6_QuitWhileProducing : Test
+        {
+            public override void Run(TestGroup nullableInstance)
+            {
+                const int producers = 8;
+                const int messages = 2000;
+                Context c = new();
+                LooperThread looper = new(c);
+
+                // every post that returns true is delivered, even when it races with the quit
+                int accepted = 0;
+                int delivered = 0;
+                Barrier start = new(producers + 1);
+                Thread[] threads = new Thread[producers];
+                for (int t = 0; t < producers; t++)
+                {
+                    threads[t] = new(() =>
+                    {
+                        start.SignalAndWait();
+                        for (int i = 0; i < messages; i++)
+                        {
+                            if (looper.handler.post(() => Interlocked.Increment(ref delivered)))
+                            {
+                                Interlocked.Increment(ref accepted);
+                            }
+                        }
+                    });
+                    threads[t].Start();
+                }
+                start.SignalAndWait();
+                while (Volatile.Read(ref delivered) < messages)
+                {
+                    Thread.Yield();
+                }
+                looper.Dispose();
+                foreach (Thread thread in threads)
+                {
+                    thread.Join();
+                }
+                Tools.AssertEqual(delivered, accepted);
+                Tools.AssertFalse(looper.handler.post(() => { }));
+            }
+        }
+
+        class _7_ScheduleOrder : Test
+        {
+            public override void Run(TestGroup nullableInstance)
+            {
+                Context c = new();
+                Thread t = new(() =>
+                {
+                    Looper.prepare(c);
+                    Looper m = Looper.myLooper(c);
+                    Handler h = new(m);
+                    MessageQueue q = m.mQueue;
+                    long now = AndroidUI.OS.NanoTime.currentTimeMillis();
+
+                    // same time messages keep their order, a time of 0 goes in front, newest first
+                    h.sendMessageAtTime(h.obtainMessage(1), now);
+                    h.sendMessageAtTime(h.obtainMessage(2), now);
+                    h.sendMessageAtTime(h.obtainMessage(3), now - 1);
+                    h.sendMessageAtFrontOfQueue(h.obtainMessage(4));
+                    h.sendMessageAtFrontOfQueue(h.obtainMessage(5));
+                    foreach (int what in new int[] { 5, 4, 3, 1, 2 })
+                    {
+                        Tools.AssertEqual(q.next().what, what);
+                    }
+
+                    // a barrier stalls later synchronous messages but not asynchronous ones
+                    int token = q.postSyncBarrier();
+                    h.sendMessageAtTime(h.obtainMessage(6), now);
+                    Message async = h.obtainMessage(7);
+                    async.setAsynchronous(true);
+                    h.sendMessageAtTime(async, now + 1);
+                    Tools.AssertEqual(q.next().what, 7);
+                    Tools.AssertFalse(q.isIdle());
+                    q.removeSyncBarrier(token);
+                    Tools.AssertEqual(q.next().what, 6);
+
+                    // removal by handler only touches that handler's messages
+                    Handler other = new(m);
+                    for (int i = 0; i < 1000; i++)
+                    {
+                        h.sendEmptyMessageDelayed(i % 4, 100000 + i);
+                        other.sendEmptyMessageDelayed(i % 4, 100000 + i);
+                    }
+                    h.removeMessages(2);
+                    Tools.AssertFalse(h.hasMessages(2));
+                    Tools.AssertTrue(h.hasMessages(3));
+                    Tools.AssertTrue(other.hasMessages(2));
+                    h.removeCallbacksAndMessages(null);
+                    other.removeCallbacksAndMessages(null);
+                    Tools.AssertTrue(q.isIdle());
+                });
+                t.Start();
+                t.Join();
+            }
+        }
+
+        class _8_FrameClock : Test
+        {
+            public override void Run(TestGroup nullableInstance)
+            {
+                using AndroidUI.OS.FrameClock clock = new(100);
+                long period = clock.getFramePeriodNanos();
+                Tools.AssertEqual(period, 10000000L);
+
+                // frame times are whole periods apart and do not advance within a period
+                long first = clock.beginFrame();
+                Tools.AssertTrue(first <= AndroidUI.OS.FrameClock.nowNanos());
+                Thread.Sleep(25);
+                long second = clock.beginFrame();
+                Tools.AssertTrue(second > first);
+                Tools.AssertEqual((second - first) % period, 0L);
+                Tools.AssertTrue(second <= AndroidUI.OS.FrameClock.nowNanos());
+
+                // frame times convert to the millisecond clock, the bound only catches a wrong unit
+                // or epoch, not scheduling delays
+                Tools.AssertTrue(clock.toMillis(first) <= clock.toMillis(second));
+                Tools.AssertTrue(Math.Abs(clock.toMillis(second) - AndroidUI.OS.NanoTime.currentTimeMillis()) <= 1000);
+
+                // while pacing, requests made before the frame is drawn fold into it, the host
+                // is never given up on so nothing here depends on how long a step takes
+                clock.setPendingFrameTimeoutPeriods(0);
+                int frames = 0;
+                ManualResetEventSlim due = new();
+                clock.setFrameListener(() =>
+                {
+                    Interlocked.Increment(ref frames);
+                    due.Set();
+                });
+                clock.requestFrame();
+                clock.requestFrame();
+                clock.requestFrame();
+                Tools.AssertTrue(due.Wait(1000));
+                clock.requestFrame();
+                Tools.AssertEqual(frames, 1);
+                Tools.AssertEqual(clock.getSkippedFrameCount(), 3L);
+
+                // drawing it lets the next one through
+                due.Reset();
+                clock.beginFrame();
+                Tools.AssertTrue(due.Wait(1000));
+                Tools.AssertEqual(frames, 2);
+                clock.setFrameListener(null);
+                Tools.AssertFalse(clock.isPacing());
+            }
+        }
+    }
+
+    // runs a looper on its own thread until disposed
+    internal sealed class LooperThread : IDisposable
+    {
+        internal readonly Looper looper;
+        internal readonly Handler handler;
+        readonly Thread thread;
+
+        internal LooperThread(Context context)
+        {
+            Looper l = null;
+            ManualResetEventSlim prepared = new();
+            thread = new(() =>
+            {
+                Looper.prepare(context);
+                l = Looper.myLooper(context);
+                prepared.Set();
+                Looper.loop(context);
+            });
+            thread.Start();
+            prepared.Wait();
+            looper = l;
+            handler = new Handler(looper);
+        }
+
+        public void Dispose()
+        {
+            looper.quitSafely();
+            thread.Join();
+        }
+    }
+
+    class looper_benchmark : XMarkTest
+    {
+        protected override void prepareBenchmark(XManager runner)
+        {
+            const int producers = 8;
+            const int messages = 20000;
+
+            runner.AddSession(new XSession(producers + " producers posting " + messages + " messages each to one looper", () =>
+            {
+                Context c = new();
+                using LooperThread looper = new(c);
+                CountdownEvent delivered = new(producers * messages);
+                Runnable dispatch = () => delivered.Signal();
+                long[][] latencies = new long[producers][];
+                Barrier start = new(producers + 1);
+                Thread[] threads = new Thread[producers];
+                for (int t = 0; t < producers; t++)
+                {
+                    long[] latency = latencies[t] = new long[messages];
+                    threads[t] = new(() =>
+                    {
+                        start.SignalAndWait();
+                        for (int i = 0; i < messages; i++)
+                        {
+                            long begin = System.Diagnostics.Stopwatch.GetTimestamp();
+                            looper.handler.post(dispatch);
+                            latency[i] = System.Diagnostics.Stopwatch.GetTimestamp() - begin;
+                        }
+                    });
+                    threads[t].Start();
+                }
+                start.SignalAndWait();
+                var watch = System.Diagnostics.Stopwatch.StartNew();
+                delivered.Wait();
+                watch.Stop();
+                foreach (Thread thread in threads)
+                {
+                    thread.Join();
+                }
+
+                long[] all = latencies.SelectMany(l => l).ToArray();
+                Array.Sort(all);
+                double ticksToMicros = 1000000.0 / System.Diagnostics.Stopwatch.Frequency;
+                Console.WriteLine("enqueue p50: " + (all[all.Length / 2] * ticksToMicros).ToString("F2") + " us");
+                Console.WriteLine("enqueue p99: " + (all[all.Length * 99 / 100] * ticksToMicros).ToString("F2") + " us");
+                Console.WriteLine("dispatch throughput: " + (all.Length / watch.Elapsed.TotalSeconds).ToString("F0") + " messages/s");
+            }, 5));
+
+            const int pending = 100000;
+            runner.AddSession(new XSession(pending + " pending delayed messages", () =>
+            {
+                Context c = new();
+                using LooperThread looper = new(c);
+                Handler[] handlers = new Handler[100];
+                for (int i = 0; i < handlers.Length; i++)
+                {
+                    handlers[i] = new Handler(looper.looper);
+                }
+                Random random = new(1);
+
+                var watch = System.Diagnostics.Stopwatch.StartNew();
+                for (int i = 0; i < pending; i++)
+                {
+                    handlers[i % handlers.Length].sendEmptyMessageDelayed(i % 16, 60000 + random.Next(60000));
+                }
+                Console.WriteLine("post: " + watch.Elapsed.TotalMilliseconds.ToString("F1") + " ms");
+
+                watch.Restart();
+                foreach (Handler handler in handlers)
+                {
+                    handler.removeMessages(3);
+                }
+                Console.WriteLine("removeMessages per handler: " + (watch.Elapsed.TotalMilliseconds * 1000 / handlers.Length).ToString("F1") + " us");
+
+                watch.Restart();
+                for (int i = 0; i < 1000; i++)
+                {
+                    handlers[i % handlers.Length].hasMessages(i % 16);
+                }
+                Console.WriteLine("hasMessages per call: " + watch.Elapsed.TotalMilliseconds.ToString("F2") + " us");
+
+                // deliver everything that is left now, in time order
+                CountdownEvent delivered = new(1);
+                foreach (Handler handler in handlers)
+                {
+                    handler.removeCallbacksAndMessages(null);
+                }
+                watch.Restart();
+                for (int i = 0; i < pending; i++)
+                {
+                    handlers[i % handlers.Length].postAtTime(() => { }, random.Next(1000));
+                }
+                handlers[0].postAtTime(() => delivered.Signal(), 1000);
+                delivered.Wait();
+                Console.WriteLine("post and deliver: " + watch.Elapsed.TotalMilliseconds.ToString("F1") + " ms");
+            }, 5));
+        }
     }
 }
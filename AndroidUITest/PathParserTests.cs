@@ -0,0 +1,136 @@
+﻿using AndroidUI;
+using AndroidUITestFramework;
+using System.Text;
+
+namespace AndroidUITest
+{
+    class PathParserTests : TestGroup
+    {
+        // a sample of Material Design icon paths (Apache License 2.0)
+        internal static readonly string[] MaterialIcons = {
+            // add
+            "M19,13h-6v6h-2v-6H5v-2h6V5h2v6h6v2z",
+            // menu
+            "M3,18h18v-2H3v2zM3,13h18v-2H3v2zM3,6v2h18V6H3z",
+            // close
+            "M19,6.41L17.59,5 12,10.59 6.41,5 5,6.41 10.59,12 5,17.59 6.41,19 12,13.41 17.59,19 19,17.59 13.41,12z",
+            // search
+            "M15.5,14h-0.79l-0.28,-0.27C15.41,12.59 16,11.11 16,9.5 16,5.91 13.09,3 9.5,3S3,5.91 3,9.5 5.91,16 9.5,16c1.61,0 3.09,-0.59 4.23,-1.57l0.27,0.28v0.79l5,4.99L20.49,19l-4.99,-5zM9.5,14C7.01,14 5,11.99 5,9.5S7.01,5 9.5,5 14,7.01 14,9.5 11.99,14 9.5,14z",
+            // arrow_back
+            "M20,11H7.83l5.59,-5.59L12,4l-8,8 8,8 1.41,-1.41L7.83,13H20v-2z",
+            // favorite
+            "M12,21.35l-1.45,-1.32C5.4,15.36 2,12.28 2,8.5 2,5.42 4.42,3 7.5,3c1.74,0 3.41,0.81 4.5,2.09C13.09,3.81 14.76,3 16.5,3 19.58,3 22,5.42 22,8.5c0,3.78 -3.4,6.86 -8.55,11.54L12,21.35z",
+            // home
+            "M10,20v-6h4v6h5v-8h3L12,3 2,12h3v8z",
+            // check
+            "M9,16.17L4.83,12l-1.42,1.41L9,19 21,7l-1.41,-1.41z",
+            // more_vert
+            "M12,8c1.1,0 2,-0.9 2,-2s-0.9,-2 -2,-2 -2,0.9 -2,2 0.9,2 2,2zM12,10c-1.1,0 -2,0.9 -2,2s0.9,2 2,2 2,-0.9 2,-2 -0.9,-2 -2,-2zM12,16c-1.1,0 -2,0.9 -2,2s0.9,2 2,2 2,-0.9 2,-2 -0.9,-2 -2,-2z",
+            // settings
+            "M19.14,12.94c0.04,-0.3 0.06,-0.61 0.06,-0.94c0,-0.32 -0.02,-0.64 -0.07,-0.94l2.03,-1.58c0.18,-0.14 0.23,-0.41 0.12,-0.61l-1.92,-3.32c-0.12,-0.22 -0.37,-0.29 -0.59,-0.22l-2.39,0.96c-0.5,-0.38 -1.03,-0.7 -1.62,-0.94L14.4,2.81c-0.04,-0.24 -0.24,-0.41 -0.48,-0.41h-3.84c-0.24,0 -0.43,0.17 -0.47,0.41L9.25,5.35C8.66,5.59 8.12,5.92 7.63,6.29L5.24,5.33c-0.22,-0.08 -0.47,0 -0.59,0.22L2.74,8.87C2.62,9.08 2.66,9.34 2.86,9.48l2.03,1.58C4.84,11.36 4.8,11.69 4.8,12s0.02,0.64 0.07,0.94l-2.03,1.58c-0.18,0.14 -0.23,0.41 -0.12,0.61l1.92,3.32c0.12,0.22 0.37,0.29 0.59,0.22l2.39,-0.96c0.5,0.38 1.03,0.7 1.62,0.94l0.36,2.54c0.05,0.24 0.24,0.41 0.48,0.41h3.84c0.24,0 0.44,-0.17 0.47,-0.41l0.36,-2.54c0.59,-0.24 1.13,-0.56 1.62,-0.94l2.39,0.96c0.22,0.08 0.47,0 0.59,-0.22l1.92,-3.32c0.12,-0.22 0.07,-0.47 -0.12,-0.61L19.14,12.94zM12,15.6c-1.98,0 -3.6,-1.62 -3.6,-3.6s1.62,-3.6 3.6,-3.6s3.6,1.62 3.6,3.6S13.98,15.6 12,15.6z",
+        };
+
+        class _1_Parse : Test
+        {
+            public override void Run(TestGroup nullableInstance)
+            {
+                PathParser.PathData data = new("M10-20.5.5e1 3L1,2z");
+                Tools.AssertEqual(new string(data.mNativePathData.verbs), "MLz");
+                Tools.AssertTrue(data.mNativePathData.verbSizes.SequenceEqual(new int[] { 4, 2, 0 }));
+                Tools.AssertTrue(data.mNativePathData.points.SequenceEqual(new float[] { 10, -20.5f, 5, 3, 1, 2 }));
+
+                PathParser.PathData utf8 = new(Encoding.UTF8.GetBytes("M10-20.5.5e1 3L1,2z"));
+                Tools.AssertTrue(utf8.mNativePathData.points.SequenceEqual(data.mNativePathData.points));
+
+                Tools.ExpectException<AndroidUI.Exceptions.IllegalArgumentException>(() => new PathParser.PathData("M1,2 L3"));
+                Tools.ExpectException<AndroidUI.Exceptions.IllegalArgumentException>(() => new PathParser.PathData("M1,2 X3,4"));
+                Tools.ExpectException<AndroidUI.Exceptions.IllegalArgumentException>(() => new PathParser.PathData("   "));
+
+                // the failure is reported at the char, not the byte, after multi-byte characters
+                try
+                {
+                    new PathParser.PathData(Encoding.UTF8.GetBytes("M1,2z\u00e9\u00e9 L1,-"));
+                    Tools.AssertTrue(false, "malformed utf-8 path data was accepted");
+                }
+                catch (AndroidUI.Exceptions.IllegalArgumentException e)
+                {
+                    Tools.AssertTrue(e.Message.Contains("parsing:  - Failure occurred at position 11 "), e.Message);
+                }
+
+                foreach (string icon in MaterialIcons)
+                {
+                    Tools.AssertFalse(PathParser.createPathFromPathData(icon).mNativePath.IsEmpty);
+                }
+            }
+        }
+
+        class _2_Morph : Test
+        {
+            public override void Run(TestGroup nullableInstance)
+            {
+                // play -> pause style morph, same verbs and float counts
+                PathParser.PathData from = new("M8,5 L8,19 L19,12 L19,12 Z");
+                PathParser.PathData to = new("M6,5 L6,19 L10,19 L10,5 Z");
+                PathParser.PathData output = new(from);
+                Tools.AssertTrue(PathParser.canMorph(from, to));
+
+                Tools.AssertTrue(PathParser.interpolatePathData(output, from, to, 0.5f));
+                Tools.AssertTrue(output.mNativePathData.points.SequenceEqual(new float[] { 7, 5, 7, 19, 14.5f, 15.5f, 14.5f, 8.5f }));
+                float[] points = output.mNativePathData.points;
+                Tools.AssertTrue(PathParser.interpolatePathData(output, from, to, 1));
+                Tools.AssertTrue(ReferenceEquals(points, output.mNativePathData.points));
+                Tools.AssertTrue(output.mNativePathData.points.SequenceEqual(to.mNativePathData.points));
+
+                Tools.AssertFalse(PathParser.canMorph(from, new PathParser.PathData("M6,5 L6,19 Z")));
+
+                // an animation of path data morphs without being given an evaluator
+                AndroidUI.AnimationFramework.Animator.PropertyValuesHolder holder =
+                    AndroidUI.AnimationFramework.Animator.PropertyValuesHolder.ofObject("pathData", null, from, to);
+                holder.init();
+                holder.calculateValue(0.5f);
+                PathParser.PathData animated = (PathParser.PathData)holder.getAnimatedValue();
+                Tools.AssertTrue(animated.mNativePathData.points.SequenceEqual(new float[] { 7, 5, 7, 19, 14.5f, 15.5f, 14.5f, 8.5f }));
+            }
+        }
+    }
+
+    class path_parser_benchmark : XMarkTest
+    {
+        protected override void prepareBenchmark(XManager runner)
+        {
+            byte[][] utf8Icons = PathParserTests.MaterialIcons.Select(Encoding.UTF8.GetBytes).ToArray();
+
+            runner.AddSession(new XSession("Material icons to PathData", () =>
+            {
+                foreach (string icon in PathParserTests.MaterialIcons)
+                {
+                    new PathParser.PathData(icon);
+                }
+            }, 10000));
+
+            runner.AddSession(new XSession("Material icons to PathData (UTF-8)", () =>
+            {
+                foreach (byte[] icon in utf8Icons)
+                {
+                    new PathParser.PathData(icon);
+                }
+            }, 10000));
+
+            runner.AddSession(new XSession("Material icons to Path", () =>
+            {
+                foreach (string icon in PathParserTests.MaterialIcons)
+                {
+                    PathParser.createPathFromPathData(icon).mNativePath.Dispose();
+                }
+            }, 10000));
+
+            PathParser.PathData from = new(PathParserTests.MaterialIcons[0]);
+            PathParser.PathData to = new(from);
+            PathParser.PathData output = new(from);
+            runner.AddSession(new XSession("PathData morph frame", () =>
+            {
+                PathParser.interpolatePathData(output, from, to, 0.5f);
+            }, 100000));
+        }
+    }
+}
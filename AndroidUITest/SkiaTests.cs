@@ -361,6 +361,644 @@ namespace AndroidUITest
             }
         }
 
+        internal class RectBounds : TestGroup
+        {
+            internal class _1_setBoundsCheck : Test
+            {
+                public override void Run(TestGroup nullableInstance)
+                {
+                    SKRect r = new();
+                    SKPoint[] pts = { new(1, 2), new(-3, 4), new(5, -6), new(7, 8), new(-9, 10) };
+
+                    Tools.AssertTrue(r.setBoundsCheck(pts, pts.Length));
+                    Tools.AssertEqual(r, new SKRect(-9, -6, 7, 10));
+
+                    // even count, offset pointer
+                    Tools.AssertTrue(r.setBoundsCheck(new AndroidUI.Utils.Arrays.MemoryPointer<SKPoint>(pts) + 1, 4));
+                    Tools.AssertEqual(r, new SKRect(-9, -6, 7, 10));
+
+                    Tools.AssertTrue(r.setBoundsCheck(pts, 2));
+                    Tools.AssertEqual(r, new SKRect(-3, 2, 1, 4));
+
+                    pts[3] = new(float.PositiveInfinity, 0);
+                    Tools.AssertFalse(r.setBoundsCheck(pts, pts.Length));
+                    Tools.AssertEqual(r, SKRect.Empty);
+
+                    pts[3] = new(0, float.NaN);
+                    Tools.AssertFalse(r.setBoundsCheck(pts, pts.Length));
+                    Tools.AssertEqual(r, SKRect.Empty);
+
+                    Tools.AssertTrue(r.setBoundsCheck(pts, 0));
+                    Tools.AssertEqual(r, SKRect.Empty);
+                }
+            }
+        }
+
+        internal class MatrixMapping : TestGroup
+        {
+            internal class _1_mapRects : Test
+            {
+                public override void Run(TestGroup nullableInstance)
+                {
+                    SKMatrix[] matrices = {
+                        SKMatrix.Identity,
+                        SKMatrix.CreateTranslation(3, -4),
+                        SKMatrix.CreateScale(-2, 3, 1, 1),
+                        SKMatrix.CreateRotationDegrees(30, 5, 5),
+                    };
+                    SKRect[] src = { new(0, 0, 10, 20), new(-5, 2, 5, 8), new(1, 1, 4, 9), new(0, 0, 10, 10) };
+                    SKRect[] dst = new SKRect[src.Length];
+
+                    for (int i = 0; i < matrices.Length; i++)
+                    {
+                        matrices[i].mapRects(dst, src);
+                        for (int j = 0; j < src.Length; j++)
+                        {
+                            SKRect expected = matrices[i].MapRect(src[j]);
+                            Tools.AssertTrue(Math.Abs(expected.Left - dst[j].Left) < 1e-4f);
+                            Tools.AssertTrue(Math.Abs(expected.Top - dst[j].Top) < 1e-4f);
+                            Tools.AssertTrue(Math.Abs(expected.Right - dst[j].Right) < 1e-4f);
+                            Tools.AssertTrue(Math.Abs(expected.Bottom - dst[j].Bottom) < 1e-4f);
+                        }
+                        Tools.AssertEqual(matrices[i].IsScaleTranslate(), i != 3);
+                    }
+
+                    SKMatrixExtensions.mapRects(matrices, dst, src);
+                    for (int j = 0; j < src.Length; j++)
+                    {
+                        SKRect expected = matrices[j].MapRect(src[j]);
+                        Tools.AssertTrue(Math.Abs(expected.Left - dst[j].Left) < 1e-4f);
+                        Tools.AssertTrue(Math.Abs(expected.Bottom - dst[j].Bottom) < 1e-4f);
+                    }
+
+                    SKPoint p = matrices[1].mapXY(1, 1);
+                    Tools.AssertEqual(p, new SKPoint(4, -3));
+                }
+            }
+
+            internal class _2_childrenBoundsInParent : Test
+            {
+                public override void Run(TestGroup nullableInstance)
+                {
+                    SKMatrix[] matrices = {
+                        SKMatrix.Identity,
+                        SKMatrix.CreateTranslation(3, -4),
+                        SKMatrix.CreateScale(-2, 3, 5, 10),
+                        SKMatrix.CreateRotationDegrees(30, 5, 10),
+                    };
+                    AndroidUI.Widgets.View parent = new();
+                    parent.layout(0, 0, 200, 200);
+                    for (int i = 0; i < matrices.Length; i++)
+                    {
+                        AndroidUI.Widgets.View child = new();
+                        parent.addView(child);
+                        child.layout(10 + i * 40, 20 + i * 5, 20 + i * 40, 40 + i * 5);
+                        child.getMatrix().Value = matrices[i];
+                    }
+
+                    SKRect[] bounds = new SKRect[matrices.Length];
+                    Tools.AssertEqual(parent.getChildrenBoundsInParent(bounds), matrices.Length);
+                    for (int i = 0; i < matrices.Length; i++)
+                    {
+                        AndroidUI.Widgets.View child = parent.getChildAt(i);
+                        SKRect expected = child.getMatrix().Value.MapRect(new SKRect(0, 0, child.getWidth(), child.getHeight()));
+                        expected.Offset(child.getLeft(), child.getTop());
+                        Tools.AssertTrue(Math.Abs(expected.Left - bounds[i].Left) < 1e-4f);
+                        Tools.AssertTrue(Math.Abs(expected.Top - bounds[i].Top) < 1e-4f);
+                        Tools.AssertTrue(Math.Abs(expected.Right - bounds[i].Right) < 1e-4f);
+                        Tools.AssertTrue(Math.Abs(expected.Bottom - bounds[i].Bottom) < 1e-4f);
+                    }
+
+                    Tools.ExpectException<AndroidUI.Exceptions.IllegalArgumentException>(() => parent.getChildrenBoundsInParent(new SKRect[1]));
+                }
+            }
+        }
+
+        internal class Tessellation : TestGroup
+        {
+            internal class _1_conic : Test
+            {
+                public override void Run(TestGroup nullableInstance)
+                {
+                    // quarter circle
+                    AndroidUI.Skia.SKConic conic = new(new(1, 0), new(1, 1), new(0, 1), MathF.Sqrt(0.5f));
+                    SKPoint[] pts = conic.tessellate(0.001f, out SKPoint[] tangents);
+                    Tools.AssertTrue(pts.Length > 2);
+                    Tools.AssertEqual(pts[0], new SKPoint(1, 0));
+                    Tools.AssertEqual(pts[^1], new SKPoint(0, 1));
+                    for (int i = 0; i < pts.Length; i++)
+                    {
+                        Tools.AssertTrue(MathF.Abs(pts[i].Length - 1) < 1e-4f);
+                        SKPoint expected = conic.evalTangentAt(i / (float)(pts.Length - 1));
+                        Tools.AssertTrue(MathF.Abs(expected.X - tangents[i].X) < 1e-4f);
+                        Tools.AssertTrue(MathF.Abs(expected.Y - tangents[i].Y) < 1e-4f);
+                    }
+                }
+            }
+
+            internal class _2_batch : Test
+            {
+                public override void Run(TestGroup nullableInstance)
+                {
+                    SKPoint[] quads = { new(0, 0), new(50, 100), new(100, 0), new(10, 10), new(10, 10), new(10, 10) };
+                    int[] segments = new int[2];
+                    int count = AndroidUI.Skia.SKTessellator.countQuads(quads, 0.25f, segments);
+                    Tools.AssertEqual(segments[1], 1);
+                    Tools.AssertEqual(count, segments[0] + 1 + 2);
+
+                    SKPoint[] pts = new SKPoint[count];
+                    Tools.AssertEqual(AndroidUI.Skia.SKTessellator.tessellateQuads(quads, segments, pts, default), count);
+                    Tools.AssertEqual(pts[segments[0]], new SKPoint(100, 0));
+                    Tools.AssertEqual(pts[segments[0] + 1], new SKPoint(10, 10));
+                    // midpoint of the first quad
+                    if (segments[0] % 2 == 0)
+                    {
+                        Tools.AssertTrue(MathF.Abs(pts[segments[0] / 2].Y - 50) < 1e-3f);
+                    }
+
+                    SKPoint[] cubic = { new(0, 0), new(0, 100), new(100, 100), new(100, 0) };
+                    count = AndroidUI.Skia.SKTessellator.countCubics(cubic, 0.25f, segments);
+                    pts = new SKPoint[count];
+                    AndroidUI.Skia.SKTessellator.tessellateCubics(cubic, segments, pts, default);
+                    Tools.AssertEqual(pts[0], cubic[0]);
+                    Tools.AssertEqual(pts[^1], cubic[3]);
+                }
+            }
+        }
+
+        internal class RunLengthRegion : TestGroup
+        {
+            internal class _1_matchesSKRegion : Test
+            {
+                public override void Run(TestGroup nullableInstance)
+                {
+                    Random random = new(31);
+                    AndroidUI.Utils.Graphics.Region.Op[] ops = {
+                        AndroidUI.Utils.Graphics.Region.Op.DIFFERENCE,
+                        AndroidUI.Utils.Graphics.Region.Op.INTERSECT,
+                        AndroidUI.Utils.Graphics.Region.Op.UNION,
+                        AndroidUI.Utils.Graphics.Region.Op.XOR,
+                        AndroidUI.Utils.Graphics.Region.Op.REVERSE_DIFFERENCE,
+                        AndroidUI.Utils.Graphics.Region.Op.REPLACE,
+                    };
+                    AndroidUI.Utils.Graphics.RunLengthRegion region = new();
+                    AndroidUI.Utils.Graphics.RunLengthRegion other = new();
+                    for (int iteration = 0; iteration < 200; iteration++)
+                    {
+                        SKRectI[] rects = new SKRectI[random.Next(1, 12)];
+                        for (int i = 0; i < rects.Length; i++)
+                        {
+                            int l = random.Next(0, 40), t = random.Next(0, 40);
+                            rects[i] = new SKRectI(l, t, l + random.Next(0, 20), t + random.Next(0, 20));
+                        }
+                        var op = ops[iteration % ops.Length];
+
+                        SKRegion expected = new(rects[0]);
+                        for (int i = 1; i < rects.Length; i++)
+                        {
+                            expected.Op(rects[i], (SKRegionOperation)op.nativeInt);
+                        }
+                        region.setRects(rects, op);
+                        Tools.AssertEqual(region.isEmpty(), expected.IsEmpty);
+
+                        AndroidUI.Utils.Rect bounds = new();
+                        region.getBounds(bounds);
+                        Tools.AssertEqual(new SKRectI(bounds.left, bounds.top, bounds.right, bounds.bottom), expected.Bounds);
+
+                        SKRectI[] actual = new SKRectI[region.getRectCount()];
+                        region.getRects(actual);
+                        SKRegion roundTrip = new();
+                        roundTrip.SetRects(actual);
+                        Tools.AssertTrue(actual.Length == 0 ? expected.IsEmpty : roundTrip.Contains(expected) && expected.Contains(roundTrip));
+
+                        for (int y = -1; y < 60; y += 3)
+                        {
+                            for (int x = -1; x < 60; x += 3)
+                            {
+                                Tools.AssertEqual(region.contains(x, y), expected.Contains(x, y));
+                            }
+                        }
+
+                        // serialized form round trips and combining regions matches SKRegion
+                        other.setRuns(region.getRuns());
+                        Tools.AssertTrue(other.Equals(region));
+                        SKRectI clip = new(10, 10, 30, 30);
+                        other.set(clip.Left, clip.Top, clip.Right, clip.Bottom);
+                        other.op(region, other, op);
+                        SKRegion expectedOp = new(expected);
+                        expectedOp.Op(new SKRegion(clip), (SKRegionOperation)op.nativeInt);
+                        for (int y = 0; y < 60; y += 2)
+                        {
+                            for (int x = 0; x < 60; x += 2)
+                            {
+                                Tools.AssertEqual(other.contains(x, y), expectedOp.Contains(x, y));
+                            }
+                        }
+                        Tools.AssertEqual(region.quickReject(clip.Left, clip.Top, clip.Right, clip.Bottom), !expected.Intersects(clip));
+                    }
+                    Tools.ExpectException<AndroidUI.Exceptions.IllegalArgumentException>(() => other.setRuns(new int[] { 0, 1, 2, 0, 1 }));
+                }
+            }
+        }
+
+        internal class NinePatchLattice : TestGroup
+        {
+            // a deserialized Res_png_9patch: header, x divs, y divs, colors
+            static byte[] chunk(int[] xDivs, int[] yDivs, uint[] colors)
+            {
+                List<byte> bytes = new() { 0, (byte)xDivs.Length, (byte)yDivs.Length, (byte)colors.Length };
+                int xDivsOffset = 32;
+                int yDivsOffset = xDivsOffset + xDivs.Length * 4;
+                int colorsOffset = yDivsOffset + yDivs.Length * 4;
+                foreach (int v in new[] { xDivsOffset, yDivsOffset, 0, 0, 0, 0, colorsOffset })
+                {
+                    bytes.AddRange(BitConverter.GetBytes(v));
+                }
+                foreach (int v in xDivs) bytes.AddRange(BitConverter.GetBytes(v));
+                foreach (int v in yDivs) bytes.AddRange(BitConverter.GetBytes(v));
+                foreach (uint v in colors) bytes.AddRange(BitConverter.GetBytes(v));
+                return bytes.ToArray();
+            }
+
+            internal class _1_cells : Test
+            {
+                public override void Run(TestGroup nullableInstance)
+                {
+                    AndroidUI.Applications.Context context = new();
+                    context.densityManager.Set(1, 96);
+                    Bitmap bm = Bitmap.createBitmap(context, 10, 10, Bitmap.Config.ARGB_8888);
+                    uint[] colors = { 0xFF00FF00, 1, 1, 1, 0, 1, 1, 1, 1 };
+                    NinePatch patch = new(bm, chunk(new[] { 2, 8 }, new[] { 3, 7 }, colors));
+
+                    AndroidUI.Graphics.NinePatchLattice lattice = patch.getLattice(100, 200);
+                    Tools.AssertEqual(lattice.getCellCount(), 9);
+                    Tools.AssertEqual(lattice.getSrc(4), new SKRect(2, 3, 8, 7));
+                    Tools.AssertEqual(lattice.getDst(4), new SKRect(2, 3, 98, 197));
+                    Tools.AssertEqual(lattice.getDst(8), new SKRect(98, 197, 100, 200));
+                    Tools.AssertEqual(lattice.getRectType(4), SKLatticeRectType.Transparent);
+                    Tools.AssertEqual(lattice.getRectType(0), SKLatticeRectType.FixedColor);
+                    Tools.AssertEqual(lattice.getColor(0), new SKColor(0xFF00FF00));
+                    Tools.AssertEqual(lattice.getRectType(1), SKLatticeRectType.Default);
+
+                    // cached per size
+                    Tools.AssertTrue(ReferenceEquals(lattice, patch.getLattice(100, 200)));
+                    Tools.AssertFalse(ReferenceEquals(lattice, patch.getLattice(50, 50)));
+                    Tools.AssertTrue(ReferenceEquals(lattice, patch.getLattice(100, 200)));
+
+                    // fixed patches shrink when they do not fit
+                    Tools.AssertEqual(patch.getLattice(3, 10).getDst(1), new SKRect(1.5f, 0, 1.5f, 3));
+
+                    Tools.AssertTrue(patch.getLattice(out SKLattice skLattice));
+                    Tools.AssertTrue(skLattice.XDivs.SequenceEqual(new[] { 2, 8 }));
+                    Tools.AssertTrue(skLattice.YDivs.SequenceEqual(new[] { 3, 7 }));
+                    Tools.AssertEqual(skLattice.RectTypes[4], SKLatticeRectType.Transparent);
+
+                    AndroidUI.Utils.Graphics.Region region = patch.getTransparentRegion(new AndroidUI.Utils.Rect(10, 10, 110, 210));
+                    Tools.AssertTrue(region.contains(50, 100));
+                    Tools.AssertFalse(region.contains(11, 11));
+                    bm.recycle();
+                }
+            }
+
+            internal class _2_chunkCache : Test
+            {
+                public override unsafe void Run(TestGroup nullableInstance)
+                {
+                    AndroidUI.Applications.Context context = new();
+                    context.densityManager.Set(1, 96);
+                    Bitmap bm = Bitmap.createBitmap(context, 10, 10, Bitmap.Config.ARGB_8888);
+                    uint[] colors = { 1, 1, 1, 1, 0, 1, 1, 1, 1 };
+
+                    long hits = NinePatchChunkCache.getHitCount();
+                    long misses = NinePatchChunkCache.getMissCount();
+                    NinePatch a = new(bm, chunk(new[] { 2, 8 }, new[] { 3, 7 }, colors));
+                    NinePatch b = new(bm, chunk(new[] { 2, 8 }, new[] { 3, 7 }, colors));
+                    NinePatch c = new(bm, chunk(new[] { 1, 8 }, new[] { 3, 7 }, colors));
+                    // identical chunks share one native patch
+                    Tools.AssertTrue(a.mNativeChunk == b.mNativeChunk);
+                    Tools.AssertTrue(a.mNativeChunk != c.mNativeChunk);
+                    Tools.AssertEqual(NinePatchChunkCache.getHitCount() - hits, 1);
+                    Tools.AssertEqual(NinePatchChunkCache.getMissCount() - misses, 2);
+                    Tools.AssertTrue(NinePatchChunkCache.getByteCount() >= 2 * (32 + 13 * 4));
+                    Tools.AssertEqual(NinePatchChunkCache.sizeOf(a.mNativeChunk), 32 + 13 * 4);
+                    GC.KeepAlive(a);
+                    GC.KeepAlive(b);
+                    GC.KeepAlive(c);
+                    bm.recycle();
+                }
+            }
+        }
+
+        internal class MappedPngChunks : TestGroup
+        {
+            static uint crc32(byte[] bytes, int offset, int count)
+            {
+                uint crc = 0xFFFFFFFF;
+                for (int i = offset; i < offset + count; i++)
+                {
+                    crc ^= bytes[i];
+                    for (int k = 0; k < 8; k++)
+                    {
+                        crc = (crc & 1) != 0 ? 0xEDB88320 ^ (crc >> 1) : crc >> 1;
+                    }
+                }
+                return ~crc;
+            }
+
+            static void bigEndian(List<byte> bytes, uint v)
+            {
+                bytes.Add((byte)(v >> 24));
+                bytes.Add((byte)(v >> 16));
+                bytes.Add((byte)(v >> 8));
+                bytes.Add((byte)v);
+            }
+
+            static byte[] chunk(string tag, List<byte> data)
+            {
+                List<byte> bytes = new();
+                bigEndian(bytes, (uint)data.Count);
+                bytes.AddRange(System.Text.Encoding.ASCII.GetBytes(tag));
+                bytes.AddRange(data);
+                // the crc covers the tag and the data
+                bigEndian(bytes, crc32(bytes.ToArray(), 4, bytes.Count - 4));
+                return bytes.ToArray();
+            }
+
+            internal class _1_decodeFile : Test
+            {
+                public override void Run(TestGroup nullableInstance)
+                {
+                    using SKBitmap source = new(10, 10);
+                    source.Erase(SKColors.Red);
+                    using SKData encoded = source.Encode(SKEncodedImageFormat.Png, 100);
+                    byte[] png = encoded.ToArray();
+
+                    // npTc is stored in network byte order, npLb in device order
+                    List<byte> npTc = new() { 0, 2, 2, 9 };
+                    foreach (uint v in new uint[] { 0, 0, 1, 2, 3, 4, 0, 2, 8, 3, 7, 1, 1, 1, 1, 0, 1, 1, 1, 1 })
+                    {
+                        bigEndian(npTc, v);
+                    }
+                    List<byte> npLb = new();
+                    foreach (int v in new[] { 1, 2, 3, 4 })
+                    {
+                        npLb.AddRange(BitConverter.GetBytes(v));
+                    }
+
+                    // after the signature and IHDR
+                    List<byte> file = new(png[..33]);
+                    file.AddRange(chunk("npTc", npTc));
+                    file.AddRange(chunk("npLb", npLb));
+                    file.AddRange(png[33..]);
+                    string path = Path.GetTempFileName();
+                    try
+                    {
+                        File.WriteAllBytes(path, file.ToArray());
+
+                        using (AndroidUI.Graphics.MappedPng mapped = AndroidUI.Graphics.MappedPng.open(path))
+                        {
+                            Tools.AssertTrue(mapped.isPng());
+                            Tools.AssertEqual(mapped.getLength(), file.Count);
+                            Tools.AssertEqual(mapped.getChunk("IHDR").Length, 13);
+                            Tools.AssertEqual(mapped.getChunk("zzzz").Length, 0);
+                        }
+
+                        AndroidUI.Applications.Context context = new();
+                        context.densityManager.Set(1, 96);
+                        Bitmap bm = BitmapFactory.decodeFile(context, path);
+                        Tools.AssertInstanceNotEqual(bm, null);
+                        Tools.AssertEqual(bm.getWidth(), 10);
+                        byte[] ninePatch = bm.getNinePatchChunk();
+                        Tools.AssertInstanceNotEqual(ninePatch, null);
+                        Tools.AssertTrue(NinePatch.isNinePatchChunk(ninePatch));
+                        Tools.AssertEqual(BitConverter.ToInt32(ninePatch, 32), 2);
+                        Tools.AssertEqual(BitConverter.ToInt32(ninePatch, 36), 8);
+                        Tools.AssertEqual(BitConverter.ToInt32(ninePatch, 12), 1);
+                        Tools.AssertInstanceNotEqual(bm.getNinePatchInsets(), null);
+                        Tools.AssertEqual(bm.getNinePatchInsets().opticalRect.right, 3);
+
+                        // the mapping is copy on write
+                        Tools.AssertTrue(File.ReadAllBytes(path).SequenceEqual(file));
+                        bm.recycle();
+                    }
+                    finally
+                    {
+                        File.Delete(path);
+                    }
+                }
+            }
+        }
+
+        internal class ScanlineDecode : TestGroup
+        {
+            static byte[] encodeGradient(int width, int height, SKEncodedImageFormat format = SKEncodedImageFormat.Png)
+            {
+                using SKBitmap source = new(new SKImageInfo(width, height, SKColorType.Rgba8888, SKAlphaType.Opaque));
+                for (int y = 0; y < height; y++)
+                {
+                    for (int x = 0; x < width; x++)
+                    {
+                        source.SetPixel(x, y, new SKColor((byte)(x * 8), (byte)(y * 8), (byte)(x * y)));
+                    }
+                }
+                using SKData encoded = source.Encode(format, 100);
+                return encoded.ToArray();
+            }
+
+            internal class _1_decodeRegion : Test
+            {
+                public override void Run(TestGroup nullableInstance)
+                {
+                    byte[] png = encodeGradient(20, 16);
+                    AndroidUI.Applications.Context context = new();
+                    context.densityManager.Set(1, 96);
+                    BitmapRegionDecoder decoder = BitmapRegionDecoder.newInstance(context, png, 0, png.Length);
+                    Tools.AssertEqual(decoder.getWidth(), 20);
+                    Tools.AssertEqual(decoder.getHeight(), 16);
+
+                    // unsampled regions are an exact crop, regions are clipped to the image
+                    BitmapFactory.Options options = new();
+                    Bitmap region = decoder.decodeRegion(new AndroidUI.Utils.Rect(3, 2, 25, 9), options);
+                    Tools.AssertInstanceNotEqual(region, null);
+                    Tools.AssertEqual(region.getWidth(), 17);
+                    Tools.AssertEqual(region.getHeight(), 7);
+                    Tools.AssertEqual(options.outMimeType, "image/png");
+                    for (int y = 0; y < 7; y++)
+                    {
+                        for (int x = 0; x < 17; x++)
+                        {
+                            Tools.AssertEqual(region.getPixel(x, y), (int)(uint)new SKColor((byte)((x + 3) * 8), (byte)((y + 2) * 8), (byte)((x + 3) * (y + 2))));
+                        }
+                    }
+
+                    // a 2x2 box average
+                    options.inSampleSize = 2;
+                    Bitmap sampled = decoder.decodeRegion(new AndroidUI.Utils.Rect(4, 4, 12, 8), options);
+                    Tools.AssertEqual(sampled.getWidth(), 4);
+                    Tools.AssertEqual(sampled.getHeight(), 2);
+                    Tools.AssertEqual(Color.red(sampled.getPixel(0, 0)), 36);
+                    Tools.AssertEqual(Color.green(sampled.getPixel(1, 1)), 52);
+
+                    Tools.ExpectException<AndroidUI.Exceptions.IllegalArgumentException>(() => decoder.decodeRegion(new AndroidUI.Utils.Rect(20, 0, 30, 5), null));
+                    decoder.recycle();
+                    Tools.AssertTrue(decoder.isRecycled());
+                    Tools.ExpectException<AndroidUI.Exceptions.IllegalStateException>(() => decoder.getWidth());
+
+                    // WebP has no scanline decoding, its regions are decoded whole, from odd
+                    // coordinates too, lossy so the colors are only close
+                    byte[] webp = encodeGradient(20, 16, SKEncodedImageFormat.Webp);
+                    BitmapRegionDecoder webpDecoder = BitmapRegionDecoder.newInstance(context, webp, 0, webp.Length);
+                    BitmapFactory.Options webpOptions = new();
+                    Bitmap webpRegion = webpDecoder.decodeRegion(new AndroidUI.Utils.Rect(3, 5, 11, 9), webpOptions);
+                    Tools.AssertInstanceNotEqual(webpRegion, null);
+                    Tools.AssertEqual(webpRegion.getWidth(), 8);
+                    Tools.AssertEqual(webpRegion.getHeight(), 4);
+                    Tools.AssertEqual(webpOptions.outMimeType, "image/webp");
+                    Tools.AssertTrue(Math.Abs(Color.red(webpRegion.getPixel(0, 0)) - 3 * 8) <= 12);
+                    Tools.AssertTrue(Math.Abs(Color.green(webpRegion.getPixel(0, 0)) - 5 * 8) <= 12);
+                    webpOptions.inSampleSize = 2;
+                    Bitmap webpSampled = webpDecoder.decodeRegion(new AndroidUI.Utils.Rect(3, 5, 11, 9), webpOptions);
+                    Tools.AssertEqual(webpSampled.getWidth(), 4);
+                    Tools.AssertEqual(webpSampled.getHeight(), 2);
+                    webpDecoder.recycle();
+                }
+            }
+
+            internal class _2_scaledDecode : Test
+            {
+                public override void Run(TestGroup nullableInstance)
+                {
+                    byte[] png = encodeGradient(20, 16);
+                    AndroidUI.Applications.Context context = new();
+                    context.densityManager.Set(1, 96);
+
+                    // the density scale is applied while the scanlines are decoded
+                    BitmapFactory.Options options = new();
+                    options.inScaled = true;
+                    options.inDensity = 4;
+                    options.inTargetDensity = 2;
+                    Bitmap bm = BitmapFactory.decodeByteArray(context, png, 0, png.Length, options);
+                    Tools.AssertInstanceNotEqual(bm, null);
+                    Tools.AssertEqual(bm.getWidth(), 10);
+                    Tools.AssertEqual(bm.getHeight(), 8);
+                    Tools.AssertEqual(Color.red(bm.getPixel(2, 0)), 36);
+                    Tools.AssertEqual(Color.alpha(bm.getPixel(9, 7)), 255);
+                }
+            }
+        }
+
+        internal class DecodeQueue : TestGroup
+        {
+            internal class _1_deliversOnLooper : Test
+            {
+                public override void Run(TestGroup nullableInstance)
+                {
+                    using SKBitmap source = new(new SKImageInfo(8, 6, SKColorType.Rgba8888, SKAlphaType.Opaque));
+                    source.Erase(SKColors.Blue);
+                    using SKData encoded = source.Encode(SKEncodedImageFormat.Png, 100);
+                    byte[] png = encoded.ToArray();
+
+                    AndroidUI.Applications.Context context = new();
+                    context.densityManager.Set(1, 96);
+                    AndroidUI.Execution.Handler handler = null;
+                    using ManualResetEventSlim prepared = new();
+                    Thread looperThread = new(() =>
+                    {
+                        AndroidUI.Execution.Looper.prepare(context);
+                        handler = new(AndroidUI.Execution.Looper.myLooper(context));
+                        prepared.Set();
+                        AndroidUI.Execution.Looper.loop(context);
+                    });
+                    looperThread.Start();
+                    prepared.Wait();
+
+                    const int count = 8;
+                    using CountdownEvent delivered = new(count);
+                    List<(Thread, Bitmap)> results = new();
+                    using (BitmapDecodeQueue queue = new(context, 2))
+                    {
+                        // cancelled before it is queued, never delivered
+                        using CancellationTokenSource cancelled = new();
+                        cancelled.Cancel();
+                        BitmapDecodeQueue.Request dropped = queue.decodeByteArray(
+                            png, 0, png.Length, null, BitmapDecodeQueue.PRIORITY_VISIBLE, handler,
+                            (_, bitmap) => results.Add((null, bitmap)), cancelled.Token
+                        );
+                        Tools.AssertTrue(dropped.isCancelled());
+
+                        for (int i = 0; i < count; i++)
+                        {
+                            BitmapDecodeQueue.Request request = queue.decodeByteArray(
+                                png, 0, png.Length, null, i % 2 == 0 ? BitmapDecodeQueue.PRIORITY_DEFAULT : BitmapDecodeQueue.PRIORITY_VISIBLE, handler,
+                                (_, bitmap) =>
+                                {
+                                    // only the looper touches results
+                                    results.Add((Thread.CurrentThread, bitmap));
+                                    delivered.Signal();
+                                }
+                            );
+                            request.setPriority(BitmapDecodeQueue.PRIORITY_VISIBLE);
+                        }
+                        Tools.AssertTrue(delivered.Wait(10000));
+                    }
+
+                    handler.getLooper().quitSafely();
+                    looperThread.Join();
+
+                    Tools.AssertEqual(results.Count, count);
+                    foreach ((Thread thread, Bitmap bitmap) in results)
+                    {
+                        Tools.AssertTrue(thread == looperThread);
+                        Tools.AssertInstanceNotEqual(bitmap, null);
+                        Tools.AssertEqual(bitmap.getWidth(), 8);
+                        Tools.AssertEqual(bitmap.getPixel(3, 3), (int)(uint)SKColors.Blue);
+                    }
+                }
+            }
+        }
+
+        internal class PixelPool : TestGroup
+        {
+            internal class _1_reusesRecycledPixels : Test
+            {
+                public override void Run(TestGroup nullableInstance)
+                {
+                    Tools.AssertEqual(BitmapPool.getSizeClass(4096), 4096);
+                    Tools.AssertEqual(BitmapPool.getSizeClass(4097), 5120);
+                    Tools.AssertEqual(BitmapPool.getSizeClass(37884), 40960);
+
+                    AndroidUI.Applications.Context context = new();
+                    context.densityManager.Set(1, 96);
+                    BitmapPool.setBudget(64 * 1024 * 1024);
+                    BitmapPool.clear();
+
+                    Bitmap first = Bitmap.createBitmap(context, 123, 77, Bitmap.Config.ARGB_8888);
+                    first.eraseColor(unchecked((int)0xFF00FF00));
+                    first.recycle();
+                    first = null;
+                    // the pixels are released once nothing references them
+                    for (int i = 0; i < 10 && BitmapPool.getPooledCount() == 0; i++)
+                    {
+                        GC.Collect();
+                        GC.WaitForPendingFinalizers();
+                    }
+                    Tools.AssertTrue(BitmapPool.getPooledCount() > 0);
+
+                    // another size in the same class reuses the buffer, zeroed
+                    long hits = BitmapPool.getHitCount();
+                    Bitmap second = Bitmap.createBitmap(context, 120, 78, Bitmap.Config.ARGB_8888);
+                    Tools.AssertTrue(BitmapPool.getHitCount() > hits);
+                    Tools.AssertEqual(second.getPixel(5, 5), 0);
+                    Tools.AssertTrue(BitmapPool.getInUseByteCount() >= 40960);
+                    second.recycle();
+
+                    BitmapPool.clear();
+                    Tools.AssertEqual(BitmapPool.getPooledByteCount(), 0);
+                    BitmapPool.setBudget(16 * 1024 * 1024);
+                }
+            }
+        }
+
         internal class BitmapTests : TestGroup
         {
             const string image_path = "K:/DESKTOP_BACKUP/Documents/2021-07-25 22.37.22.jpg";
@@ -939,5 +1577,395 @@ namespace AndroidUITest
                 }
             }
         }
+
+        internal class CommandBuffer : TestGroup
+        {
+            static void draw(SKCanvas canvas, SKPaint paint, SKPath path)
+            {
+                canvas.Clear(SKColors.White);
+                canvas.Save();
+                canvas.Translate(4, 4);
+                paint.Color = SKColors.Red;
+                canvas.DrawRect(new SKRect(0, 0, 20, 20), paint);
+                paint.Color = SKColors.Blue;
+                canvas.DrawCircle(40, 40, 10, paint);
+                canvas.DrawPath(path, paint);
+                canvas.Restore();
+                paint.Color = SKColors.Red;
+                canvas.DrawRect(44, 4, 16, 16, paint);
+            }
+
+            static byte[] pixels(Action<SKCanvas> action)
+            {
+                using SKSurface surface = SKSurface.Create(new SKImageInfo(64, 64, SKColorType.Rgba8888, SKAlphaType.Premul));
+                action(surface.Canvas);
+                surface.Canvas.Flush();
+                using SKImage image = surface.Snapshot();
+                using SKPixmap pixmap = image.PeekPixels();
+                return pixmap.GetPixelSpan().ToArray();
+            }
+
+            internal class _1_playback : Test
+            {
+                public override void Run(TestGroup nullableInstance)
+                {
+                    using SKPaint paint = new() { IsAntialias = true };
+                    using SKPath path = new();
+                    path.MoveTo(0, 60);
+                    path.LineTo(30, 40);
+                    path.LineTo(30, 60);
+                    path.Close();
+
+                    byte[] expected = pixels(canvas => draw(canvas, paint, path));
+
+                    using RecordingCanvas2 recorder = new(64, 64);
+                    draw(recorder, paint, path);
+                    using RecordingCanvas2.CommandBuffer buffer = recorder.GetCommandBuffer();
+                    Tools.AssertEqual(buffer.Count, 8);
+                    // both red rectangles share one paint, the path and blue paint make three
+                    Tools.AssertEqual(buffer.ObjectCount, 3);
+
+                    // the recording owns copies, changing what was recorded changes nothing
+                    paint.Color = SKColors.Green;
+                    path.Reset();
+                    Tools.AssertTrue(pixels(buffer.Playback).AsSpan().SequenceEqual(expected));
+                    // and playback can be repeated
+                    Tools.AssertTrue(pixels(buffer.Playback).AsSpan().SequenceEqual(expected));
+
+                    // the buffer outlives the recording it was taken from
+                    recorder.ResetRecording();
+                    recorder.Dispose();
+                    Tools.AssertTrue(pixels(buffer.Playback).AsSpan().SequenceEqual(expected));
+                }
+            }
+
+            internal class _2_cull : Test
+            {
+                // a long column of rows, like the content of a ScrollView
+                static void column(SKCanvas canvas, SKPaint fill, SKPaint stroke, SKPaint blur)
+                {
+                    for (int i = 0; i < 100; i++)
+                    {
+                        fill.Color = i % 2 == 0 ? SKColors.Red : SKColors.Blue;
+                        canvas.DrawRect(0, i * 20, 64, 16, fill);
+                    }
+                    // the stroke of a line just outside the first screen still reaches into it
+                    canvas.DrawLine(0, 70, 64, 70, stroke);
+                    // and a blurred layer spreads what is drawn in it
+                    canvas.SaveLayer(blur);
+                    canvas.DrawRect(20, 1000, 20, 4, fill);
+                    canvas.Restore();
+                }
+
+                public override void Run(TestGroup nullableInstance)
+                {
+                    // antialiased, so the rows stay separate draws rather than becoming paths
+                    using SKPaint fill = new() { IsAntialias = true };
+                    using SKPaint stroke = new() { Style = SKPaintStyle.Stroke, StrokeWidth = 16, Color = SKColors.Green };
+                    using SKPaint blur = new() { ImageFilter = SKImageFilter.CreateBlur(8, 8) };
+
+                    using RecordingCanvas2 recorder = new(64, 2000);
+                    column(recorder, fill, stroke, blur);
+                    using RecordingCanvas2.CommandBuffer buffer = recorder.GetCommandBuffer();
+
+                    Tools.AssertTrue(pixels(buffer.Playback).AsSpan().SequenceEqual(pixels(canvas => column(canvas, fill, stroke, blur))));
+                    // the rows on the first screen, the line, and the draw in the blurred layer
+                    Tools.AssertEqual(buffer.DrawnCount, 6);
+                    Tools.AssertEqual(buffer.CulledCount, 96);
+
+                    // scrolled to the middle of the column
+                    Action<SKCanvas> scrolled(Action<SKCanvas> draw) => canvas =>
+                    {
+                        canvas.Translate(0, -1000);
+                        draw(canvas);
+                    };
+                    Tools.AssertTrue(pixels(scrolled(buffer.Playback)).AsSpan().SequenceEqual(pixels(scrolled(canvas => column(canvas, fill, stroke, blur)))));
+                    Tools.AssertEqual(buffer.DrawnCount, 5);
+                    Tools.AssertEqual(buffer.CulledCount, 97);
+
+                    // playbacks share no state, one buffer may be played on several threads at once
+                    byte[] expected = pixels(scrolled(buffer.Playback));
+                    bool[] same = new bool[8];
+                    Parallel.For(0, same.Length, i => same[i] = pixels(scrolled(buffer.Playback)).AsSpan().SequenceEqual(expected));
+                    Tools.AssertTrue(same.All(b => b));
+
+                    // a region clip does not move with the playback matrix, a draw outside it when
+                    // recorded is inside it when played back further up
+                    static void clippedRegion(SKCanvas canvas, SKPaint fill)
+                    {
+                        using SKRegion region = new(new SKRectI(0, 0, 10, 10));
+                        canvas.ClipRegion(region);
+                        canvas.DrawRect(20, 20, 10, 10, fill);
+                    }
+                    using RecordingCanvas2 regionRecorder = new(64, 64);
+                    clippedRegion(regionRecorder, fill);
+                    using RecordingCanvas2.CommandBuffer regionBuffer = regionRecorder.GetCommandBuffer();
+                    Action<SKCanvas> raised(Action<SKCanvas> draw) => canvas =>
+                    {
+                        canvas.Translate(-20, -20);
+                        draw(canvas);
+                    };
+                    Tools.AssertTrue(pixels(raised(regionBuffer.Playback)).AsSpan().SequenceEqual(pixels(raised(canvas => clippedRegion(canvas, fill)))));
+                    Tools.AssertEqual(regionBuffer.DrawnCount, 1);
+                }
+            }
+
+            internal class _3_optimize : Test
+            {
+                static void scene(SKCanvas canvas, SKPaint red, SKPaint blue, SKImage image)
+                {
+                    canvas.Clear(SKColors.White);
+                    // a save with nothing drawn in it
+                    canvas.Save();
+                    canvas.Translate(10, 10);
+                    canvas.Restore();
+                    // rows of alternating paints, then a blue bar over all of them
+                    for (int i = 0; i < 4; i++)
+                    {
+                        canvas.DrawRect(0, i * 8, 30, 6, i % 2 == 0 ? red : blue);
+                    }
+                    canvas.DrawRect(20, 0, 10, 30, blue);
+                    // one image drawn along a row
+                    for (int i = 0; i < 4; i++)
+                    {
+                        canvas.DrawImage(image, 36 + i * 6, 0);
+                    }
+                    // a draw the clip hides
+                    canvas.Save();
+                    canvas.ClipRect(new SKRect(0, 40, 64, 64));
+                    canvas.DrawRect(0, 0, 10, 10, red);
+                    canvas.DrawRect(0, 50, 10, 10, red);
+                    canvas.Restore();
+                }
+
+                public override void Run(TestGroup nullableInstance)
+                {
+                    using SKPaint red = new() { Color = SKColors.Red };
+                    using SKPaint blue = new() { Color = SKColors.Blue.WithAlpha(0x80) };
+                    using SKBitmap bitmap = new(4, 4);
+                    bitmap.Erase(SKColors.Green);
+                    using SKImage image = SKImage.FromBitmap(bitmap);
+
+                    using RecordingCanvas2 recorder = new(64, 64);
+                    scene(recorder, red, blue, image);
+                    using RecordingCanvas2.CommandBuffer buffer = recorder.GetCommandBuffer();
+
+                    // the clear, one atlas of the images, a path of the red rows, a path of the
+                    // blue rows, the bar, which overlaps them so is drawn alone after them, and
+                    // the save, clip, visible draw and restore
+                    Tools.AssertEqual(buffer.Count, 9);
+                    Tools.AssertTrue(pixels(buffer.Playback).AsSpan().SequenceEqual(pixels(canvas => scene(canvas, red, blue, image))));
+
+                    // null images are kept as they are rather than merged into an atlas
+                    recorder.ResetRecording();
+                    recorder.DrawImage(null, 0, 0);
+                    recorder.DrawImage(null, 8, 0);
+                    using RecordingCanvas2.CommandBuffer nulls = recorder.GetCommandBuffer();
+                    Tools.AssertEqual(nulls.Count, 2);
+                }
+            }
+
+            internal class _4_file : Test
+            {
+                static SKImage image()
+                {
+                    using SKBitmap bitmap = new(64, 64);
+                    bitmap.Erase(SKColors.Green);
+                    bitmap.SetPixel(3, 5, SKColors.Yellow);
+                    return SKImage.FromBitmap(bitmap);
+                }
+
+                public override void Run(TestGroup nullableInstance)
+                {
+                    using SKImage first = image();
+                    using SKImage second = image();
+                    using SKPaint paint = new() { IsAntialias = true, Color = SKColors.Blue };
+                    using SKFont font = new(SKTypeface.Default, 12);
+                    using SKPath path = new();
+                    path.AddCircle(40, 40, 12);
+
+                    void scene(SKCanvas canvas)
+                    {
+                        canvas.Clear(SKColors.White);
+                        canvas.DrawImage(first, new SKRect(0, 0, 32, 32));
+                        canvas.DrawImage(second, new SKRect(32, 32, 64, 64));
+                        canvas.DrawPath(path, paint);
+                        canvas.DrawText("AUDL", 4, 50, font, paint);
+                    }
+
+                    using RecordingCanvas2 recorder = new(64, 64);
+                    scene(recorder);
+                    using RecordingCanvas2.CommandBuffer buffer = recorder.GetCommandBuffer();
+
+                    string file = Path.GetTempFileName();
+                    string newer = Path.GetTempFileName();
+                    try
+                    {
+                        buffer.WriteTo(file);
+                        using (RecordingCanvas2.CommandBuffer mapped = RecordingCanvas2.CommandBuffer.Map(file))
+                        {
+                            Tools.AssertEqual(mapped.Count, buffer.Count);
+                            Tools.AssertEqual(mapped.ObjectCount, buffer.ObjectCount);
+                            Tools.AssertTrue(pixels(mapped.Playback).AsSpan().SequenceEqual(pixels(scene)));
+                        }
+
+                        // the two images hold the same pixels, so they are stored once
+                        Tools.AssertTrue(new FileInfo(file).Length < 2 * 64 * 64 * 4);
+
+                        // a file of a major version this build does not know is refused
+                        byte[] bytes = File.ReadAllBytes(file);
+                        bytes[4]++;
+                        File.WriteAllBytes(newer, bytes);
+                        Tools.ExpectException<InvalidDataException>(() => RecordingCanvas2.CommandBuffer.Map(newer));
+
+                        // and so is one whose records do not hold together, the offsets of the
+                        // commands and draws are in the first and second entries of the table
+                        void corrupt(Action<byte[], int, int> change)
+                        {
+                            byte[] data = File.ReadAllBytes(file);
+                            change(data, (int)BitConverter.ToInt64(data, 16 + 8), (int)BitConverter.ToInt64(data, 16 + 24 + 8));
+                            File.WriteAllBytes(newer, data);
+                            Tools.ExpectException<InvalidDataException>(() => RecordingCanvas2.CommandBuffer.Map(newer));
+                        }
+                        // an unknown command
+                        corrupt((data, commands, draws) => BitConverter.TryWriteBytes(data.AsSpan(commands), 0x7FFF));
+                        // a payload longer than its command has
+                        corrupt((data, commands, draws) => data[commands + 4]++);
+                        // a draw past the last record
+                        corrupt((data, commands, draws) => BitConverter.TryWriteBytes(data.AsSpan(draws), buffer.Count));
+                        // a handle to an object of another kind, the objects are the fourth entry of
+                        // the table, each starting with its kind, 12 being a string
+                        corrupt((data, commands, draws) => BitConverter.TryWriteBytes(data.AsSpan((int)BitConverter.ToInt64(data, 16 + 3 * 24 + 8)), 12u));
+                        // an image without pixels, and one whose rows run past its pixels, the
+                        // images are the fifth entry of the table
+                        int images(byte[] data) => (int)BitConverter.ToInt64(data, 16 + 4 * 24 + 8);
+                        corrupt((data, commands, draws) => BitConverter.TryWriteBytes(data.AsSpan(images(data)), 0));
+                        corrupt((data, commands, draws) => BitConverter.TryWriteBytes(data.AsSpan(images(data) + 16), (long)int.MaxValue));
+                    }
+                    finally
+                    {
+                        File.Delete(file);
+                        File.Delete(newer);
+                    }
+                }
+            }
+
+            internal class _5_render_node : Test
+            {
+                static RecordingCanvas2.CommandBuffer square(SKPaint paint)
+                {
+                    using RecordingCanvas2 recorder = new(10, 10);
+                    recorder.DrawRect(0, 0, 10, 10, paint);
+                    return recorder.GetCommandBuffer();
+                }
+
+                public override void Run(TestGroup nullableInstance)
+                {
+                    using SKPaint red = new() { Color = SKColors.Red };
+                    using SKPaint blue = new() { Color = SKColors.Blue };
+
+                    RenderNode node = new();
+                    node.setDisplayList(square(red), 10, 10);
+                    node.setPosition(5, 5);
+                    // a node never drawn may land anywhere
+                    Tools.AssertEqual(node.damage(), RecordingCanvas2.UNBOUNDED);
+
+                    using RecordingCanvas2 recorder = new(64, 64);
+                    recorder.Clear(SKColors.White);
+                    recorder.DrawRenderNode(node);
+                    using (RecordingCanvas2.CommandBuffer parent = recorder.GetCommandBuffer())
+                    {
+                        Tools.AssertTrue(pixels(parent.Playback).AsSpan().SequenceEqual(pixels(canvas =>
+                        {
+                            canvas.Clear(SKColors.White);
+                            canvas.DrawRect(5, 5, 10, 10, red);
+                        })));
+
+                        // the parent is not recorded again, it draws what the node has now
+                        Tools.AssertTrue(node.setPosition(30, 30));
+                        Tools.AssertFalse(node.setPosition(30, 30));
+                        node.setDisplayList(square(blue), 10, 10);
+                        Tools.AssertEqual(node.damage(), new SKRect(5, 5, 40, 40));
+                        Tools.AssertTrue(pixels(parent.Playback).AsSpan().SequenceEqual(pixels(canvas =>
+                        {
+                            canvas.Clear(SKColors.White);
+                            canvas.DrawRect(30, 30, 10, 10, blue);
+                        })));
+                        Tools.AssertEqual(node.damage(), new SKRect(30, 30, 40, 40));
+
+                        // a change of alpha alone damages the node and is drawn without recording
+                        Tools.AssertTrue(node.setAlpha(0.5f));
+                        Tools.AssertFalse(node.setAlpha(0.5f));
+                        Tools.AssertEqual(node.damage(), new SKRect(30, 30, 40, 40));
+                        using SKPaint half = new() { Color = SKColors.Black.WithAlpha(128) };
+                        Tools.AssertTrue(pixels(parent.Playback).AsSpan().SequenceEqual(pixels(canvas =>
+                        {
+                            canvas.Clear(SKColors.White);
+                            canvas.SaveLayer(half);
+                            canvas.DrawRect(30, 30, 10, 10, blue);
+                            canvas.Restore();
+                        })));
+                    }
+
+                    // the parent refers to the node, it does not own it
+                    Tools.AssertTrue(node.hasDisplayList());
+                    node.discardDisplayList();
+                    Tools.AssertFalse(node.hasDisplayList());
+
+                    // a paint fills whatever the parent shows, so the node damages all of it,
+                    // even once drawn
+                    RenderNode fill = new();
+                    using (RecordingCanvas2 paint = new(10, 10))
+                    {
+                        paint.DrawPaint(red);
+                        fill.setDisplayList(paint.GetCommandBuffer(), 10, 10);
+                    }
+                    pixels(fill.draw);
+                    Tools.AssertEqual(fill.damage(), RecordingCanvas2.UNBOUNDED);
+                    fill.discardDisplayList();
+                }
+            }
+
+            internal class _6_frame_file : Test
+            {
+                public override void Run(TestGroup nullableInstance)
+                {
+                    bool commandBuffers = AndroidUI.Widgets.ViewRootImpl.REPLACE_SKPICTURE_WITH_COMMAND_BUFFER;
+                    AndroidUI.Widgets.ViewRootImpl.REPLACE_SKPICTURE_WITH_COMMAND_BUFFER = true;
+                    string file = Path.GetTempFileName();
+                    try
+                    {
+                        // a frame of views drawn through render nodes, one moved and see through
+                        AndroidUI.Applications.Application application = new();
+                        AndroidUI.Widgets.FrameLayout content = new();
+                        AndroidUI.Widgets.View square = new();
+                        square.setBackgroundColor(Color.RED);
+                        square.setTranslationX(8);
+                        square.setAlpha(0.5f);
+                        content.addView(square, new AndroidUI.Widgets.FrameLayout.LayoutParams(20, 20));
+                        application.SetContentView(content);
+                        application.onSizeChanged(64, 64);
+                        using SKSurface surface = SKSurface.Create(new SKImageInfo(64, 64));
+                        using AndroidUI.Graphics.Canvas canvas = BaseCanvas.CreateHardwareAcceleratedCanvas<AndroidUI.Graphics.Canvas>(null, surface, 64, 64);
+                        application.Draw(canvas);
+
+                        RenderNode root = application.Context.mAttachInfo.mRootView.mDisplayListNode;
+                        Tools.AssertTrue(root.hasDisplayList());
+
+                        // the root refers to the nodes of its children, which a file cannot hold
+                        // unless they are written in place
+                        Tools.ExpectException<NotSupportedException>(() => root.getDisplayList().WriteTo(file));
+                        root.getDisplayList().WriteTo(file, true);
+                        using RecordingCanvas2.CommandBuffer mapped = RecordingCanvas2.CommandBuffer.Map(file);
+                        Tools.AssertTrue(pixels(mapped.Playback).AsSpan().SequenceEqual(pixels(root.draw)));
+                    }
+                    finally
+                    {
+                        AndroidUI.Widgets.ViewRootImpl.REPLACE_SKPICTURE_WITH_COMMAND_BUFFER = commandBuffers;
+                        File.Delete(file);
+                    }
+                }
+            }
+        }
     }
 }
@@ -1,4 +1,6 @@
 ﻿using AndroidUI.Input;
+using AndroidUI.Utils.Input;
+using AndroidUI.Utils.Lists;
 using AndroidUITestFramework;
 
 namespace AndroidUITest
@@ -349,5 +351,188 @@ namespace AndroidUITest
                 }
             }
         }
+
+        private class VelocityTracking : TestGroup
+        {
+            // pointer 0 moves at (500, -250) and pointer 1 at (-1000, 0) units per second,
+            // sampled every 8 ms
+            static void fling(NativeVelocityTracker tracker, int movements)
+            {
+                for (int i = 0; i < movements; i++)
+                {
+                    float ms = i * 8;
+                    Dictionary<object, NativeVelocityTracker.Position> positions = new();
+                    positions[0] = new() { x = 100 + 0.5f * ms, y = 200 - 0.25f * ms };
+                    positions[1] = new() { x = 300 - ms, y = 50 };
+                    tracker.addMovement(1000000000L + i * 8 * NativeVelocityTracker.NANOS_PER_MS, new BitwiseList<object>(new object[] { 0, 1 }), positions);
+                }
+            }
+
+            static void expectVelocity(NativeVelocityTracker tracker, object id, float vx, float vy)
+            {
+                Tools.AssertTrue(tracker.getVelocity(id, out float x, out float y));
+                Tools.AssertTrue(Math.Abs(x - vx) < 1, "x velocity of pointer " + id + " was " + x + ", expected " + vx);
+                Tools.AssertTrue(Math.Abs(y - vy) < 1, "y velocity of pointer " + id + " was " + y + ", expected " + vy);
+            }
+
+            class _1_strategies : Test
+            {
+                public override void Run(TestGroup nullableInstance)
+                {
+                    foreach (NativeVelocityTracker.Strategy strategy in new[] {
+                        NativeVelocityTracker.Strategy.IMPULSE,
+                        NativeVelocityTracker.Strategy.LSQ1,
+                        NativeVelocityTracker.Strategy.LSQ2,
+                        NativeVelocityTracker.Strategy.LSQ3,
+                        NativeVelocityTracker.Strategy.WLSQ2_DELTA,
+                        NativeVelocityTracker.Strategy.WLSQ2_CENTRAL,
+                        NativeVelocityTracker.Strategy.WLSQ2_RECENT,
+                    })
+                    {
+                        NativeVelocityTracker tracker = new(strategy);
+                        fling(tracker, 12);
+                        expectVelocity(tracker, 0, 500, -250);
+                        expectVelocity(tracker, 1, -1000, 0);
+
+                        NativeVelocityTracker.Estimator estimator = new();
+                        Tools.AssertTrue(tracker.getEstimator(1, estimator));
+                        if (strategy != NativeVelocityTracker.Strategy.IMPULSE)
+                        {
+                            // the polynomial is relative to the last movement, 300 - 88
+                            Tools.AssertTrue(Math.Abs(estimator.xCoeff[0] - 212) < 0.01f, "x position was " + estimator.xCoeff[0]);
+                            Tools.AssertTrue(estimator.confidence > 0.99f, "confidence was " + estimator.confidence);
+                        }
+                    }
+                }
+            }
+
+            class _2_single_sample : Test
+            {
+                public override void Run(TestGroup nullableInstance)
+                {
+                    NativeVelocityTracker tracker = new(NativeVelocityTracker.Strategy.LSQ2);
+                    fling(tracker, 1);
+                    NativeVelocityTracker.Estimator estimator = new();
+                    Tools.AssertTrue(tracker.getEstimator(0, estimator));
+                    Tools.AssertEqual(estimator.degree, 0);
+                    Tools.AssertEqual(estimator.xCoeff[0], 100.0f);
+                    Tools.AssertFalse(tracker.getVelocity(0, out _, out _));
+                }
+            }
+
+            class _3_pointer_up : Test
+            {
+                public override void Run(TestGroup nullableInstance)
+                {
+                    NativeVelocityTracker tracker = new(NativeVelocityTracker.Strategy.LSQ2);
+                    fling(tracker, 6);
+
+                    // pointer 1 went up, pointer 0 keeps its history
+                    Dictionary<object, NativeVelocityTracker.Position> positions = new();
+                    positions[0] = new() { x = 100 + 0.5f * 48, y = 200 - 0.25f * 48 };
+                    tracker.addMovement(1000000000L + 48 * NativeVelocityTracker.NANOS_PER_MS, new BitwiseList<object>(new object[] { 0 }), positions);
+                    expectVelocity(tracker, 0, 500, -250);
+                    Tools.AssertFalse(tracker.getVelocity(1, out _, out _));
+
+                    // a new pointer takes the free slot and starts from an empty history
+                    positions[0] = new() { x = 100 + 0.5f * 56, y = 200 - 0.25f * 56 };
+                    positions[2] = new() { x = 10, y = 10 };
+                    tracker.addMovement(1000000000L + 56 * NativeVelocityTracker.NANOS_PER_MS, new BitwiseList<object>(new object[] { 0, 2 }), positions);
+                    expectVelocity(tracker, 0, 500, -250);
+                    NativeVelocityTracker.Estimator estimator = new();
+                    Tools.AssertTrue(tracker.getEstimator(2, estimator));
+                    Tools.AssertEqual(estimator.degree, 0);
+
+                    tracker.clear();
+                    Tools.AssertFalse(tracker.getEstimator(0, estimator));
+                }
+            }
+
+            class _4_many_pointers : Test
+            {
+                // pointer p goes down at movement 3p and moves along its own curve, so the
+                // pointers hold histories of 30 down to 3 movements, 8 ms apart, and the
+                // longest reach past the 100 ms horizon
+                const int POINTERS = 10;
+                const int MOVEMENTS = 30;
+
+                static NativeVelocityTracker.Position position(int pointer, int movement)
+                {
+                    float ms = movement * 8;
+                    return new()
+                    {
+                        x = 100 + 10 * pointer + (pointer + 1) * 0.3f * ms + (pointer - 4) * 0.002f * ms * ms,
+                        y = 400 - 20 * pointer - (pointer - 5) * 0.4f * ms + (pointer % 3) * 0.001f * ms * ms,
+                    };
+                }
+
+                static long time(int movement)
+                {
+                    return 1000000000L + movement * 8 * NativeVelocityTracker.NANOS_PER_MS;
+                }
+
+                static void expectClose(float actual, float expected, string what)
+                {
+                    Tools.AssertTrue(Math.Abs(actual - expected) <= 1e-4f * Math.Max(1, Math.Abs(expected)), what + " was " + actual + ", expected " + expected);
+                }
+
+                public override void Run(TestGroup nullableInstance)
+                {
+                    foreach (NativeVelocityTracker.Strategy strategy in new[] {
+                        NativeVelocityTracker.Strategy.IMPULSE,
+                        NativeVelocityTracker.Strategy.LSQ1,
+                        NativeVelocityTracker.Strategy.LSQ2,
+                        NativeVelocityTracker.Strategy.LSQ3,
+                        NativeVelocityTracker.Strategy.WLSQ2_DELTA,
+                        NativeVelocityTracker.Strategy.WLSQ2_CENTRAL,
+                        NativeVelocityTracker.Strategy.WLSQ2_RECENT,
+                    })
+                    {
+                        NativeVelocityTracker tracker = new(strategy);
+                        for (int i = 0; i < MOVEMENTS; i++)
+                        {
+                            List<object> ids = new();
+                            Dictionary<object, NativeVelocityTracker.Position> positions = new();
+                            for (int pointer = 0; pointer < POINTERS && 3 * pointer <= i; pointer++)
+                            {
+                                ids.Add(pointer);
+                                positions[pointer] = position(pointer, i);
+                            }
+                            tracker.addMovement(time(i), new BitwiseList<object>(ids.ToArray()), positions);
+                        }
+
+                        // each pointer is estimated as a tracker of that pointer alone would
+                        for (int pointer = 0; pointer < POINTERS; pointer++)
+                        {
+                            NativeVelocityTracker single = new(strategy);
+                            for (int i = 3 * pointer; i < MOVEMENTS; i++)
+                            {
+                                Dictionary<object, NativeVelocityTracker.Position> positions = new();
+                                positions[pointer] = position(pointer, i);
+                                single.addMovement(time(i), new BitwiseList<object>(new object[] { pointer }), positions);
+                            }
+
+                            NativeVelocityTracker.Estimator estimator = new();
+                            NativeVelocityTracker.Estimator expected = new();
+                            Tools.AssertTrue(tracker.getEstimator(pointer, estimator));
+                            Tools.AssertTrue(single.getEstimator(pointer, expected));
+                            string name = strategy + " pointer " + pointer;
+                            Tools.AssertEqual(estimator.degree, expected.degree, name + " degree");
+                            Tools.AssertEqual(estimator.time, expected.time, name + " time");
+                            expectClose(estimator.confidence, expected.confidence, name + " confidence");
+                            for (int i = 0; i <= expected.degree; i++)
+                            {
+                                expectClose(estimator.xCoeff[i], expected.xCoeff[i], name + " x coefficient " + i);
+                                expectClose(estimator.yCoeff[i], expected.yCoeff[i], name + " y coefficient " + i);
+                            }
+
+                            Tools.AssertEqual(tracker.getVelocity(pointer, out float vx, out float vy), single.getVelocity(pointer, out float ex, out float ey), name + " velocity");
+                            expectClose(vx, ex, name + " x velocity");
+                            expectClose(vy, ey, name + " y velocity");
+                        }
+                    }
+                }
+            }
+        }
     }
 }